@@ -0,0 +1,35 @@
+#include "common-tests/disc_image_test_utils.h"
+#include "common/cd_image.h"
+#include "common/cd_image_hasher.h"
+#include "common/timer.h"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+namespace {
+
+using CDImageHasherBenchmark = DiscImageTest;
+
+} // namespace
+
+TEST_F(CDImageHasherBenchmark, HashTypes)
+{
+  // 32MB, a small CD's worth
+  const std::string path = WriteTrack("cd_image_hasher_benchmark.bin", 0x33, 14000);
+  ASSERT_FALSE(path.empty());
+  std::unique_ptr<CDImage> image = CDImage::Open(path.c_str());
+  ASSERT_TRUE(image);
+
+  Common::Timer timer;
+  CDImageHasher::Hash md5_hash, xxh128_hash;
+  ASSERT_TRUE(CDImageHasher::GetTrackHash(image.get(), 1, &md5_hash));
+  const double md5_time = timer.GetTimeMilliseconds();
+
+  timer.Reset();
+  ASSERT_TRUE(CDImageHasher::GetTrackHash(image.get(), 1, &xxh128_hash, ProgressCallback::NullProgressCallback,
+                                          CDImageHasher::HashType::XXH128));
+  const double xxh128_time = timer.GetTimeMilliseconds();
+
+  std::printf("md5: %.2f ms, xxh128: %.2f ms\n", md5_time, xxh128_time);
+}
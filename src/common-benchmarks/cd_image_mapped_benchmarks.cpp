@@ -0,0 +1,45 @@
+#include "common-tests/disc_image_test_utils.h"
+#include "common/cd_image.h"
+#include "common/cd_image_hasher.h"
+#include "common/timer.h"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+namespace {
+
+using CDImageMappedBenchmark = DiscImageTest;
+
+} // namespace
+
+TEST_F(CDImageMappedBenchmark, OpenAndHash)
+{
+  // 32MB, big enough for the preload to show up in the timings
+  static constexpr u32 SECTORS = 14000;
+  const std::string path = WriteTrack("cd_image_mapped_benchmark.bin", 0x5A, SECTORS);
+  ASSERT_FALSE(path.empty());
+
+  Common::Timer timer;
+  std::unique_ptr<CDImage> mapped_image = CDImage::Open(path.c_str());
+  ASSERT_TRUE(mapped_image);
+  const double mapped_open_time = timer.GetTimeMilliseconds();
+
+  timer.Reset();
+  std::unique_ptr<CDImage> source_image = CDImage::Open(path.c_str());
+  ASSERT_TRUE(source_image);
+  std::unique_ptr<CDImage> memory_image = CDImage::CreateMemoryImage(source_image.get());
+  ASSERT_TRUE(memory_image);
+  const double preload_time = timer.GetTimeMilliseconds();
+
+  CDImageHasher::Hash mapped_hash, memory_hash;
+  timer.Reset();
+  ASSERT_TRUE(CDImageHasher::GetImageHash(mapped_image.get(), &mapped_hash));
+  const double mapped_hash_time = timer.GetTimeMilliseconds();
+  timer.Reset();
+  ASSERT_TRUE(CDImageHasher::GetImageHash(memory_image.get(), &memory_hash));
+  const double memory_hash_time = timer.GetTimeMilliseconds();
+
+  std::printf("open mapped: %.2f ms, open and preload: %.2f ms\n", mapped_open_time, preload_time);
+  std::printf("hash mapped: %.2f ms, hash preloaded: %.2f ms\n", mapped_hash_time, memory_hash_time);
+}
@@ -0,0 +1,75 @@
+#include "common-tests/disc_image_test_utils.h"
+#include "common/cd_image.h"
+#include "common/file_system.h"
+#include "common/timer.h"
+#include "core/game_list.h"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+static constexpr u32 IMAGE_COUNT = 200;
+static constexpr u32 IMAGE_SECTORS = 32;
+
+class GameListBenchmark : public DiscImageTest
+{
+protected:
+  void SetUp() override
+  {
+    m_directory = GetFilePath("game_list_benchmark");
+    m_cache_filename = testing::TempDir() + "game_list_benchmark.cache";
+    std::remove(m_cache_filename.c_str());
+    ASSERT_TRUE(FileSystem::CreateDirectory(m_directory.c_str(), false));
+
+    const std::vector<u8> data(CDImage::RAW_SECTOR_SIZE * IMAGE_SECTORS);
+    for (u32 i = 0; i < IMAGE_COUNT; i++)
+    {
+      char name[64];
+      std::snprintf(name, sizeof(name), "game_list_benchmark/game %03u.bin", i);
+      ASSERT_FALSE(WriteFile(name, data.data(), data.size()).empty());
+
+      char cue_sheet[128];
+      std::snprintf(cue_sheet, sizeof(cue_sheet),
+                    "FILE \"game %03u.bin\" BINARY\n  TRACK 01 MODE2/2352\n    INDEX 01 00:00:00\n", i);
+      std::snprintf(name, sizeof(name), "game_list_benchmark/game %03u.cue", i);
+      ASSERT_FALSE(WriteCueSheet(name, cue_sheet).empty());
+    }
+  }
+
+  void TearDown() override
+  {
+    DiscImageTest::TearDown();
+    FileSystem::DeleteDirectory(m_directory.c_str(), true);
+    std::remove(m_cache_filename.c_str());
+  }
+
+  size_t Refresh()
+  {
+    GameList list;
+    list.SetCacheFilename(m_cache_filename);
+    list.AddDirectory(m_directory, false);
+    list.Refresh(false, false);
+    return list.GetEntries().size();
+  }
+
+  std::string m_directory;
+  std::string m_cache_filename;
+};
+
+} // namespace
+
+// Compares scanning every image against loading the entries from the cache.
+TEST_F(GameListBenchmark, ColdAndWarmRefresh)
+{
+  Common::Timer timer;
+  ASSERT_EQ(Refresh(), IMAGE_COUNT);
+  const double cold_time = timer.GetTimeMilliseconds();
+
+  timer.Reset();
+  ASSERT_EQ(Refresh(), IMAGE_COUNT);
+  const double warm_time = timer.GetTimeMilliseconds();
+
+  std::printf("%u images, cold refresh: %.2f ms, warm refresh: %.2f ms\n", IMAGE_COUNT, cold_time, warm_time);
+}
@@ -0,0 +1,121 @@
+#include "common/timer.h"
+#include "core/gte.h"
+#include <array>
+#include <cstdio>
+#include <gtest/gtest.h>
+
+namespace {
+
+static constexpr u32 NUM_REGISTERS = 64;
+
+using RegisterState = std::array<u32, NUM_REGISTERS>;
+
+class Random
+{
+public:
+  explicit Random(u32 seed) : m_state(seed) {}
+
+  u32 Next()
+  {
+    m_state = m_state * 1664525u + 1013904223u;
+    return m_state >> 8;
+  }
+
+  u32 Next32() { return (Next() << 16) ^ Next(); }
+
+private:
+  u32 m_state;
+};
+
+struct Command
+{
+  const char* name;
+  u32 opcode;
+};
+
+static constexpr std::array<Command, 9> s_vector_commands = {{{"RTPS", 0x01},
+                                                               {"MVMVA", 0x12},
+                                                               {"NCDS", 0x13},
+                                                               {"NCDT", 0x16},
+                                                               {"NCCS", 0x1B},
+                                                               {"NCS", 0x1E},
+                                                               {"NCT", 0x20},
+                                                               {"RTPT", 0x30},
+                                                               {"NCCT", 0x3F}}};
+
+// Mostly small values so results land near the saturation boundaries, with some full-range ones to hit the overflows.
+static void RandomizeRegisters(Random& rng)
+{
+  for (u32 i = 0; i < NUM_REGISTERS; i++)
+  {
+    // skip SXYP, writes push the screen XY FIFO
+    if (i == 15)
+      continue;
+
+    u32 value;
+    switch (rng.Next() % 4)
+    {
+      case 0:
+        value = rng.Next32();
+        break;
+      case 1:
+        value = (rng.Next() & 0x1FFF) - 0x1000;
+        break;
+      default:
+        value = ((rng.Next() & 0x1FFF) - 0x1000) | (((rng.Next() & 0x1FFF) - 0x1000) << 16);
+        break;
+    }
+    GTE::WriteRegister(i, value);
+  }
+}
+
+static void SaveRegisters(RegisterState* state)
+{
+  for (u32 i = 0; i < NUM_REGISTERS; i++)
+    (*state)[i] = *GTE::GetRegisterPtr(i);
+}
+
+static void LoadRegisters(const RegisterState& state)
+{
+  for (u32 i = 0; i < NUM_REGISTERS; i++)
+    *GTE::GetRegisterPtr(i) = state[i];
+}
+
+} // namespace
+
+TEST(GTEBenchmark, KernelThroughput)
+{
+  static constexpr u32 NUM_OPS = 200000;
+
+  GTE::Initialize();
+
+  Random rng(2);
+  RandomizeRegisters(rng);
+  RegisterState input;
+  SaveRegisters(&input);
+
+  for (const Command& cmd : s_vector_commands)
+  {
+    // sf=1, lm=0, MVMVA as RT*V0+TR
+    const u32 inst_bits = cmd.opcode | (1u << 19);
+
+    double seconds[2] = {};
+    for (u32 vector = 0; vector < 2; vector++)
+    {
+      if (vector && !GTE::HasVectorKernels())
+        break;
+
+      const GTE::InstructionImpl impl = GTE::GetInstructionImpl(inst_bits, vector == 0);
+      LoadRegisters(input);
+
+      Common::Timer timer;
+      for (u32 i = 0; i < NUM_OPS; i++)
+        impl(GTE::Instruction{inst_bits});
+      seconds[vector] = timer.GetTimeSeconds();
+    }
+
+    std::printf("%-5s scalar: %.2f Mops/s, vector: %.2f Mops/s\n", cmd.name,
+                static_cast<double>(NUM_OPS) / seconds[0] / 1000000.0,
+                (seconds[1] > 0.0) ? (static_cast<double>(NUM_OPS) / seconds[1] / 1000000.0) : 0.0);
+  }
+}
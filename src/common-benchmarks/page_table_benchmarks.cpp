@@ -0,0 +1,68 @@
+#include "common/page_table.h"
+#include "common/timer.h"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <unordered_map>
+#include <vector>
+
+// Compares the cost of looking up code blocks by PC in a hash map (the old code cache) against the page table.
+TEST(PageTableBenchmark, Lookup)
+{
+  static constexpr u32 NUM_BLOCKS = 8192;
+  static constexpr u32 NUM_LOOKUPS = 8 * 1024 * 1024;
+  static constexpr u32 RAM_SIZE = 2 * 1024 * 1024;
+
+  std::vector<u32> block_pcs;
+  std::vector<u32> lookup_pcs;
+  block_pcs.reserve(NUM_BLOCKS);
+  lookup_pcs.reserve(NUM_LOOKUPS);
+
+  u32 seed = 0x12345678u;
+  auto rand = [&seed]() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+  };
+
+  std::unordered_map<u32, u32*> map;
+  PageTable<u32*, RAM_SIZE / 4096, 1024> table;
+  std::vector<u32> storage(NUM_BLOCKS);
+  for (u32 i = 0; i < NUM_BLOCKS; i++)
+  {
+    const u32 pc = 0x80000000u | ((rand() % RAM_SIZE) & ~3u);
+    block_pcs.push_back(pc);
+    map[pc] = &storage[i];
+    table.GetEntry((pc & (RAM_SIZE - 1)) / 4096, (pc & 4095) / 4) = &storage[i];
+  }
+
+  // Hot loops with occasional jumps elsewhere, roughly what a game does.
+  u32 current = 0;
+  for (u32 i = 0; i < NUM_LOOKUPS; i++)
+  {
+    if ((rand() & 15) == 0)
+      current = rand() % NUM_BLOCKS;
+    else
+      current = (current + 1) % std::min<u32>(NUM_BLOCKS, current + 8);
+    lookup_pcs.push_back(block_pcs[current]);
+  }
+
+  uintptr_t map_sum = 0;
+  Common::Timer map_timer;
+  for (const u32 pc : lookup_pcs)
+  {
+    auto iter = map.find(pc);
+    map_sum += (iter != map.end()) ? reinterpret_cast<uintptr_t>(iter->second) : 0;
+  }
+  const double map_time = map_timer.GetTimeNanoseconds();
+
+  uintptr_t table_sum = 0;
+  Common::Timer table_timer;
+  for (const u32 pc : lookup_pcs)
+    table_sum += reinterpret_cast<uintptr_t>(table.Lookup((pc & (RAM_SIZE - 1)) / 4096, (pc & 4095) / 4));
+  const double table_time = table_timer.GetTimeNanoseconds();
+
+  ASSERT_EQ(map_sum, table_sum);
+  std::printf("unordered_map: %.2f ns/lookup, page table: %.2f ns/lookup\n", map_time / NUM_LOOKUPS,
+              table_time / NUM_LOOKUPS);
+}
@@ -0,0 +1,59 @@
+#include "common/timer.h"
+#include "core/rewind_buffer.h"
+#include <algorithm>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+static constexpr u32 SNAPSHOT_SIZE = 4 * 1024 * 1024;
+static constexpr u32 SNAPSHOT_COUNT = 20;
+
+// Like consecutive states, mostly the same with a few scattered changes.
+static std::vector<u8> CreateSnapshot(u32 index, u32 size = SNAPSHOT_SIZE)
+{
+  std::vector<u8> snapshot(size);
+  for (u32 i = 0; i < size; i++)
+    snapshot[i] = static_cast<u8>((i * 7) ^ (i >> 11));
+
+  u32 seed = 0xBEEF0000u;
+  for (u32 i = 0; i <= index; i++)
+  {
+    for (u32 j = 0; j < 64; j++)
+    {
+      seed = seed * 1103515245u + 12345u;
+      snapshot[(seed >> 8) % size] = static_cast<u8>(seed >> 16);
+    }
+  }
+
+  return snapshot;
+}
+
+} // namespace
+
+TEST(RewindBufferBenchmark, EncodeAndRestore)
+{
+  RewindBuffer buffer;
+  buffer.SetMemoryBudget(UINT64_C(1) << 32);
+
+  for (u32 i = 0; i < SNAPSHOT_COUNT; i++)
+    buffer.PushSnapshot(CreateSnapshot(i));
+
+  Common::Timer timer;
+  buffer.Flush();
+  const double encode_time = timer.GetTimeMilliseconds();
+  const u64 memory_usage = buffer.GetMemoryUsage();
+
+  std::vector<u8> snapshot;
+  double worst_pop_time = 0.0;
+  for (u32 i = SNAPSHOT_COUNT; i > 0; i--)
+  {
+    timer.Reset();
+    ASSERT_TRUE(buffer.PopSnapshot(&snapshot));
+    worst_pop_time = std::max(worst_pop_time, timer.GetTimeMilliseconds());
+  }
+
+  std::printf("%u snapshots of %u bytes in %u bytes, remaining encode: %.2f ms, worst restore: %.2f ms\n",
+              SNAPSHOT_COUNT, SNAPSHOT_SIZE, static_cast<u32>(memory_usage), encode_time, worst_pop_time);
+}
@@ -0,0 +1,65 @@
+#include "common/byte_stream.h"
+#include "common/timer.h"
+#include "core/save_state_version.h"
+#include "core/system.h"
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace {
+
+static constexpr char MEDIA_FILENAME[] = "game.cue";
+static constexpr u32 DATA_SIZE = 4 * 1024 * 1024;
+
+// What SaveState() would write, with data that's a mix of noise and runs like RAM/VRAM tend to be.
+static std::vector<u8> CreateState()
+{
+  SAVE_STATE_HEADER header = {};
+  header.magic = SAVE_STATE_MAGIC;
+  header.version = SAVE_STATE_VERSION;
+  header.media_filename_length = sizeof(MEDIA_FILENAME) - 1;
+  header.offset_to_media_filename = sizeof(header);
+  header.data_compression_type = SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE;
+  header.data_uncompressed_size = DATA_SIZE;
+  header.offset_to_data = header.offset_to_media_filename + header.media_filename_length;
+
+  std::vector<u8> state(header.offset_to_data + DATA_SIZE);
+  std::memcpy(state.data(), &header, sizeof(header));
+  std::memcpy(&state[header.offset_to_media_filename], MEDIA_FILENAME, header.media_filename_length);
+
+  u32 seed = 0x12345678u;
+  u8* data = &state[header.offset_to_data];
+  for (u32 i = 0; i < DATA_SIZE; i++)
+  {
+    seed = seed * 1103515245u + 12345u;
+    if ((i & 0xFFFF) < 0x2000)
+      data[i] = static_cast<u8>(seed >> 16);
+    else if ((i & 0xFFFF) < 0x8000)
+      data[i] = static_cast<u8>(i >> 8);
+  }
+
+  return state;
+}
+
+} // namespace
+
+TEST(SaveStateBenchmark, CompressAndDecompress)
+{
+  const std::vector<u8> state = CreateState();
+
+  Common::Timer timer;
+  std::unique_ptr<GrowableMemoryByteStream> compressed = ByteStream_CreateGrowableMemoryStream();
+  ASSERT_TRUE(System::CompressSaveState(state.data(), static_cast<u32>(state.size()), compressed.get()));
+  const double compress_time = timer.GetTimeMilliseconds();
+
+  timer.Reset();
+  std::unique_ptr<GrowableMemoryByteStream> decompressed = ByteStream_CreateGrowableMemoryStream();
+  ASSERT_TRUE(System::DecompressSaveState(compressed->GetMemoryPointer(), static_cast<u32>(compressed->GetSize()),
+                                          decompressed.get()));
+  const double decompress_time = timer.GetTimeMilliseconds();
+
+  std::printf("%u -> %u bytes, compress: %.2f ms, decompress: %.2f ms\n", static_cast<u32>(state.size()),
+              static_cast<u32>(compressed->GetSize()), compress_time, decompress_time);
+}
@@ -0,0 +1,63 @@
+#include "common/timer.h"
+#include "core/cpu_core.h"
+#include "core/timing_event.h"
+#include <array>
+#include <cinttypes>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace {
+class TimingEventsBenchmark : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    CPU::g_state.pending_ticks = 0;
+    CPU::g_state.downcount = 0;
+    CPU::g_state.frame_done = false;
+    TimingEvents::Initialize();
+  }
+
+  void TearDown() override { TimingEvents::Shutdown(); }
+
+  static void RunTicks(TickCount ticks)
+  {
+    CPU::AddPendingTicks(ticks);
+    TimingEvents::RunEvents();
+  }
+};
+} // namespace
+
+TEST_F(TimingEventsBenchmark, RunEvents)
+{
+  // Roughly the mix of a running system: a few fast events, and some slow ones.
+  static constexpr std::array<TickCount, 8> intervals = {{2, 3, 8, 17, 64, 768, 2172, 33868}};
+  static constexpr u32 NUM_SLICES = 100000;
+  static constexpr TickCount SLICE_TICKS = 128;
+
+  u64 event_count = 0;
+  std::vector<std::unique_ptr<TimingEvent>> events;
+  for (const TickCount interval : intervals)
+  {
+    events.push_back(TimingEvents::CreateTimingEvent(
+      "Benchmark Event", interval, interval,
+      [](void* param, TickCount ticks, TickCount ticks_late) { (*static_cast<u64*>(param))++; }, &event_count, true));
+  }
+
+  Common::Timer timer;
+  for (u32 i = 0; i < NUM_SLICES; i++)
+  {
+    RunTicks(SLICE_TICKS);
+
+    // the CPU core would reschedule some events from I/O handlers
+    if ((i & 7) == 0)
+      events[2]->Schedule(5);
+  }
+  const double seconds = timer.GetTimeSeconds();
+
+  ASSERT_EQ(TimingEvents::GetGlobalTickCounter(), NUM_SLICES * static_cast<u32>(SLICE_TICKS));
+  std::printf("%" PRIu64 " events in %.3f ms, %.2f million events/sec\n", event_count, seconds * 1000.0,
+              static_cast<double>(event_count) / seconds / 1000000.0);
+}
@@ -0,0 +1,79 @@
+#include "core/bus.h"
+#include "core/cpu_core.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+static constexpr u32 RAM_TEST_OFFSET = 0x1000;
+static constexpr u32 KUSEG_BASE = 0x00000000u;
+static constexpr u32 KSEG0_BASE = 0x80000000u;
+static constexpr u32 KSEG1_BASE = 0xA0000000u;
+
+class BusFastmemTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_TRUE(Bus::Initialize());
+    Bus::UpdateFastmemViews(true, false);
+    m_base = Bus::GetFastmemBase();
+    if (!m_base)
+      GTEST_SKIP() << "fastmem is not supported on this host";
+  }
+
+  void TearDown() override { Bus::Shutdown(); }
+
+  u8* m_base = nullptr;
+};
+
+} // namespace
+
+TEST_F(BusFastmemTest, SegmentsMapRAM)
+{
+  Bus::g_ram[RAM_TEST_OFFSET] = 0x5A;
+  for (const u32 segment : {KUSEG_BASE, KSEG0_BASE, KSEG1_BASE})
+  {
+    for (u32 mirror = 0; mirror < Bus::RAM_MIRROR_END; mirror += Bus::RAM_SIZE)
+      ASSERT_EQ(m_base[segment | mirror | RAM_TEST_OFFSET], 0x5A) << std::hex << (segment | mirror);
+  }
+
+  m_base[KSEG1_BASE | RAM_TEST_OFFSET] = 0xA5;
+  EXPECT_EQ(Bus::g_ram[RAM_TEST_OFFSET], 0xA5);
+}
+
+TEST_F(BusFastmemTest, IsolatedCacheSwitchesRegion)
+{
+  Bus::g_ram[RAM_TEST_OFFSET] = 0x5A;
+
+  Bus::UpdateFastmemViews(true, true);
+  u8* isolated_base = Bus::GetFastmemBase();
+  ASSERT_NE(isolated_base, nullptr);
+  EXPECT_NE(isolated_base, m_base);
+
+  // loads still go straight to RAM, and the writable region is left alone
+  EXPECT_EQ(isolated_base[KSEG0_BASE | RAM_TEST_OFFSET], 0x5A);
+  EXPECT_EQ(isolated_base[KSEG1_BASE | RAM_TEST_OFFSET], 0x5A);
+  m_base[KSEG0_BASE | RAM_TEST_OFFSET] = 0x11;
+  EXPECT_EQ(isolated_base[KSEG0_BASE | RAM_TEST_OFFSET], 0x11);
+
+  Bus::UpdateFastmemViews(true, false);
+  EXPECT_EQ(Bus::GetFastmemBase(), m_base);
+}
+
+// The scratchpad is mapped with a whole host page, so the rest of the page is backed by unused memory rather than
+// raising a bus error. Only accesses through a register can reach it.
+TEST_F(BusFastmemTest, ScratchpadTailHitsUnusedPage)
+{
+  static constexpr u32 TAIL_ADDRESS = KSEG0_BASE | (CPU::DCACHE_LOCATION + CPU::DCACHE_SIZE);
+
+  Bus::g_scratchpad[0] = 0x33;
+  m_base[TAIL_ADDRESS] = 0x77;
+  EXPECT_EQ(m_base[TAIL_ADDRESS], 0x77);
+  EXPECT_EQ(m_base[KSEG0_BASE | CPU::DCACHE_LOCATION], 0x33);
+  EXPECT_EQ(Bus::g_scratchpad[0], 0x33);
+
+  EXPECT_TRUE(Bus::CanUseFastmemForAddress(KSEG0_BASE | CPU::DCACHE_LOCATION));
+  EXPECT_TRUE(Bus::CanUseFastmemForAddress(TAIL_ADDRESS - 4));
+  EXPECT_FALSE(Bus::CanUseFastmemForAddress(TAIL_ADDRESS));
+  EXPECT_FALSE(Bus::CanUseFastmemForAddress(KSEG1_BASE | CPU::DCACHE_LOCATION));
+}
@@ -0,0 +1,195 @@
+#include "common/cd_image.h"
+#include "common/cd_image_hasher.h"
+#include "disc_image_test_utils.h"
+#include <array>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+static constexpr u32 SECTOR_DATA_SIZE = CDImage::RAW_SECTOR_SIZE + 96;
+static constexpr u32 SECTORS_PER_HUNK = 8;
+static constexpr u32 HUNK_SIZE = SECTOR_DATA_SIZE * SECTORS_PER_HUNK;
+static constexpr u32 HUNK_COUNT = 16;
+static constexpr u32 IMAGE_SECTORS = HUNK_COUNT * SECTORS_PER_HUNK;
+
+// The loader assumes a two second pregap which isn't stored in the file.
+static constexpr CDImage::LBA DATA_START_LBA = 150;
+
+using Sector = std::array<u8, CDImage::RAW_SECTOR_SIZE>;
+
+static void PutBigEndian(std::vector<u8>& data, u32 offset, u64 value, u32 size)
+{
+  for (u32 i = 0; i < size; i++)
+    data[offset + i] = static_cast<u8>(value >> ((size - 1 - i) * 8));
+}
+
+class CDImageCHDTest : public DiscImageTest
+{
+protected:
+  static constexpr u8 SEED = 0x3C;
+
+  void SetUp() override
+  {
+    // start from an empty cache, the previous test may have used the same image
+    CDImage::SetCHDHunkCacheSize(0);
+    CDImage::SetCHDHunkCacheSize(DEFAULT_CACHE_SIZE);
+
+    m_image_path = WriteImage("cd_image_chd_test.chd", SEED);
+    ASSERT_FALSE(m_image_path.empty());
+  }
+
+  void TearDown() override
+  {
+    CDImage::SetCHDHunkCacheSize(DEFAULT_CACHE_SIZE);
+    DiscImageTest::TearDown();
+  }
+
+  // Writes an uncompressed v4 CHD with a single data track. Compressed images would need chdman, but the hunk
+  // handling is the same regardless of codec.
+  std::string WriteImage(const char* name, u8 seed)
+  {
+    static constexpr u32 HEADER_SIZE = 108;
+    static constexpr u32 MAP_ENTRY_SIZE = 16;
+    static constexpr u32 METADATA_OFFSET = HEADER_SIZE + (HUNK_COUNT + 1) * MAP_ENTRY_SIZE;
+
+    std::vector<u8> file((HUNK_COUNT + 1) * HUNK_SIZE);
+    std::memcpy(&file[0], "MComprHD", 8);
+    PutBigEndian(file, 8, HEADER_SIZE, 4);
+    PutBigEndian(file, 12, 4, 4); // version
+    PutBigEndian(file, 24, HUNK_COUNT, 4);
+    PutBigEndian(file, 28, static_cast<u64>(HUNK_COUNT) * HUNK_SIZE, 8);
+    PutBigEndian(file, 36, METADATA_OFFSET, 8);
+    PutBigEndian(file, 44, HUNK_SIZE, 4);
+    for (u32 i = 0; i < 20; i++)
+      file[48 + i] = static_cast<u8>(seed + i); // sha1, identifies the image in the hunk cache
+
+    // the map is terminated by a cookie rather than a count
+    std::memcpy(&file[HEADER_SIZE + HUNK_COUNT * MAP_ENTRY_SIZE], "EndOfListCookie", MAP_ENTRY_SIZE);
+
+    char metadata[256];
+    const int metadata_length =
+      std::snprintf(metadata, sizeof(metadata),
+                    "TRACK:1 TYPE:MODE2_RAW SUBTYPE:NONE FRAMES:%u PREGAP:0 PGTYPE:MODE1 PGSUB:RW POSTGAP:0",
+                    IMAGE_SECTORS) +
+      1;
+    PutBigEndian(file, METADATA_OFFSET, 0x43485432, 4); // CHT2
+    PutBigEndian(file, METADATA_OFFSET + 4, static_cast<u32>(metadata_length), 4);
+    std::memcpy(&file[METADATA_OFFSET + 16], metadata, metadata_length);
+
+    for (u32 hunk = 0; hunk < HUNK_COUNT; hunk++)
+    {
+      // uncompressed hunk without a crc
+      const u32 block = hunk + 1;
+      const u32 map_offset = HEADER_SIZE + hunk * MAP_ENTRY_SIZE;
+      PutBigEndian(file, map_offset, static_cast<u64>(block) * HUNK_SIZE, 8);
+      PutBigEndian(file, map_offset + 12, HUNK_SIZE & 0xFFFF, 2);
+      file[map_offset + 14] = static_cast<u8>(HUNK_SIZE >> 16);
+      file[map_offset + 15] = 0x12;
+      for (u32 i = 0; i < SECTORS_PER_HUNK; i++)
+      {
+        const u32 sector = hunk * SECTORS_PER_HUNK + i;
+        u8* sector_data = &file[block * HUNK_SIZE + i * SECTOR_DATA_SIZE];
+        for (u32 j = 0; j < CDImage::RAW_SECTOR_SIZE; j++)
+          sector_data[j] = GetExpectedByte(seed, sector, j);
+      }
+    }
+
+    return WriteFile(name, file.data(), file.size());
+  }
+
+  static void ExpectSector(CDImage* image, u8 seed, CDImage::LBA lba)
+  {
+    Sector sector;
+    ASSERT_TRUE(image->Seek(lba) && image->ReadRawSector(sector.data())) << "LBA " << lba;
+
+    const u32 sector_in_file = lba - DATA_START_LBA;
+    for (u32 j = 0; j < sector.size(); j++)
+      ASSERT_EQ(sector[j], GetExpectedByte(seed, sector_in_file, j)) << "LBA " << lba << " offset " << j;
+  }
+
+  static constexpr u32 DEFAULT_CACHE_SIZE = 16 * 1024 * 1024;
+
+  std::string m_image_path;
+};
+
+} // namespace
+
+TEST_F(CDImageCHDTest, SequentialReadsMatchImage)
+{
+  std::unique_ptr<CDImage> image = CDImage::Open(m_image_path.c_str());
+  ASSERT_TRUE(image);
+  ASSERT_EQ(image->GetLBACount(), DATA_START_LBA + IMAGE_SECTORS);
+
+  const CDImage::CHDHunkCacheStats start_stats = CDImage::GetCHDHunkCacheStats();
+  for (CDImage::LBA lba = DATA_START_LBA; lba < DATA_START_LBA + IMAGE_SECTORS; lba++)
+    ExpectSector(image.get(), SEED, lba);
+
+  image.reset();
+
+  // every hunk was decompressed either by the reader or the prefetch thread
+  const CDImage::CHDHunkCacheStats stats = CDImage::GetCHDHunkCacheStats();
+  EXPECT_GE((stats.misses - start_stats.misses) + (stats.prefetches - start_stats.prefetches), HUNK_COUNT);
+  EXPECT_EQ(stats.hunk_count, HUNK_COUNT);
+  EXPECT_EQ(stats.size, HUNK_COUNT * HUNK_SIZE);
+}
+
+TEST_F(CDImageCHDTest, RandomReadsMatchImage)
+{
+  // small enough that hunks are evicted and have to be decompressed again
+  CDImage::SetCHDHunkCacheSize(HUNK_SIZE * 5);
+
+  std::unique_ptr<CDImage> image = CDImage::Open(m_image_path.c_str());
+  ASSERT_TRUE(image);
+
+  u32 state = 1;
+  for (u32 i = 0; i < 500; i++)
+  {
+    state = state * 1664525u + 1013904223u;
+    const CDImage::LBA lba = DATA_START_LBA + ((state >> 8) % IMAGE_SECTORS);
+
+    // runs of sequential sectors start the prefetch thread
+    for (u32 j = 0; j < 4 && (lba + j) < (DATA_START_LBA + IMAGE_SECTORS); j++)
+      ExpectSector(image.get(), SEED, lba + j);
+
+    ASSERT_LE(CDImage::GetCHDHunkCacheStats().size, HUNK_SIZE * 5);
+  }
+}
+
+TEST_F(CDImageCHDTest, ReadsWithoutCache)
+{
+  CDImage::SetCHDHunkCacheSize(0);
+
+  std::unique_ptr<CDImage> image = CDImage::Open(m_image_path.c_str());
+  ASSERT_TRUE(image);
+  for (CDImage::LBA lba = DATA_START_LBA; lba < DATA_START_LBA + IMAGE_SECTORS; lba++)
+    ExpectSector(image.get(), SEED, lba);
+  for (CDImage::LBA lba = DATA_START_LBA + IMAGE_SECTORS - 1; lba >= DATA_START_LBA; lba--)
+    ExpectSector(image.get(), SEED, lba);
+
+  EXPECT_EQ(CDImage::GetCHDHunkCacheStats().hunk_count, 0u);
+}
+
+TEST_F(CDImageCHDTest, HasherReusesDecompressedHunks)
+{
+  std::unique_ptr<CDImage> running_image = CDImage::Open(m_image_path.c_str());
+  ASSERT_TRUE(running_image);
+  for (CDImage::LBA lba = DATA_START_LBA; lba < DATA_START_LBA + IMAGE_SECTORS; lba++)
+    ExpectSector(running_image.get(), SEED, lba);
+
+  // the game properties dialog opens its own copy of the image
+  const CDImage::CHDHunkCacheStats start_stats = CDImage::GetCHDHunkCacheStats();
+  std::unique_ptr<CDImage> hash_image = CDImage::Open(m_image_path.c_str());
+  ASSERT_TRUE(hash_image);
+
+  CDImageHasher::Hash hash;
+  ASSERT_TRUE(CDImageHasher::GetImageHash(hash_image.get(), &hash));
+
+  const CDImage::CHDHunkCacheStats stats = CDImage::GetCHDHunkCacheStats();
+  EXPECT_EQ(stats.misses, start_stats.misses);
+  EXPECT_EQ(stats.prefetches, start_stats.prefetches);
+  EXPECT_GE(stats.hits - start_stats.hits, HUNK_COUNT);
+}
@@ -0,0 +1,109 @@
+#include "common/cd_image.h"
+#include "common/cd_image_hasher.h"
+#include "common/md5_digest.h"
+#include "disc_image_test_utils.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+class CDImageHasherTest : public DiscImageTest
+{
+protected:
+  // Returns the MD5 of the track data written, which is what the hasher should come up with.
+  CDImageHasher::Hash WriteHashedTrack(const char* name, u8 seed, u32 sectors)
+  {
+    EXPECT_FALSE(WriteTrack(name, seed, sectors).empty());
+
+    MD5Digest digest;
+    std::vector<u8> sector(CDImage::RAW_SECTOR_SIZE);
+    for (u32 i = 0; i < sectors; i++)
+    {
+      for (u32 j = 0; j < CDImage::RAW_SECTOR_SIZE; j++)
+        sector[j] = GetExpectedByte(seed, i, j);
+      digest.Update(sector.data(), static_cast<u32>(sector.size()));
+    }
+
+    CDImageHasher::Hash hash;
+    digest.Final(hash.data());
+    return hash;
+  }
+
+  // Two data tracks, so there's no pregap which isn't in the files.
+  std::unique_ptr<CDImage> OpenMultiTrackImage(std::vector<CDImageHasher::Hash>* expected_hashes)
+  {
+    expected_hashes->push_back(WriteHashedTrack("cd_image_hasher_1.bin", 0x10, 500));
+    expected_hashes->push_back(WriteHashedTrack("cd_image_hasher_2.bin", 0x80, 300));
+    expected_hashes->push_back(WriteHashedTrack("cd_image_hasher_3.bin", 0xC4, 1));
+    const std::string path = WriteCueSheet("cd_image_hasher.cue", "FILE \"cd_image_hasher_1.bin\" BINARY\n"
+                                                                  "  TRACK 01 MODE2/2352\n"
+                                                                  "    INDEX 01 00:00:00\n"
+                                                                  "FILE \"cd_image_hasher_2.bin\" BINARY\n"
+                                                                  "  TRACK 02 MODE2/2352\n"
+                                                                  "    INDEX 01 00:00:00\n"
+                                                                  "FILE \"cd_image_hasher_3.bin\" BINARY\n"
+                                                                  "  TRACK 03 MODE2/2352\n"
+                                                                  "    INDEX 01 00:00:00\n");
+    return CDImage::Open(path.c_str());
+  }
+};
+
+} // namespace
+
+TEST_F(CDImageHasherTest, TrackHashesMatchTrackData)
+{
+  std::vector<CDImageHasher::Hash> expected_hashes;
+  std::unique_ptr<CDImage> image = OpenMultiTrackImage(&expected_hashes);
+  ASSERT_TRUE(image);
+  ASSERT_EQ(image->GetTrackCount(), 3u);
+
+  std::vector<CDImageHasher::Hash> hashes;
+  ASSERT_TRUE(CDImageHasher::GetTrackHashes(image.get(), &hashes));
+  EXPECT_EQ(hashes, expected_hashes);
+
+  for (u8 track = 1; track <= image->GetTrackCount(); track++)
+  {
+    CDImageHasher::Hash hash;
+    ASSERT_TRUE(CDImageHasher::GetTrackHash(image.get(), track, &hash));
+    EXPECT_EQ(hash, expected_hashes[track - 1]) << "track " << static_cast<u32>(track);
+  }
+}
+
+TEST_F(CDImageHasherTest, XXH128MatchesBetweenPaths)
+{
+  std::vector<CDImageHasher::Hash> expected_hashes;
+  std::unique_ptr<CDImage> image = OpenMultiTrackImage(&expected_hashes);
+  ASSERT_TRUE(image);
+
+  std::vector<CDImageHasher::Hash> hashes;
+  ASSERT_TRUE(CDImageHasher::GetTrackHashes(image.get(), &hashes, ProgressCallback::NullProgressCallback,
+                                            CDImageHasher::HashType::XXH128));
+  ASSERT_EQ(hashes.size(), expected_hashes.size());
+  EXPECT_NE(hashes[0], hashes[1]);
+
+  for (u8 track = 1; track <= image->GetTrackCount(); track++)
+  {
+    CDImageHasher::Hash hash;
+    ASSERT_TRUE(CDImageHasher::GetTrackHash(image.get(), track, &hash, ProgressCallback::NullProgressCallback,
+                                            CDImageHasher::HashType::XXH128));
+    EXPECT_EQ(hash, hashes[track - 1]);
+    EXPECT_NE(hash, expected_hashes[track - 1]);
+  }
+}
+
+TEST_F(CDImageHasherTest, HashStringRoundTrip)
+{
+  const CDImageHasher::Hash hash = {0x00, 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd,
+                                    0xef, 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc};
+  const std::string str = CDImageHasher::HashToString(hash);
+  EXPECT_EQ(str, "000123456789abcdef1032547698badc");
+
+  CDImageHasher::Hash parsed;
+  ASSERT_TRUE(CDImageHasher::HashFromString("000123456789ABCDEF1032547698BADC", &parsed));
+  EXPECT_EQ(parsed, hash);
+
+  EXPECT_FALSE(CDImageHasher::HashFromString("000123456789abcdef1032547698bad", &parsed));
+  EXPECT_FALSE(CDImageHasher::HashFromString("000123456789abcdef1032547698badx", &parsed));
+}
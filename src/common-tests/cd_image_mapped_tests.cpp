@@ -0,0 +1,132 @@
+#include "common/cd_image.h"
+#include "common/cd_image_hasher.h"
+#include "disc_image_test_utils.h"
+#include <array>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+namespace {
+
+// The loader adds a two second pregap in front of the first track which isn't stored in the file.
+static constexpr CDImage::LBA DATA_START_LBA = 150;
+
+using Sector = std::array<u8, CDImage::RAW_SECTOR_SIZE>;
+
+class CDImageMappedTest : public DiscImageTest
+{
+protected:
+  static void ExpectSectors(CDImage* image, CDImage::LBA start_lba, u32 count, u8 seed, u32 sector_size)
+  {
+    ASSERT_TRUE(image->Seek(start_lba));
+    for (u32 i = 0; i < count; i++)
+    {
+      Sector sector;
+      ASSERT_TRUE(image->ReadRawSector(sector.data())) << "LBA " << (start_lba + i);
+      for (u32 j = 0; j < sector_size; j++)
+        ASSERT_EQ(sector[j], GetExpectedByte(seed, i, j)) << "LBA " << (start_lba + i) << " offset " << j;
+    }
+  }
+};
+
+} // namespace
+
+TEST_F(CDImageMappedTest, BinSectorsMatchFile)
+{
+  static constexpr u32 SECTORS = 300;
+  const std::string path = WriteTrack("cd_image_mapped.bin", 0x21, SECTORS, CDImage::RAW_SECTOR_SIZE);
+  std::unique_ptr<CDImage> image = CDImage::Open(path.c_str());
+  ASSERT_TRUE(image);
+  ASSERT_EQ(image->GetLBACount(), SECTORS);
+
+  ExpectSectors(image.get(), DATA_START_LBA, SECTORS, 0x21, CDImage::RAW_SECTOR_SIZE);
+
+  // pointers go straight into the file
+  ASSERT_TRUE(image->Seek(DATA_START_LBA));
+  for (u32 i = 0; i < SECTORS; i++)
+  {
+    const u8* data = image->ReadRawSectorPointer();
+    ASSERT_NE(data, nullptr);
+    for (u32 j = 0; j < CDImage::RAW_SECTOR_SIZE; j++)
+      ASSERT_EQ(data[j], GetExpectedByte(0x21, i, j));
+  }
+  EXPECT_EQ(image->GetPositionOnDisc(), DATA_START_LBA + SECTORS);
+
+  // the lead-out isn't backed by the file, so it has to be read normally
+  ASSERT_TRUE(image->Seek(DATA_START_LBA + SECTORS));
+  EXPECT_EQ(image->ReadRawSectorPointer(), nullptr);
+  EXPECT_EQ(image->GetPositionOnDisc(), DATA_START_LBA + SECTORS);
+}
+
+TEST_F(CDImageMappedTest, CueSheetWithMultipleFiles)
+{
+  static constexpr u32 DATA_SECTORS = 200;
+  static constexpr u32 AUDIO_SECTORS = 120;
+  ASSERT_FALSE(WriteTrack("cd_image_mapped_data.bin", 0x42, DATA_SECTORS, CDImage::RAW_SECTOR_SIZE).empty());
+  ASSERT_FALSE(WriteTrack("cd_image_mapped_audio.bin", 0x99, AUDIO_SECTORS, CDImage::RAW_SECTOR_SIZE).empty());
+  const std::string path = WriteCueSheet("cd_image_mapped.cue", "FILE \"cd_image_mapped_data.bin\" BINARY\n"
+                                                                "  TRACK 01 MODE2/2352\n"
+                                                                "    INDEX 01 00:00:00\n"
+                                                                "FILE \"cd_image_mapped_audio.bin\" BINARY\n"
+                                                                "  TRACK 02 AUDIO\n"
+                                                                "    INDEX 01 00:00:00\n");
+
+  std::unique_ptr<CDImage> image = CDImage::Open(path.c_str());
+  ASSERT_TRUE(image);
+  ASSERT_EQ(image->GetTrackCount(), 2u);
+  ASSERT_EQ(image->GetTrackStartPosition(2), DATA_START_LBA + DATA_SECTORS);
+
+  ExpectSectors(image.get(), DATA_START_LBA, DATA_SECTORS, 0x42, CDImage::RAW_SECTOR_SIZE);
+  ExpectSectors(image.get(), image->GetTrackStartPosition(2), AUDIO_SECTORS, 0x99, CDImage::RAW_SECTOR_SIZE);
+
+  // jumping back and forth between files
+  for (u32 i = 0; i < 20; i++)
+  {
+    const u32 sector = (i * 37) % AUDIO_SECTORS;
+    ASSERT_TRUE(image->Seek(DATA_START_LBA + sector));
+    const u8* data = image->ReadRawSectorPointer();
+    ASSERT_NE(data, nullptr);
+    ASSERT_EQ(data[100], GetExpectedByte(0x42, sector, 100));
+
+    ASSERT_TRUE(image->Seek(image->GetTrackStartPosition(2) + sector));
+    data = image->ReadRawSectorPointer();
+    ASSERT_NE(data, nullptr);
+    ASSERT_EQ(data[100], GetExpectedByte(0x99, sector, 100));
+  }
+}
+
+TEST_F(CDImageMappedTest, CookedSectorsAreCopied)
+{
+  static constexpr u32 SECTORS = 64;
+  ASSERT_FALSE(WriteTrack("cd_image_mapped.iso", 0x17, SECTORS, CDImage::DATA_SECTOR_SIZE).empty());
+  const std::string path = WriteCueSheet("cd_image_mapped_iso.cue", "FILE \"cd_image_mapped.iso\" BINARY\n"
+                                                                    "  TRACK 01 MODE1/2048\n"
+                                                                    "    INDEX 01 00:00:00\n");
+
+  std::unique_ptr<CDImage> image = CDImage::Open(path.c_str());
+  ASSERT_TRUE(image);
+  ExpectSectors(image.get(), DATA_START_LBA, SECTORS, 0x17, CDImage::DATA_SECTOR_SIZE);
+
+  // not raw sectors, so there's nothing to point at
+  ASSERT_TRUE(image->Seek(DATA_START_LBA));
+  EXPECT_EQ(image->ReadRawSectorPointer(), nullptr);
+}
+
+TEST_F(CDImageMappedTest, MatchesPreloadedImage)
+{
+  static constexpr u32 SECTORS = 1000;
+  const std::string path = WriteTrack("cd_image_mapped_large.bin", 0x5A, SECTORS, CDImage::RAW_SECTOR_SIZE);
+  ASSERT_FALSE(path.empty());
+
+  std::unique_ptr<CDImage> mapped_image = CDImage::Open(path.c_str());
+  ASSERT_TRUE(mapped_image);
+  std::unique_ptr<CDImage> source_image = CDImage::Open(path.c_str());
+  ASSERT_TRUE(source_image);
+  std::unique_ptr<CDImage> memory_image = CDImage::CreateMemoryImage(source_image.get());
+  ASSERT_TRUE(memory_image);
+
+  CDImageHasher::Hash mapped_hash, memory_hash;
+  ASSERT_TRUE(CDImageHasher::GetImageHash(mapped_image.get(), &mapped_hash));
+  ASSERT_TRUE(CDImageHasher::GetImageHash(memory_image.get(), &memory_hash));
+  EXPECT_EQ(mapped_hash, memory_hash);
+}
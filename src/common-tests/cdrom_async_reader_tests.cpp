@@ -0,0 +1,132 @@
+#include "core/cdrom_async_reader.h"
+#include "disc_image_test_utils.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+namespace {
+
+static constexpr u32 IMAGE_SECTORS = 64;
+
+// First LBA backed by the file, the BIN loader adds a two second pregap.
+static constexpr CDImage::LBA DATA_START_LBA = 150;
+
+class CDROMAsyncReaderTest : public DiscImageTest
+{
+protected:
+  void SetUp() override
+  {
+    m_image_path = WriteTrack("cdrom_async_reader_a.bin", 0x11, IMAGE_SECTORS);
+    m_other_image_path = WriteTrack("cdrom_async_reader_b.bin", 0x77, IMAGE_SECTORS);
+    ASSERT_FALSE(m_image_path.empty());
+    ASSERT_FALSE(m_other_image_path.empty());
+  }
+
+  static void ReadReference(const std::string& path, CDImage::LBA lba, CDROMAsyncReader::SectorBuffer* data)
+  {
+    std::unique_ptr<CDImage> image = CDImage::Open(path.c_str());
+    ASSERT_TRUE(image && image->Seek(lba) && image->ReadRawSector(data->data()));
+  }
+
+  static void ExpectSector(CDROMAsyncReader& reader, const std::string& path, CDImage::LBA lba)
+  {
+    CDROMAsyncReader::SectorBuffer expected;
+    ReadReference(path, lba, &expected);
+
+    ASSERT_TRUE(reader.WaitForReadToComplete());
+    ASSERT_EQ(reader.GetLastReadSector(), lba);
+    ASSERT_EQ(reader.GetSectorBuffer(), expected) << "LBA " << lba;
+  }
+
+  std::string m_image_path;
+  std::string m_other_image_path;
+};
+
+} // namespace
+
+TEST_F(CDROMAsyncReaderTest, SequentialReadsMatchImage)
+{
+  for (const bool use_thread : {false, true})
+  {
+    CDROMAsyncReader reader;
+    reader.SetReadaheadSectors(8);
+    if (use_thread)
+      reader.StartThread();
+    reader.SetMedia(CDImage::Open(m_image_path.c_str()));
+
+    for (CDImage::LBA lba = DATA_START_LBA; lba < DATA_START_LBA + IMAGE_SECTORS; lba++)
+    {
+      reader.QueueReadSector(lba);
+      ExpectSector(reader, m_image_path, lba);
+    }
+
+    const CDROMAsyncReader::Stats& stats = reader.GetStats();
+    EXPECT_EQ(stats.hits + stats.misses, IMAGE_SECTORS);
+    reader.StopThread();
+  }
+}
+
+TEST_F(CDROMAsyncReaderTest, RandomSeeksMatchImage)
+{
+  CDROMAsyncReader reader;
+  reader.SetReadaheadSectors(4);
+  reader.StartThread();
+  reader.SetMedia(CDImage::Open(m_image_path.c_str()));
+
+  u32 state = 1;
+  for (u32 i = 0; i < 200; i++)
+  {
+    state = state * 1664525u + 1013904223u;
+    const CDImage::LBA lba = DATA_START_LBA + ((state >> 8) % IMAGE_SECTORS);
+
+    // queue a few without waiting, only the last one should be returned
+    reader.QueueReadSector(lba ^ 1);
+    reader.QueueReadSector(lba);
+    ExpectSector(reader, m_image_path, lba);
+  }
+}
+
+TEST_F(CDROMAsyncReaderTest, RecentSectorsAreCached)
+{
+  CDROMAsyncReader reader;
+  reader.SetReadaheadSectors(8);
+  reader.StartThread();
+  reader.SetMedia(CDImage::Open(m_image_path.c_str()));
+
+  for (CDImage::LBA lba = DATA_START_LBA; lba < DATA_START_LBA + 10; lba++)
+  {
+    reader.QueueReadSector(lba);
+    ExpectSector(reader, m_image_path, lba);
+  }
+
+  reader.ResetStats();
+  reader.QueueReadSector(DATA_START_LBA + 3);
+  ExpectSector(reader, m_image_path, DATA_START_LBA + 3);
+  EXPECT_EQ(reader.GetStats().hits, 1u);
+  EXPECT_EQ(reader.GetStats().misses, 0u);
+  EXPECT_EQ(reader.GetStats().stalls, 0u);
+}
+
+TEST_F(CDROMAsyncReaderTest, SetMediaInvalidatesCache)
+{
+  CDROMAsyncReader reader;
+  reader.SetReadaheadSectors(8);
+  reader.StartThread();
+  reader.SetMedia(CDImage::Open(m_image_path.c_str()));
+
+  reader.QueueReadSector(DATA_START_LBA);
+  ExpectSector(reader, m_image_path, DATA_START_LBA);
+
+  std::unique_ptr<CDImage> old_media = reader.RemoveMedia();
+  ASSERT_TRUE(old_media);
+  ASSERT_FALSE(reader.HasMedia());
+
+  reader.SetMedia(CDImage::Open(m_other_image_path.c_str()));
+  reader.ResetStats();
+  for (CDImage::LBA lba = DATA_START_LBA; lba < DATA_START_LBA + 4; lba++)
+  {
+    reader.QueueReadSector(lba);
+    ExpectSector(reader, m_other_image_path, lba);
+  }
+  EXPECT_GE(reader.GetStats().misses, 1u);
+}
@@ -0,0 +1,183 @@
+#include "core/cpu_block_analysis.h"
+#include <gtest/gtest.h>
+#include <initializer_list>
+#include <vector>
+
+using namespace CPU;
+
+static constexpr u32 BLOCK_PC = 0x80010000u;
+
+static u32 EncodeI(InstructionOp op, Reg rs, Reg rt, u16 imm)
+{
+  return (static_cast<u32>(op) << 26) | (static_cast<u32>(rs) << 21) | (static_cast<u32>(rt) << 16) | imm;
+}
+
+static u32 EncodeR(InstructionFunct funct, Reg rs, Reg rt, Reg rd, u32 shamt = 0)
+{
+  return (static_cast<u32>(rs) << 21) | (static_cast<u32>(rt) << 16) | (static_cast<u32>(rd) << 11) | (shamt << 6) |
+         static_cast<u32>(funct);
+}
+
+static std::vector<CodeBlockInstruction> MakeBlock(std::initializer_list<u32> words)
+{
+  std::vector<CodeBlockInstruction> block;
+  u32 pc = BLOCK_PC;
+  for (const u32 bits : words)
+  {
+    CodeBlockInstruction cbi = {};
+    cbi.instruction.bits = bits;
+    cbi.pc = pc;
+    cbi.can_trap = CanInstructionTrap(cbi.instruction, false);
+    block.push_back(cbi);
+    pc += sizeof(u32);
+  }
+
+  return block;
+}
+
+static std::vector<InstructionAnalysis> Analyze(const std::vector<CodeBlockInstruction>& block,
+                                                bool memory_exceptions = false)
+{
+  std::vector<InstructionAnalysis> analysis;
+  AnalyzeBlockInstructions(block.data(), block.data() + block.size(), memory_exceptions, &analysis);
+  return analysis;
+}
+
+static bool IsDead(const InstructionAnalysis& ia, Reg reg)
+{
+  return (ia.dead_registers & GetRegisterMask(reg)) != 0;
+}
+
+TEST(CPUBlockAnalysis, LuiOriAddressIsKnown)
+{
+  const auto block = MakeBlock({EncodeI(InstructionOp::lui, Reg::zero, Reg::t0, 0x8001),
+                                EncodeI(InstructionOp::ori, Reg::t0, Reg::t0, 0x2000),
+                                EncodeI(InstructionOp::lw, Reg::t0, Reg::t1, 0xFFF0),
+                                EncodeI(InstructionOp::sh, Reg::t0, Reg::t1, 0x0010)});
+  const auto analysis = Analyze(block);
+  ASSERT_EQ(analysis.size(), block.size());
+  ASSERT_FALSE(analysis[0].has_known_address);
+  ASSERT_FALSE(analysis[1].has_known_address);
+  ASSERT_TRUE(analysis[2].has_known_address);
+  ASSERT_EQ(analysis[2].known_address, 0x80011FF0u);
+  ASSERT_TRUE(analysis[3].has_known_address);
+  ASSERT_EQ(analysis[3].known_address, 0x80012010u);
+}
+
+TEST(CPUBlockAnalysis, ConstantsFoldThroughALUInstructions)
+{
+  const auto block = MakeBlock({EncodeI(InstructionOp::lui, Reg::zero, Reg::t0, 0x1F80),
+                                EncodeI(InstructionOp::addiu, Reg::zero, Reg::t1, 0x0100),
+                                EncodeR(InstructionFunct::sll, Reg::zero, Reg::t1, Reg::t1, 2),
+                                EncodeR(InstructionFunct::or_, Reg::t0, Reg::t1, Reg::t2),
+                                EncodeI(InstructionOp::lbu, Reg::t2, Reg::t3, 0x0003)});
+  const auto analysis = Analyze(block);
+  ASSERT_TRUE(analysis[4].has_known_address);
+  ASSERT_EQ(analysis[4].known_address, 0x1F800403u);
+}
+
+TEST(CPUBlockAnalysis, LoadedValuesAreNotKnown)
+{
+  // the delay slot still sees the old value, but it's forgotten as soon as the load issues
+  const auto block = MakeBlock({EncodeI(InstructionOp::lui, Reg::zero, Reg::t0, 0x8001),
+                                EncodeI(InstructionOp::lw, Reg::t0, Reg::t0, 0x0000),
+                                EncodeI(InstructionOp::lw, Reg::t0, Reg::t1, 0x0000),
+                                EncodeI(InstructionOp::lw, Reg::t0, Reg::t2, 0x0000)});
+  const auto analysis = Analyze(block);
+  ASSERT_TRUE(analysis[1].has_known_address);
+  ASSERT_FALSE(analysis[2].has_known_address);
+  ASSERT_FALSE(analysis[3].has_known_address);
+}
+
+TEST(CPUBlockAnalysis, OverflowingAddIsNotKnown)
+{
+  const auto block = MakeBlock({EncodeI(InstructionOp::lui, Reg::zero, Reg::t0, 0x7FFF),
+                                EncodeI(InstructionOp::ori, Reg::t0, Reg::t0, 0xFFFF),
+                                EncodeI(InstructionOp::addi, Reg::t0, Reg::t0, 0x0001),
+                                EncodeI(InstructionOp::lw, Reg::t0, Reg::t1, 0x0000)});
+  const auto analysis = Analyze(block);
+  ASSERT_FALSE(analysis[3].has_known_address);
+}
+
+TEST(CPUBlockAnalysis, UnknownInstructionForgetsConstants)
+{
+  const auto block = MakeBlock({EncodeI(InstructionOp::lui, Reg::zero, Reg::t0, 0x8001),
+                                EncodeI(InstructionOp::cop1, Reg::zero, Reg::t0, 0x0000),
+                                EncodeI(InstructionOp::lw, Reg::t0, Reg::t1, 0x0000)});
+  const auto analysis = Analyze(block);
+  ASSERT_FALSE(analysis[2].has_known_address);
+}
+
+TEST(CPUBlockAnalysis, OverwrittenRegisterIsDead)
+{
+  const auto block = MakeBlock({EncodeI(InstructionOp::addiu, Reg::zero, Reg::t0, 0x0001),
+                                EncodeI(InstructionOp::addiu, Reg::t1, Reg::t1, 0x0001),
+                                EncodeI(InstructionOp::addiu, Reg::zero, Reg::t0, 0x0002),
+                                EncodeI(InstructionOp::sw, Reg::sp, Reg::t0, 0x0000)});
+  const auto analysis = Analyze(block);
+  ASSERT_TRUE(IsDead(analysis[0], Reg::t0));
+  ASSERT_TRUE(IsDead(analysis[1], Reg::t0));
+  ASSERT_FALSE(IsDead(analysis[2], Reg::t0));
+  ASSERT_FALSE(IsDead(analysis[3], Reg::t0));
+
+  // everything is live at the end of the block
+  for (const InstructionAnalysis& ia : analysis)
+  {
+    ASSERT_FALSE(IsDead(ia, Reg::zero));
+    ASSERT_FALSE(IsDead(ia, Reg::t1));
+    ASSERT_FALSE(IsDead(ia, Reg::sp));
+  }
+}
+
+TEST(CPUBlockAnalysis, ReadRegisterIsLive)
+{
+  const auto block = MakeBlock({EncodeI(InstructionOp::addiu, Reg::zero, Reg::t0, 0x0001),
+                                EncodeR(InstructionFunct::addu, Reg::t0, Reg::t0, Reg::t1),
+                                EncodeI(InstructionOp::addiu, Reg::zero, Reg::t0, 0x0002)});
+  const auto analysis = Analyze(block);
+  ASSERT_FALSE(IsDead(analysis[0], Reg::t0));
+  ASSERT_FALSE(IsDead(analysis[1], Reg::t0));
+}
+
+TEST(CPUBlockAnalysis, LoadDoesNotKillRegister)
+{
+  // a later load to the same register could cancel the first one, so the old value has to stay around
+  const auto block = MakeBlock({EncodeI(InstructionOp::addiu, Reg::zero, Reg::t0, 0x0001),
+                                EncodeI(InstructionOp::lw, Reg::sp, Reg::t0, 0x0000)});
+  const auto analysis = Analyze(block);
+  ASSERT_FALSE(IsDead(analysis[0], Reg::t0));
+}
+
+TEST(CPUBlockAnalysis, TrappingInstructionKeepsRegistersLive)
+{
+  const auto block = MakeBlock({EncodeI(InstructionOp::addiu, Reg::zero, Reg::t0, 0x0001),
+                                EncodeI(InstructionOp::addi, Reg::t1, Reg::t1, 0x0001),
+                                EncodeI(InstructionOp::addiu, Reg::zero, Reg::t0, 0x0002)});
+  const auto analysis = Analyze(block);
+  ASSERT_FALSE(IsDead(analysis[0], Reg::t0));
+  ASSERT_FALSE(IsDead(analysis[1], Reg::t0));
+}
+
+TEST(CPUBlockAnalysis, MemoryExceptionsKeepRegistersLive)
+{
+  const auto block = MakeBlock({EncodeI(InstructionOp::addiu, Reg::zero, Reg::t0, 0x0001),
+                                EncodeI(InstructionOp::lw, Reg::sp, Reg::t1, 0x0000),
+                                EncodeI(InstructionOp::addiu, Reg::zero, Reg::t0, 0x0002)});
+  ASSERT_TRUE(IsDead(Analyze(block, false)[0], Reg::t0));
+  ASSERT_FALSE(IsDead(Analyze(block, true)[0], Reg::t0));
+}
+
+TEST(CPUBlockAnalysis, HiLoLiveness)
+{
+  const auto block = MakeBlock({EncodeR(InstructionFunct::mult, Reg::t0, Reg::t1, Reg::zero),
+                                EncodeR(InstructionFunct::mflo, Reg::zero, Reg::zero, Reg::t2),
+                                EncodeR(InstructionFunct::mthi, Reg::t3, Reg::zero, Reg::zero),
+                                EncodeR(InstructionFunct::mtlo, Reg::t3, Reg::zero, Reg::zero)});
+  const auto analysis = Analyze(block);
+  ASSERT_TRUE(IsDead(analysis[0], Reg::hi));
+  ASSERT_FALSE(IsDead(analysis[0], Reg::lo));
+  ASSERT_FALSE(IsDead(analysis[1], Reg::lo));
+  ASSERT_FALSE(IsDead(analysis[2], Reg::hi));
+  ASSERT_TRUE(IsDead(analysis[2], Reg::lo));
+  ASSERT_FALSE(IsDead(analysis[3], Reg::lo));
+}
@@ -0,0 +1,141 @@
+#include "core/bus.h"
+#include "core/cpu_code_cache.h"
+#include "core/cpu_core.h"
+#include "core/settings.h"
+#include "core/timing_event.h"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+
+#ifdef WITH_RECOMPILER
+
+using namespace CPU;
+
+namespace {
+
+static constexpr u32 LOOP_PC = 0x80010000u;
+static constexpr u32 LOOP_RAM_OFFSET = LOOP_PC & Bus::RAM_MASK;
+
+class CodeCacheTieringTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    g_settings.cpu_execution_mode = CPUExecutionMode::Recompiler;
+    g_settings.cpu_recompiler_tiering = true;
+    g_settings.cpu_recompiler_icache = false;
+    g_settings.cpu_recompiler_memory_exceptions = false;
+    g_settings.gpu_pgxp_enable = false;
+
+    TimingEvents::Initialize();
+    CPU::Initialize();
+    ASSERT_TRUE(Bus::Initialize());
+    CodeCache::Initialize(true, false);
+    CPU::Reset();
+    Bus::Reset();
+
+    // Ends each slice after a handful of instructions, so the loop only runs a few times per call to Run().
+    m_stop_event = TimingEvents::CreateTimingEvent(
+      "Stop", 8, 8, [](void*, TickCount, TickCount) { g_state.frame_done = true; }, nullptr, true);
+
+    // loop: addiu t0, t0, 1; addiu t1, zero, 1; bne t0, t2, loop; nop
+    WriteLoop(1);
+    g_state.regs.t2 = UINT32_C(0xFFFFFFFF);
+    g_state.regs.pc = LOOP_PC;
+    g_state.regs.npc = LOOP_PC + 4;
+  }
+
+  void TearDown() override
+  {
+    m_stop_event.reset();
+    CodeCache::Shutdown();
+    Bus::Shutdown();
+    CPU::Shutdown();
+    TimingEvents::Shutdown();
+  }
+
+  void WriteLoop(u16 t1_value)
+  {
+    const u32 code[] = {0x25080001u, 0x24090000u | t1_value, 0x150AFFFDu, 0x00000000u};
+    std::memcpy(&Bus::g_ram[LOOP_RAM_OFFSET], code, sizeof(code));
+  }
+
+  // Changes the code the way a store from the CPU would.
+  void ModifyLoop(u16 t1_value)
+  {
+    WriteLoop(t1_value);
+    CodeCache::InvalidateBlocksWithPageIndex(LOOP_RAM_OFFSET / CPU_CODE_CACHE_PAGE_SIZE);
+  }
+
+  u32 GetExecutionCount() const { return g_state.regs.t0; }
+
+  void Run() { CodeCache::ExecuteRecompiler(); }
+
+  void RunUntilExecutionCount(u32 count)
+  {
+    while (GetExecutionCount() < count)
+      Run();
+  }
+
+  std::unique_ptr<TimingEvent> m_stop_event;
+};
+
+} // namespace
+
+TEST_F(CodeCacheTieringTest, HotBlocksAreCompiled)
+{
+  u32 interpreted_checks = 0;
+  while (GetExecutionCount() < (CodeCache::RECOMPILER_TIER_UP_EXECUTION_COUNT - 1))
+  {
+    Run();
+    if (GetExecutionCount() >= CodeCache::RECOMPILER_TIER_UP_EXECUTION_COUNT)
+      break;
+
+    const CodeCache::Stats stats = CodeCache::GetStats();
+    EXPECT_EQ(stats.interpreted_blocks, 1u);
+    EXPECT_EQ(stats.recompiled_blocks, 0u);
+    EXPECT_EQ(stats.host_compile_count, 0u);
+    interpreted_checks++;
+  }
+  ASSERT_GT(interpreted_checks, 0u);
+
+  RunUntilExecutionCount(CodeCache::RECOMPILER_TIER_UP_EXECUTION_COUNT);
+  const CodeCache::Stats stats = CodeCache::GetStats();
+  EXPECT_EQ(stats.interpreted_blocks, 0u);
+  EXPECT_EQ(stats.recompiled_blocks, 1u);
+  EXPECT_EQ(stats.demoted_blocks, 0u);
+  EXPECT_EQ(stats.host_compile_count, 1u);
+
+  // once compiled, it stays compiled
+  RunUntilExecutionCount(GetExecutionCount() + CodeCache::RECOMPILER_TIER_UP_EXECUTION_COUNT * 4);
+  EXPECT_EQ(CodeCache::GetStats().host_compile_count, 1u);
+  EXPECT_EQ(g_state.regs.t1, 1u);
+}
+
+TEST_F(CodeCacheTieringTest, ChangingBlocksAreDemoted)
+{
+  for (u32 i = 0; i < CodeCache::RECOMPILER_DEMOTE_RECOMPILE_COUNT; i++)
+  {
+    RunUntilExecutionCount(GetExecutionCount() + CodeCache::RECOMPILER_TIER_UP_EXECUTION_COUNT);
+    const CodeCache::Stats stats = CodeCache::GetStats();
+    EXPECT_EQ(stats.recompiled_blocks, 1u);
+    EXPECT_EQ(stats.host_compile_count, i + 1);
+    EXPECT_EQ(stats.code_change_count, i);
+
+    ModifyLoop(static_cast<u16>(i + 2));
+  }
+
+  // the last change is picked up on the next execution, which demotes the block instead of compiling it again
+  RunUntilExecutionCount(GetExecutionCount() + CodeCache::RECOMPILER_TIER_UP_EXECUTION_COUNT * 4);
+  const CodeCache::Stats stats = CodeCache::GetStats();
+  EXPECT_EQ(stats.interpreted_blocks, 0u);
+  EXPECT_EQ(stats.recompiled_blocks, 0u);
+  EXPECT_EQ(stats.demoted_blocks, 1u);
+  EXPECT_EQ(stats.host_compile_count, CodeCache::RECOMPILER_DEMOTE_RECOMPILE_COUNT);
+  EXPECT_EQ(stats.code_change_count, CodeCache::RECOMPILER_DEMOTE_RECOMPILE_COUNT);
+
+  // demoted blocks still see code changes
+  EXPECT_EQ(g_state.regs.t1, CodeCache::RECOMPILER_DEMOTE_RECOMPILE_COUNT + 1);
+}
+
+#endif
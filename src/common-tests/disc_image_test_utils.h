@@ -0,0 +1,66 @@
+#pragma once
+#include "common/cd_image.h"
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+// Base fixture for tests which write disc images to the temporary directory. Files are named relative to it, and
+// everything written is removed when the test finishes.
+class DiscImageTest : public testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    for (const std::string& path : m_files)
+      std::remove(path.c_str());
+    m_files.clear();
+  }
+
+  // Every byte of a sector is derived from its position in the track, so misplaced reads are obvious.
+  static u8 GetExpectedByte(u8 seed, u32 sector, u32 offset) { return static_cast<u8>(seed + sector * 7 + offset); }
+
+  static std::string GetFilePath(const char* name) { return testing::TempDir() + name; }
+
+  // Returns the path written, or an empty string if the file couldn't be created.
+  std::string WriteFile(const char* name, const void* data, size_t size)
+  {
+    const std::string path = GetFilePath(name);
+    std::FILE* fp = std::fopen(path.c_str(), "wb");
+    if (!fp)
+      return {};
+
+    std::fwrite(data, size, 1, fp);
+    std::fclose(fp);
+    m_files.push_back(path);
+    return path;
+  }
+
+  std::string WriteTrack(const char* name, u8 seed, u32 sectors, u32 sector_size = CDImage::RAW_SECTOR_SIZE)
+  {
+    const std::string path = GetFilePath(name);
+    std::FILE* fp = std::fopen(path.c_str(), "wb");
+    if (!fp)
+      return {};
+
+    std::vector<u8> sector(sector_size);
+    for (u32 i = 0; i < sectors; i++)
+    {
+      for (u32 j = 0; j < sector_size; j++)
+        sector[j] = GetExpectedByte(seed, i, j);
+      std::fwrite(sector.data(), sector.size(), 1, fp);
+    }
+
+    std::fclose(fp);
+    m_files.push_back(path);
+    return path;
+  }
+
+  std::string WriteCueSheet(const char* name, const char* contents)
+  {
+    return WriteFile(name, contents, std::strlen(contents));
+  }
+
+  std::vector<std::string> m_files;
+};
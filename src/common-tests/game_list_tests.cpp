@@ -0,0 +1,246 @@
+#include "common/cd_image.h"
+#include "common/file_system.h"
+#include "common/md5_digest.h"
+#include "core/game_list.h"
+#include "disc_image_test_utils.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+static constexpr u32 IMAGE_COUNT = 40;
+static constexpr u32 IMAGE_SECTORS = 32;
+
+class GameListTest : public DiscImageTest
+{
+protected:
+  void SetUp() override
+  {
+    m_directory = GetFilePath("game_list_test");
+    m_cache_filename = testing::TempDir() + "game_list_test.cache";
+    FileSystem::DeleteDirectory(m_directory.c_str(), true);
+    std::remove(m_cache_filename.c_str());
+    ASSERT_TRUE(FileSystem::CreateDirectory(m_directory.c_str(), false));
+
+    for (u32 i = 0; i < IMAGE_COUNT; i++)
+      ASSERT_TRUE(WriteImage(i));
+  }
+
+  void TearDown() override
+  {
+    // DeleteDirectory() isn't implemented everywhere, so the images are removed by the fixture first
+    DiscImageTest::TearDown();
+    FileSystem::DeleteDirectory(m_directory.c_str(), true);
+    std::remove(m_cache_filename.c_str());
+  }
+
+  static std::string GetImageName(u32 index, const char* extension)
+  {
+    char name[64];
+    std::snprintf(name, sizeof(name), "game_list_test/game %02u.%s", index, extension);
+    return name;
+  }
+
+  static std::string GetImagePath(u32 index, const char* extension)
+  {
+    return GetFilePath(GetImageName(index, extension).c_str());
+  }
+
+  // Blank data tracks, which don't have a game code so they're listed by file name.
+  bool WriteImage(u32 index)
+  {
+    const std::vector<u8> data(CDImage::RAW_SECTOR_SIZE * IMAGE_SECTORS);
+    if (WriteFile(GetImageName(index, "bin").c_str(), data.data(), data.size()).empty())
+      return false;
+
+    char cue_sheet[128];
+    std::snprintf(cue_sheet, sizeof(cue_sheet),
+                  "FILE \"game %02u.bin\" BINARY\n  TRACK 01 MODE2/2352\n    INDEX 01 00:00:00\n", index);
+    return !WriteCueSheet(GetImageName(index, "cue").c_str(), cue_sheet).empty();
+  }
+
+  // Just enough of an ISO9660 filesystem for SYSTEM.CNF to be found, so the disc has a game code. Returns the MD5 of
+  // the track, as listed in redump.
+  CDImageHasher::Hash WriteDisc(const char* name, const char* boot_filename, u8 seed)
+  {
+    static constexpr u32 DATA_OFFSET = 24;
+    static constexpr u32 PVD_LBA = 16;
+    static constexpr u32 ROOT_LBA = 18;
+    static constexpr u32 SYSTEM_CNF_LBA = 19;
+
+    std::vector<u8> data(CDImage::RAW_SECTOR_SIZE * IMAGE_SECTORS);
+    const auto sector_data = [&data](u32 lba) { return &data[lba * CDImage::RAW_SECTOR_SIZE + DATA_OFFSET]; };
+    const auto write_directory_entry = [](u8* de, u32 lba, u32 size, u8 flags, const char* filename) {
+      const u8 filename_length = static_cast<u8>(std::max<size_t>(std::strlen(filename), 1));
+      de[0] = static_cast<u8>((33 + filename_length + 1) & ~1);
+      std::memcpy(&de[2], &lba, sizeof(lba));
+      std::memcpy(&de[10], &size, sizeof(size));
+      de[25] = flags;
+      de[32] = filename_length;
+      std::memcpy(&de[33], filename, std::strlen(filename));
+      return de[0];
+    };
+
+    char system_cnf[64];
+    std::snprintf(system_cnf, sizeof(system_cnf), "BOOT = cdrom:\\%s;1\r\n", boot_filename);
+    const u32 system_cnf_size = static_cast<u32>(std::strlen(system_cnf));
+
+    u8* pvd = sector_data(PVD_LBA);
+    pvd[0] = 1;
+    std::memcpy(&pvd[1], "CD001", 5);
+    pvd[6] = 1;
+    write_directory_entry(&pvd[156], ROOT_LBA, 2048, 2, "");
+
+    u8* root = sector_data(ROOT_LBA);
+    root += write_directory_entry(root, ROOT_LBA, 2048, 2, "");
+    write_directory_entry(root, SYSTEM_CNF_LBA, system_cnf_size, 0, "SYSTEM.CNF;1");
+    std::memcpy(sector_data(SYSTEM_CNF_LBA), system_cnf, system_cnf_size);
+
+    // different contents for each disc
+    sector_data(IMAGE_SECTORS - 1)[0] = seed;
+
+    const std::string bin_name = std::string("game_list_test/") + name + ".bin";
+    const std::string cue_name = std::string("game_list_test/") + name + ".cue";
+    EXPECT_FALSE(WriteFile(bin_name.c_str(), data.data(), data.size()).empty());
+
+    char cue_sheet[128];
+    std::snprintf(cue_sheet, sizeof(cue_sheet),
+                  "FILE \"%s.bin\" BINARY\n  TRACK 01 MODE2/2352\n    INDEX 01 00:00:00\n", name);
+    EXPECT_FALSE(WriteCueSheet(cue_name.c_str(), cue_sheet).empty());
+
+    MD5Digest digest;
+    digest.Update(data.data(), static_cast<u32>(data.size()));
+    CDImageHasher::Hash hash;
+    digest.Final(hash.data());
+    return hash;
+  }
+
+  std::vector<std::string> Refresh(bool invalidate_cache = false)
+  {
+    GameList list;
+    list.SetCacheFilename(m_cache_filename);
+    list.AddDirectory(m_directory, false);
+    list.Refresh(invalidate_cache, false);
+
+    // directory order isn't defined, so compare sorted
+    std::vector<std::string> titles;
+    for (const GameListEntry& entry : list.GetEntries())
+      titles.push_back(entry.title);
+    std::sort(titles.begin(), titles.end());
+    return titles;
+  }
+
+  std::string m_directory;
+  std::string m_cache_filename;
+};
+
+} // namespace
+
+TEST_F(GameListTest, ScannedEntriesAreCached)
+{
+  const std::vector<std::string> titles = Refresh();
+  ASSERT_EQ(titles.size(), IMAGE_COUNT);
+  ASSERT_TRUE(FileSystem::FileExists(m_cache_filename.c_str()));
+
+  // without the data the images can't be opened, so these can only come from the cache
+  for (u32 i = 0; i < IMAGE_COUNT; i++)
+    ASSERT_TRUE(FileSystem::DeleteFile(GetImagePath(i, "bin").c_str()));
+
+  EXPECT_EQ(Refresh(), titles);
+  EXPECT_TRUE(Refresh(true).empty());
+}
+
+TEST_F(GameListTest, ChangedFilesAreRescanned)
+{
+  const std::vector<std::string> titles = Refresh();
+  ASSERT_EQ(titles.size(), IMAGE_COUNT);
+
+  // the modification time might not change within a test, but the size does
+  ASSERT_TRUE(FileSystem::DeleteFile(GetImagePath(3, "bin").c_str()));
+  std::FILE* fp = std::fopen(GetImagePath(3, "cue").c_str(), "ab");
+  ASSERT_TRUE(fp);
+  std::fputs("REM changed\n", fp);
+  std::fclose(fp);
+
+  std::vector<std::string> expected_titles = titles;
+  expected_titles.erase(std::find(expected_titles.begin(), expected_titles.end(), "game 03"));
+  EXPECT_EQ(Refresh(), expected_titles);
+
+  // the stale entry was dropped from the cache too
+  ASSERT_TRUE(WriteImage(3));
+  ASSERT_TRUE(FileSystem::DeleteFile(GetImagePath(3, "bin").c_str()));
+  EXPECT_EQ(Refresh(), expected_titles);
+}
+
+TEST_F(GameListTest, CorruptedCacheIsReplaced)
+{
+  std::FILE* fp = std::fopen(m_cache_filename.c_str(), "wb");
+  ASSERT_TRUE(fp);
+  std::fputs("GLCE not really a cache", fp);
+  std::fclose(fp);
+
+  const std::vector<std::string> titles = Refresh();
+  ASSERT_EQ(titles.size(), IMAGE_COUNT);
+  EXPECT_EQ(Refresh(), titles);
+}
+
+TEST_F(GameListTest, EntriesAreVerifiedAgainstDatabase)
+{
+  const CDImageHasher::Hash good_hash = WriteDisc("good", "SLUS_000.01", 1);
+  const CDImageHasher::Hash bad_hash = WriteDisc("bad", "SLUS_000.02", 2);
+  WriteDisc("unknown", "SLUS_000.03", 3);
+  ASSERT_NE(good_hash, bad_hash);
+
+  // the bad dump is listed with the good dump's hash, and the unknown dump isn't listed at all
+  const std::string good_hash_str = CDImageHasher::HashToString(good_hash);
+  const std::string database_filename = testing::TempDir() + "game_list_test.dat";
+  std::FILE* fp = std::fopen(database_filename.c_str(), "wb");
+  ASSERT_TRUE(fp);
+  std::fprintf(fp,
+               "<?xml version=\"1.0\"?>\n<datafile>\n"
+               "  <game name=\"Good Game\">\n    <serial>SLUS-00001</serial>\n"
+               "    <rom name=\"Good Game.cue\" md5=\"00000000000000000000000000000000\"/>\n"
+               "    <rom name=\"Good Game.bin\" md5=\"%s\"/>\n  </game>\n"
+               "  <game name=\"Bad Game\">\n    <serial>SLUS-00002</serial>\n"
+               "    <rom name=\"Bad Game.bin\" md5=\"%s\"/>\n  </game>\n"
+               "</datafile>\n",
+               good_hash_str.c_str(), good_hash_str.c_str());
+  std::fclose(fp);
+
+  GameList list;
+  list.SetDatabaseFilename(database_filename);
+  list.AddDirectory(m_directory, false);
+  list.Refresh(false, false);
+
+  const std::vector<GameListVerificationResult> results = list.VerifyEntries();
+  ASSERT_EQ(results.size(), list.GetEntryCount());
+  std::remove(database_filename.c_str());
+
+  // compared by name, so failures are readable
+  std::map<std::string, std::string> results_by_code;
+  u32 uncoded_count = 0;
+  for (u32 i = 0; i < list.GetEntryCount(); i++)
+  {
+    const GameListEntry& entry = list.GetEntries()[i];
+    if (entry.code.empty())
+    {
+      // the blank images have no game code, so there's nothing to look up
+      EXPECT_EQ(results[i], GameListVerificationResult::NotInDatabase)
+        << GameList::VerificationResultToString(results[i]);
+      uncoded_count++;
+      continue;
+    }
+
+    results_by_code.emplace(entry.code, GameList::VerificationResultToString(results[i]));
+  }
+
+  EXPECT_EQ(uncoded_count, IMAGE_COUNT);
+  const std::map<std::string, std::string> expected_results = {
+    {"SLUS-00001", "Verified"}, {"SLUS-00002", "Mismatch"}, {"SLUS-00003", "NotInDatabase"}};
+  EXPECT_EQ(results_by_code, expected_results);
+}
@@ -0,0 +1,160 @@
+#include "core/gpu_sw_span.h"
+#include <array>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace SWSpan;
+
+namespace {
+
+static constexpr u32 IMAGE_WIDTH = 64;
+static constexpr u32 IMAGE_HEIGHT = 16;
+
+using Image = std::vector<u16>;
+
+class Random
+{
+public:
+  explicit Random(u32 seed) : m_state(seed) {}
+
+  u32 Next()
+  {
+    m_state = m_state * 1664525u + 1013904223u;
+    return m_state >> 8;
+  }
+
+private:
+  u32 m_state;
+};
+
+struct SpanCase
+{
+  u32 x, y;
+  SpanPixels pixels;
+};
+
+// Spans at every dither phase, with a mix of transparent, opaque and zero texels, and partial coverage.
+static std::vector<SpanCase> GenerateSpans(u32 seed)
+{
+  Random rng(seed);
+  std::vector<SpanCase> spans;
+  for (u32 y = 0; y < IMAGE_HEIGHT; y++)
+  {
+    for (u32 x = (y % 3); (x + SPAN_WIDTH) <= IMAGE_WIDTH; x += 5)
+    {
+      SpanCase sc = {};
+      sc.x = x;
+      sc.y = y;
+      sc.pixels.coverage = ((rng.Next() % 4) == 0) ? static_cast<u8>(rng.Next()) : 0xFF;
+      for (u32 i = 0; i < SPAN_WIDTH; i++)
+      {
+        const u32 kind = rng.Next() % 8;
+        sc.pixels.texels[i] = (kind == 0) ? 0 : static_cast<u16>(rng.Next());
+        sc.pixels.r[i] = static_cast<u8>(rng.Next());
+        sc.pixels.g[i] = static_cast<u8>(rng.Next());
+        sc.pixels.b[i] = static_cast<u8>(rng.Next());
+      }
+      spans.push_back(sc);
+    }
+  }
+  return spans;
+}
+
+static Image GenerateBackground(u32 seed)
+{
+  Random rng(seed);
+  Image image(IMAGE_WIDTH * IMAGE_HEIGHT);
+  for (u16& pixel : image)
+    pixel = static_cast<u16>(rng.Next());
+  return image;
+}
+
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+static void CompareSpanPaths(u32 seed)
+{
+  static constexpr std::array<GPU::TransparencyMode, 5> transparency_modes = {
+    {GPU::TransparencyMode::HalfBackgroundPlusHalfForeground, GPU::TransparencyMode::BackgroundPlusForeground,
+     GPU::TransparencyMode::BackgroundMinusForeground, GPU::TransparencyMode::BackgroundPlusQuarterForeground,
+     GPU::TransparencyMode::Disabled}};
+  static constexpr std::array<std::pair<u16, u16>, 3> mask_modes = {{{0, 0}, {0, 0x8000}, {0x8000, 0}}};
+
+  const std::vector<SpanCase> spans = GenerateSpans(seed);
+  const Image background = GenerateBackground(seed ^ 0x5A5A5A5Au);
+
+  for (const GPU::TransparencyMode transparency_mode : transparency_modes)
+  {
+    for (const auto& [mask_and, mask_or] : mask_modes)
+    {
+      const PixelState ps{mask_and, mask_or, transparency_mode};
+      Image scalar_image = background;
+      Image vector_image = background;
+
+      for (const SpanCase& sc : spans)
+      {
+        const u32 offset = sc.y * IMAGE_WIDTH + sc.x;
+        ShadeSpanScalar<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+          ps, &scalar_image[offset], sc.x, sc.y, sc.pixels, SPAN_WIDTH);
+        ShadeSpan<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+          ps, &vector_image[offset], sc.x, sc.y, sc.pixels);
+      }
+
+      for (u32 i = 0; i < scalar_image.size(); i++)
+      {
+        ASSERT_EQ(scalar_image[i], vector_image[i])
+          << "pixel " << (i % IMAGE_WIDTH) << "," << (i / IMAGE_WIDTH) << " transparency mode "
+          << static_cast<u32>(transparency_mode) << " mask " << mask_and << "/" << mask_or;
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST(GPUSWSpan, UntexturedMatchesScalar)
+{
+  CompareSpanPaths<false, false, false, false>(1);
+  CompareSpanPaths<false, false, false, true>(2);
+  CompareSpanPaths<false, false, true, false>(3);
+  CompareSpanPaths<false, false, true, true>(4);
+}
+
+TEST(GPUSWSpan, TexturedMatchesScalar)
+{
+  CompareSpanPaths<true, false, false, false>(5);
+  CompareSpanPaths<true, false, false, true>(6);
+  CompareSpanPaths<true, false, true, false>(7);
+  CompareSpanPaths<true, false, true, true>(8);
+}
+
+TEST(GPUSWSpan, RawTexturedMatchesScalar)
+{
+  CompareSpanPaths<true, true, false, false>(9);
+  CompareSpanPaths<true, true, true, false>(10);
+}
+
+TEST(GPUSWSpan, UncoveredPixelsAreUnchanged)
+{
+  const Image background = GenerateBackground(11);
+  Image image = background;
+
+  SpanPixels pixels = {};
+  for (u32 i = 0; i < SPAN_WIDTH; i++)
+  {
+    pixels.texels[i] = 0x7FFF;
+    pixels.r[i] = pixels.g[i] = pixels.b[i] = 0xFF;
+  }
+  pixels.coverage = 0x55;
+
+  const PixelState ps{0, 0, GPU::TransparencyMode::Disabled};
+  ShadeSpan<true, false, false, false>(ps, &image[0], 0, 0, pixels);
+
+  for (u32 i = 0; i < SPAN_WIDTH; i++)
+  {
+    if (pixels.coverage & (1u << i))
+      ASSERT_NE(image[i], background[i]);
+    else
+      ASSERT_EQ(image[i], background[i]);
+  }
+  for (u32 i = SPAN_WIDTH; i < image.size(); i++)
+    ASSERT_EQ(image[i], background[i]);
+}
@@ -0,0 +1,124 @@
+#include "core/gte.h"
+#include <array>
+#include <gtest/gtest.h>
+
+namespace {
+
+static constexpr u32 NUM_REGISTERS = 64;
+
+using RegisterState = std::array<u32, NUM_REGISTERS>;
+
+class Random
+{
+public:
+  explicit Random(u32 seed) : m_state(seed) {}
+
+  u32 Next()
+  {
+    m_state = m_state * 1664525u + 1013904223u;
+    return m_state >> 8;
+  }
+
+  u32 Next32() { return (Next() << 16) ^ Next(); }
+
+private:
+  u32 m_state;
+};
+
+struct Command
+{
+  const char* name;
+  u32 opcode;
+};
+
+static constexpr std::array<Command, 9> s_vector_commands = {{{"RTPS", 0x01},
+                                                               {"MVMVA", 0x12},
+                                                               {"NCDS", 0x13},
+                                                               {"NCDT", 0x16},
+                                                               {"NCCS", 0x1B},
+                                                               {"NCS", 0x1E},
+                                                               {"NCT", 0x20},
+                                                               {"RTPT", 0x30},
+                                                               {"NCCT", 0x3F}}};
+
+// Mostly small values so results land near the saturation boundaries, with some full-range ones to hit the overflows.
+static void RandomizeRegisters(Random& rng)
+{
+  for (u32 i = 0; i < NUM_REGISTERS; i++)
+  {
+    // skip SXYP, writes push the screen XY FIFO
+    if (i == 15)
+      continue;
+
+    u32 value;
+    switch (rng.Next() % 4)
+    {
+      case 0:
+        value = rng.Next32();
+        break;
+      case 1:
+        value = (rng.Next() & 0x1FFF) - 0x1000;
+        break;
+      default:
+        value = ((rng.Next() & 0x1FFF) - 0x1000) | (((rng.Next() & 0x1FFF) - 0x1000) << 16);
+        break;
+    }
+    GTE::WriteRegister(i, value);
+  }
+}
+
+static void SaveRegisters(RegisterState* state)
+{
+  for (u32 i = 0; i < NUM_REGISTERS; i++)
+    (*state)[i] = *GTE::GetRegisterPtr(i);
+}
+
+static void LoadRegisters(const RegisterState& state)
+{
+  for (u32 i = 0; i < NUM_REGISTERS; i++)
+    *GTE::GetRegisterPtr(i) = state[i];
+}
+
+static u32 MakeInstruction(u32 opcode, Random& rng)
+{
+  // sf (bit 19), MVMVA operands (bits 13-18) and lm (bit 10)
+  return opcode | (rng.Next() & ((1u << 19) | (0x3Fu << 13) | (1u << 10)));
+}
+
+} // namespace
+
+TEST(GTE, VectorKernelsMatchScalar)
+{
+  if (!GTE::HasVectorKernels())
+    GTEST_SKIP() << "vector kernels are not supported on this CPU";
+
+  static constexpr u32 NUM_ITERATIONS = 20000;
+
+  GTE::Initialize();
+
+  Random rng(1);
+  for (const Command& cmd : s_vector_commands)
+  {
+    for (u32 iteration = 0; iteration < NUM_ITERATIONS; iteration++)
+    {
+      RandomizeRegisters(rng);
+      const u32 inst_bits = MakeInstruction(cmd.opcode, rng);
+
+      RegisterState input, scalar_output, vector_output;
+      SaveRegisters(&input);
+
+      GTE::GetInstructionImpl(inst_bits, true)(GTE::Instruction{inst_bits});
+      SaveRegisters(&scalar_output);
+
+      LoadRegisters(input);
+      GTE::GetInstructionImpl(inst_bits, false)(GTE::Instruction{inst_bits});
+      SaveRegisters(&vector_output);
+
+      for (u32 i = 0; i < NUM_REGISTERS; i++)
+      {
+        ASSERT_EQ(scalar_output[i], vector_output[i])
+          << cmd.name << " instruction " << std::hex << inst_bits << " register " << std::dec << i;
+      }
+    }
+  }
+}
@@ -0,0 +1,94 @@
+#include "common/page_table.h"
+#include <gtest/gtest.h>
+#include <unordered_map>
+#include <vector>
+
+using TestTable = PageTable<u32*, 512, 1024>;
+
+TEST(PageTable, LookupWithoutPageReturnsDefault)
+{
+  TestTable t;
+  ASSERT_EQ(t.Lookup(0, 0), nullptr);
+  ASSERT_EQ(t.Lookup(511, 1023), nullptr);
+  ASSERT_EQ(t.GetAllocatedPageCount(), 0u);
+}
+
+TEST(PageTable, GetEntryAllocatesPage)
+{
+  TestTable t;
+  u32 value = 0;
+  t.GetEntry(3, 7) = &value;
+  ASSERT_EQ(t.GetAllocatedPageCount(), 1u);
+  ASSERT_EQ(t.Lookup(3, 7), &value);
+  ASSERT_EQ(t.Lookup(3, 6), nullptr);
+  ASSERT_EQ(t.GetPage(2), nullptr);
+  ASSERT_NE(t.GetPage(3), nullptr);
+}
+
+TEST(PageTable, ClearEntryKeepsPage)
+{
+  TestTable t;
+  u32 value = 0;
+  t.GetEntry(10, 0) = &value;
+  t.ClearEntry(10, 0);
+  t.ClearEntry(11, 0);
+  ASSERT_EQ(t.Lookup(10, 0), nullptr);
+  ASSERT_EQ(t.GetAllocatedPageCount(), 1u);
+}
+
+TEST(PageTable, EnumerateAndClear)
+{
+  TestTable t;
+  u32 values[3] = {};
+  t.GetEntry(1, 1) = &values[0];
+  t.GetEntry(100, 2) = &values[1];
+  t.GetEntry(100, 3) = &values[2];
+
+  u32 pages = 0, entries = 0;
+  t.EnumeratePages([&pages, &entries](u32 page_index, TestTable::Page& page) {
+    pages++;
+    for (u32* entry : page)
+      entries += (entry != nullptr) ? 1 : 0;
+  });
+  ASSERT_EQ(pages, 2u);
+  ASSERT_EQ(entries, 3u);
+
+  t.Clear();
+  ASSERT_EQ(t.GetAllocatedPageCount(), 0u);
+  ASSERT_EQ(t.Lookup(100, 2), nullptr);
+}
+
+TEST(PageTable, LookupMatchesHashMap)
+{
+  static constexpr u32 NUM_BLOCKS = 1024;
+  static constexpr u32 NUM_LOOKUPS = 16 * 1024;
+  static constexpr u32 RAM_SIZE = 2 * 1024 * 1024;
+
+  u32 seed = 0x12345678u;
+  auto rand = [&seed]() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+  };
+
+  std::unordered_map<u32, u32*> map;
+  PageTable<u32*, RAM_SIZE / 4096, 1024> table;
+  std::vector<u32> storage(NUM_BLOCKS);
+  for (u32 i = 0; i < NUM_BLOCKS; i++)
+  {
+    const u32 pc = (rand() % RAM_SIZE) & ~3u;
+    map[pc] = &storage[i];
+    table.GetEntry(pc / 4096, (pc & 4095) / 4) = &storage[i];
+  }
+
+  // Mostly misses, so both present and absent entries are compared.
+  for (u32 i = 0; i < NUM_LOOKUPS; i++)
+  {
+    const u32 pc = (rand() % RAM_SIZE) & ~3u;
+    auto iter = map.find(pc);
+    ASSERT_EQ(table.Lookup(pc / 4096, (pc & 4095) / 4), (iter != map.end()) ? iter->second : nullptr);
+  }
+  for (const auto& it : map)
+    ASSERT_EQ(table.Lookup(it.first / 4096, (it.first & 4095) / 4), it.second);
+}
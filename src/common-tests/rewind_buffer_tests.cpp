@@ -0,0 +1,105 @@
+#include "core/rewind_buffer.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+static constexpr u32 SNAPSHOT_SIZE = 256 * 1024;
+static constexpr u32 SNAPSHOT_COUNT = 20;
+
+// Like consecutive states, mostly the same with a few scattered changes.
+static std::vector<u8> CreateSnapshot(u32 index, u32 size = SNAPSHOT_SIZE)
+{
+  std::vector<u8> snapshot(size);
+  for (u32 i = 0; i < size; i++)
+    snapshot[i] = static_cast<u8>((i * 7) ^ (i >> 11));
+
+  u32 seed = 0xBEEF0000u;
+  for (u32 i = 0; i <= index; i++)
+  {
+    for (u32 j = 0; j < 64; j++)
+    {
+      seed = seed * 1103515245u + 12345u;
+      snapshot[(seed >> 8) % size] = static_cast<u8>(seed >> 16);
+    }
+  }
+
+  return snapshot;
+}
+
+} // namespace
+
+TEST(RewindBuffer, SnapshotsAreRestoredNewestFirst)
+{
+  RewindBuffer buffer;
+  buffer.SetMemoryBudget(UINT64_C(1) << 32);
+
+  for (u32 i = 0; i < SNAPSHOT_COUNT; i++)
+    buffer.PushSnapshot(CreateSnapshot(i));
+  EXPECT_EQ(buffer.GetSnapshotCount(), SNAPSHOT_COUNT);
+
+  buffer.Flush();
+
+  // the deltas should be tiny next to the full snapshots
+  const u64 memory_usage = buffer.GetMemoryUsage();
+  EXPECT_LT(memory_usage, static_cast<u64>(SNAPSHOT_SIZE) * 2);
+
+  std::vector<u8> snapshot;
+  for (u32 i = SNAPSHOT_COUNT; i > 0; i--)
+  {
+    ASSERT_TRUE(buffer.PopSnapshot(&snapshot));
+    ASSERT_TRUE(snapshot == CreateSnapshot(i - 1)) << "snapshot " << (i - 1);
+  }
+
+  // the oldest snapshot stays
+  EXPECT_EQ(buffer.GetSnapshotCount(), 1u);
+  ASSERT_TRUE(buffer.PopSnapshot(&snapshot));
+  EXPECT_TRUE(snapshot == CreateSnapshot(0));
+
+  buffer.Clear();
+  EXPECT_EQ(buffer.GetSnapshotCount(), 0u);
+  EXPECT_FALSE(buffer.PopSnapshot(&snapshot));
+}
+
+TEST(RewindBuffer, OldestSnapshotsAreDroppedOverBudget)
+{
+  RewindBuffer buffer;
+  buffer.SetMemoryBudget(UINT64_C(1) << 32);
+  for (u32 i = 0; i < SNAPSHOT_COUNT; i++)
+    buffer.PushSnapshot(CreateSnapshot(i));
+  ASSERT_EQ(buffer.GetSnapshotCount(), SNAPSHOT_COUNT);
+
+  // just the newest snapshot and a few deltas
+  buffer.SetMemoryBudget(buffer.GetMemoryUsage() - 1);
+  const u32 count = buffer.GetSnapshotCount();
+  EXPECT_LT(count, SNAPSHOT_COUNT);
+  EXPECT_GT(count, 1u);
+
+  std::vector<u8> snapshot;
+  for (u32 i = 0; i < count; i++)
+  {
+    ASSERT_TRUE(buffer.PopSnapshot(&snapshot));
+    ASSERT_TRUE(snapshot == CreateSnapshot(SNAPSHOT_COUNT - 1 - i));
+  }
+
+  // can't go back past the oldest kept snapshot
+  ASSERT_TRUE(buffer.PopSnapshot(&snapshot));
+  EXPECT_TRUE(snapshot == CreateSnapshot(SNAPSHOT_COUNT - count));
+}
+
+TEST(RewindBuffer, SnapshotSizeCanChange)
+{
+  RewindBuffer buffer;
+  buffer.SetMemoryBudget(UINT64_C(1) << 32);
+  buffer.PushSnapshot(CreateSnapshot(0, SNAPSHOT_SIZE + 100));
+  buffer.PushSnapshot(CreateSnapshot(1, SNAPSHOT_SIZE));
+  buffer.PushSnapshot(CreateSnapshot(2, SNAPSHOT_SIZE + 50));
+
+  std::vector<u8> snapshot;
+  ASSERT_TRUE(buffer.PopSnapshot(&snapshot));
+  EXPECT_TRUE(snapshot == CreateSnapshot(2, SNAPSHOT_SIZE + 50));
+  ASSERT_TRUE(buffer.PopSnapshot(&snapshot));
+  EXPECT_TRUE(snapshot == CreateSnapshot(1, SNAPSHOT_SIZE));
+  ASSERT_TRUE(buffer.PopSnapshot(&snapshot));
+  EXPECT_TRUE(snapshot == CreateSnapshot(0, SNAPSHOT_SIZE + 100));
+}
@@ -0,0 +1,111 @@
+#include "common/byte_stream.h"
+#include "core/save_state_version.h"
+#include "core/system.h"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace {
+
+static constexpr char MEDIA_FILENAME[] = "game.cue";
+static constexpr u32 DATA_SIZE = 1024 * 1024;
+
+// What SaveState() would write, with data that's a mix of noise and runs like RAM/VRAM tend to be.
+static std::vector<u8> CreateState()
+{
+  SAVE_STATE_HEADER header = {};
+  header.magic = SAVE_STATE_MAGIC;
+  header.version = SAVE_STATE_VERSION;
+  header.media_filename_length = sizeof(MEDIA_FILENAME) - 1;
+  header.offset_to_media_filename = sizeof(header);
+  header.data_compression_type = SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE;
+  header.data_uncompressed_size = DATA_SIZE;
+  header.offset_to_data = header.offset_to_media_filename + header.media_filename_length;
+
+  std::vector<u8> state(header.offset_to_data + DATA_SIZE);
+  std::memcpy(state.data(), &header, sizeof(header));
+  std::memcpy(&state[header.offset_to_media_filename], MEDIA_FILENAME, header.media_filename_length);
+
+  u32 seed = 0x12345678u;
+  u8* data = &state[header.offset_to_data];
+  for (u32 i = 0; i < DATA_SIZE; i++)
+  {
+    seed = seed * 1103515245u + 12345u;
+    if ((i & 0xFFFF) < 0x2000)
+      data[i] = static_cast<u8>(seed >> 16);
+    else if ((i & 0xFFFF) < 0x8000)
+      data[i] = static_cast<u8>(i >> 8);
+  }
+
+  return state;
+}
+
+static SAVE_STATE_HEADER GetHeader(const GrowableMemoryByteStream* stream)
+{
+  SAVE_STATE_HEADER header;
+  std::memcpy(&header, stream->GetMemoryPointer(), sizeof(header));
+  return header;
+}
+
+} // namespace
+
+TEST(SaveState, CompressedStateRoundTrips)
+{
+  const std::vector<u8> state = CreateState();
+
+  std::unique_ptr<GrowableMemoryByteStream> compressed = ByteStream_CreateGrowableMemoryStream();
+  ASSERT_TRUE(System::CompressSaveState(state.data(), static_cast<u32>(state.size()), compressed.get()));
+
+  const SAVE_STATE_HEADER header = GetHeader(compressed.get());
+  EXPECT_EQ(header.data_compression_type, SAVE_STATE_HEADER::COMPRESSION_TYPE_ZLIB);
+  EXPECT_EQ(header.data_uncompressed_size, DATA_SIZE);
+  EXPECT_EQ(compressed->GetSize(), header.offset_to_data + header.data_compressed_size);
+  EXPECT_LT(compressed->GetSize(), state.size() / 2);
+
+  // the media filename can still be read without decompressing
+  EXPECT_EQ(std::memcmp(compressed->GetMemoryPointer() + header.offset_to_media_filename, MEDIA_FILENAME,
+                        header.media_filename_length),
+            0);
+
+  std::unique_ptr<GrowableMemoryByteStream> decompressed = ByteStream_CreateGrowableMemoryStream();
+  ASSERT_TRUE(System::DecompressSaveState(compressed->GetMemoryPointer(), static_cast<u32>(compressed->GetSize()),
+                                          decompressed.get()));
+
+  ASSERT_EQ(decompressed->GetSize(), state.size());
+  EXPECT_EQ(std::memcmp(decompressed->GetMemoryPointer(), state.data(), state.size()), 0);
+}
+
+TEST(SaveState, InvalidStatesAreRejected)
+{
+  std::vector<u8> state = CreateState();
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream_CreateGrowableMemoryStream();
+
+  // truncated data
+  EXPECT_FALSE(System::CompressSaveState(state.data(), static_cast<u32>(state.size() - 1), stream.get()));
+
+  // already compressed
+  std::unique_ptr<GrowableMemoryByteStream> compressed = ByteStream_CreateGrowableMemoryStream();
+  ASSERT_TRUE(System::CompressSaveState(state.data(), static_cast<u32>(state.size()), compressed.get()));
+  EXPECT_FALSE(System::CompressSaveState(compressed->GetMemoryPointer(), static_cast<u32>(compressed->GetSize()),
+                                         stream.get()));
+
+  // sizes which would need huge allocations
+  std::vector<u8> oversized(compressed->GetMemoryPointer(), compressed->GetMemoryPointer() + compressed->GetSize());
+  SAVE_STATE_HEADER header = GetHeader(compressed.get());
+  header.data_uncompressed_size = UINT32_C(0xFFFFFFF0);
+  std::memcpy(oversized.data(), &header, sizeof(header));
+  EXPECT_FALSE(System::DecompressSaveState(oversized.data(), static_cast<u32>(oversized.size()), stream.get()));
+  header = GetHeader(compressed.get());
+  header.data_compressed_size += 1;
+  std::memcpy(oversized.data(), &header, sizeof(header));
+  EXPECT_FALSE(System::DecompressSaveState(oversized.data(), static_cast<u32>(oversized.size()), stream.get()));
+
+  // corrupted compressed data
+  compressed->GetMemoryPointer()[GetHeader(compressed.get()).offset_to_data + 16] ^= 0xFF;
+  EXPECT_FALSE(System::DecompressSaveState(compressed->GetMemoryPointer(), static_cast<u32>(compressed->GetSize()),
+                                           stream.get()));
+
+  state[0] ^= 0xFF;
+  EXPECT_FALSE(System::DecompressSaveState(state.data(), static_cast<u32>(state.size()), stream.get()));
+}
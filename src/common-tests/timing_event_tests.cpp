@@ -0,0 +1,190 @@
+#include "common/byte_stream.h"
+#include "common/state_wrapper.h"
+#include "core/cpu_core.h"
+#include "core/timing_event.h"
+#include <array>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace {
+struct EventLog
+{
+  std::vector<u32> ids;
+  std::vector<u32> times;
+};
+
+struct TestEvent
+{
+  EventLog* log;
+  u32 id;
+  std::unique_ptr<TimingEvent> event;
+};
+
+class TimingEventsTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    CPU::g_state.pending_ticks = 0;
+    CPU::g_state.downcount = 0;
+    CPU::g_state.frame_done = false;
+    TimingEvents::Initialize();
+  }
+
+  void TearDown() override
+  {
+    m_events.clear();
+    TimingEvents::Shutdown();
+  }
+
+  TestEvent* AddEvent(u32 id, TickCount interval, bool activate = true)
+  {
+    std::unique_ptr<TestEvent> te = std::make_unique<TestEvent>();
+    te->log = &m_log;
+    te->id = id;
+    te->event = TimingEvents::CreateTimingEvent(
+      "Test Event " + std::to_string(id), interval, interval,
+      [](void* param, TickCount ticks, TickCount ticks_late) {
+        TestEvent* te = static_cast<TestEvent*>(param);
+        te->log->ids.push_back(te->id);
+        te->log->times.push_back(TimingEvents::GetGlobalTickCounter());
+      },
+      te.get(), activate);
+    m_events.push_back(std::move(te));
+    return m_events.back().get();
+  }
+
+  static void RunTicks(TickCount ticks)
+  {
+    CPU::AddPendingTicks(ticks);
+    TimingEvents::RunEvents();
+  }
+
+  EventLog m_log;
+  std::vector<std::unique_ptr<TestEvent>> m_events;
+};
+} // namespace
+
+TEST_F(TimingEventsTest, EventsRunInDowncountOrder)
+{
+  AddEvent(1, 10);
+  AddEvent(2, 3);
+  AddEvent(3, 7);
+  ASSERT_EQ(CPU::g_state.downcount, 3);
+
+  RunTicks(10);
+  ASSERT_EQ(m_log.ids, (std::vector<u32>{2, 2, 3, 2, 1}));
+  ASSERT_EQ(m_log.times, (std::vector<u32>{3, 6, 7, 9, 10}));
+  ASSERT_EQ(CPU::g_state.downcount, 2);
+}
+
+TEST_F(TimingEventsTest, DeactivatedEventDoesNotRun)
+{
+  AddEvent(1, 4);
+  TestEvent* te = AddEvent(2, 2);
+  AddEvent(3, 5);
+  te->event->Deactivate();
+  ASSERT_EQ(CPU::g_state.downcount, 4);
+
+  RunTicks(5);
+  ASSERT_EQ(m_log.ids, (std::vector<u32>{1, 3}));
+
+  te->event->Activate();
+  ASSERT_EQ(CPU::g_state.downcount, 2);
+  RunTicks(2);
+  ASSERT_EQ(m_log.ids, (std::vector<u32>{1, 3, 2}));
+}
+
+TEST_F(TimingEventsTest, ScheduleMovesEvent)
+{
+  AddEvent(1, 10);
+  TestEvent* te = AddEvent(2, 20);
+  te->event->Schedule(5);
+  ASSERT_EQ(CPU::g_state.downcount, 5);
+
+  RunTicks(10);
+  ASSERT_EQ(m_log.ids, (std::vector<u32>{2, 1}));
+  ASSERT_EQ(m_log.times, (std::vector<u32>{5, 10}));
+}
+
+TEST_F(TimingEventsTest, CallbackCanDeactivateItself)
+{
+  struct OneshotState
+  {
+    TimingEvent* event;
+    u32 count;
+  } state = {};
+
+  std::unique_ptr<TimingEvent> oneshot = TimingEvents::CreateTimingEvent(
+    "Oneshot", 3, 3,
+    [](void* param, TickCount ticks, TickCount ticks_late) {
+      OneshotState* state = static_cast<OneshotState*>(param);
+      state->count++;
+      state->event->Deactivate();
+    },
+    &state, false);
+  state.event = oneshot.get();
+  oneshot->Activate();
+  AddEvent(1, 4);
+
+  RunTicks(12);
+  ASSERT_EQ(state.count, 1u);
+  ASSERT_FALSE(oneshot->IsActive());
+  ASSERT_EQ(m_log.ids, (std::vector<u32>{1, 1, 1}));
+}
+
+TEST_F(TimingEventsTest, DoStateRoundTrip)
+{
+  TestEvent* a = AddEvent(1, 10);
+  TestEvent* b = AddEvent(2, 15);
+  RunTicks(12);
+
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream_CreateGrowableMemoryStream();
+  {
+    StateWrapper sw(stream.get(), StateWrapper::Mode::Write);
+    ASSERT_TRUE(TimingEvents::DoState(sw));
+  }
+
+  const TickCount a_downcount = a->event->GetDowncount();
+  const TickCount b_downcount = b->event->GetDowncount();
+  RunTicks(7);
+  ASSERT_NE(a->event->GetDowncount(), a_downcount);
+
+  ASSERT_TRUE(stream->SeekAbsolute(0));
+  {
+    StateWrapper sw(stream.get(), StateWrapper::Mode::Read);
+    ASSERT_TRUE(TimingEvents::DoState(sw));
+  }
+
+  ASSERT_EQ(a->event->GetDowncount(), a_downcount);
+  ASSERT_EQ(b->event->GetDowncount(), b_downcount);
+  ASSERT_EQ(CPU::g_state.downcount, b_downcount);
+  ASSERT_EQ(TimingEvents::GetGlobalTickCounter(), 12u);
+}
+
+TEST_F(TimingEventsTest, ManyEventsRunAtTheirIntervals)
+{
+  // Roughly the mix of a running system: a few fast events, and some slow ones.
+  static constexpr std::array<TickCount, 8> intervals = {{2, 3, 8, 17, 64, 768, 2172, 33868}};
+  static constexpr u32 NUM_SLICES = 1000;
+  static constexpr TickCount SLICE_TICKS = 128;
+
+  std::array<u32, intervals.size()> counts = {};
+  std::vector<std::unique_ptr<TimingEvent>> events;
+  for (u32& count : counts)
+  {
+    const TickCount interval = intervals[events.size()];
+    events.push_back(TimingEvents::CreateTimingEvent(
+      "Counting Event", interval, interval,
+      [](void* param, TickCount ticks, TickCount ticks_late) { (*static_cast<u32*>(param))++; }, &count, true));
+  }
+
+  for (u32 i = 0; i < NUM_SLICES; i++)
+    RunTicks(SLICE_TICKS);
+
+  static constexpr u32 total_ticks = NUM_SLICES * static_cast<u32>(SLICE_TICKS);
+  ASSERT_EQ(TimingEvents::GetGlobalTickCounter(), total_ticks);
+  for (size_t i = 0; i < intervals.size(); i++)
+    ASSERT_EQ(counts[i], total_ticks / static_cast<u32>(intervals[i])) << "interval " << intervals[i];
+}
@@ -1,6 +1,7 @@
 #include "cd_image.h"
 #include "assert.h"
 #include "log.h"
+#include "mapped_file.h"
 #include <array>
 Log_SetChannel(CDImage);
 
@@ -237,6 +238,32 @@ bool CDImage::ReadRawSector(void* buffer)
   return true;
 }
 
+const u8* CDImage::ReadRawSectorPointer()
+{
+  if (m_position_in_index == m_current_index->length)
+  {
+    if (!Seek(m_position_on_disc))
+      return nullptr;
+  }
+
+  if (m_current_index->file_sector_size == 0)
+    return nullptr;
+
+  const u8* data = GetSectorPointer(*m_current_index, m_position_in_index);
+  if (!data)
+    return nullptr;
+
+  m_position_on_disc++;
+  m_position_in_index++;
+  m_position_in_track++;
+  return data;
+}
+
+const u8* CDImage::GetSectorPointer(const Index& index, LBA lba_in_index)
+{
+  return nullptr;
+}
+
 bool CDImage::ReadSubChannelQ(SubChannelQ* subq)
 {
   // handle case where we're at the end of the track/index
@@ -319,6 +346,19 @@ void CDImage::AddLeadOutIndex()
   m_indices.push_back(index);
 }
 
+const u8* CDImage::GetMappedSector(Common::MappedFile& file, const Index& index, LBA lba_in_index)
+{
+  // Just under two seconds of reading at double speed.
+  static constexpr u64 PREFETCH_SECTORS = 256;
+
+  const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  if ((file_position + index.file_sector_size) > file.GetSize())
+    return nullptr;
+
+  file.PrefetchAhead(file_position, PREFETCH_SECTORS * index.file_sector_size);
+  return file.GetData() + file_position;
+}
+
 u16 CDImage::SubChannelQ::ComputeCRC(const Data& data)
 {
   static constexpr std::array<u16, 256> crc16_table = {
@@ -8,6 +8,10 @@
 #include <tuple>
 #include <vector>
 
+namespace Common {
+class MappedFile;
+}
+
 class CDImage
 {
 public:
@@ -198,6 +202,18 @@ public:
   static std::unique_ptr<CDImage>
   CreateMemoryImage(CDImage* image, ProgressCallback* progress = ProgressCallback::NullProgressCallback);
 
+  // Decompressed CHD hunks are cached process-wide, so every image opened from the same file shares them.
+  struct CHDHunkCacheStats
+  {
+    u64 hits;       // hunk was already decompressed
+    u64 misses;     // hunk had to be decompressed by the reader
+    u64 prefetches; // hunk was decompressed ahead of time by a worker thread
+    u32 hunk_count;
+    u32 size;
+  };
+  static void SetCHDHunkCacheSize(u32 size);
+  static CHDHunkCacheStats GetCHDHunkCacheStats();
+
   // Accessors.
   const std::string& GetFileName() const { return m_filename; }
   LBA GetPositionOnDisc() const { return m_position_on_disc; }
@@ -239,12 +255,19 @@ public:
   // Read a single raw sector from the current LBA.
   bool ReadRawSector(void* buffer);
 
+  // Returns the raw sector at the current LBA without copying it, and advances past it. Only images which keep the
+  // data in memory support this, nullptr is returned otherwise and the sector has to be read with ReadRawSector().
+  const u8* ReadRawSectorPointer();
+
   // Reads sub-channel Q for the current LBA.
   virtual bool ReadSubChannelQ(SubChannelQ* subq);
 
   // Reads a single sector from an index.
   virtual bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) = 0;
 
+  // Returns a pointer to a raw sector in an index, or nullptr if the image doesn't keep it in memory.
+  virtual const u8* GetSectorPointer(const Index& index, LBA lba_in_index);
+
 protected:
   const Index* GetIndexForDiscPosition(LBA pos);
   const Index* GetIndexForTrackPosition(u32 track_number, LBA track_pos);
@@ -258,6 +281,9 @@ protected:
   /// Synthesis of lead-out data.
   void AddLeadOutIndex();
 
+  /// Returns a sector in a memory-mapped file, and hints that the sectors following it are about to be read.
+  static const u8* GetMappedSector(Common::MappedFile& file, const Index& index, LBA lba_in_index);
+
   std::string m_filename;
   u32 m_lba_count = 0;
 
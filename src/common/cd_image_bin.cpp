@@ -2,7 +2,9 @@
 #include "cd_subchannel_replacement.h"
 #include "file_system.h"
 #include "log.h"
+#include "mapped_file.h"
 #include <cerrno>
+#include <cstring>
 Log_SetChannel(CDImageBin);
 
 class CDImageBin : public CDImage
@@ -17,8 +19,11 @@ public:
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
+  const u8* GetSectorPointer(const Index& index, LBA lba_in_index) override;
 
 private:
+  // Files which can't be mapped, e.g. because they don't fit in the address space, are read with stdio instead.
+  Common::MappedFile m_mapping;
   std::FILE* m_fp = nullptr;
   u64 m_file_position = 0;
 
@@ -57,9 +62,19 @@ bool CDImageBin::Open(const char* filename)
   const u32 track_sector_size = RAW_SECTOR_SIZE;
 
   // determine the length from the file
-  std::fseek(m_fp, 0, SEEK_END);
-  const u32 file_size = static_cast<u32>(std::ftell(m_fp));
-  std::fseek(m_fp, 0, SEEK_SET);
+  u32 file_size;
+  if (m_mapping.Map(m_fp))
+  {
+    file_size = static_cast<u32>(m_mapping.GetSize());
+    std::fclose(m_fp);
+    m_fp = nullptr;
+  }
+  else
+  {
+    std::fseek(m_fp, 0, SEEK_END);
+    file_size = static_cast<u32>(std::ftell(m_fp));
+    std::fseek(m_fp, 0, SEEK_SET);
+  }
 
   m_lba_count = file_size / track_sector_size;
 
@@ -116,6 +131,16 @@ bool CDImageBin::ReadSubChannelQ(SubChannelQ* subq)
 
 bool CDImageBin::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
+  if (m_mapping.IsMapped())
+  {
+    const u8* data = GetMappedSector(m_mapping, index, lba_in_index);
+    if (!data)
+      return false;
+
+    std::memcpy(buffer, data, index.file_sector_size);
+    return true;
+  }
+
   const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
   if (m_file_position != file_position)
   {
@@ -135,6 +160,14 @@ bool CDImageBin::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
   return true;
 }
 
+const u8* CDImageBin::GetSectorPointer(const Index& index, LBA lba_in_index)
+{
+  if (!m_mapping.IsMapped() || index.file_sector_size != RAW_SECTOR_SIZE)
+    return nullptr;
+
+  return GetMappedSector(m_mapping, index, lba_in_index);
+}
+
 std::unique_ptr<CDImage> CDImage::OpenBinImage(const char* filename)
 {
   std::unique_ptr<CDImageBin> image = std::make_unique<CDImageBin>();
@@ -12,11 +12,146 @@
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <condition_variable>
+#include <list>
 #include <map>
 #include <cerrno>
+#include <mutex>
 #include <optional>
+#include <thread>
+#include <unordered_map>
 Log_SetChannel(CDImageCHD);
 
+namespace {
+
+using HunkPtr = std::shared_ptr<const std::vector<u8>>;
+
+// LRU of decompressed hunks shared by every open CHD. Files are identified by the hash in their header rather than
+// the path, so the same disc opened by the hasher or game list reuses whatever the emulated drive has decompressed.
+class HunkCache
+{
+public:
+  static constexpr u32 DEFAULT_SIZE = 16 * 1024 * 1024;
+
+  u32 GetFileID(const std::string& key);
+
+  HunkPtr Lookup(u32 file_id, u32 hunk_index);
+  bool Contains(u32 file_id, u32 hunk_index);
+  void Insert(u32 file_id, u32 hunk_index, HunkPtr data, bool prefetched);
+
+  u32 GetSize();
+  void SetSize(u32 size);
+  CDImage::CHDHunkCacheStats GetStats();
+
+private:
+  struct Entry
+  {
+    HunkPtr data;
+    std::list<u64>::iterator lru_position;
+  };
+
+  static constexpr u64 MakeKey(u32 file_id, u32 hunk_index) { return (ZeroExtend64(file_id) << 32) | hunk_index; }
+
+  void EvictToSize(u32 size);
+
+  std::mutex m_mutex;
+  std::unordered_map<std::string, u32> m_file_ids;
+  std::unordered_map<u64, Entry> m_entries;
+  std::list<u64> m_lru; // most recently used at the front
+  u32 m_used_size = 0;
+  u32 m_max_size = DEFAULT_SIZE;
+  u64 m_hits = 0;
+  u64 m_misses = 0;
+  u64 m_prefetches = 0;
+};
+
+u32 HunkCache::GetFileID(const std::string& key)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto it = m_file_ids.find(key);
+  if (it != m_file_ids.end())
+    return it->second;
+
+  const u32 id = static_cast<u32>(m_file_ids.size());
+  m_file_ids.emplace(key, id);
+  return id;
+}
+
+HunkPtr HunkCache::Lookup(u32 file_id, u32 hunk_index)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto it = m_entries.find(MakeKey(file_id, hunk_index));
+  if (it == m_entries.end())
+    return {};
+
+  m_lru.splice(m_lru.begin(), m_lru, it->second.lru_position);
+  m_hits++;
+  return it->second.data;
+}
+
+bool HunkCache::Contains(u32 file_id, u32 hunk_index)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  return m_entries.find(MakeKey(file_id, hunk_index)) != m_entries.end();
+}
+
+void HunkCache::Insert(u32 file_id, u32 hunk_index, HunkPtr data, bool prefetched)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (prefetched)
+    m_prefetches++;
+  else
+    m_misses++;
+
+  const u32 data_size = static_cast<u32>(data->size());
+  if (data_size > m_max_size)
+    return;
+
+  const u64 key = MakeKey(file_id, hunk_index);
+  if (m_entries.find(key) != m_entries.end())
+    return;
+
+  EvictToSize(m_max_size - data_size);
+  m_lru.push_front(key);
+  m_entries.emplace(key, Entry{std::move(data), m_lru.begin()});
+  m_used_size += data_size;
+}
+
+u32 HunkCache::GetSize()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  return m_max_size;
+}
+
+void HunkCache::SetSize(u32 size)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_max_size = size;
+  EvictToSize(size);
+}
+
+CDImage::CHDHunkCacheStats HunkCache::GetStats()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  return CDImage::CHDHunkCacheStats{m_hits, m_misses, m_prefetches, static_cast<u32>(m_entries.size()), m_used_size};
+}
+
+void HunkCache::EvictToSize(u32 size)
+{
+  // readers hold a reference to the hunk they're using, so it stays alive after eviction
+  while (m_used_size > size)
+  {
+    auto it = m_entries.find(m_lru.back());
+    m_used_size -= static_cast<u32>(it->second.data->size());
+    m_entries.erase(it);
+    m_lru.pop_back();
+  }
+}
+
+static HunkCache s_hunk_cache;
+
+} // namespace
+
 static std::optional<CDImage::TrackMode> ParseTrackModeString(const char* str)
 {
   if (std::strncmp(str, "MODE2_FORM_MIX", 14) == 0)
@@ -56,17 +191,42 @@ private:
   enum : u32
   {
     CHD_SECTOR_DATA_SIZE = 2352 + 96,
+    INVALID_HUNK_INDEX = static_cast<u32>(-1),
+
+    // Hunks decompressed ahead of a sequential reader, about 30 sectors for a typical 8 sector hunk.
+    PREFETCH_HUNK_COUNT = 4,
   };
 
   bool ReadHunk(u32 hunk_index);
+  HunkPtr DecompressHunk(chd_file* chd, u32 hunk_index);
+
+  void QueuePrefetch(u32 hunk_index);
+  bool WaitForPrefetch(u32 hunk_index);
+  void StopPrefetchThread();
+  void PrefetchThreadEntryPoint();
 
   std::FILE* m_fp = nullptr;
   chd_file* m_chd = nullptr;
   u32 m_hunk_size = 0;
+  u32 m_hunk_count = 0;
   u32 m_sectors_per_hunk = 0;
-
-  std::vector<u8> m_hunk_buffer;
-  u32 m_current_hunk_index = static_cast<u32>(-1);
+  u32 m_cache_file_id = 0;
+
+  HunkPtr m_current_hunk;
+  u32 m_current_hunk_index = INVALID_HUNK_INDEX;
+
+  // libchdr handles aren't thread safe, so the prefetch thread opens the file a second time. It's only started once
+  // the image is read sequentially, which keeps the game list from spawning a thread for every disc it looks at.
+  std::FILE* m_prefetch_fp = nullptr;
+  chd_file* m_prefetch_chd = nullptr;
+  std::thread m_prefetch_thread;
+  std::mutex m_prefetch_mutex;
+  std::condition_variable m_prefetch_cv;
+  std::condition_variable m_prefetch_done_cv;
+  u32 m_prefetch_position = 0;
+  u32 m_prefetch_end = 0;
+  u32 m_prefetch_busy_hunk = INVALID_HUNK_INDEX;
+  bool m_prefetch_shutdown = false;
 
   CDSubChannelReplacement m_sbi;
 };
@@ -75,6 +235,7 @@ CDImageCHD::CDImageCHD() = default;
 
 CDImageCHD::~CDImageCHD()
 {
+  StopPrefetchThread();
   if (m_chd)
     chd_close(m_chd);
   if (m_fp)
@@ -106,10 +267,17 @@ bool CDImageCHD::Open(const char* filename)
     return false;
   }
 
+  m_hunk_count = header->totalhunks;
   m_sectors_per_hunk = m_hunk_size / CHD_SECTOR_DATA_SIZE;
-  m_hunk_buffer.resize(m_hunk_size);
   m_filename = filename;
 
+  // Old versions don't have a hash of the data, fall back to the path for those.
+  static constexpr u8 null_sha1[CHD_SHA1_BYTES] = {};
+  if (std::memcmp(header->sha1, null_sha1, sizeof(null_sha1)) != 0)
+    m_cache_file_id = s_hunk_cache.GetFileID(std::string(reinterpret_cast<const char*>(header->sha1), CHD_SHA1_BYTES));
+  else
+    m_cache_file_id = s_hunk_cache.GetFileID(m_filename);
+
   u32 disc_lba = 0;
   u64 file_lba = 0;
 
@@ -302,30 +470,169 @@ bool CDImageCHD::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
     return false;
 
   // Audio data is in big-endian, so we have to swap it for little endian hosts...
+  const u8* hunk_data = m_current_hunk->data();
   if (index.mode == TrackMode::Audio)
-    CopyAndSwap(buffer, &m_hunk_buffer[hunk_offset], RAW_SECTOR_SIZE);
+    CopyAndSwap(buffer, &hunk_data[hunk_offset], RAW_SECTOR_SIZE);
   else
-    std::memcpy(buffer, &m_hunk_buffer[hunk_offset], RAW_SECTOR_SIZE);
+    std::memcpy(buffer, &hunk_data[hunk_offset], RAW_SECTOR_SIZE);
 
   return true;
 }
 
 bool CDImageCHD::ReadHunk(u32 hunk_index)
 {
-  const chd_error err = chd_read(m_chd, hunk_index, m_hunk_buffer.data());
+  const bool sequential =
+    (m_current_hunk_index != INVALID_HUNK_INDEX && hunk_index == (m_current_hunk_index + 1));
+
+  HunkPtr hunk = s_hunk_cache.Lookup(m_cache_file_id, hunk_index);
+  if (!hunk && WaitForPrefetch(hunk_index))
+    hunk = s_hunk_cache.Lookup(m_cache_file_id, hunk_index);
+
+  if (!hunk)
+  {
+    hunk = DecompressHunk(m_chd, hunk_index);
+    if (!hunk)
+    {
+      m_current_hunk.reset();
+      m_current_hunk_index = INVALID_HUNK_INDEX;
+      return false;
+    }
+
+    s_hunk_cache.Insert(m_cache_file_id, hunk_index, hunk, false);
+  }
+
+  m_current_hunk = std::move(hunk);
+  m_current_hunk_index = hunk_index;
+
+  if (sequential)
+    QueuePrefetch(hunk_index + 1);
+
+  return true;
+}
+
+HunkPtr CDImageCHD::DecompressHunk(chd_file* chd, u32 hunk_index)
+{
+  std::shared_ptr<std::vector<u8>> data = std::make_shared<std::vector<u8>>(m_hunk_size);
+  const chd_error err = chd_read(chd, hunk_index, data->data());
   if (err != CHDERR_NONE)
   {
     Log_ErrorPrintf("chd_read(%u) failed: %s", hunk_index, chd_error_string(err));
+    return {};
+  }
 
-    // data might have been partially written
-    m_current_hunk_index = static_cast<u32>(-1);
-    return false;
+  return data;
+}
+
+void CDImageCHD::QueuePrefetch(u32 hunk_index)
+{
+  // nowhere to put the hunks
+  if (s_hunk_cache.GetSize() < (m_hunk_size * PREFETCH_HUNK_COUNT))
+    return;
+
+  std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+  if (!m_prefetch_thread.joinable())
+  {
+    if (m_prefetch_shutdown)
+      return;
+
+    m_prefetch_fp = FileSystem::OpenCFile(m_filename.c_str(), "rb");
+    const chd_error err =
+      m_prefetch_fp ? chd_open_file(m_prefetch_fp, CHD_OPEN_READ, nullptr, &m_prefetch_chd) : CHDERR_FILE_NOT_FOUND;
+    if (err != CHDERR_NONE)
+    {
+      Log_WarningPrintf("Failed to reopen '%s' for prefetching: %s", m_filename.c_str(), chd_error_string(err));
+      if (m_prefetch_fp)
+      {
+        std::fclose(m_prefetch_fp);
+        m_prefetch_fp = nullptr;
+      }
+
+      // don't keep trying on every hunk
+      m_prefetch_shutdown = true;
+      return;
+    }
+
+    m_prefetch_thread = std::thread(&CDImageCHD::PrefetchThreadEntryPoint, this);
   }
 
-  m_current_hunk_index = hunk_index;
+  m_prefetch_position = hunk_index;
+  m_prefetch_end = std::min(hunk_index + PREFETCH_HUNK_COUNT, m_hunk_count);
+  m_prefetch_cv.notify_one();
+}
+
+bool CDImageCHD::WaitForPrefetch(u32 hunk_index)
+{
+  if (!m_prefetch_thread.joinable())
+    return false;
+
+  // Decompressing it ourselves would only duplicate the work the thread is already halfway through.
+  std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+  if (m_prefetch_busy_hunk != hunk_index)
+    return false;
+
+  m_prefetch_done_cv.wait(lock, [this, hunk_index]() { return m_prefetch_busy_hunk != hunk_index; });
   return true;
 }
 
+void CDImageCHD::StopPrefetchThread()
+{
+  if (m_prefetch_thread.joinable())
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+      m_prefetch_shutdown = true;
+      m_prefetch_cv.notify_one();
+    }
+
+    m_prefetch_thread.join();
+  }
+
+  if (m_prefetch_chd)
+  {
+    chd_close(m_prefetch_chd);
+    m_prefetch_chd = nullptr;
+  }
+  if (m_prefetch_fp)
+  {
+    std::fclose(m_prefetch_fp);
+    m_prefetch_fp = nullptr;
+  }
+}
+
+void CDImageCHD::PrefetchThreadEntryPoint()
+{
+  std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+
+  while (!m_prefetch_shutdown)
+  {
+    if (m_prefetch_position >= m_prefetch_end)
+    {
+      m_prefetch_cv.wait(lock, [this]() { return m_prefetch_shutdown || m_prefetch_position < m_prefetch_end; });
+      continue;
+    }
+
+    const u32 hunk_index = m_prefetch_position++;
+    if (s_hunk_cache.Contains(m_cache_file_id, hunk_index))
+      continue;
+
+    m_prefetch_busy_hunk = hunk_index;
+    lock.unlock();
+
+    HunkPtr hunk = DecompressHunk(m_prefetch_chd, hunk_index);
+    const bool result = static_cast<bool>(hunk);
+    if (result)
+      s_hunk_cache.Insert(m_cache_file_id, hunk_index, std::move(hunk), true);
+
+    lock.lock();
+    m_prefetch_busy_hunk = INVALID_HUNK_INDEX;
+    m_prefetch_done_cv.notify_all();
+
+    // stop on errors rather than retrying
+    if (!result)
+      m_prefetch_end = m_prefetch_position;
+  }
+}
+
 std::unique_ptr<CDImage> CDImage::OpenCHDImage(const char* filename)
 {
   std::unique_ptr<CDImageCHD> image = std::make_unique<CDImageCHD>();
@@ -334,3 +641,13 @@ std::unique_ptr<CDImage> CDImage::OpenCHDImage(const char* filename)
 
   return image;
 }
+
+void CDImage::SetCHDHunkCacheSize(u32 size)
+{
+  s_hunk_cache.SetSize(size);
+}
+
+CDImage::CHDHunkCacheStats CDImage::GetCHDHunkCacheStats()
+{
+  return s_hunk_cache.GetStats();
+}
@@ -3,8 +3,10 @@
 #include "cd_subchannel_replacement.h"
 #include "file_system.h"
 #include "log.h"
+#include "mapped_file.h"
 #include <algorithm>
 #include <cerrno>
+#include <cstring>
 #include <libcue/libcue.h>
 #include <map>
 Log_SetChannel(CDImageCueSheet);
@@ -21,15 +23,18 @@ public:
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
+  const u8* GetSectorPointer(const Index& index, LBA lba_in_index) override;
 
 private:
   Cd* m_cd = nullptr;
 
+  // Files are read through a mapping where possible, with stdio as a fallback.
   struct TrackFile
   {
     std::string filename;
     std::FILE* file;
     u64 file_position;
+    std::unique_ptr<Common::MappedFile> mapping;
   };
 
   std::vector<TrackFile> m_files;
@@ -40,7 +45,10 @@ CDImageCueSheet::CDImageCueSheet() = default;
 
 CDImageCueSheet::~CDImageCueSheet()
 {
-  std::for_each(m_files.begin(), m_files.end(), [](TrackFile& t) { std::fclose(t.file); });
+  std::for_each(m_files.begin(), m_files.end(), [](TrackFile& t) {
+    if (t.file)
+      std::fclose(t.file);
+  });
   cd_delete(m_cd);
 }
 
@@ -103,7 +111,18 @@ bool CDImageCueSheet::OpenAndParse(const char* filename)
         return false;
       }
 
-      m_files.push_back(TrackFile{std::move(track_filename), track_fp, 0});
+      std::unique_ptr<Common::MappedFile> mapping = std::make_unique<Common::MappedFile>();
+      if (mapping->Map(track_fp))
+      {
+        std::fclose(track_fp);
+        track_fp = nullptr;
+      }
+      else
+      {
+        mapping.reset();
+      }
+
+      m_files.push_back(TrackFile{std::move(track_filename), track_fp, 0, std::move(mapping)});
     }
 
     // data type determines the sector size
@@ -120,9 +139,18 @@ bool CDImageCueSheet::OpenAndParse(const char* filename)
     // determine the length from the file
     if (track_length < 0)
     {
-      std::fseek(m_files[track_file_index].file, 0, SEEK_END);
-      long file_size = std::ftell(m_files[track_file_index].file);
-      std::fseek(m_files[track_file_index].file, 0, SEEK_SET);
+      const TrackFile& tf = m_files[track_file_index];
+      long file_size;
+      if (tf.mapping)
+      {
+        file_size = static_cast<long>(tf.mapping->GetSize());
+      }
+      else
+      {
+        std::fseek(tf.file, 0, SEEK_END);
+        file_size = std::ftell(tf.file);
+        std::fseek(tf.file, 0, SEEK_SET);
+      }
 
       file_size /= track_sector_size;
       Assert(track_start < file_size);
@@ -233,6 +261,16 @@ bool CDImageCueSheet::ReadSectorFromIndex(void* buffer, const Index& index, LBA
   DebugAssert(index.file_index < m_files.size());
 
   TrackFile& tf = m_files[index.file_index];
+  if (tf.mapping)
+  {
+    const u8* data = GetMappedSector(*tf.mapping, index, lba_in_index);
+    if (!data)
+      return false;
+
+    std::memcpy(buffer, data, index.file_sector_size);
+    return true;
+  }
+
   const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
   if (tf.file_position != file_position)
   {
@@ -252,6 +290,17 @@ bool CDImageCueSheet::ReadSectorFromIndex(void* buffer, const Index& index, LBA
   return true;
 }
 
+const u8* CDImageCueSheet::GetSectorPointer(const Index& index, LBA lba_in_index)
+{
+  DebugAssert(index.file_index < m_files.size());
+
+  TrackFile& tf = m_files[index.file_index];
+  if (!tf.mapping || index.file_sector_size != RAW_SECTOR_SIZE)
+    return nullptr;
+
+  return GetMappedSector(*tf.mapping, index, lba_in_index);
+}
+
 std::unique_ptr<CDImage> CDImage::OpenCueSheetImage(const char* filename)
 {
   std::unique_ptr<CDImageCueSheet> image = std::make_unique<CDImageCueSheet>();
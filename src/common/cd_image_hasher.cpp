@@ -2,10 +2,189 @@
 #include "cd_image.h"
 #include "md5_digest.h"
 #include "string_util.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <xxhash.h>
 
 namespace CDImageHasher {
 
-static bool ReadIndex(CDImage* image, u8 track, u8 index, MD5Digest* digest, ProgressCallback* progress_callback)
+namespace {
+
+// ~150KB per batch, big enough that handing it to another thread is cheap next to hashing it.
+static constexpr u32 BATCH_SECTORS = 64;
+static constexpr u32 MAX_QUEUED_BATCHES = 8;
+static constexpr u32 MAX_HASH_THREADS = 4;
+
+class Digest
+{
+public:
+  Digest(HashType type) : m_type(type)
+  {
+    if (m_type == HashType::XXH128)
+    {
+      m_xxh3_state = XXH3_createState();
+      XXH3_128bits_reset(m_xxh3_state);
+    }
+  }
+
+  Digest(const Digest&) = delete;
+
+  ~Digest()
+  {
+    if (m_xxh3_state)
+      XXH3_freeState(m_xxh3_state);
+  }
+
+  Digest& operator=(const Digest&) = delete;
+
+  void Update(const void* data, u32 size)
+  {
+    if (m_type == HashType::XXH128)
+      XXH3_128bits_update(m_xxh3_state, data, size);
+    else
+      m_md5.Update(data, size);
+  }
+
+  void Final(Hash* hash)
+  {
+    if (m_type == HashType::XXH128)
+    {
+      XXH128_canonical_t canonical;
+      XXH128_canonicalFromHash(&canonical, XXH3_128bits_digest(m_xxh3_state));
+      static_assert(sizeof(canonical.digest) == sizeof(Hash), "XXH128 fits in a hash");
+      std::memcpy(hash->data(), canonical.digest, sizeof(canonical.digest));
+    }
+    else
+    {
+      m_md5.Final(hash->data());
+    }
+  }
+
+private:
+  HashType m_type;
+  MD5Digest m_md5;
+  XXH3_state_t* m_xxh3_state = nullptr;
+};
+
+struct Batch
+{
+  u32 digest_index;
+  u32 sector_count;
+  std::array<const u8*, BATCH_SECTORS> sectors;
+
+  // sectors which the image can't point to directly are read into here
+  std::array<u8, BATCH_SECTORS * CDImage::RAW_SECTOR_SIZE> buffer;
+};
+
+// CDImage isn't thread safe, so the caller does all of the reading and the workers only hash. Every batch for a digest
+// goes to the same worker, which keeps the updates in order.
+class Pipeline
+{
+public:
+  Pipeline(HashType type, u32 num_digests, u32 num_workers)
+  {
+    for (u32 i = 0; i < num_digests; i++)
+      m_digests.push_back(std::make_unique<Digest>(type));
+
+    for (u32 i = 0; i < MAX_QUEUED_BATCHES; i++)
+    {
+      m_batches.push_back(std::make_unique<Batch>());
+      m_free_batches.push_back(m_batches.back().get());
+    }
+
+    m_worker_queues.resize(num_workers);
+    for (u32 i = 0; i < num_workers; i++)
+      m_workers.emplace_back(&Pipeline::WorkerThread, this, i);
+  }
+
+  ~Pipeline()
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_shutdown = true;
+      m_work_cv.notify_all();
+    }
+
+    for (std::thread& worker : m_workers)
+      worker.join();
+  }
+
+  Batch* GetBatch(u32 digest_index)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_free_cv.wait(lock, [this]() { return !m_free_batches.empty(); });
+
+    Batch* batch = m_free_batches.back();
+    m_free_batches.pop_back();
+    batch->digest_index = digest_index;
+    batch->sector_count = 0;
+    return batch;
+  }
+
+  void SubmitBatch(Batch* batch)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_worker_queues[batch->digest_index % m_worker_queues.size()].push_back(batch);
+    m_work_cv.notify_all();
+  }
+
+  void GetHashes(Hash* hashes)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_free_cv.wait(lock, [this]() { return m_free_batches.size() == m_batches.size(); });
+    }
+
+    for (size_t i = 0; i < m_digests.size(); i++)
+      m_digests[i]->Final(&hashes[i]);
+  }
+
+private:
+  void WorkerThread(u32 worker_index)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::deque<Batch*>& queue = m_worker_queues[worker_index];
+    for (;;)
+    {
+      m_work_cv.wait(lock, [this, &queue]() { return !queue.empty() || m_shutdown; });
+      if (queue.empty())
+        break;
+
+      Batch* batch = queue.front();
+      queue.pop_front();
+      lock.unlock();
+
+      Digest* digest = m_digests[batch->digest_index].get();
+      for (u32 i = 0; i < batch->sector_count; i++)
+        digest->Update(batch->sectors[i], CDImage::RAW_SECTOR_SIZE);
+
+      lock.lock();
+      m_free_batches.push_back(batch);
+      m_free_cv.notify_one();
+    }
+  }
+
+  std::vector<std::unique_ptr<Digest>> m_digests;
+  std::vector<std::unique_ptr<Batch>> m_batches;
+  std::vector<Batch*> m_free_batches;
+  std::vector<std::deque<Batch*>> m_worker_queues;
+  std::vector<std::thread> m_workers;
+
+  std::mutex m_mutex;
+  std::condition_variable m_work_cv;
+  std::condition_variable m_free_cv;
+  bool m_shutdown = false;
+};
+
+} // namespace
+
+static bool ReadIndex(CDImage* image, u8 track, u8 index, u32 digest_index, Pipeline* pipeline,
+                      ProgressCallback* progress_callback)
 {
   const CDImage::LBA index_start = image->GetTrackIndexPosition(track, index);
   const u32 index_length = image->GetTrackIndexLength(track, index);
@@ -21,26 +200,48 @@ static bool ReadIndex(CDImage* image, u8 track, u8 index, MD5Digest* digest, Pro
     return false;
   }
 
-  std::array<u8, CDImage::RAW_SECTOR_SIZE> sector;
-  for (u32 lba = 0; lba < index_length; lba++)
+  u32 next_update = 0;
+  for (u32 lba = 0; lba < index_length;)
   {
-    if ((lba % update_interval) == 0)
+    if (lba >= next_update)
+    {
       progress_callback->SetProgressValue(lba);
+      next_update = lba + update_interval;
+    }
 
-    if (!image->ReadRawSector(sector.data()))
+    Batch* batch = pipeline->GetBatch(digest_index);
+    const u32 batch_sectors = std::min(BATCH_SECTORS, index_length - lba);
+    for (; batch->sector_count < batch_sectors; batch->sector_count++)
     {
-      progress_callback->DisplayFormattedModalError("Failed to read sector %u from image", image->GetPositionOnDisc());
-      return false;
+      // hash straight out of the image where it's in memory, saves a copy per sector
+      const u8* sector_data = image->ReadRawSectorPointer();
+      if (!sector_data)
+      {
+        u8* buffer = &batch->buffer[batch->sector_count * CDImage::RAW_SECTOR_SIZE];
+        if (!image->ReadRawSector(buffer))
+        {
+          pipeline->SubmitBatch(batch);
+          progress_callback->DisplayFormattedModalError("Failed to read sector %u from image",
+                                                        image->GetPositionOnDisc());
+          return false;
+        }
+
+        sector_data = buffer;
+      }
+
+      batch->sectors[batch->sector_count] = sector_data;
     }
 
-    digest->Update(sector.data(), static_cast<u32>(sector.size()));
+    pipeline->SubmitBatch(batch);
+    lba += batch_sectors;
   }
 
   progress_callback->SetProgressValue(index_length);
   return true;
 }
 
-static bool ReadTrack(CDImage* image, u8 track, MD5Digest* digest, ProgressCallback* progress_callback)
+static bool ReadTrack(CDImage* image, u8 track, u32 digest_index, Pipeline* pipeline,
+                      ProgressCallback* progress_callback)
 {
   static constexpr u8 INDICES_TO_READ = 2;
 
@@ -56,7 +257,7 @@ static bool ReadTrack(CDImage* image, u8 track, MD5Digest* digest, ProgressCallb
       continue;
 
     progress_callback->PushState();
-    if (!ReadIndex(image, track, index, digest, progress_callback))
+    if (!ReadIndex(image, track, index, digest_index, pipeline, progress_callback))
     {
       progress_callback->PopState();
       progress_callback->PopState();
@@ -78,10 +279,41 @@ std::string HashToString(const Hash& hash)
                                          hash[9], hash[10], hash[11], hash[12], hash[13], hash[14], hash[15]);
 }
 
+static int GetHexDigitValue(char ch)
+{
+  if (ch >= '0' && ch <= '9')
+    return ch - '0';
+  else if (ch >= 'a' && ch <= 'f')
+    return ch - 'a' + 10;
+  else if (ch >= 'A' && ch <= 'F')
+    return ch - 'A' + 10;
+  else
+    return -1;
+}
+
+bool HashFromString(const char* str, Hash* hash)
+{
+  if (std::strlen(str) != hash->size() * 2)
+    return false;
+
+  for (size_t i = 0; i < hash->size(); i++)
+  {
+    const int high = GetHexDigitValue(str[i * 2]);
+    const int low = GetHexDigitValue(str[i * 2 + 1]);
+    if (high < 0 || low < 0)
+      return false;
+
+    (*hash)[i] = static_cast<u8>((high << 4) | low);
+  }
+
+  return true;
+}
+
 bool GetImageHash(CDImage* image, Hash* out_hash,
-                  ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
+                  ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/,
+                  HashType type /*= HashType::MD5*/)
 {
-  MD5Digest digest;
+  Pipeline pipeline(type, 1, 1);
 
   progress_callback->SetProgressRange(image->GetTrackCount());
   progress_callback->SetProgressValue(0);
@@ -90,7 +322,7 @@ bool GetImageHash(CDImage* image, Hash* out_hash,
   for (u32 i = 1; i <= image->GetTrackCount(); i++)
   {
     progress_callback->SetProgressValue(i - 1);
-    if (!ReadTrack(image, i, &digest, progress_callback))
+    if (!ReadTrack(image, i, 0, &pipeline, progress_callback))
     {
       progress_callback->PopState();
       return false;
@@ -98,19 +330,53 @@ bool GetImageHash(CDImage* image, Hash* out_hash,
   }
 
   progress_callback->SetProgressValue(image->GetTrackCount());
-  digest.Final(out_hash->data());
+  pipeline.GetHashes(out_hash);
   return true;
 }
 
 bool GetTrackHash(CDImage* image, u8 track, Hash* out_hash,
-                  ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
+                  ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/,
+                  HashType type /*= HashType::MD5*/)
 {
-  MD5Digest digest;
-  if (!ReadTrack(image, track, &digest, progress_callback))
+  Pipeline pipeline(type, 1, 1);
+  if (!ReadTrack(image, track, 0, &pipeline, progress_callback))
     return false;
 
-  digest.Final(out_hash->data());
+  pipeline.GetHashes(out_hash);
+  return true;
+}
+
+bool GetTrackHashes(CDImage* image, std::vector<Hash>* out_hashes,
+                    ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/,
+                    HashType type /*= HashType::MD5*/)
+{
+  // leave a core for the reader
+  const u32 track_count = image->GetTrackCount();
+  const u32 hardware_threads = std::thread::hardware_concurrency();
+  const u32 num_workers =
+    std::min(std::clamp<u32>((hardware_threads > 1) ? (hardware_threads - 1) : 1, 1, MAX_HASH_THREADS), track_count);
+  Pipeline pipeline(type, track_count, std::max<u32>(num_workers, 1));
+
+  progress_callback->SetProgressRange(track_count);
+  progress_callback->SetProgressValue(0);
+  progress_callback->PushState();
+
+  for (u32 i = 1; i <= track_count; i++)
+  {
+    progress_callback->SetProgressValue(i - 1);
+    if (!ReadTrack(image, i, i - 1, &pipeline, progress_callback))
+    {
+      progress_callback->PopState();
+      return false;
+    }
+  }
+
+  progress_callback->PopState();
+  progress_callback->SetProgressValue(track_count);
+
+  out_hashes->resize(track_count);
+  pipeline.GetHashes(out_hashes->data());
   return true;
 }
 
-} // namespace CDImageHasher
\ No newline at end of file
+} // namespace CDImageHasher
@@ -3,6 +3,7 @@
 #include "types.h"
 #include <array>
 #include <string>
+#include <vector>
 
 class CDImage;
 
@@ -10,10 +11,26 @@ namespace CDImageHasher {
 
 using Hash = std::array<u8, 16>;
 std::string HashToString(const Hash& hash);
+bool HashFromString(const char* str, Hash* hash);
 
+enum class HashType : u8
+{
+  MD5,   // what redump lists, needed to verify dumps
+  XXH128 // much faster, for checking whether two images are the same
+};
+
+// Sectors are read on the calling thread in large batches, and hashed on worker threads while the next batch is read.
 bool GetImageHash(CDImage* image, Hash* out_hash,
-                  ProgressCallback* progress_callback = ProgressCallback::NullProgressCallback);
+                  ProgressCallback* progress_callback = ProgressCallback::NullProgressCallback,
+                  HashType type = HashType::MD5);
 bool GetTrackHash(CDImage* image, u8 track, Hash* out_hash,
-                  ProgressCallback* progress_callback = ProgressCallback::NullProgressCallback);
+                  ProgressCallback* progress_callback = ProgressCallback::NullProgressCallback,
+                  HashType type = HashType::MD5);
+
+// Hashes every track in a single pass over the image. Each track has its own digest, so different tracks are hashed
+// on different threads at the same time.
+bool GetTrackHashes(CDImage* image, std::vector<Hash>* out_hashes,
+                    ProgressCallback* progress_callback = ProgressCallback::NullProgressCallback,
+                    HashType type = HashType::MD5);
 
-} // namespace CDImageHasher
\ No newline at end of file
+} // namespace CDImageHasher
@@ -1287,6 +1287,17 @@ static u32 RecursiveFindFiles(const char* OriginPath, const char* ParentPath, co
         outData.FileName = pDirEnt->d_name;
     }
 
+    struct stat sFile;
+    if (fstatat(dirfd(pDir), pDirEnt->d_name, &sFile, 0) == 0)
+    {
+      outData.ModificationTime.SetUnixTimestamp((Timestamp::UnixTimestampValue)sFile.st_mtime);
+      outData.Size = S_ISREG(sFile.st_mode) ? static_cast<u64>(sFile.st_size) : 0;
+    }
+    else
+    {
+      outData.Size = 0;
+    }
+
     nFiles++;
     pResults->push_back(std::move(outData));
   }
@@ -0,0 +1,130 @@
+#include "mapped_file.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+#include <limits>
+Log_SetChannel(Common::MappedFile);
+
+#if defined(WIN32)
+#include "windows_headers.h"
+#include <io.h>
+#else
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Common {
+
+MappedFile::MappedFile() = default;
+
+MappedFile::~MappedFile()
+{
+  Unmap();
+}
+
+bool MappedFile::Map(std::FILE* fp)
+{
+  Assert(!m_data);
+
+#if defined(WIN32)
+  const HANDLE file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fp)));
+  LARGE_INTEGER file_size;
+  if (file_handle == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_handle, &file_size))
+    return false;
+
+  // can't map empty files, and the whole file has to fit in the address space
+  if (file_size.QuadPart == 0 ||
+      static_cast<u64>(file_size.QuadPart) > static_cast<u64>(std::numeric_limits<size_t>::max()))
+  {
+    return false;
+  }
+
+  const HANDLE mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping_handle)
+  {
+    Log_WarningPrintf("CreateFileMappingW() failed: %u", GetLastError());
+    return false;
+  }
+
+  // the view keeps the mapping object alive
+  void* data = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping_handle);
+  if (!data)
+  {
+    Log_WarningPrintf("MapViewOfFile() failed: %u", GetLastError());
+    return false;
+  }
+
+  m_data = static_cast<const u8*>(data);
+  m_size = static_cast<u64>(file_size.QuadPart);
+  return true;
+#else
+  const int fd = fileno(fp);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0)
+    return false;
+
+  if (st.st_size <= 0 || static_cast<u64>(st.st_size) > static_cast<u64>(std::numeric_limits<size_t>::max()))
+    return false;
+
+  void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED)
+  {
+    Log_WarningPrintf("mmap() failed: %d", errno);
+    return false;
+  }
+
+  m_data = static_cast<const u8*>(data);
+  m_size = static_cast<u64>(st.st_size);
+  return true;
+#endif
+}
+
+void MappedFile::Unmap()
+{
+  if (!m_data)
+    return;
+
+#if defined(WIN32)
+  UnmapViewOfFile(m_data);
+#else
+  munmap(const_cast<u8*>(m_data), static_cast<size_t>(m_size));
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+  m_prefetch_start = 0;
+  m_prefetch_end = 0;
+}
+
+void MappedFile::Prefetch(u64 offset, u64 size) const
+{
+  if (offset >= m_size)
+    return;
+
+  size = std::min(size, m_size - offset);
+
+#if defined(WIN32)
+  // PrefetchVirtualMemory() needs Windows 8, and we still target Vista. Page faults still read ahead a little.
+#else
+  // madvise() needs a page-aligned start
+  const u64 page_mask = static_cast<u64>(sysconf(_SC_PAGESIZE)) - 1;
+  const u64 aligned_offset = offset & ~page_mask;
+  madvise(const_cast<u8*>(m_data) + aligned_offset, static_cast<size_t>(size + (offset - aligned_offset)),
+          MADV_WILLNEED);
+#endif
+}
+
+void MappedFile::PrefetchAhead(u64 offset, u64 window_size)
+{
+  if (offset >= m_prefetch_start && (offset + window_size / 2) <= m_prefetch_end)
+    return;
+
+  m_prefetch_start = offset;
+  m_prefetch_end = offset + window_size;
+  Prefetch(offset, window_size);
+}
+
+} // namespace Common
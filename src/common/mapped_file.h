@@ -0,0 +1,40 @@
+#pragma once
+#include "types.h"
+#include <cstdio>
+
+namespace Common {
+
+/// Read-only mapping of a whole file. Accesses go straight to the OS page cache, so there's no syscall or copy into
+/// an intermediate buffer per read.
+class MappedFile
+{
+public:
+  MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  ~MappedFile();
+
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool IsMapped() const { return (m_data != nullptr); }
+  const u8* GetData() const { return m_data; }
+  u64 GetSize() const { return m_size; }
+
+  /// Maps the file behind an open stdio handle. The mapping stays valid if the handle is closed afterwards.
+  bool Map(std::FILE* fp);
+  void Unmap();
+
+  /// Hints that the range is going to be read soon, so the OS can start reading it in.
+  void Prefetch(u64 offset, u64 size) const;
+
+  /// Keeps the hinted range ahead of a reader at offset. A new window is only hinted after a seek, or when the
+  /// reader is halfway through the previous one, so this is cheap to call on every read.
+  void PrefetchAhead(u64 offset, u64 window_size);
+
+private:
+  const u8* m_data = nullptr;
+  u64 m_size = 0;
+  u64 m_prefetch_start = 0;
+  u64 m_prefetch_end = 0;
+};
+
+} // namespace Common
@@ -0,0 +1,357 @@
+#include "memory_arena.h"
+#include "assert.h"
+#include "log.h"
+#include "string_util.h"
+Log_SetChannel(Common::MemoryArena);
+
+#if defined(WIN32)
+#include "windows_headers.h"
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__HAIKU__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Common {
+
+MemoryArena::MemoryArena() = default;
+
+MemoryArena::~MemoryArena()
+{
+  Destroy();
+}
+
+void* MemoryArena::FindBaseAddressForMapping(size_t size)
+{
+  void* base_address;
+#if defined(WIN32)
+  base_address = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_READWRITE);
+  if (base_address)
+    VirtualFree(base_address, 0, MEM_RELEASE);
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__HAIKU__)
+  base_address = mmap(nullptr, size, PROT_NONE, MAP_ANON | MAP_PRIVATE | MAP_NORESERVE, -1, 0);
+  if (base_address == MAP_FAILED)
+    base_address = nullptr;
+  else
+    munmap(base_address, size);
+#else
+  base_address = nullptr;
+#endif
+
+  if (!base_address)
+  {
+    Log_ErrorPrintf("Failed to get base address for memory mapping of size %zu", size);
+    return nullptr;
+  }
+
+  return base_address;
+}
+
+size_t MemoryArena::GetHostPageSize()
+{
+#if defined(WIN32)
+  SYSTEM_INFO si = {};
+  GetSystemInfo(&si);
+  return si.dwPageSize;
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__HAIKU__)
+  return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+  return 0;
+#endif
+}
+
+bool MemoryArena::Create(size_t size, bool writable, bool executable)
+{
+  if (m_size > 0)
+    Destroy();
+
+#if defined(WIN32)
+  const DWORD protect = (writable ? (executable ? PAGE_EXECUTE_READWRITE : PAGE_READWRITE) :
+                                    (executable ? PAGE_EXECUTE_READ : PAGE_READONLY));
+#ifdef _WIN64
+  const DWORD size_hi = static_cast<DWORD>(size >> 32);
+#else
+  const DWORD size_hi = 0;
+#endif
+  const DWORD size_lo = static_cast<DWORD>(size);
+  m_file_handle = CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, protect, size_hi, size_lo, nullptr);
+  if (!m_file_handle)
+  {
+    Log_ErrorPrintf("CreateFileMapping failed: %u", GetLastError());
+    return false;
+  }
+#elif defined(__linux__) && !defined(__ANDROID__)
+  m_shmem_fd = memfd_create("duckstation_arena", 0);
+  if (m_shmem_fd < 0)
+  {
+    Log_ErrorPrintf("memfd_create failed: %d", errno);
+    return false;
+  }
+
+  if (ftruncate(m_shmem_fd, static_cast<off_t>(size)) < 0)
+  {
+    Log_ErrorPrintf("ftruncate(%zu) failed: %d", size, errno);
+    close(m_shmem_fd);
+    m_shmem_fd = -1;
+    return false;
+  }
+#elif defined(__ANDROID__) || defined(__APPLE__) || defined(__HAIKU__)
+  const std::string file_mapping_name =
+    StringUtil::StdStringFromFormat("duckstation_arena_%u", static_cast<unsigned>(getpid()));
+  m_shmem_fd = shm_open(file_mapping_name.c_str(), O_CREAT | O_EXCL | (writable ? O_RDWR : O_RDONLY), 0600);
+  if (m_shmem_fd < 0)
+  {
+    Log_ErrorPrintf("shm_open failed: %d", errno);
+    return false;
+  }
+
+  // we're not going to be opening this mapping in other processes, so remove the file
+  shm_unlink(file_mapping_name.c_str());
+
+  if (ftruncate(m_shmem_fd, static_cast<off_t>(size)) < 0)
+  {
+    Log_ErrorPrintf("ftruncate(%zu) failed: %d", size, errno);
+    close(m_shmem_fd);
+    m_shmem_fd = -1;
+    return false;
+  }
+#else
+  return false;
+#endif
+
+  m_size = size;
+  m_writable = writable;
+  m_executable = executable;
+  return true;
+}
+
+void MemoryArena::Destroy()
+{
+  Assert(m_num_views.load() == 0);
+
+#if defined(WIN32)
+  if (m_file_handle)
+  {
+    CloseHandle(m_file_handle);
+    m_file_handle = nullptr;
+  }
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__HAIKU__)
+  if (m_shmem_fd >= 0)
+  {
+    close(m_shmem_fd);
+    m_shmem_fd = -1;
+  }
+#endif
+
+  m_size = 0;
+}
+
+std::optional<MemoryArena::View> MemoryArena::CreateView(size_t offset, size_t size, bool writable, bool executable,
+                                                         void* fixed_address)
+{
+  void* base_pointer = CreateViewPtr(offset, size, writable, executable, fixed_address);
+  if (!base_pointer)
+    return std::nullopt;
+
+  return View(this, base_pointer, offset, size, writable, fixed_address != nullptr);
+}
+
+std::optional<MemoryArena::View> MemoryArena::CreateReservedView(size_t size, void* fixed_address /*= nullptr*/)
+{
+  void* base_pointer = CreateReservedPtr(size, fixed_address);
+  if (!base_pointer)
+    return std::nullopt;
+
+  return View(this, base_pointer, View::RESERVED_REGION_OFFSET, size, false, fixed_address != nullptr);
+}
+
+void* MemoryArena::CreateViewPtr(size_t offset, size_t size, bool writable, bool executable,
+                                 void* fixed_address /*= nullptr*/)
+{
+  void* base_pointer;
+#if defined(WIN32)
+  const DWORD desired_access = FILE_MAP_READ | (writable ? FILE_MAP_WRITE : 0) | (executable ? FILE_MAP_EXECUTE : 0);
+#ifdef _WIN64
+  const DWORD offset_hi = static_cast<DWORD>(offset >> 32);
+#else
+  const DWORD offset_hi = 0;
+#endif
+  const DWORD offset_lo = static_cast<DWORD>(offset);
+  base_pointer = MapViewOfFileEx(m_file_handle, desired_access, offset_hi, offset_lo, size, fixed_address);
+  if (!base_pointer)
+    return nullptr;
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__HAIKU__)
+  const int flags = (fixed_address != nullptr) ? (MAP_SHARED | MAP_FIXED) : MAP_SHARED;
+  const int prot = PROT_READ | (writable ? PROT_WRITE : 0) | (executable ? PROT_EXEC : 0);
+  base_pointer = mmap(fixed_address, size, prot, flags, m_shmem_fd, static_cast<off_t>(offset));
+  if (base_pointer == MAP_FAILED)
+    return nullptr;
+#else
+  return nullptr;
+#endif
+
+  m_num_views.fetch_add(1);
+  return base_pointer;
+}
+
+bool MemoryArena::FlushViewPtr(void* address, size_t size)
+{
+#if defined(WIN32)
+  return FlushViewOfFile(address, size);
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__HAIKU__)
+  return (msync(address, size, 0) >= 0);
+#else
+  return false;
+#endif
+}
+
+bool MemoryArena::ReleaseViewPtr(void* address, size_t size, bool keep_reserved /*= false*/)
+{
+  bool result;
+#if defined(WIN32)
+  result = static_cast<bool>(UnmapViewOfFile(address));
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__HAIKU__)
+  if (keep_reserved)
+  {
+    // Replace the view with inaccessible memory, so nothing else can be allocated in the reserved region.
+    result = (mmap(address, size, PROT_NONE, MAP_PRIVATE | MAP_ANON | MAP_NORESERVE | MAP_FIXED, -1, 0) != MAP_FAILED);
+  }
+  else
+  {
+    result = (munmap(address, size) >= 0);
+  }
+#else
+  result = false;
+#endif
+
+  if (!result)
+  {
+    Log_ErrorPrintf("Failed to unmap previously-created view at %p", address);
+    return false;
+  }
+
+  const size_t prev_count = m_num_views.fetch_sub(1);
+  Assert(prev_count > 0);
+  return true;
+}
+
+void* MemoryArena::CreateReservedPtr(size_t size, void* fixed_address /*= nullptr*/)
+{
+  void* base_pointer;
+#if defined(WIN32)
+  base_pointer = VirtualAlloc(fixed_address, size, MEM_RESERVE, PAGE_NOACCESS);
+  if (!base_pointer)
+    return nullptr;
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__HAIKU__)
+  const int flags = (fixed_address != nullptr) ? (MAP_PRIVATE | MAP_ANON | MAP_NORESERVE | MAP_FIXED) :
+                                                 (MAP_PRIVATE | MAP_ANON | MAP_NORESERVE);
+  base_pointer = mmap(fixed_address, size, PROT_NONE, flags, -1, 0);
+  if (base_pointer == MAP_FAILED)
+    return nullptr;
+#else
+  return nullptr;
+#endif
+
+  m_num_views.fetch_add(1);
+  return base_pointer;
+}
+
+bool MemoryArena::ReleaseReservedPtr(void* address, size_t size)
+{
+  bool result;
+#if defined(WIN32)
+  result = static_cast<bool>(VirtualFree(address, 0, MEM_RELEASE));
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__HAIKU__)
+  result = (munmap(address, size) >= 0);
+#else
+  result = false;
+#endif
+
+  if (!result)
+  {
+    Log_ErrorPrintf("Failed to release previously-created view at %p", address);
+    return false;
+  }
+
+  const size_t prev_count = m_num_views.fetch_sub(1);
+  Assert(prev_count > 0);
+  return true;
+}
+
+bool MemoryArena::SetPageProtection(void* address, size_t length, bool readable, bool writable, bool executable)
+{
+#if defined(WIN32)
+  static constexpr DWORD protection_table[2][2][2] = {
+    {{PAGE_NOACCESS, PAGE_EXECUTE}, {PAGE_WRITECOPY, PAGE_EXECUTE_WRITECOPY}},
+    {{PAGE_READONLY, PAGE_EXECUTE_READ}, {PAGE_READWRITE, PAGE_EXECUTE_READWRITE}}};
+
+  DWORD old_protect;
+  return static_cast<bool>(
+    VirtualProtect(address, length, protection_table[readable][writable][executable], &old_protect));
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__HAIKU__)
+  const int prot = (readable ? PROT_READ : 0) | (writable ? PROT_WRITE : 0) | (executable ? PROT_EXEC : 0);
+  return (mprotect(address, length, prot) >= 0);
+#else
+  return false;
+#endif
+}
+
+MemoryArena::View::View(MemoryArena* parent, void* base_pointer, size_t arena_offset, size_t mapping_size,
+                        bool writable, bool fixed)
+  : m_parent(parent), m_base_pointer(base_pointer), m_arena_offset(arena_offset), m_mapping_size(mapping_size),
+    m_writable(writable), m_fixed(fixed)
+{
+}
+
+MemoryArena::View::View(View&& view)
+  : m_parent(view.m_parent), m_base_pointer(view.m_base_pointer), m_arena_offset(view.m_arena_offset),
+    m_mapping_size(view.m_mapping_size), m_writable(view.m_writable), m_fixed(view.m_fixed)
+{
+  view.m_parent = nullptr;
+  view.m_base_pointer = nullptr;
+  view.m_arena_offset = 0;
+  view.m_mapping_size = 0;
+}
+
+MemoryArena::View::~View()
+{
+  Release();
+}
+
+MemoryArena::View& MemoryArena::View::operator=(View&& view)
+{
+  Release();
+
+  m_parent = view.m_parent;
+  m_base_pointer = view.m_base_pointer;
+  m_arena_offset = view.m_arena_offset;
+  m_mapping_size = view.m_mapping_size;
+  m_writable = view.m_writable;
+  m_fixed = view.m_fixed;
+  view.m_parent = nullptr;
+  view.m_base_pointer = nullptr;
+  view.m_arena_offset = 0;
+  view.m_mapping_size = 0;
+  return *this;
+}
+
+void MemoryArena::View::Release()
+{
+  if (!m_parent)
+    return;
+
+  if (m_arena_offset != RESERVED_REGION_OFFSET)
+  {
+    if (!m_parent->ReleaseViewPtr(m_base_pointer, m_mapping_size, m_fixed))
+      Panic("Failed to unmap previously-created view");
+  }
+  else
+  {
+    if (!m_parent->ReleaseReservedPtr(m_base_pointer, m_mapping_size))
+      Panic("Failed to release previously-created view");
+  }
+
+  m_parent = nullptr;
+}
+} // namespace Common
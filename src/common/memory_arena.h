@@ -0,0 +1,81 @@
+#pragma once
+#include "types.h"
+#include <atomic>
+#include <optional>
+
+namespace Common {
+class MemoryArena
+{
+public:
+  class View
+  {
+  public:
+    enum : size_t
+    {
+      RESERVED_REGION_OFFSET = static_cast<size_t>(-1)
+    };
+
+    View(MemoryArena* parent, void* base_pointer, size_t arena_offset, size_t mapping_size, bool writable,
+         bool fixed);
+    View(View&& view);
+    View(const View&) = delete;
+    ~View();
+
+    View& operator=(View&& view);
+    View& operator=(const View&) = delete;
+
+    void* GetBasePointer() const { return m_base_pointer; }
+    size_t GetArenaOffset() const { return m_arena_offset; }
+    size_t GetMappingSize() const { return m_mapping_size; }
+    bool IsWritable() const { return m_writable; }
+
+  private:
+    void Release();
+
+    MemoryArena* m_parent;
+    void* m_base_pointer;
+    size_t m_arena_offset;
+    size_t m_mapping_size;
+    bool m_writable;
+    bool m_fixed;
+  };
+
+  MemoryArena();
+  ~MemoryArena();
+
+  static void* FindBaseAddressForMapping(size_t size);
+  static size_t GetHostPageSize();
+
+  bool Create(size_t size, bool writable, bool executable);
+  void Destroy();
+
+  /// Views created at a fixed address are assumed to be placed inside a reserved region, and return the address
+  /// range to the reservation when released.
+  std::optional<View> CreateView(size_t offset, size_t size, bool writable, bool executable,
+                                 void* fixed_address = nullptr);
+
+  std::optional<View> CreateReservedView(size_t size, void* fixed_address = nullptr);
+
+  void* CreateViewPtr(size_t offset, size_t size, bool writable, bool executable, void* fixed_address = nullptr);
+  bool FlushViewPtr(void* address, size_t size);
+  /// Releases a view. If keep_reserved is set, the address range is left reserved on platforms which support it.
+  bool ReleaseViewPtr(void* address, size_t size, bool keep_reserved = false);
+
+  void* CreateReservedPtr(size_t size, void* fixed_address = nullptr);
+  bool ReleaseReservedPtr(void* address, size_t size);
+
+  static bool SetPageProtection(void* address, size_t length, bool readable, bool writable, bool executable);
+
+private:
+#if defined(WIN32)
+  void* m_file_handle = nullptr;
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__HAIKU__)
+  int m_shmem_fd = -1;
+#endif
+
+  std::atomic_size_t m_num_views{0};
+  size_t m_size = 0;
+  bool m_writable = false;
+  bool m_executable = false;
+};
+} // namespace Common
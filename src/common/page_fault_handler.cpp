@@ -0,0 +1,252 @@
+#include "page_fault_handler.h"
+#include "log.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+Log_SetChannel(Common::PageFaultHandler);
+
+#if defined(WIN32)
+#include "windows_headers.h"
+#elif defined(__linux__) || defined(__ANDROID__)
+#include <signal.h>
+#include <ucontext.h>
+#include <unistd.h>
+#define USE_SIGSEGV 1
+#elif defined(__APPLE__)
+#include <signal.h>
+#include <sys/ucontext.h>
+#include <unistd.h>
+#define USE_SIGSEGV 1
+#endif
+
+namespace Common::PageFaultHandler {
+
+struct RegisteredHandler
+{
+  void* owner;
+  Callback callback;
+};
+static std::vector<RegisteredHandler> m_handlers;
+static std::mutex m_handler_lock;
+static thread_local bool s_in_handler;
+
+#if defined(WIN32)
+static PVOID s_veh_handle;
+
+static LONG ExceptionHandler(PEXCEPTION_POINTERS exi)
+{
+  if (exi->ExceptionRecord->ExceptionCode != EXCEPTION_ACCESS_VIOLATION || s_in_handler)
+    return EXCEPTION_CONTINUE_SEARCH;
+
+  s_in_handler = true;
+
+#if defined(_M_AMD64)
+  void* const exception_pc = reinterpret_cast<void*>(exi->ContextRecord->Rip);
+#elif defined(_M_ARM64)
+  void* const exception_pc = reinterpret_cast<void*>(exi->ContextRecord->Pc);
+#else
+  void* const exception_pc = nullptr;
+#endif
+
+  void* const exception_address = reinterpret_cast<void*>(exi->ExceptionRecord->ExceptionInformation[1]);
+  const bool is_write = exi->ExceptionRecord->ExceptionInformation[0] == 1;
+
+  std::lock_guard<std::mutex> guard(m_handler_lock);
+  for (const RegisteredHandler& rh : m_handlers)
+  {
+    if (rh.callback(exception_pc, exception_address, is_write) == HandlerResult::ContinueExecution)
+    {
+      s_in_handler = false;
+      return EXCEPTION_CONTINUE_EXECUTION;
+    }
+  }
+
+  s_in_handler = false;
+  return EXCEPTION_CONTINUE_SEARCH;
+}
+
+#elif defined(USE_SIGSEGV)
+
+static struct sigaction s_old_sigsegv_action;
+#if defined(__APPLE__)
+static struct sigaction s_old_sigbus_action;
+#endif
+
+static void CallExistingSignalHandler(int signal, siginfo_t* siginfo, void* ctx)
+{
+#if defined(__APPLE__)
+  const struct sigaction& sa = (signal == SIGBUS) ? s_old_sigbus_action : s_old_sigsegv_action;
+#else
+  const struct sigaction& sa = s_old_sigsegv_action;
+#endif
+
+  if (sa.sa_flags & SA_SIGINFO)
+  {
+    sa.sa_sigaction(signal, siginfo, ctx);
+  }
+  else if (sa.sa_handler == SIG_DFL)
+  {
+    // Re-raising the signal would just queue it, and since we'd restore the handler back to us,
+    // we'd end up right back here again. So just abort, because that's probably what it'd do anyway.
+    abort();
+  }
+  else if (sa.sa_handler != SIG_IGN)
+  {
+    sa.sa_handler(signal);
+  }
+}
+
+static void SIGSEGVHandler(int sig, siginfo_t* info, void* ctx)
+{
+  if ((info->si_code != SEGV_MAPERR && info->si_code != SEGV_ACCERR) || s_in_handler)
+  {
+    CallExistingSignalHandler(sig, info, ctx);
+    return;
+  }
+
+#if defined(__linux__) || defined(__ANDROID__)
+  void* const exception_address = reinterpret_cast<void*>(info->si_addr);
+
+#if defined(__x86_64__)
+  void* const exception_pc = reinterpret_cast<void*>(static_cast<ucontext_t*>(ctx)->uc_mcontext.gregs[REG_RIP]);
+  const bool is_write = (static_cast<ucontext_t*>(ctx)->uc_mcontext.gregs[REG_ERR] & 2) != 0;
+#elif defined(__aarch64__)
+  void* const exception_pc = reinterpret_cast<void*>(static_cast<ucontext_t*>(ctx)->uc_mcontext.pc);
+  const bool is_write = false;
+#else
+  void* const exception_pc = nullptr;
+  const bool is_write = false;
+#endif
+
+#elif defined(__APPLE__)
+
+#if defined(__x86_64__)
+  void* const exception_address =
+    reinterpret_cast<void*>(static_cast<ucontext_t*>(ctx)->uc_mcontext->__es.__faultvaddr);
+  void* const exception_pc = reinterpret_cast<void*>(static_cast<ucontext_t*>(ctx)->uc_mcontext->__ss.__rip);
+  const bool is_write = (static_cast<ucontext_t*>(ctx)->uc_mcontext->__es.__err & 2) != 0;
+#elif defined(__aarch64__)
+  void* const exception_address = reinterpret_cast<void*>(static_cast<ucontext_t*>(ctx)->uc_mcontext->__es.__far);
+  void* const exception_pc = reinterpret_cast<void*>(static_cast<ucontext_t*>(ctx)->uc_mcontext->__ss.__pc);
+  const bool is_write = false;
+#else
+  void* const exception_address = reinterpret_cast<void*>(info->si_addr);
+  void* const exception_pc = nullptr;
+  const bool is_write = false;
+#endif
+
+#endif
+
+  std::unique_lock<std::mutex> lock(m_handler_lock);
+  s_in_handler = true;
+  for (const RegisteredHandler& rh : m_handlers)
+  {
+    if (rh.callback(exception_pc, exception_address, is_write) == HandlerResult::ContinueExecution)
+    {
+      s_in_handler = false;
+      return;
+    }
+  }
+
+  s_in_handler = false;
+  lock.unlock();
+
+  // call old signal handler
+  CallExistingSignalHandler(sig, info, ctx);
+}
+
+#endif
+
+bool InstallHandler(void* owner, Callback callback)
+{
+  bool was_empty;
+  {
+    std::lock_guard<std::mutex> guard(m_handler_lock);
+    if (std::find_if(m_handlers.begin(), m_handlers.end(),
+                     [owner](const RegisteredHandler& rh) { return rh.owner == owner; }) != m_handlers.end())
+    {
+      return false;
+    }
+
+    was_empty = m_handlers.empty();
+    m_handlers.push_back(RegisteredHandler{owner, callback});
+  }
+
+  if (was_empty)
+  {
+#if defined(WIN32)
+    s_veh_handle = AddVectoredExceptionHandler(1, ExceptionHandler);
+    if (!s_veh_handle)
+    {
+      Log_ErrorPrint("Failed to add vectored exception handler");
+      RemoveHandler(owner);
+      return false;
+    }
+#elif defined(USE_SIGSEGV)
+    struct sigaction sa = {};
+    sa.sa_sigaction = SIGSEGVHandler;
+    sa.sa_flags = SA_SIGINFO;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGSEGV, &sa, &s_old_sigsegv_action) < 0)
+    {
+      Log_ErrorPrint("Failed to install SIGSEGV handler");
+      RemoveHandler(owner);
+      return false;
+    }
+#if defined(__APPLE__)
+    if (sigaction(SIGBUS, &sa, &s_old_sigbus_action) < 0)
+    {
+      Log_ErrorPrint("Failed to install SIGBUS handler");
+      RemoveHandler(owner);
+      return false;
+    }
+#endif
+#else
+    RemoveHandler(owner);
+    return false;
+#endif
+  }
+
+  return true;
+}
+
+bool RemoveHandler(void* owner)
+{
+  std::lock_guard<std::mutex> guard(m_handler_lock);
+  auto it = std::find_if(m_handlers.begin(), m_handlers.end(),
+                         [owner](const RegisteredHandler& rh) { return rh.owner == owner; });
+  if (it == m_handlers.end())
+    return false;
+
+  m_handlers.erase(it);
+
+  if (m_handlers.empty())
+  {
+#if defined(WIN32)
+    if (s_veh_handle)
+    {
+      RemoveVectoredExceptionHandler(s_veh_handle);
+      s_veh_handle = nullptr;
+    }
+#elif defined(USE_SIGSEGV)
+    // restore old signal handler
+    if (sigaction(SIGSEGV, &s_old_sigsegv_action, nullptr) < 0)
+    {
+      Log_ErrorPrint("Failed to restore SIGSEGV handler");
+      return false;
+    }
+#if defined(__APPLE__)
+    if (sigaction(SIGBUS, &s_old_sigbus_action, nullptr) < 0)
+    {
+      Log_ErrorPrint("Failed to restore SIGBUS handler");
+      return false;
+    }
+#endif
+#endif
+  }
+
+  return true;
+}
+
+} // namespace Common::PageFaultHandler
@@ -0,0 +1,90 @@
+#pragma once
+#include "assert.h"
+#include "types.h"
+#include <array>
+#include <memory>
+
+/// Two-level table, indexed by page and then by entry within the page. Pages are allocated on first write, so a
+/// sparse address space only pays for the pages which are actually touched. Lookups never allocate, and return a
+/// value-initialized T for entries in pages which have not been allocated.
+template<typename T, u32 PAGE_COUNT, u32 ENTRIES_PER_PAGE>
+class PageTable
+{
+public:
+  using Page = std::array<T, ENTRIES_PER_PAGE>;
+
+  PageTable() = default;
+  PageTable(const PageTable&) = delete;
+  PageTable& operator=(const PageTable&) = delete;
+  ~PageTable() = default;
+
+  static constexpr u32 GetPageCount() { return PAGE_COUNT; }
+  static constexpr u32 GetEntriesPerPage() { return ENTRIES_PER_PAGE; }
+  u32 GetAllocatedPageCount() const { return m_allocated_page_count; }
+
+  ALWAYS_INLINE const Page* GetPage(u32 page) const
+  {
+    DebugAssert(page < PAGE_COUNT);
+    return m_pages[page].get();
+  }
+
+  ALWAYS_INLINE Page* GetPage(u32 page)
+  {
+    DebugAssert(page < PAGE_COUNT);
+    return m_pages[page].get();
+  }
+
+  ALWAYS_INLINE T Lookup(u32 page, u32 entry) const
+  {
+    DebugAssert(entry < ENTRIES_PER_PAGE);
+    const Page* p = GetPage(page);
+    return p ? (*p)[entry] : T{};
+  }
+
+  /// Returns a reference to the entry, allocating the page if needed.
+  T& GetEntry(u32 page, u32 entry)
+  {
+    DebugAssert(page < PAGE_COUNT && entry < ENTRIES_PER_PAGE);
+    std::unique_ptr<Page>& p = m_pages[page];
+    if (!p)
+    {
+      p = std::make_unique<Page>();
+      p->fill(T{});
+      m_allocated_page_count++;
+    }
+
+    return (*p)[entry];
+  }
+
+  /// Resets an entry to its default value. Does not allocate, or free the page.
+  void ClearEntry(u32 page, u32 entry)
+  {
+    DebugAssert(entry < ENTRIES_PER_PAGE);
+    Page* p = GetPage(page);
+    if (p)
+      (*p)[entry] = T{};
+  }
+
+  /// Calls callback(page_index, page) for each allocated page.
+  template<typename Callback>
+  void EnumeratePages(Callback callback)
+  {
+    for (u32 i = 0; i < PAGE_COUNT; i++)
+    {
+      if (m_pages[i])
+        callback(i, *m_pages[i]);
+    }
+  }
+
+  /// Frees all pages.
+  void Clear()
+  {
+    for (std::unique_ptr<Page>& p : m_pages)
+      p.reset();
+    m_allocated_page_count = 0;
+  }
+
+private:
+  std::array<std::unique_ptr<Page>, PAGE_COUNT> m_pages{};
+  u32 m_allocated_page_count = 0;
+};
@@ -0,0 +1,249 @@
+#include "trace.h"
+#include "file_system.h"
+#include "log.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+Log_SetChannel(Trace);
+
+namespace Trace {
+
+namespace {
+
+struct Event
+{
+  std::atomic<const char*> name;
+  std::atomic<Common::Timer::Value> start_time;
+  std::atomic<Common::Timer::Value> end_time;
+};
+
+struct ThreadBuffer
+{
+  enum : u64
+  {
+    CAPACITY = 256 * 1024
+  };
+
+  std::unique_ptr<Event[]> events = std::make_unique<Event[]>(CAPACITY);
+
+  // Total number of events ever written. Only the owning thread writes it, the index in the ring is count % CAPACITY.
+  std::atomic<u64> event_count{0};
+
+  std::string name;
+  u32 thread_id = 0;
+  bool in_use = false;
+};
+
+struct SavedEvent
+{
+  const char* name;
+  Common::Timer::Value start_time;
+  Common::Timer::Value end_time;
+};
+
+// Buffers are never freed, threads which exit hand theirs back for reuse by the next thread which records.
+class ThreadBufferOwner
+{
+public:
+  ~ThreadBufferOwner();
+
+  ThreadBuffer* Get();
+
+private:
+  ThreadBuffer* m_buffer = nullptr;
+};
+
+} // namespace
+
+std::atomic_bool g_recording{false};
+
+static std::mutex s_buffers_mutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+static std::atomic<Common::Timer::Value> s_recording_start_time{0};
+
+static std::mutex s_names_mutex;
+static std::unordered_set<std::string> s_names;
+
+static thread_local ThreadBufferOwner s_thread_buffer;
+
+ThreadBufferOwner::~ThreadBufferOwner()
+{
+  if (!m_buffer)
+    return;
+
+  std::unique_lock lock(s_buffers_mutex);
+  m_buffer->in_use = false;
+}
+
+ThreadBuffer* ThreadBufferOwner::Get()
+{
+  if (m_buffer)
+    return m_buffer;
+
+  std::unique_lock lock(s_buffers_mutex);
+  for (const std::unique_ptr<ThreadBuffer>& buffer : s_buffers)
+  {
+    if (!buffer->in_use)
+    {
+      m_buffer = buffer.get();
+      break;
+    }
+  }
+
+  if (!m_buffer)
+  {
+    s_buffers.push_back(std::make_unique<ThreadBuffer>());
+    m_buffer = s_buffers.back().get();
+    m_buffer->thread_id = static_cast<u32>(s_buffers.size());
+  }
+
+  m_buffer->in_use = true;
+  m_buffer->name.clear();
+  m_buffer->event_count.store(0, std::memory_order_release);
+  return m_buffer;
+}
+
+void SetRecording(bool enabled)
+{
+  if (enabled && !g_recording.load(std::memory_order_relaxed))
+    s_recording_start_time.store(Common::Timer::GetValue(), std::memory_order_relaxed);
+
+  g_recording.store(enabled, std::memory_order_release);
+}
+
+void SetThreadName(const char* name)
+{
+  ThreadBuffer* buffer = s_thread_buffer.Get();
+  std::unique_lock lock(s_buffers_mutex);
+  buffer->name = name;
+}
+
+const char* InternName(const char* name)
+{
+  std::unique_lock lock(s_names_mutex);
+  return s_names.emplace(name).first->c_str();
+}
+
+void AddEvent(const char* name, Common::Timer::Value start_time, Common::Timer::Value end_time)
+{
+  ThreadBuffer* buffer = s_thread_buffer.Get();
+  const u64 count = buffer->event_count.load(std::memory_order_relaxed);
+  Event& event = buffer->events[count % ThreadBuffer::CAPACITY];
+  event.name.store(name, std::memory_order_relaxed);
+  event.start_time.store(start_time, std::memory_order_relaxed);
+  event.end_time.store(end_time, std::memory_order_relaxed);
+  buffer->event_count.store(count + 1, std::memory_order_release);
+}
+
+static void WriteEscapedString(std::FILE* fp, const char* str)
+{
+  std::fputc('"', fp);
+  for (; *str != '\0'; str++)
+  {
+    const char ch = *str;
+    if (ch == '"' || ch == '\\')
+      std::fprintf(fp, "\\%c", ch);
+    else if (static_cast<unsigned char>(ch) < 0x20)
+      std::fprintf(fp, "\\u%04x", static_cast<unsigned>(ch));
+    else
+      std::fputc(ch, fp);
+  }
+  std::fputc('"', fp);
+}
+
+bool SaveChromeTrace(const char* filename)
+{
+  struct SavedThread
+  {
+    std::string name;
+    u32 thread_id;
+    std::vector<SavedEvent> events;
+  };
+
+  const Common::Timer::Value recording_start_time = s_recording_start_time.load(std::memory_order_relaxed);
+  std::vector<SavedThread> threads;
+  {
+    std::unique_lock lock(s_buffers_mutex);
+    threads.reserve(s_buffers.size());
+    for (const std::unique_ptr<ThreadBuffer>& buffer : s_buffers)
+    {
+      const u64 count_before = buffer->event_count.load(std::memory_order_acquire);
+      const u64 first = (count_before > ThreadBuffer::CAPACITY) ? (count_before - ThreadBuffer::CAPACITY) : 0;
+
+      SavedThread& thread = threads.emplace_back();
+      thread.name = buffer->name;
+      thread.thread_id = buffer->thread_id;
+      thread.events.reserve(static_cast<size_t>(count_before - first));
+      for (u64 i = first; i < count_before; i++)
+      {
+        const Event& event = buffer->events[i % ThreadBuffer::CAPACITY];
+        thread.events.push_back(SavedEvent{event.name.load(std::memory_order_relaxed),
+                                           event.start_time.load(std::memory_order_relaxed),
+                                           event.end_time.load(std::memory_order_relaxed)});
+      }
+
+      // The owner keeps writing while we copy. Anything it could have lapped in the meantime is torn, so drop it.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      const u64 count_after = buffer->event_count.load(std::memory_order_relaxed);
+      if (count_after > first + ThreadBuffer::CAPACITY)
+      {
+        const u64 overwritten = std::min<u64>(count_after - (first + ThreadBuffer::CAPACITY), thread.events.size());
+        thread.events.erase(thread.events.begin(), thread.events.begin() + static_cast<size_t>(overwritten));
+      }
+    }
+  }
+
+  std::FILE* fp = FileSystem::OpenCFile(filename, "wb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open '%s' for writing", filename);
+    return false;
+  }
+
+  u32 event_count = 0;
+  bool first_entry = true;
+  std::fputs("{\"traceEvents\":[", fp);
+  for (const SavedThread& thread : threads)
+  {
+    if (!thread.name.empty())
+    {
+      std::fprintf(fp, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                   first_entry ? "" : ",", thread.thread_id);
+      WriteEscapedString(fp, thread.name.c_str());
+      std::fputs("}}", fp);
+      first_entry = false;
+    }
+
+    for (const SavedEvent& event : thread.events)
+    {
+      if (!event.name || event.start_time < recording_start_time || event.end_time < event.start_time)
+        continue;
+
+      const double ts = Common::Timer::ConvertValueToNanoseconds(event.start_time - recording_start_time) / 1000.0;
+      const double dur = Common::Timer::ConvertValueToNanoseconds(event.end_time - event.start_time) / 1000.0;
+      std::fprintf(fp, "%s\n{\"name\":", first_entry ? "" : ",");
+      WriteEscapedString(fp, event.name);
+      std::fprintf(fp, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", thread.thread_id, ts, dur);
+      first_entry = false;
+      event_count++;
+    }
+  }
+  std::fputs("\n],\"displayTimeUnit\":\"ms\"}\n", fp);
+
+  const bool result = (std::ferror(fp) == 0);
+  std::fclose(fp);
+  if (!result)
+  {
+    Log_ErrorPrintf("Failed to write trace to '%s'", filename);
+    return false;
+  }
+
+  Log_InfoPrintf("Saved %u trace events from %zu threads to '%s'", event_count, threads.size(), filename);
+  return true;
+}
+
+} // namespace Trace
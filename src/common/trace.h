@@ -0,0 +1,73 @@
+#pragma once
+#include "timer.h"
+#include "types.h"
+#include <atomic>
+
+/// Scoped tracing of where host time goes, saved in the Chrome trace event format for chrome://tracing or Perfetto.
+///
+/// Scopes are only compiled in when WITH_TRACING is defined, and only record while recording is enabled. Each thread
+/// appends to its own ring buffer without taking any locks, so a saved trace holds the most recent events of each
+/// thread. Scope names must outlive the trace, use string literals or InternName().
+namespace Trace {
+
+extern std::atomic_bool g_recording;
+
+ALWAYS_INLINE bool IsRecording()
+{
+  return g_recording.load(std::memory_order_relaxed);
+}
+
+/// Only events recorded after recording is enabled are saved.
+void SetRecording(bool enabled);
+
+/// Names the calling thread in saved traces.
+void SetThreadName(const char* name);
+
+/// Returns a copy of name which lives as long as the process, for scopes with names that aren't literals.
+const char* InternName(const char* name);
+
+/// Records a completed scope on the calling thread's buffer.
+void AddEvent(const char* name, Common::Timer::Value start_time, Common::Timer::Value end_time);
+
+/// Writes the buffered events of all threads to a JSON file. Safe to call while other threads are recording.
+bool SaveChromeTrace(const char* filename);
+
+class Scope
+{
+public:
+  ALWAYS_INLINE Scope(const char* name)
+    : m_name(IsRecording() ? name : nullptr), m_start_time(m_name ? Common::Timer::GetValue() : 0)
+  {
+  }
+
+  ALWAYS_INLINE ~Scope()
+  {
+    if (m_name)
+      AddEvent(m_name, m_start_time, Common::Timer::GetValue());
+  }
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  const char* m_name;
+  Common::Timer::Value m_start_time;
+};
+
+} // namespace Trace
+
+#ifdef WITH_TRACING
+#define TRACE_SCOPE_CONCAT_(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_SCOPE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) Trace::SetThreadName(name)
+#else
+#define TRACE_SCOPE(name)                                                                                              \
+  do                                                                                                                   \
+  {                                                                                                                    \
+  } while (0)
+#define TRACE_THREAD_NAME(name)                                                                                        \
+  do                                                                                                                   \
+  {                                                                                                                    \
+  } while (0)
+#endif
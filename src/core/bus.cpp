@@ -3,6 +3,7 @@
 #include "common/align.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "common/memory_arena.h"
 #include "common/state_wrapper.h"
 #include "cpu_code_cache.h"
 #include "cpu_core.h"
@@ -16,7 +17,9 @@
 #include "sio.h"
 #include "spu.h"
 #include "timers.h"
+#include <array>
 #include <cstdio>
+#include <cstring>
 #include <tuple>
 Log_SetChannel(Bus);
 
@@ -68,9 +71,23 @@ union MEMCTRL
   };
 };
 
+enum : u32
+{
+  // RAM and the scratchpad live in a shared memory arena, so they can be mapped into the fastmem region.
+  // The scratchpad gets a whole host page, of which only the first 1KB is used.
+  MEMORY_ARENA_RAM_OFFSET = 0,
+  MEMORY_ARENA_SCRATCHPAD_OFFSET = RAM_SIZE,
+  MEMORY_ARENA_SIZE = MEMORY_ARENA_SCRATCHPAD_OFFSET + 4096,
+
+  FASTMEM_HOST_PAGE_SIZE = 4096,
+  FASTMEM_RAM_MIRROR_COUNT = RAM_MIRROR_END / RAM_SIZE,
+  FASTMEM_CODE_PAGES_PER_HOST_PAGE = FASTMEM_HOST_PAGE_SIZE / CPU_CODE_CACHE_PAGE_SIZE,
+};
+
 std::bitset<CPU_CODE_CACHE_PAGE_COUNT> m_ram_code_bits{};
-u8 g_ram[RAM_SIZE]{};   // 2MB RAM
-u8 g_bios[BIOS_SIZE]{}; // 512K BIOS ROM
+u8* g_ram = nullptr;        // 2MB RAM
+u8* g_scratchpad = nullptr; // 1KB scratchpad (data cache)
+u8 g_bios[BIOS_SIZE]{};     // 512K BIOS ROM
 
 static std::array<TickCount, 3> m_exp1_access_time = {};
 static std::array<TickCount, 3> m_exp2_access_time = {};
@@ -85,9 +102,27 @@ static u32 m_ram_size_reg = 0;
 
 static std::string m_tty_line_buffer;
 
+static Common::MemoryArena m_memory_arena;
+static u8* m_fastmem_base = nullptr;
+static u8* m_fastmem_isolated_base = nullptr;
+static std::vector<Common::MemoryArena::View> m_fastmem_views;
+#ifndef WIN32
+static std::vector<Common::MemoryArena::View> m_fastmem_reserved_views;
+#endif
+static bool m_fastmem_isolate_cache = false;
+
+// KUSEG and KSEG0 are cached, and are affected by cache isolation. KSEG1 is not.
+static constexpr std::array<u32, 2> FASTMEM_CACHED_SEGMENTS = {{0x00000000u, 0x80000000u}};
+static constexpr u32 FASTMEM_UNCACHED_SEGMENT = 0xA0000000u;
+
 static std::tuple<TickCount, TickCount, TickCount> CalculateMemoryTiming(MEMDELAY mem_delay, COMDELAY common_delay);
 static void RecalculateMemoryTimings();
 
+static bool AllocateMemory();
+static void ReleaseMemory();
+static u8* CreateFastmemRegion(bool writable);
+static void SetFastmemRAMPageProtection(u32 host_page_offset);
+
 #define FIXUP_WORD_READ_OFFSET(offset) ((offset) & ~u32(3))
 #define FIXUP_WORD_READ_VALUE(offset, value) ((value) >> (((offset)&u32(3)) * 8u))
 #define FIXUP_HALFWORD_READ_OFFSET(offset) ((offset) & ~u32(1))
@@ -103,19 +138,275 @@ ALWAYS_INLINE static void FixupUnalignedWordAccessW32(u32& offset, u32& value)
   value <<= byte_offset * 8;
 }
 
-void Initialize()
+bool Initialize()
 {
+  if (!AllocateMemory())
+    return false;
+
   Reset();
+  return true;
 }
 
 void Shutdown()
 {
-  //
+  UpdateFastmemViews(false, false);
+  ReleaseMemory();
+}
+
+bool AllocateMemory()
+{
+  if (!m_memory_arena.Create(MEMORY_ARENA_SIZE, true, false))
+  {
+    Log_ErrorPrint("Failed to create memory arena");
+    return false;
+  }
+
+  // Create the base views.
+  u8* base = static_cast<u8*>(m_memory_arena.CreateViewPtr(0, MEMORY_ARENA_SIZE, true, false));
+  if (!base)
+  {
+    Log_ErrorPrint("Failed to create base views of memory");
+    m_memory_arena.Destroy();
+    return false;
+  }
+
+  g_ram = base + MEMORY_ARENA_RAM_OFFSET;
+  g_scratchpad = base + MEMORY_ARENA_SCRATCHPAD_OFFSET;
+  Log_InfoPrintf("RAM is mapped at %p, scratchpad at %p", g_ram, g_scratchpad);
+  return true;
+}
+
+void ReleaseMemory()
+{
+  if (g_ram)
+  {
+    m_memory_arena.ReleaseViewPtr(g_ram - MEMORY_ARENA_RAM_OFFSET, MEMORY_ARENA_SIZE);
+    g_ram = nullptr;
+    g_scratchpad = nullptr;
+  }
+
+  m_memory_arena.Destroy();
+}
+
+u8* GetFastmemBase()
+{
+  return m_fastmem_isolate_cache ? m_fastmem_isolated_base : m_fastmem_base;
+}
+
+void UpdateFastmemViews(bool enabled, bool isolate_cache)
+{
+  if (!enabled)
+  {
+    m_fastmem_views.clear();
+#ifndef WIN32
+    m_fastmem_reserved_views.clear();
+#endif
+    m_fastmem_base = nullptr;
+    m_fastmem_isolated_base = nullptr;
+    return;
+  }
+
+  // Toggling cache isolation only switches regions, so it doesn't touch the page protection.
+  m_fastmem_isolate_cache = isolate_cache;
+  if (m_fastmem_base)
+    return;
+
+  Assert(g_ram);
+
+  if (Common::MemoryArena::GetHostPageSize() != FASTMEM_HOST_PAGE_SIZE)
+  {
+    Log_ErrorPrintf("Host page size (%zu) is not supported for fastmem", Common::MemoryArena::GetHostPageSize());
+    return;
+  }
+
+  // The isolated region is mapped read-only, so stores fault and take the slow path, which redirects them to the
+  // icache. Loads are unaffected.
+  m_fastmem_base = CreateFastmemRegion(true);
+  m_fastmem_isolated_base = m_fastmem_base ? CreateFastmemRegion(false) : nullptr;
+  if (!m_fastmem_isolated_base)
+  {
+    UpdateFastmemViews(false, false);
+    return;
+  }
+
+  Log_InfoPrintf("Fastmem base: %p, isolated cache base: %p", m_fastmem_base, m_fastmem_isolated_base);
+
+  // Code pages must stay read-only.
+  for (u32 code_page = 0; code_page < CPU_CODE_CACHE_PAGE_COUNT; code_page += FASTMEM_CODE_PAGES_PER_HOST_PAGE)
+  {
+    for (u32 i = 0; i < FASTMEM_CODE_PAGES_PER_HOST_PAGE; i++)
+    {
+      if (m_ram_code_bits[code_page + i])
+      {
+        SetFastmemRAMPageProtection(code_page * CPU_CODE_CACHE_PAGE_SIZE);
+        break;
+      }
+    }
+  }
+}
+
+u8* CreateFastmemRegion(bool writable)
+{
+#ifdef WIN32
+  // Windows can't map views into a reserved region, so we have to find a free area and hope nobody takes it.
+  u8* base = static_cast<u8*>(m_memory_arena.FindBaseAddressForMapping(FASTMEM_REGION_SIZE));
+#else
+  u8* base = nullptr;
+  std::optional<Common::MemoryArena::View> reserved_view = m_memory_arena.CreateReservedView(FASTMEM_REGION_SIZE);
+  if (reserved_view.has_value())
+  {
+    base = static_cast<u8*>(reserved_view->GetBasePointer());
+    m_fastmem_reserved_views.push_back(std::move(reserved_view.value()));
+  }
+#endif
+  if (!base)
+  {
+    Log_ErrorPrint("Failed to find base address for fastmem");
+    return nullptr;
+  }
+
+  auto MapView = [base, writable](u32 arena_offset, u32 size, u32 address) {
+    u8* map_address = base + address;
+    auto view = m_memory_arena.CreateView(arena_offset, size, writable, false, map_address);
+    if (!view)
+    {
+      Log_ErrorPrintf("Failed to map 0x%08X at fastmem area %p", address, map_address);
+      return false;
+    }
+
+    m_fastmem_views.push_back(std::move(view.value()));
+    return true;
+  };
+
+  bool result = true;
+  for (u32 mirror = 0; mirror < FASTMEM_RAM_MIRROR_COUNT; mirror++)
+  {
+    const u32 mirror_address = RAM_BASE + (mirror * RAM_SIZE);
+    for (const u32 segment : FASTMEM_CACHED_SEGMENTS)
+      result &= MapView(MEMORY_ARENA_RAM_OFFSET, RAM_SIZE, segment | mirror_address);
+    result &= MapView(MEMORY_ARENA_RAM_OFFSET, RAM_SIZE, FASTMEM_UNCACHED_SEGMENT | mirror_address);
+  }
+
+  // The scratchpad is only accessible through the cached segments. The host page can't be split, so accesses to
+  // 0x1F800400-0x1F800FFF through a register hit the unused part of the page instead of raising a bus error. Accesses
+  // with a constant address in that range are rejected by CanUseFastmemForAddress() and take the slow path.
+  for (const u32 segment : FASTMEM_CACHED_SEGMENTS)
+    result &= MapView(MEMORY_ARENA_SCRATCHPAD_OFFSET, FASTMEM_HOST_PAGE_SIZE, segment | CPU::DCACHE_LOCATION);
+
+  return result ? base : nullptr;
+}
+
+bool CanUseFastmemForAddress(VirtualMemoryAddress address)
+{
+  const PhysicalMemoryAddress paddr = address & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
+
+  switch (address >> 29)
+  {
+    case 0x00: // KUSEG 0M-512M
+    case 0x04: // KSEG0 - physical memory cached
+      return (paddr < RAM_MIRROR_END) || ((paddr & CPU::DCACHE_LOCATION_MASK) == CPU::DCACHE_LOCATION);
+
+    case 0x05: // KSEG1 - physical memory uncached
+      return (paddr < RAM_MIRROR_END);
+
+    default:
+      return false;
+  }
+}
+
+const void* GetDirectReadPointer(VirtualMemoryAddress address, u32 size, TickCount* read_ticks)
+{
+  // KUSEG, KSEG0 and KSEG1 only.
+  const u32 segment = address >> 29;
+  if ((address & (size - 1)) != 0 || (segment != 0x00 && segment != 0x04 && segment != 0x05))
+    return nullptr;
+
+  const PhysicalMemoryAddress paddr = address & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
+  if (segment != 0x05 && (paddr & CPU::DCACHE_LOCATION_MASK) == CPU::DCACHE_LOCATION)
+  {
+    *read_ticks = 0;
+    return &g_scratchpad[paddr & CPU::DCACHE_OFFSET_MASK];
+  }
+
+  if (paddr < RAM_MIRROR_END)
+  {
+    *read_ticks = RAM_READ_TICKS;
+    return &g_ram[paddr & RAM_MASK];
+  }
+
+  return nullptr;
+}
+
+void SetFastmemRAMPageProtection(u32 host_page_offset)
+{
+  // Only the writable region needs updating, everything in the isolated region is already read-only.
+  const u32 first_code_page = host_page_offset / CPU_CODE_CACHE_PAGE_SIZE;
+  bool is_code = false;
+  for (u32 i = 0; i < FASTMEM_CODE_PAGES_PER_HOST_PAGE; i++)
+    is_code |= m_ram_code_bits[first_code_page + i];
+
+  for (u32 mirror = 0; mirror < FASTMEM_RAM_MIRROR_COUNT; mirror++)
+  {
+    const u32 mirror_address = RAM_BASE + (mirror * RAM_SIZE) + host_page_offset;
+    for (const u32 segment : {FASTMEM_CACHED_SEGMENTS[0], FASTMEM_CACHED_SEGMENTS[1], FASTMEM_UNCACHED_SEGMENT})
+    {
+      if (!Common::MemoryArena::SetPageProtection(m_fastmem_base + (segment | mirror_address),
+                                                  FASTMEM_HOST_PAGE_SIZE, true, !is_code, false))
+      {
+        Log_ErrorPrintf("Failed to protect fastmem page 0x%08X", segment | mirror_address);
+      }
+    }
+  }
+}
+
+void SetRAMCodePage(u32 index)
+{
+  if (m_ram_code_bits[index])
+    return;
+
+  m_ram_code_bits[index] = true;
+  if (m_fastmem_base)
+    SetFastmemRAMPageProtection((index * CPU_CODE_CACHE_PAGE_SIZE) & ~(FASTMEM_HOST_PAGE_SIZE - 1));
+}
+
+void ClearRAMCodePage(u32 index)
+{
+  if (!m_ram_code_bits[index])
+    return;
+
+  m_ram_code_bits[index] = false;
+  if (m_fastmem_base)
+    SetFastmemRAMPageProtection((index * CPU_CODE_CACHE_PAGE_SIZE) & ~(FASTMEM_HOST_PAGE_SIZE - 1));
+}
+
+void ClearRAMCodePageFlags()
+{
+  if (!m_fastmem_base)
+  {
+    m_ram_code_bits.reset();
+    return;
+  }
+
+  // Only the pages which were previously code need their protection restored.
+  const std::bitset<CPU_CODE_CACHE_PAGE_COUNT> old_bits = m_ram_code_bits;
+  m_ram_code_bits.reset();
+  for (u32 code_page = 0; code_page < CPU_CODE_CACHE_PAGE_COUNT; code_page += FASTMEM_CODE_PAGES_PER_HOST_PAGE)
+  {
+    for (u32 i = 0; i < FASTMEM_CODE_PAGES_PER_HOST_PAGE; i++)
+    {
+      if (old_bits[code_page + i])
+      {
+        SetFastmemRAMPageProtection(code_page * CPU_CODE_CACHE_PAGE_SIZE);
+        break;
+      }
+    }
+  }
 }
 
 void Reset()
 {
-  std::memset(g_ram, 0, sizeof(g_ram));
+  std::memset(g_ram, 0, RAM_SIZE);
+  std::memset(g_scratchpad, 0, CPU::DCACHE_SIZE);
   m_MEMCTRL.exp1_base = 0x1F000000;
   m_MEMCTRL.exp2_base = 0x1F802000;
   m_MEMCTRL.exp1_delay_size.bits = 0x0013243F;
@@ -126,7 +417,7 @@ void Reset()
   m_MEMCTRL.exp2_delay_size.bits = 0x00070777;
   m_MEMCTRL.common_delay.bits = 0x00031125;
   m_ram_size_reg = UINT32_C(0x00000B88);
-  m_ram_code_bits = {};
+  ClearRAMCodePageFlags();
   RecalculateMemoryTimings();
 }
 
@@ -137,7 +428,33 @@ bool DoState(StateWrapper& sw)
   sw.Do(&m_bios_access_time);
   sw.Do(&m_cdrom_access_time);
   sw.Do(&m_spu_access_time);
-  sw.DoBytes(g_ram, sizeof(g_ram));
+
+  if (sw.IsReading() && m_ram_code_bits.any())
+  {
+    // The code cache wasn't flushed, so only invalidate blocks from pages which are different in the state.
+    std::array<u8, CPU_CODE_CACHE_PAGE_SIZE> page_data;
+    for (u32 page = 0; page < CPU_CODE_CACHE_PAGE_COUNT; page++)
+    {
+      u8* page_ptr = &g_ram[page * CPU_CODE_CACHE_PAGE_SIZE];
+      if (!m_ram_code_bits[page])
+      {
+        sw.DoBytes(page_ptr, CPU_CODE_CACHE_PAGE_SIZE);
+        continue;
+      }
+
+      sw.DoBytes(page_data.data(), CPU_CODE_CACHE_PAGE_SIZE);
+      if (std::memcmp(page_ptr, page_data.data(), CPU_CODE_CACHE_PAGE_SIZE) != 0)
+      {
+        CPU::CodeCache::InvalidateBlocksWithPageIndex(page);
+        std::memcpy(page_ptr, page_data.data(), CPU_CODE_CACHE_PAGE_SIZE);
+      }
+    }
+  }
+  else
+  {
+    sw.DoBytes(g_ram, RAM_SIZE);
+  }
+
   sw.DoBytes(g_bios, sizeof(g_bios));
   sw.DoArray(m_MEMCTRL.regs, countof(m_MEMCTRL.regs));
   sw.Do(&m_ram_size_reg);
@@ -288,7 +605,7 @@ ALWAYS_INLINE static TickCount DoRAMAccess(u32 offset, u32& value)
     }
   }
 
-  return (type == MemoryAccessType::Read) ? 4 : 0;
+  return (type == MemoryAccessType::Read) ? RAM_READ_TICKS : 0;
 }
 
 template<MemoryAccessType type, MemoryAccessSize size>
@@ -898,30 +1215,30 @@ ALWAYS_INLINE static TickCount DoScratchpadAccess(PhysicalMemoryAddress address,
   if constexpr (size == MemoryAccessSize::Byte)
   {
     if constexpr (type == MemoryAccessType::Read)
-      value = ZeroExtend32(g_state.dcache[cache_offset]);
+      value = ZeroExtend32(Bus::g_scratchpad[cache_offset]);
     else
-      g_state.dcache[cache_offset] = Truncate8(value);
+      Bus::g_scratchpad[cache_offset] = Truncate8(value);
   }
   else if constexpr (size == MemoryAccessSize::HalfWord)
   {
     if constexpr (type == MemoryAccessType::Read)
     {
       u16 temp;
-      std::memcpy(&temp, &g_state.dcache[cache_offset], sizeof(temp));
+      std::memcpy(&temp, &Bus::g_scratchpad[cache_offset], sizeof(temp));
       value = ZeroExtend32(temp);
     }
     else
     {
       u16 temp = Truncate16(value);
-      std::memcpy(&g_state.dcache[cache_offset], &temp, sizeof(temp));
+      std::memcpy(&Bus::g_scratchpad[cache_offset], &temp, sizeof(temp));
     }
   }
   else if constexpr (size == MemoryAccessSize::Word)
   {
     if constexpr (type == MemoryAccessType::Read)
-      std::memcpy(&value, &g_state.dcache[cache_offset], sizeof(value));
+      std::memcpy(&value, &Bus::g_scratchpad[cache_offset], sizeof(value));
     else
-      std::memcpy(&g_state.dcache[cache_offset], &value, sizeof(value));
+      std::memcpy(&Bus::g_scratchpad[cache_offset], &value, sizeof(value));
   }
 
   return 0;
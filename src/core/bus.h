@@ -63,10 +63,16 @@ enum : u32
 
 enum : u32
 {
-  MEMCTRL_REG_COUNT = 9
+  MEMCTRL_REG_COUNT = 9,
+  RAM_READ_TICKS = 4
 };
 
-void Initialize();
+enum : u64
+{
+  FASTMEM_REGION_SIZE = UINT64_C(0x100000000)
+};
+
+bool Initialize();
 void Shutdown();
 void Reset();
 bool DoState(StateWrapper& sw);
@@ -75,17 +81,33 @@ void SetExpansionROM(std::vector<u8> data);
 void SetBIOS(const std::vector<u8>& image);
 
 extern std::bitset<CPU_CODE_CACHE_PAGE_COUNT> m_ram_code_bits;
-extern u8 g_ram[RAM_SIZE];   // 2MB RAM
+extern u8* g_ram;            // 2MB RAM
+extern u8* g_scratchpad;     // 1KB scratchpad (data cache)
 extern u8 g_bios[BIOS_SIZE]; // 512K BIOS ROM
 
+/// Returns the base pointer of the fastmem region, or nullptr if fastmem is not active.
+u8* GetFastmemBase();
+
+/// Maps RAM and the scratchpad into the fastmem region, or releases the mappings when disabled. When the cache is
+/// isolated, GetFastmemBase() returns a second region where everything is mapped read-only, so stores fault and take
+/// the slow path.
+void UpdateFastmemViews(bool enabled, bool isolate_cache);
+
+/// Returns true if a load/store to the specified address can be serviced by the fastmem region.
+bool CanUseFastmemForAddress(VirtualMemoryAddress address);
+
+/// Returns a host pointer which an aligned load of the specified size can read from directly, bypassing the bus, along
+/// with the number of ticks the access takes. Returns nullptr if the address isn't in RAM or the scratchpad.
+const void* GetDirectReadPointer(VirtualMemoryAddress address, u32 size, TickCount* read_ticks);
+
 /// Flags a RAM region as code, so we know when to invalidate blocks.
-ALWAYS_INLINE void SetRAMCodePage(u32 index) { m_ram_code_bits[index] = true; }
+void SetRAMCodePage(u32 index);
 
 /// Unflags a RAM region as code, the code cache will no longer be notified when writes occur.
-ALWAYS_INLINE void ClearRAMCodePage(u32 index) { m_ram_code_bits[index] = false; }
+void ClearRAMCodePage(u32 index);
 
 /// Clears all code bits for RAM regions.
-ALWAYS_INLINE void ClearRAMCodePageFlags() { m_ram_code_bits.reset(); }
+void ClearRAMCodePageFlags();
 
 /// Returns the number of cycles stolen by DMA RAM access.
 ALWAYS_INLINE TickCount GetDMARAMTickCount(u32 word_count)
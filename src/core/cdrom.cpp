@@ -2,12 +2,14 @@
 #include "common/cd_image.h"
 #include "common/log.h"
 #include "common/state_wrapper.h"
+#include "common/trace.h"
 #include "dma.h"
 #include "game_list.h"
 #include "imgui.h"
 #include "interrupt_controller.h"
 #include "settings.h"
 #include "spu.h"
+#include "subsystem_timing.h"
 #include "system.h"
 Log_SetChannel(CDROM);
 
@@ -284,10 +286,18 @@ CDROM::~CDROM() = default;
 void CDROM::Initialize()
 {
   m_command_event =
-    TimingEvents::CreateTimingEvent("CDROM Command Event", 1, 1, std::bind(&CDROM::ExecuteCommand, this), false);
+    TimingEvents::CreateTimingEvent("CDROM Command Event", 1, 1,
+                                    [](void* param, TickCount ticks, TickCount ticks_late) {
+                                      static_cast<CDROM*>(param)->ExecuteCommand();
+                                    },
+                                    this, false);
   m_drive_event = TimingEvents::CreateTimingEvent("CDROM Drive Event", 1, 1,
-                                                  std::bind(&CDROM::ExecuteDrive, this, std::placeholders::_2), false);
+                                                  [](void* param, TickCount ticks, TickCount ticks_late) {
+                                                    static_cast<CDROM*>(param)->ExecuteDrive(ticks_late);
+                                                  },
+                                                  this, false);
 
+  m_reader.SetReadaheadSectors(g_settings.cdrom_readahead_sectors);
   if (g_settings.cdrom_read_thread)
     m_reader.StartThread();
 
@@ -509,6 +519,11 @@ void CDROM::SetUseReadThread(bool enabled)
     m_reader.StopThread();
 }
 
+void CDROM::SetReadaheadSectors(u32 count)
+{
+  m_reader.SetReadaheadSectors(count);
+}
+
 u8 CDROM::ReadRegister(u32 offset)
 {
   switch (offset)
@@ -710,6 +725,8 @@ void CDROM::WriteRegister(u32 offset, u8 value)
 
 void CDROM::DMARead(u32* words, u32 word_count)
 {
+  SubsystemTiming::ScopedTimer subsystem_timer(SubsystemTiming::Subsystem::CDROM);
+
   const u32 words_in_fifo = m_data_fifo.GetSize() / 4;
   if (words_in_fifo < word_count)
   {
@@ -934,6 +951,8 @@ void CDROM::AbortCommand()
 
 void CDROM::ExecuteCommand()
 {
+  SubsystemTiming::ScopedTimer subsystem_timer(SubsystemTiming::Subsystem::CDROM);
+
   const CommandInfo& ci = s_command_info[static_cast<u8>(m_command)];
   Log_DevPrintf("CDROM executing command 0x%02X (%s)", static_cast<u8>(m_command), ci.name);
   if (m_param_fifo.GetSize() < ci.expected_parameters)
@@ -1485,6 +1504,8 @@ void CDROM::UpdateCommandEvent()
 
 void CDROM::ExecuteDrive(TickCount ticks_late)
 {
+  SubsystemTiming::ScopedTimer subsystem_timer(SubsystemTiming::Subsystem::CDROM);
+
   switch (m_drive_state)
   {
     case DriveState::Resetting:
@@ -1581,7 +1602,7 @@ void CDROM::BeginPlaying(u8 track_bcd, TickCount ticks_late /* = 0 */, bool afte
     if (track_bcd > m_reader.GetMedia()->GetTrackCount())
     {
       // restart current track
-      track_bcd = BinaryToBCD(Truncate8(m_reader.GetMedia()->GetTrackNumber()));
+      track_bcd = BinaryToBCD(Truncate8(m_reader.GetLastReadTrackNumber()));
     }
 
     m_setloc_position = m_reader.GetMedia()->GetTrackStartMSFPosition(PackedBCDToBinary(track_bcd));
@@ -1910,6 +1931,8 @@ void CDROM::StopReadingWithDataEnd()
 
 void CDROM::DoSectorRead()
 {
+  TRACE_SCOPE("CDROM::DoSectorRead");
+
   if (!m_reader.WaitForReadToComplete())
     Panic("Sector read failed");
 
@@ -2357,18 +2380,37 @@ void CDROM::DrawDebugWindow()
   {
     if (m_reader.HasMedia())
     {
+      // the image position is wherever readahead got to, so use the track of the last sector returned
       const CDImage* media = m_reader.GetMedia();
+      const u32 track_number = m_reader.GetLastReadTrackNumber();
       const CDImage::Position disc_position = CDImage::Position::FromLBA(m_current_lba);
-      const CDImage::Position track_position = CDImage::Position::FromLBA(
-        m_current_lba - media->GetTrackStartPosition(static_cast<u8>(media->GetTrackNumber())));
+      const CDImage::Position track_position =
+        CDImage::Position::FromLBA(m_current_lba - media->GetTrackStartPosition(static_cast<u8>(track_number)));
 
       ImGui::Text("Filename: %s", media->GetFileName().c_str());
       ImGui::Text("Disc Position: MSF[%02u:%02u:%02u] LBA[%u]", disc_position.minute, disc_position.second,
                   disc_position.frame, disc_position.ToLBA());
-      ImGui::Text("Track Position: Number[%u] MSF[%02u:%02u:%02u] LBA[%u]", media->GetTrackNumber(),
+      ImGui::Text("Track Position: Number[%u] MSF[%02u:%02u:%02u] LBA[%u]", track_number,
                   track_position.minute, track_position.second, track_position.frame, track_position.ToLBA());
       ImGui::Text("Last Sector: %02X:%02X:%02X (Mode %u)", m_last_sector_header.minute, m_last_sector_header.second,
                   m_last_sector_header.frame, m_last_sector_header.sector_mode);
+
+      const CDROMAsyncReader::Stats& stats = m_reader.GetStats();
+      const u64 requests = stats.hits + stats.misses;
+      ImGui::Text("Readahead: %u sectors, Hits[%llu] Misses[%llu] (%.1f%% hit rate)", m_reader.GetReadaheadSectors(),
+                  static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses),
+                  (requests > 0) ? (static_cast<double>(stats.hits) * 100.0 / static_cast<double>(requests)) : 0.0);
+      ImGui::Text("Read Stalls: %llu (%.2f ms total)", static_cast<unsigned long long>(stats.stalls),
+                  stats.stall_time_ms);
+
+      const CDImage::CHDHunkCacheStats chd_stats = CDImage::GetCHDHunkCacheStats();
+      if (chd_stats.hits > 0 || chd_stats.misses > 0)
+      {
+        ImGui::Text("CHD Cache: %u hunks (%.1f MB), Hits[%llu] Misses[%llu] Prefetched[%llu]", chd_stats.hunk_count,
+                    static_cast<double>(chd_stats.size) / 1048576.0, static_cast<unsigned long long>(chd_stats.hits),
+                    static_cast<unsigned long long>(chd_stats.misses),
+                    static_cast<unsigned long long>(chd_stats.prefetches));
+      }
     }
     else
     {
@@ -40,6 +40,7 @@ public:
   void DrawDebugWindow();
 
   void SetUseReadThread(bool enabled);
+  void SetReadaheadSectors(u32 count);
 
   /// Reads a frame from the audio FIFO, used by the SPU.
   ALWAYS_INLINE std::tuple<s16, s16> GetAudioFrame()
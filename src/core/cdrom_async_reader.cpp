@@ -2,9 +2,15 @@
 #include "common/assert.h"
 #include "common/log.h"
 #include "common/timer.h"
+#include "common/trace.h"
+#include <algorithm>
 Log_SetChannel(CDROMAsyncReader);
 
-CDROMAsyncReader::CDROMAsyncReader() = default;
+CDROMAsyncReader::CDROMAsyncReader()
+{
+  m_buffers.resize(RECENT_SECTOR_COUNT);
+  InvalidateBuffers();
+}
 
 CDROMAsyncReader::~CDROMAsyncReader()
 {
@@ -16,7 +22,7 @@ void CDROMAsyncReader::StartThread()
   if (IsUsingThread())
     return;
 
-  m_shutdown_flag.store(false);
+  m_shutdown_flag = false;
   m_read_thread = std::thread(&CDROMAsyncReader::WorkerThreadEntryPoint, this);
 }
 
@@ -25,63 +31,120 @@ void CDROMAsyncReader::StopThread()
   if (!IsUsingThread())
     return;
 
+  WaitForReadToComplete();
+
   {
     std::unique_lock<std::mutex> lock(m_mutex);
-    if (m_sector_read_pending.load())
-      m_notify_read_complete_cv.wait(lock, [this]() { return !m_sector_read_pending.load(); });
-
-    m_shutdown_flag.store(true);
+    CancelReadahead(lock);
+    m_shutdown_flag = true;
     m_do_read_cv.notify_one();
   }
 
   m_read_thread.join();
 }
 
+void CDROMAsyncReader::SetReadaheadSectors(u32 count)
+{
+  count = std::min(count, MAX_READAHEAD_SECTORS);
+  if (m_readahead_sectors == count)
+    return;
+
+  WaitForReadToComplete();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  CancelReadahead(lock);
+
+  // the window has to fit alongside the recent sectors, otherwise readahead would evict the sector being returned
+  m_readahead_sectors = count;
+  m_buffers.resize(RECENT_SECTOR_COUNT + count);
+  InvalidateBuffers();
+}
+
 void CDROMAsyncReader::SetMedia(std::unique_ptr<CDImage> media)
 {
   WaitForReadToComplete();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  CancelReadahead(lock);
+  InvalidateBuffers();
   m_media = std::move(media);
+  if (m_media)
+    m_last_read_track_number = m_media->GetTrackNumber();
 }
 
 std::unique_ptr<CDImage> CDROMAsyncReader::RemoveMedia()
 {
   WaitForReadToComplete();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  CancelReadahead(lock);
+  InvalidateBuffers();
   return std::move(m_media);
 }
 
 void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
 {
-  if (!IsUsingThread())
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  // A new request replaces any outstanding one, the worker drops a result that's no longer wanted.
+  m_requested_sector = lba;
+  m_request_pending = false;
+
+  BufferedSector* buffer = LookupBuffer(lba);
+  if (buffer)
   {
-    m_sector_read_pending.store(true);
-    m_next_position_set.store(true);
-    m_next_position = lba;
-    DoSectorRead();
-    return;
+    m_stats.hits++;
+
+    // the CDC code re-requests the sector it just read when going from seeking to reading
+    if (m_last_read_sector != lba || !m_sector_read_result)
+      CompleteRequest(buffer);
   }
+  else
+  {
+    m_stats.misses++;
 
-  std::unique_lock<std::mutex> lock(m_mutex);
-  if (m_sector_read_pending.load())
-    m_notify_read_complete_cv.wait(lock, [this]() { return !m_sector_read_pending.load(); });
+    if (!IsUsingThread())
+    {
+      buffer = AllocateBuffer();
+      if (ReadSectorIntoBuffer(lba, buffer))
+      {
+        InsertBuffer(buffer, lba);
+        CompleteRequest(buffer);
+      }
+      else
+      {
+        m_sector_read_result = false;
+      }
 
-  // don't re-read the same sector if it was the last one we read
-  // the CDC code does this when seeking->reading
-  if (m_last_read_sector == lba && m_sector_read_result.load())
+      return;
+    }
+
+    m_request_pending = true;
+  }
+
+  if (IsUsingThread())
   {
-    Log_DebugPrintf("Skipping re-reading same sector %u", lba);
-    return;
+    m_readahead_position = lba + 1;
+    m_readahead_end = m_readahead_position + m_readahead_sectors;
+    m_do_read_cv.notify_one();
   }
+}
 
-  m_sector_read_pending.store(true);
-  m_next_position_set.store(true);
-  m_next_position = lba;
-  m_do_read_cv.notify_one();
+void CDROMAsyncReader::QueueReadNextSector()
+{
+  QueueReadSector(m_requested_sector + 1);
 }
 
 bool CDROMAsyncReader::ReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data)
 {
   WaitForReadToComplete();
 
+  // Holding the lock keeps the worker from starting another read while we're using the image. It'll seek back to
+  // where it was afterwards, so readahead carries on.
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_worker_busy)
+    m_notify_read_complete_cv.wait(lock, [this]() { return !m_worker_busy; });
+
   if (m_media->GetPositionOnDisc() != lba && !m_media->Seek(lba))
   {
     Log_WarningPrintf("Seek to LBA %u failed", lba);
@@ -97,88 +160,210 @@ bool CDROMAsyncReader::ReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ
   return true;
 }
 
-void CDROMAsyncReader::QueueReadNextSector()
-{
-  if (!IsUsingThread())
-  {
-    m_sector_read_pending.store(true);
-    DoSectorRead();
-    return;
-  }
-
-  std::unique_lock<std::mutex> lock(m_mutex);
-  if (m_sector_read_pending.load())
-    m_notify_read_complete_cv.wait(lock, [this]() { return !m_sector_read_pending.load(); });
-
-  m_sector_read_pending.store(true);
-  m_do_read_cv.notify_one();
-}
-
 bool CDROMAsyncReader::WaitForReadToComplete()
 {
   if (!IsUsingThread())
-    return m_sector_read_result.load();
+    return m_sector_read_result;
 
   std::unique_lock<std::mutex> lock(m_mutex);
-  if (m_sector_read_pending.load())
+  if (m_request_pending)
   {
     Log_DebugPrintf("Sector read pending, waiting");
 
     Common::Timer wait_timer;
-    m_notify_read_complete_cv.wait(lock, [this]() { return !m_sector_read_pending.load(); });
+    m_notify_read_complete_cv.wait(lock, [this]() { return !m_request_pending; });
 
     const double wait_time = wait_timer.GetTimeMilliseconds();
+    m_stats.stalls++;
+    m_stats.stall_time_ms += wait_time;
     if (wait_time > 1.0f)
-      Log_WarningPrintf("Had to wait %.2f msec for LBA %u", wait_time, m_last_read_sector);
+      Log_WarningPrintf("Had to wait %.2f msec for LBA %u", wait_time, m_requested_sector);
   }
 
-  return m_sector_read_result.load();
+  return m_sector_read_result;
 }
 
-void CDROMAsyncReader::DoSectorRead()
+CDROMAsyncReader::BufferedSector* CDROMAsyncReader::LookupBuffer(CDImage::LBA lba)
 {
-  Common::Timer timer;
+  for (BufferedSector& buffer : m_buffers)
+  {
+    if (buffer.valid && buffer.lba == lba)
+    {
+      buffer.last_use = ++m_buffer_use_counter;
+      return &buffer;
+    }
+  }
 
-  if (m_next_position_set.load())
+  return nullptr;
+}
+
+CDROMAsyncReader::BufferedSector* CDROMAsyncReader::AllocateBuffer()
+{
+  // Prefer free buffers, then the least recently used one outside the window we're currently reading.
+  BufferedSector* best = nullptr;
+  for (BufferedSector& buffer : m_buffers)
   {
-    if (m_media->GetPositionOnDisc() != m_next_position && !m_media->Seek(m_next_position))
+    if (!buffer.valid)
     {
-      Log_WarningPrintf("Seek to LBA %u failed", m_next_position);
-      m_sector_read_result.store(false);
-      return;
+      best = &buffer;
+      break;
     }
+
+    if (buffer.lba >= m_requested_sector && buffer.lba < m_readahead_end)
+      continue;
+
+    if (!best || buffer.last_use < best->last_use)
+      best = &buffer;
   }
 
-  CDImage::LBA pos = m_media->GetPositionOnDisc();
-  if (!m_media->ReadSubChannelQ(&m_subq) || !m_media->ReadRawSector(m_sector_buffer.data()))
+  // Everything is in the window, which only happens if the readahead count is larger than the buffer count.
+  if (!best)
   {
-    m_sector_read_result.store(false);
-    Log_WarningPrintf("Read of LBA %u failed", pos);
-    return;
+    best = &m_buffers[0];
+    for (BufferedSector& buffer : m_buffers)
+    {
+      if (buffer.last_use < best->last_use)
+        best = &buffer;
+    }
+  }
+
+  best->valid = false;
+  return best;
+}
+
+void CDROMAsyncReader::InsertBuffer(BufferedSector* buffer, CDImage::LBA lba)
+{
+  buffer->lba = lba;
+  buffer->last_use = ++m_buffer_use_counter;
+  buffer->valid = true;
+}
+
+void CDROMAsyncReader::InvalidateBuffers()
+{
+  for (BufferedSector& buffer : m_buffers)
+  {
+    buffer.valid = false;
+    buffer.last_use = 0;
+  }
+
+  m_buffer_use_counter = 0;
+}
+
+void CDROMAsyncReader::CompleteRequest(BufferedSector* buffer)
+{
+  m_last_read_sector = buffer->lba;
+  m_last_read_track_number = buffer->track_number;
+  m_subq = buffer->subq;
+  m_sector_buffer = buffer->data;
+  m_sector_read_result = true;
+  m_request_pending = false;
+}
+
+void CDROMAsyncReader::CancelReadahead(std::unique_lock<std::mutex>& lock)
+{
+  m_readahead_end = m_readahead_position;
+  if (m_worker_busy)
+    m_notify_read_complete_cv.wait(lock, [this]() { return !m_worker_busy; });
+}
+
+bool CDROMAsyncReader::ReadSectorIntoBuffer(CDImage::LBA lba, BufferedSector* buffer)
+{
+  TRACE_SCOPE("CDROMAsyncReader::ReadSector");
+  Common::Timer timer;
+
+  if (m_media->GetPositionOnDisc() != lba && !m_media->Seek(lba))
+  {
+    Log_WarningPrintf("Seek to LBA %u failed", lba);
+    return false;
   }
 
-  m_last_read_sector = pos;
-  m_sector_read_result.store(true);
+  buffer->track_number = m_media->GetTrackNumber();
+  if (!m_media->ReadSubChannelQ(&buffer->subq) || !m_media->ReadRawSector(buffer->data.data()))
+  {
+    Log_WarningPrintf("Read of LBA %u failed", lba);
+    return false;
+  }
 
   const double read_time = timer.GetTimeMilliseconds();
   if (read_time > 1.0f)
-    Log_DevPrintf("Read LBA %u took %.2f msec", pos, read_time);
+    Log_DevPrintf("Read LBA %u took %.2f msec", lba, read_time);
+
+  return true;
 }
 
 void CDROMAsyncReader::WorkerThreadEntryPoint()
 {
+  TRACE_THREAD_NAME("CD-ROM Read Thread");
+
   std::unique_lock lock(m_mutex);
 
-  while (!m_shutdown_flag.load())
+  while (!m_shutdown_flag)
   {
-    m_do_read_cv.wait(lock, [this]() { return (m_shutdown_flag.load() || m_sector_read_pending.load()); });
-    if (m_sector_read_pending.load())
+    CDImage::LBA lba;
+    if (m_request_pending)
+    {
+      // readahead may have got there first
+      BufferedSector* buffer = LookupBuffer(m_requested_sector);
+      if (buffer)
+      {
+        CompleteRequest(buffer);
+        m_notify_read_complete_cv.notify_all();
+        continue;
+      }
+
+      lba = m_requested_sector;
+    }
+    else if (m_readahead_position < m_readahead_end)
+    {
+      if (LookupBuffer(m_readahead_position))
+      {
+        m_readahead_position++;
+        continue;
+      }
+
+      lba = m_readahead_position;
+    }
+    else
+    {
+      m_do_read_cv.wait(lock, [this]() {
+        return (m_shutdown_flag || m_request_pending || m_readahead_position < m_readahead_end);
+      });
+      continue;
+    }
+
+    BufferedSector* buffer = AllocateBuffer();
+    m_worker_busy = true;
+    lock.unlock();
+
+    const bool result = ReadSectorIntoBuffer(lba, buffer);
+
+    lock.lock();
+    m_worker_busy = false;
+    if (result)
+      InsertBuffer(buffer, lba);
+
+    if (m_request_pending && m_requested_sector == lba)
     {
-      lock.unlock();
-      DoSectorRead();
-      lock.lock();
-      m_sector_read_pending.store(false);
-      m_notify_read_complete_cv.notify_one();
+      if (result)
+      {
+        CompleteRequest(buffer);
+      }
+      else
+      {
+        m_sector_read_result = false;
+        m_request_pending = false;
+      }
     }
+
+    if (lba == m_readahead_position)
+    {
+      // stop at the end of the disc or on errors rather than retrying
+      if (result)
+        m_readahead_position++;
+      else
+        m_readahead_end = m_readahead_position;
+    }
+
+    m_notify_read_complete_cv.notify_all();
   }
 }
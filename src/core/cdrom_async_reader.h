@@ -2,19 +2,33 @@
 #include "common/cd_image.h"
 #include "types.h"
 #include <array>
-#include <atomic>
 #include <condition_variable>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 class CDROMAsyncReader
 {
 public:
   using SectorBuffer = std::array<u8, CDImage::RAW_SECTOR_SIZE>;
 
+  /// Recently-read sectors kept in addition to the read-ahead window, so seeking back doesn't hit the image.
+  static constexpr u32 RECENT_SECTOR_COUNT = 16;
+  static constexpr u32 MAX_READAHEAD_SECTORS = 64;
+
+  struct Stats
+  {
+    u64 hits = 0;   // requested sector was already buffered
+    u64 misses = 0; // requested sector had to be read on demand
+    u64 stalls = 0; // the caller had to wait for a read to finish
+    double stall_time_ms = 0.0;
+  };
+
   CDROMAsyncReader();
   ~CDROMAsyncReader();
 
   const CDImage::LBA GetLastReadSector() const { return m_last_read_sector; }
+  const u32 GetLastReadTrackNumber() const { return m_last_read_track_number; }
   const SectorBuffer& GetSectorBuffer() const { return m_sector_buffer; }
   const CDImage::SubChannelQ& GetSectorSubQ() const { return m_subq; }
   const bool HasMedia() const { return static_cast<bool>(m_media); }
@@ -25,6 +39,12 @@ public:
   void StartThread();
   void StopThread();
 
+  u32 GetReadaheadSectors() const { return m_readahead_sectors; }
+  void SetReadaheadSectors(u32 count);
+
+  const Stats& GetStats() const { return m_stats; }
+  void ResetStats() { m_stats = {}; }
+
   void SetMedia(std::unique_ptr<CDImage> media);
   std::unique_ptr<CDImage> RemoveMedia();
 
@@ -37,7 +57,23 @@ public:
   bool ReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data);
 
 private:
-  void DoSectorRead();
+  struct BufferedSector
+  {
+    CDImage::LBA lba;
+    u32 track_number;
+    u64 last_use;
+    bool valid;
+    CDImage::SubChannelQ subq;
+    SectorBuffer data;
+  };
+
+  BufferedSector* LookupBuffer(CDImage::LBA lba);
+  BufferedSector* AllocateBuffer();
+  void InsertBuffer(BufferedSector* buffer, CDImage::LBA lba);
+  void InvalidateBuffers();
+  void CompleteRequest(BufferedSector* buffer);
+  void CancelReadahead(std::unique_lock<std::mutex>& lock);
+  bool ReadSectorIntoBuffer(CDImage::LBA lba, BufferedSector* buffer);
   void WorkerThreadEntryPoint();
 
   std::unique_ptr<CDImage> m_media;
@@ -47,13 +83,26 @@ private:
   std::condition_variable m_do_read_cv;
   std::condition_variable m_notify_read_complete_cv;
 
-  CDImage::LBA m_next_position{};
-  std::atomic_bool m_next_position_set{false};
-  std::atomic_bool m_sector_read_pending{false};
-  std::atomic_bool m_shutdown_flag{true};
+  // Everything below is protected by m_mutex while the thread is running. The worker only touches m_media while
+  // m_worker_busy is set, and the buffer it is reading into is marked invalid until the read completes.
+  std::vector<BufferedSector> m_buffers;
+  u64 m_buffer_use_counter = 0;
+  u32 m_readahead_sectors = 0;
+
+  CDImage::LBA m_requested_sector{};
+  CDImage::LBA m_readahead_position{};
+  CDImage::LBA m_readahead_end{};
+  bool m_request_pending = false;
+  bool m_worker_busy = false;
+  bool m_shutdown_flag = true;
 
+  // Result of the last request, read by the caller after WaitForReadToComplete().
   CDImage::LBA m_last_read_sector{};
+  u32 m_last_read_track_number = 0;
   CDImage::SubChannelQ m_subq{};
   SectorBuffer m_sector_buffer{};
-  std::atomic_bool m_sector_read_result{false};
+  bool m_sector_read_result = false;
+
+  // Only updated from the caller's thread.
+  Stats m_stats;
 };
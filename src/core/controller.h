@@ -39,6 +39,9 @@ public:
   virtual void Reset();
   virtual bool DoState(StateWrapper& sw);
 
+  /// Saves/loads only the input set by the host, which run-ahead keeps when it rolls back the rest of the state.
+  virtual bool DoInputState(StateWrapper& sw);
+
   // Resets all state for the transferring to/from the device.
   virtual void ResetTransferState();
 
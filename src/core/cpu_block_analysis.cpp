@@ -0,0 +1,481 @@
+#include "cpu_block_analysis.h"
+#include "common/assert.h"
+#include "common/bitutils.h"
+#include <array>
+
+namespace CPU {
+
+// Liveness covers the GPRs and hi/lo. pc/npc are handled separately by the recompiler.
+static constexpr u64 ALL_REGISTERS = (GetRegisterMask(Reg::lo) << 1) - 1;
+
+namespace {
+struct RegisterUsage
+{
+  u64 reads;
+  u64 writes;         // written by the instruction itself
+  u64 delayed_writes; // written at the end of the next instruction, i.e. loads
+};
+
+struct ConstantState
+{
+  std::array<u32, 32> values;
+  u32 known; // bit per GPR
+};
+} // namespace
+
+/// Returns false if the instruction's register usage isn't known, in which case it has to be assumed to read and write
+/// every register.
+static bool GetRegisterUsage(const Instruction& instruction, RegisterUsage* usage)
+{
+  *usage = {};
+
+  const u64 rs = GetRegisterMask(instruction.i.rs);
+  const u64 rt = GetRegisterMask(instruction.i.rt);
+  const u64 rd = GetRegisterMask(instruction.r.rd);
+  const u64 hilo = GetRegisterMask(Reg::hi) | GetRegisterMask(Reg::lo);
+
+  switch (instruction.op)
+  {
+    case InstructionOp::funct:
+    {
+      switch (instruction.r.funct)
+      {
+        case InstructionFunct::sll:
+        case InstructionFunct::srl:
+        case InstructionFunct::sra:
+          usage->reads = rt;
+          usage->writes = rd;
+          break;
+
+        case InstructionFunct::sllv:
+        case InstructionFunct::srlv:
+        case InstructionFunct::srav:
+        case InstructionFunct::add:
+        case InstructionFunct::addu:
+        case InstructionFunct::sub:
+        case InstructionFunct::subu:
+        case InstructionFunct::and_:
+        case InstructionFunct::or_:
+        case InstructionFunct::xor_:
+        case InstructionFunct::nor:
+        case InstructionFunct::slt:
+        case InstructionFunct::sltu:
+          usage->reads = rs | rt;
+          usage->writes = rd;
+          break;
+
+        case InstructionFunct::jr:
+          usage->reads = rs;
+          break;
+
+        case InstructionFunct::jalr:
+          usage->reads = rs;
+          usage->writes = rd;
+          break;
+
+        case InstructionFunct::syscall:
+        case InstructionFunct::break_:
+          break;
+
+        case InstructionFunct::mfhi:
+          usage->reads = GetRegisterMask(Reg::hi);
+          usage->writes = rd;
+          break;
+
+        case InstructionFunct::mflo:
+          usage->reads = GetRegisterMask(Reg::lo);
+          usage->writes = rd;
+          break;
+
+        case InstructionFunct::mthi:
+          usage->reads = rs;
+          usage->writes = GetRegisterMask(Reg::hi);
+          break;
+
+        case InstructionFunct::mtlo:
+          usage->reads = rs;
+          usage->writes = GetRegisterMask(Reg::lo);
+          break;
+
+        case InstructionFunct::mult:
+        case InstructionFunct::multu:
+        case InstructionFunct::div:
+        case InstructionFunct::divu:
+          usage->reads = rs | rt;
+          usage->writes = hilo;
+          break;
+
+        default:
+          return false;
+      }
+    }
+    break;
+
+    case InstructionOp::b:
+    {
+      // bltzal/bgezal link even when the branch isn't taken
+      usage->reads = rs;
+      if ((static_cast<u8>(instruction.i.rt.GetValue()) & u8(0x1E)) == u8(0x10))
+        usage->writes = GetRegisterMask(Reg::ra);
+    }
+    break;
+
+    case InstructionOp::j:
+      break;
+
+    case InstructionOp::jal:
+      usage->writes = GetRegisterMask(Reg::ra);
+      break;
+
+    case InstructionOp::beq:
+    case InstructionOp::bne:
+      usage->reads = rs | rt;
+      break;
+
+    case InstructionOp::blez:
+    case InstructionOp::bgtz:
+      usage->reads = rs;
+      break;
+
+    case InstructionOp::addi:
+    case InstructionOp::addiu:
+    case InstructionOp::slti:
+    case InstructionOp::sltiu:
+    case InstructionOp::andi:
+    case InstructionOp::ori:
+    case InstructionOp::xori:
+      usage->reads = rs;
+      usage->writes = rt;
+      break;
+
+    case InstructionOp::lui:
+      usage->writes = rt;
+      break;
+
+    case InstructionOp::lb:
+    case InstructionOp::lh:
+    case InstructionOp::lw:
+    case InstructionOp::lbu:
+    case InstructionOp::lhu:
+      usage->reads = rs;
+      usage->delayed_writes = rt;
+      break;
+
+    case InstructionOp::lwl:
+    case InstructionOp::lwr:
+      // merges with the existing value
+      usage->reads = rs | rt;
+      usage->delayed_writes = rt;
+      break;
+
+    case InstructionOp::sb:
+    case InstructionOp::sh:
+    case InstructionOp::sw:
+    case InstructionOp::swl:
+    case InstructionOp::swr:
+      usage->reads = rs | rt;
+      break;
+
+    case InstructionOp::lwc2:
+    case InstructionOp::swc2:
+      usage->reads = rs;
+      break;
+
+    case InstructionOp::cop0:
+    case InstructionOp::cop2:
+    {
+      // rfe and the GTE commands don't touch the GPRs
+      if (!instruction.cop.IsCommonInstruction())
+        break;
+
+      switch (instruction.cop.CommonOp())
+      {
+        case CopCommonInstruction::mfcn:
+        case CopCommonInstruction::cfcn:
+          usage->delayed_writes = rt;
+          break;
+
+        case CopCommonInstruction::mtcn:
+        case CopCommonInstruction::ctcn:
+          usage->reads = rt;
+          break;
+
+        default:
+          return false;
+      }
+    }
+    break;
+
+    default:
+      return false;
+  }
+
+  // writes to $zero are discarded
+  usage->writes &= ~GetRegisterMask(Reg::zero);
+  usage->delayed_writes &= ~GetRegisterMask(Reg::zero);
+  return true;
+}
+
+/// Returns true if the instruction can leave the block with the register file visible to the rest of the system,
+/// i.e. by raising an exception, or dispatching an interrupt.
+static bool CanObserveRegisters(const CodeBlockInstruction& cbi, bool memory_exceptions)
+{
+  // mtc0/rfe can unmask a pending interrupt, which is dispatched straight away
+  if (cbi.instruction.op == InstructionOp::cop0)
+    return true;
+
+  if (!cbi.can_trap)
+    return false;
+
+  switch (cbi.instruction.op)
+  {
+    // these are compiled, and only check for exceptions when asked to
+    case InstructionOp::lb:
+    case InstructionOp::lbu:
+    case InstructionOp::lh:
+    case InstructionOp::lhu:
+    case InstructionOp::lw:
+    case InstructionOp::sb:
+    case InstructionOp::sh:
+    case InstructionOp::sw:
+      return memory_exceptions;
+
+    default:
+      return true;
+  }
+}
+
+/// Returns the address accessed by a load/store instruction, if its base register is known.
+static bool GetKnownAddress(const Instruction& instruction, const ConstantState& cs, u32* address)
+{
+  switch (instruction.op)
+  {
+    case InstructionOp::lb:
+    case InstructionOp::lh:
+    case InstructionOp::lwl:
+    case InstructionOp::lw:
+    case InstructionOp::lbu:
+    case InstructionOp::lhu:
+    case InstructionOp::lwr:
+    case InstructionOp::sb:
+    case InstructionOp::sh:
+    case InstructionOp::swl:
+    case InstructionOp::sw:
+    case InstructionOp::swr:
+    case InstructionOp::lwc2:
+    case InstructionOp::swc2:
+      break;
+
+    default:
+      return false;
+  }
+
+  const u8 rs = static_cast<u8>(instruction.i.rs.GetValue());
+  if (!(cs.known & (1u << rs)))
+    return false;
+
+  *address = cs.values[rs] + instruction.i.imm_sext32();
+  return true;
+}
+
+/// Evaluates the value the instruction writes to its destination register, if all of its inputs are known.
+static bool EvaluateConstant(const CodeBlockInstruction& cbi, const ConstantState& cs, u32* value)
+{
+  const Instruction instruction = cbi.instruction;
+  const u8 rs_index = static_cast<u8>(instruction.i.rs.GetValue());
+  const u8 rt_index = static_cast<u8>(instruction.i.rt.GetValue());
+  const bool rs_known = (cs.known & (1u << rs_index)) != 0;
+  const bool rt_known = (cs.known & (1u << rt_index)) != 0;
+  const u32 rs = cs.values[rs_index];
+  const u32 rt = cs.values[rt_index];
+
+  switch (instruction.op)
+  {
+    case InstructionOp::lui:
+      *value = instruction.i.imm_zext32() << 16;
+      return true;
+
+    case InstructionOp::addiu:
+      *value = rs + instruction.i.imm_sext32();
+      return rs_known;
+
+    case InstructionOp::addi:
+    {
+      // overflow raises an exception and leaves the register alone
+      const u32 imm = instruction.i.imm_sext32();
+      *value = rs + imm;
+      return rs_known && (((rs ^ *value) & (imm ^ *value)) & UINT32_C(0x80000000)) == 0;
+    }
+
+    case InstructionOp::slti:
+      *value = BoolToUInt32(static_cast<s32>(rs) < static_cast<s32>(instruction.i.imm_sext32()));
+      return rs_known;
+
+    case InstructionOp::sltiu:
+      *value = BoolToUInt32(rs < instruction.i.imm_sext32());
+      return rs_known;
+
+    case InstructionOp::andi:
+      *value = rs & instruction.i.imm_zext32();
+      return rs_known;
+
+    case InstructionOp::ori:
+      *value = rs | instruction.i.imm_zext32();
+      return rs_known;
+
+    case InstructionOp::xori:
+      *value = rs ^ instruction.i.imm_zext32();
+      return rs_known;
+
+    case InstructionOp::b:
+    case InstructionOp::jal:
+      *value = cbi.pc + 8;
+      return true;
+
+    case InstructionOp::funct:
+    {
+      switch (instruction.r.funct)
+      {
+        case InstructionFunct::sll:
+          *value = rt << instruction.r.shamt;
+          return rt_known;
+
+        case InstructionFunct::srl:
+          *value = rt >> instruction.r.shamt;
+          return rt_known;
+
+        case InstructionFunct::sra:
+          *value = static_cast<u32>(static_cast<s32>(rt) >> instruction.r.shamt);
+          return rt_known;
+
+        case InstructionFunct::sllv:
+          *value = rt << (rs & 31u);
+          return rs_known && rt_known;
+
+        case InstructionFunct::srlv:
+          *value = rt >> (rs & 31u);
+          return rs_known && rt_known;
+
+        case InstructionFunct::srav:
+          *value = static_cast<u32>(static_cast<s32>(rt) >> (rs & 31u));
+          return rs_known && rt_known;
+
+        case InstructionFunct::jalr:
+          *value = cbi.pc + 8;
+          return true;
+
+        case InstructionFunct::add:
+          *value = rs + rt;
+          return rs_known && rt_known && (((rs ^ *value) & (rt ^ *value)) & UINT32_C(0x80000000)) == 0;
+
+        case InstructionFunct::addu:
+          *value = rs + rt;
+          return rs_known && rt_known;
+
+        case InstructionFunct::sub:
+          *value = rs - rt;
+          return rs_known && rt_known && (((rs ^ rt) & (rs ^ *value)) & UINT32_C(0x80000000)) == 0;
+
+        case InstructionFunct::subu:
+          *value = rs - rt;
+          return rs_known && rt_known;
+
+        case InstructionFunct::and_:
+          *value = rs & rt;
+          return rs_known && rt_known;
+
+        case InstructionFunct::or_:
+          *value = rs | rt;
+          return rs_known && rt_known;
+
+        case InstructionFunct::xor_:
+          *value = rs ^ rt;
+          return rs_known && rt_known;
+
+        case InstructionFunct::nor:
+          *value = ~(rs | rt);
+          return rs_known && rt_known;
+
+        case InstructionFunct::slt:
+          *value = BoolToUInt32(static_cast<s32>(rs) < static_cast<s32>(rt));
+          return rs_known && rt_known;
+
+        case InstructionFunct::sltu:
+          *value = BoolToUInt32(rs < rt);
+          return rs_known && rt_known;
+
+        default:
+          return false;
+      }
+    }
+
+    default:
+      return false;
+  }
+}
+
+void AnalyzeBlockInstructions(const CodeBlockInstruction* start, const CodeBlockInstruction* end, bool memory_exceptions,
+                              std::vector<InstructionAnalysis>* analysis)
+{
+  const u32 count = static_cast<u32>(end - start);
+  analysis->clear();
+  analysis->resize(count);
+
+  // Forward pass: constant propagation. Nothing is known on entry, except $zero.
+  ConstantState cs = {};
+  cs.known = 1u;
+  for (u32 i = 0; i < count; i++)
+  {
+    const CodeBlockInstruction& cbi = start[i];
+    InstructionAnalysis& ia = (*analysis)[i];
+    ia.has_known_address = GetKnownAddress(cbi.instruction, cs, &ia.known_address);
+
+    RegisterUsage usage;
+    if (!GetRegisterUsage(cbi.instruction, &usage))
+    {
+      cs.known = 1u;
+      continue;
+    }
+
+    // Loaded values aren't known. Forget about them now, since the old value is only visible to the delay slot.
+    cs.known &= ~static_cast<u32>(usage.delayed_writes);
+
+    const u32 written_gprs = static_cast<u32>(usage.writes);
+    if (written_gprs != 0)
+    {
+      DebugAssert((written_gprs & (written_gprs - 1)) == 0);
+      const u8 dest = static_cast<u8>(CountTrailingZeros(written_gprs));
+      u32 value;
+      if (EvaluateConstant(cbi, cs, &value))
+      {
+        cs.values[dest] = value;
+        cs.known |= written_gprs;
+      }
+      else
+      {
+        cs.known &= ~written_gprs;
+      }
+    }
+  }
+
+  // Backward pass: liveness. Everything is live when the block exits. Delayed writes don't count as overwriting the
+  // register, since they can be cancelled by another load.
+  u64 live = ALL_REGISTERS;
+  for (u32 i = count; i > 0; i--)
+  {
+    const CodeBlockInstruction& cbi = start[i - 1];
+    InstructionAnalysis& ia = (*analysis)[i - 1];
+    const u64 live_after = live;
+
+    RegisterUsage usage;
+    if (!GetRegisterUsage(cbi.instruction, &usage) || CanObserveRegisters(cbi, memory_exceptions))
+      live = ALL_REGISTERS;
+    else
+      live = (live & ~usage.writes) | usage.reads;
+
+    // The register cache can hold either the value from before or after the instruction, both have to be dead.
+    ia.dead_registers = ALL_REGISTERS & ~(live | live_after | GetRegisterMask(Reg::zero));
+  }
+}
+
+} // namespace CPU
@@ -0,0 +1,27 @@
+#pragma once
+#include "cpu_code_cache.h"
+#include "cpu_types.h"
+#include <vector>
+
+namespace CPU {
+
+struct InstructionAnalysis
+{
+  u64 dead_registers;     // registers (by GetRegisterMask()) whose values are overwritten before they're read again
+  u32 known_address;      // address accessed by the load/store, if has_known_address is set
+  bool has_known_address; // the load/store's base register is a constant at this point in the block
+};
+
+/// Returns the bit for the register in InstructionAnalysis::dead_registers.
+constexpr u64 GetRegisterMask(Reg reg)
+{
+  return UINT64_C(1) << static_cast<u8>(reg);
+}
+
+/// Runs constant propagation and register liveness over a block's instructions, filling in one entry per instruction.
+/// Registers are only dead if no later instruction in the block can observe them, either by reading them or by raising
+/// an exception. When memory_exceptions is false, loads and stores are assumed not to raise exceptions.
+void AnalyzeBlockInstructions(const CodeBlockInstruction* start, const CodeBlockInstruction* end, bool memory_exceptions,
+                              std::vector<InstructionAnalysis>* analysis);
+
+} // namespace CPU
@@ -2,11 +2,15 @@
 #include "bus.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "common/page_fault_handler.h"
+#include "common/page_table.h"
+#include "common/trace.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "cpu_disasm.h"
 #include "system.h"
 #include "timing_event.h"
+#include <map>
 Log_SetChannel(CPU::CodeCache);
 
 #ifdef WITH_RECOMPILER
@@ -27,6 +31,10 @@ constexpr bool USE_BLOCK_LINKING = true;
 static constexpr u32 RECOMPILER_CODE_CACHE_SIZE = 32 * 1024 * 1024;
 static constexpr u32 RECOMPILER_FAR_CODE_CACHE_SIZE = 32 * 1024 * 1024;
 
+// Traces follow at most this many unconditional branches, and stop growing past this many instructions.
+static constexpr u32 RECOMPILER_TRACE_MAX_BRANCHES = 8;
+static constexpr u32 RECOMPILER_TRACE_MAX_INSTRUCTIONS = 256;
+
 #ifdef USE_STATIC_CODE_BUFFER
 static constexpr u32 RECOMPILER_GUARD_SIZE = 4096;
 alignas(Recompiler::CODE_STORAGE_ALIGNMENT) static u8
@@ -60,18 +68,64 @@ static void ResetFastMap()
 
 static void SetFastMap(u32 pc, CodeBlock::HostCodePointer function)
 {
-  s_fast_map[GetFastMapIndex(pc)] = function;
+  // Blocks without host code are still in the interpreter tier, and have to go through the lookup.
+  s_fast_map[GetFastMapIndex(pc)] = function ? function : FastCompileBlockFunction;
 }
 
+static bool s_use_fastmem = false;
+static u64 s_host_compile_count = 0;
+
+// Lookup of host code to blocks, for backpatching faulting fastmem loads/stores.
+using HostCodeMap = std::map<CodeBlock::HostCodePointer, CodeBlock*>;
+static HostCodeMap s_host_code_map;
+
+static void AddBlockToHostCodeMap(CodeBlock* block);
+static void RemoveBlockFromHostCodeMap(CodeBlock* block);
+
+/// Returns false if the code buffer may not have enough space left to compile the block.
+static bool HasCodeSpaceForBlock(const CodeBlock* block);
+
+/// Compiles an already-decoded block to host code.
+static bool CompileBlockHostCode(CodeBlock* block);
+
+/// Returns true if the block's code has changed so often that it's no longer worth compiling.
+static bool IsBlockDemoted(const CodeBlock* block);
+
+static bool InitializeFastmem();
+static void ShutdownFastmem();
+
+/// Patches the block's exits which are linked to target (or all exits, if target is null) back to their link stubs.
+static void UnlinkBlockExits(CodeBlock* block, CodeBlock* target);
+static Common::PageFaultHandler::HandlerResult PageFaultHandler(void* exception_pc, void* fault_address,
+                                                                 bool is_write);
+
 #endif
 
-using BlockMap = std::unordered_map<u32, CodeBlock*>;
+enum : u32
+{
+  // Blocks are looked up through a two-level table, indexed by the code region page and then the instruction.
+  // Each of KUSEG, KSEG0 and KSEG1 gets its own copy of the RAM mirrors, EXP1 and BIOS pages, and kernel/user mode
+  // blocks are kept separate. The 512MB aliases of KUSEG share entries, which is resolved by comparing the key.
+  BLOCK_TABLE_PAGE_SIZE = 4096,
+  BLOCK_TABLE_ENTRIES_PER_PAGE = BLOCK_TABLE_PAGE_SIZE / sizeof(Instruction),
+  BLOCK_TABLE_RAM_PAGES = Bus::RAM_MIRROR_END / BLOCK_TABLE_PAGE_SIZE,
+  BLOCK_TABLE_EXP1_PAGES = Bus::EXP1_SIZE / BLOCK_TABLE_PAGE_SIZE,
+  BLOCK_TABLE_BIOS_PAGES = Bus::BIOS_SIZE / BLOCK_TABLE_PAGE_SIZE,
+  BLOCK_TABLE_PAGES_PER_SEGMENT = BLOCK_TABLE_RAM_PAGES + BLOCK_TABLE_EXP1_PAGES + BLOCK_TABLE_BIOS_PAGES,
+  BLOCK_TABLE_SEGMENT_COUNT = 3,
+  BLOCK_TABLE_PAGE_COUNT = BLOCK_TABLE_PAGES_PER_SEGMENT * BLOCK_TABLE_SEGMENT_COUNT * 2,
+};
+
+using BlockTable = PageTable<CodeBlock*, BLOCK_TABLE_PAGE_COUNT, BLOCK_TABLE_ENTRIES_PER_PAGE>;
 
 void LogCurrentState();
 
 /// Returns the block key for the current execution state.
 static CodeBlockKey GetNextBlockKey();
 
+/// Returns the block table page and entry for the key, or false if blocks can't be cached at this address.
+static bool GetBlockTableIndex(CodeBlockKey key, u32* page, u32* entry);
+
 /// Looks up the block in the cache if it's already been compiled.
 static CodeBlock* LookupBlock(CodeBlockKey key);
 
@@ -80,10 +134,20 @@ static CodeBlock* LookupBlock(CodeBlockKey key);
 static bool RevalidateBlock(CodeBlock* block);
 
 static bool CompileBlock(CodeBlock* block);
+
+/// Returns the pc a trace continues at after the branch delay slot which was just decoded, or false if the block
+/// ends there.
+static bool GetTraceContinuePC(const CodeBlock* block, u32 trace_branches, u32* pc);
+
 static void FlushBlock(CodeBlock* block);
 static void AddBlockToPageMap(CodeBlock* block);
 static void RemoveBlockFromPageMap(CodeBlock* block);
 
+/// Calls callback(page_index) for each RAM code page the block's instructions are in. Traces cover several ranges of
+/// instructions which can share pages, in which case the page is passed more than once.
+template<typename Callback>
+static void EnumerateBlockPages(const CodeBlock* block, Callback callback);
+
 /// Link block from to to.
 static void LinkBlock(CodeBlock* from, CodeBlock* to);
 
@@ -91,15 +155,18 @@ static void LinkBlock(CodeBlock* from, CodeBlock* to);
 static void UnlinkBlock(CodeBlock* block);
 
 static bool s_use_recompiler = false;
-static BlockMap s_blocks;
+static u64 s_code_change_count = 0;
+static BlockTable s_blocks;
 static std::array<std::vector<CodeBlock*>, CPU_CODE_CACHE_PAGE_COUNT> m_ram_block_map;
 
-void Initialize(bool use_recompiler)
+void Initialize(bool use_recompiler, bool use_fastmem)
 {
-  Assert(s_blocks.empty());
+  Assert(s_blocks.GetAllocatedPageCount() == 0);
+  s_code_change_count = 0;
 
 #ifdef WITH_RECOMPILER
   s_use_recompiler = use_recompiler;
+  s_host_compile_count = 0;
 #ifdef USE_STATIC_CODE_BUFFER
   if (!s_code_buffer.Initialize(s_code_storage, sizeof(s_code_storage), RECOMPILER_FAR_CODE_CACHE_SIZE,
                                 RECOMPILER_GUARD_SIZE))
@@ -111,6 +178,13 @@ void Initialize(bool use_recompiler)
   }
 
   ResetFastMap();
+
+  if (use_recompiler && use_fastmem)
+  {
+    s_use_fastmem = InitializeFastmem();
+    if (!s_use_fastmem)
+      Log_WarningPrintf("Failed to initialize fastmem, falling back to slowmem.");
+  }
 #else
   s_use_recompiler = false;
 #endif
@@ -120,6 +194,12 @@ void Shutdown()
 {
   Flush();
 #ifdef WITH_RECOMPILER
+  if (s_use_fastmem)
+  {
+    ShutdownFastmem();
+    s_use_fastmem = false;
+  }
+
   s_code_buffer.Destroy();
 #endif
 }
@@ -268,27 +348,54 @@ void ExecuteRecompiler()
 
 #endif
 
-void SetUseRecompiler(bool enable)
+void SetUseRecompiler(bool enable, bool fastmem)
 {
 #ifdef WITH_RECOMPILER
-  if (s_use_recompiler == enable)
+  const bool use_fastmem = (enable && fastmem);
+  if (s_use_recompiler == enable && s_use_fastmem == use_fastmem)
     return;
 
   s_use_recompiler = enable;
   Flush();
+
+  if (s_use_fastmem && !use_fastmem)
+  {
+    ShutdownFastmem();
+    s_use_fastmem = false;
+  }
+  else if (!s_use_fastmem && use_fastmem)
+  {
+    s_use_fastmem = InitializeFastmem();
+    if (!s_use_fastmem)
+      Log_WarningPrintf("Failed to initialize fastmem, falling back to slowmem.");
+  }
+#endif
+}
+
+bool IsUsingFastmem()
+{
+#ifdef WITH_RECOMPILER
+  return s_use_fastmem;
+#else
+  return false;
 #endif
 }
 
 void Flush()
 {
+  TRACE_SCOPE("CodeCache::Flush");
+
   Bus::ClearRAMCodePageFlags();
   for (auto& it : m_ram_block_map)
     it.clear();
 
-  for (const auto& it : s_blocks)
-    delete it.second;
-  s_blocks.clear();
+  s_blocks.EnumeratePages([](u32 page_index, BlockTable::Page& page) {
+    for (CodeBlock* block : page)
+      delete block;
+  });
+  s_blocks.Clear();
 #ifdef WITH_RECOMPILER
+  s_host_code_map.clear();
   s_code_buffer.Reset();
   ResetFastMap();
 #endif
@@ -317,15 +424,71 @@ CodeBlockKey GetNextBlockKey()
   return key;
 }
 
+bool GetBlockTableIndex(CodeBlockKey key, u32* page, u32* entry)
+{
+  const u32 pc = key.GetPC();
+  u32 segment;
+  switch (pc >> 29)
+  {
+    case 0x00: // KUSEG 0M-512M
+    case 0x01: // KUSEG 512M-1024M
+    case 0x02: // KUSEG 1024M-1536M
+    case 0x03: // KUSEG 1536M-2048M
+      segment = 0;
+      break;
+
+    case 0x04: // KSEG0 - physical memory cached
+      segment = 1;
+      break;
+
+    case 0x05: // KSEG1 - physical memory uncached
+      segment = 2;
+      break;
+
+    default:
+      return false;
+  }
+
+  const PhysicalMemoryAddress paddr = key.GetPCPhysicalAddress();
+  u32 region_page;
+  if (paddr < Bus::RAM_MIRROR_END)
+    region_page = paddr / BLOCK_TABLE_PAGE_SIZE;
+  else if (paddr >= Bus::EXP1_BASE && paddr < (Bus::EXP1_BASE + Bus::EXP1_SIZE))
+    region_page = BLOCK_TABLE_RAM_PAGES + ((paddr - Bus::EXP1_BASE) / BLOCK_TABLE_PAGE_SIZE);
+  else if (paddr >= Bus::BIOS_BASE && paddr < (Bus::BIOS_BASE + Bus::BIOS_SIZE))
+    region_page = BLOCK_TABLE_RAM_PAGES + BLOCK_TABLE_EXP1_PAGES + ((paddr - Bus::BIOS_BASE) / BLOCK_TABLE_PAGE_SIZE);
+  else
+    return false;
+
+  const u32 mode = key.user_mode ? 1 : 0;
+  *page = (((mode * BLOCK_TABLE_SEGMENT_COUNT) + segment) * BLOCK_TABLE_PAGES_PER_SEGMENT) + region_page;
+  *entry = (paddr % BLOCK_TABLE_PAGE_SIZE) / sizeof(Instruction);
+  return true;
+}
+
 CodeBlock* LookupBlock(CodeBlockKey key)
 {
-  BlockMap::iterator iter = s_blocks.find(key.bits);
-  if (iter != s_blocks.end())
+  u32 table_page, table_entry;
+  if (!GetBlockTableIndex(key, &table_page, &table_entry))
+  {
+    Log_DevPrintf("Not caching block at uncacheable address 0x%08X", key.GetPC());
+    return nullptr;
+  }
+
+  CodeBlock* existing_block = s_blocks.Lookup(table_page, table_entry);
+  if (existing_block)
   {
     // ensure it hasn't been invalidated
-    CodeBlock* existing_block = iter->second;
-    if (!existing_block || !existing_block->invalidated || RevalidateBlock(existing_block))
-      return existing_block;
+    if (existing_block->key == key)
+    {
+      if (!existing_block->invalidated || RevalidateBlock(existing_block))
+        return existing_block;
+    }
+    else
+    {
+      // aliased KUSEG address, evict the old block
+      FlushBlock(existing_block);
+    }
   }
 
   CodeBlock* block = new CodeBlock(key);
@@ -342,10 +505,10 @@ CodeBlock* LookupBlock(CodeBlockKey key)
   {
     Log_ErrorPrintf("Failed to compile block at PC=0x%08X", key.GetPC());
     delete block;
-    block = nullptr;
+    return nullptr;
   }
 
-  iter = s_blocks.emplace(key.bits, block).first;
+  s_blocks.GetEntry(table_page, table_entry) = block;
   return block;
 }
 
@@ -372,7 +535,26 @@ bool RevalidateBlock(CodeBlock* block)
   return true;
 
 recompile:
+  block->recompile_count++;
+  block->execution_count = 0;
+  s_code_change_count++;
+
+#ifdef WITH_RECOMPILER
+  RemoveBlockFromHostCodeMap(block);
+  block->host_code = nullptr;
+  block->host_code_size = 0;
+  block->loadstore_backpatch_info.clear();
+  block->exit_links.clear();
+
+  if (IsBlockDemoted(block) && block->recompile_count == RECOMPILER_DEMOTE_RECOMPILE_COUNT)
+  {
+    Log_DevPrintf("Block 0x%08X changed %u times, keeping it in the interpreter.", block->GetPC(),
+                  block->recompile_count);
+  }
+#endif
+
   block->instructions.clear();
+  block->contains_loadstore_instructions = false;
   if (!CompileBlock(block))
   {
     Log_WarningPrintf("Failed to recompile block 0x%08X - flushing.", block->GetPC());
@@ -381,14 +563,18 @@ recompile:
   }
 
   // re-add to page map again
-  if (block->IsInRAM())
-    AddBlockToPageMap(block);
-
+  block->invalidated = false;
+  AddBlockToPageMap(block);
+#ifdef WITH_RECOMPILER
+  SetFastMap(block->GetPC(), block->host_code);
+#endif
   return true;
 }
 
 bool CompileBlock(CodeBlock* block)
 {
+  TRACE_SCOPE("CodeCache::CompileBlock");
+
   u32 pc = block->GetPC();
   bool is_branch_delay_slot = false;
   bool is_load_delay_slot = false;
@@ -399,6 +585,7 @@ bool CompileBlock(CodeBlock* block)
 #endif
 
   u32 last_cache_line = ICACHE_LINES;
+  u32 trace_branches = 0;
 
   for (;;)
   {
@@ -414,6 +601,7 @@ bool CompileBlock(CodeBlock* block)
     cbi.is_store_instruction = IsMemoryStoreInstruction(cbi.instruction);
     cbi.has_load_delay = InstructionHasLoadDelay(cbi.instruction);
     cbi.can_trap = CanInstructionTrap(cbi.instruction, InUserMode());
+    block->contains_loadstore_instructions |= (cbi.is_load_instruction || cbi.is_store_instruction);
 
     if (g_settings.cpu_recompiler_icache)
     {
@@ -433,8 +621,14 @@ bool CompileBlock(CodeBlock* block)
 
     // if we're in a branch delay slot, the block is now done
     // except if this is a branch in a branch delay slot, then we grab the one after that, and so on...
+    // traces carry on at the target if the branch is always taken
     if (is_branch_delay_slot && !cbi.is_branch_instruction)
-      break;
+    {
+      if (!GetTraceContinuePC(block, trace_branches, &pc))
+        break;
+
+      trace_branches++;
+    }
 
     // if this is a branch, we grab the next instruction (delay slot), and then exit
     is_branch_delay_slot = cbi.is_branch_instruction;
@@ -469,24 +663,18 @@ bool CompileBlock(CodeBlock* block)
   }
 
 #ifdef WITH_RECOMPILER
-  if (s_use_recompiler)
+  // With tiering, blocks start out interpreted, and are compiled by the dispatcher once they're hot.
+  if (s_use_recompiler && !g_settings.cpu_recompiler_tiering)
   {
     // Ensure we're not going to run out of space while compiling this block.
-    if (s_code_buffer.GetFreeCodeSpace() <
-          (block->instructions.size() * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION) ||
-        s_code_buffer.GetFreeFarCodeSpace() <
-          (block->instructions.size() * Recompiler::MAX_FAR_HOST_BYTES_PER_INSTRUCTION))
+    if (!HasCodeSpaceForBlock(block))
     {
       Log_WarningPrintf("Out of code space, flushing all blocks.");
       Flush();
     }
 
-    Recompiler::CodeGenerator codegen(&s_code_buffer);
-    if (!codegen.CompileBlock(block, &block->host_code, &block->host_code_size))
-    {
-      Log_ErrorPrintf("Failed to compile host code for block at 0x%08X", block->key.GetPC());
+    if (!CompileBlockHostCode(block))
       return false;
-    }
   }
 #endif
 
@@ -495,68 +683,255 @@ bool CompileBlock(CodeBlock* block)
 
 #ifdef WITH_RECOMPILER
 
+bool HasCodeSpaceForBlock(const CodeBlock* block)
+{
+  return (s_code_buffer.GetFreeCodeSpace() >=
+            (block->instructions.size() * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION) &&
+          s_code_buffer.GetFreeFarCodeSpace() >=
+            (block->instructions.size() * Recompiler::MAX_FAR_HOST_BYTES_PER_INSTRUCTION));
+}
+
+bool CompileBlockHostCode(CodeBlock* block)
+{
+  Recompiler::CodeGenerator codegen(&s_code_buffer);
+  if (!codegen.CompileBlock(block, &block->host_code, &block->host_code_size))
+  {
+    Log_ErrorPrintf("Failed to compile host code for block at 0x%08X", block->key.GetPC());
+    return false;
+  }
+
+  AddBlockToHostCodeMap(block);
+  s_host_compile_count++;
+  return true;
+}
+
+bool IsBlockDemoted(const CodeBlock* block)
+{
+  return (s_use_recompiler && g_settings.cpu_recompiler_tiering &&
+          block->recompile_count >= RECOMPILER_DEMOTE_RECOMPILE_COUNT);
+}
+
+#endif
+
+/// Returns true if the branch is always taken, and its target is known at compile time.
+static bool GetAlwaysTakenBranchTarget(const CodeBlockInstruction& cbi, u32* target)
+{
+  const Instruction& instruction = cbi.instruction;
+  switch (instruction.op)
+  {
+    case InstructionOp::j:
+    case InstructionOp::jal:
+      *target = ((cbi.pc + 4) & UINT32_C(0xF0000000)) | (instruction.j.target << 2);
+      return true;
+
+    case InstructionOp::beq:
+      // beq rs, rs is how assemblers encode an unconditional branch
+      if (instruction.i.rs.GetValue() != instruction.i.rt.GetValue())
+        return false;
+      break;
+
+    case InstructionOp::blez:
+      if (instruction.i.rs != Reg::zero)
+        return false;
+      break;
+
+    case InstructionOp::b:
+      // bgez/bgezal zero
+      if (instruction.i.rs != Reg::zero || (static_cast<u8>(instruction.i.rt.GetValue()) & u8(1)) == 0)
+        return false;
+      break;
+
+    default:
+      return false;
+  }
+
+  *target = cbi.pc + 4 + (instruction.i.imm_sext32() << 2);
+  return true;
+}
+
+bool GetTraceContinuePC(const CodeBlock* block, u32 trace_branches, u32* pc)
+{
+  // The recompiler's icache simulation assumes the block is contiguous.
+  if (!s_use_recompiler || !g_settings.cpu_recompiler_traces || g_settings.cpu_recompiler_icache ||
+      !block->IsInRAM() || trace_branches >= RECOMPILER_TRACE_MAX_BRANCHES ||
+      block->instructions.size() >= RECOMPILER_TRACE_MAX_INSTRUCTIONS)
+  {
+    return false;
+  }
+
+  const CodeBlockInstruction& branch = block->instructions[block->instructions.size() - 2];
+  u32 target;
+  if (branch.is_branch_delay_slot || !GetAlwaysTakenBranchTarget(branch, &target))
+    return false;
+
+  // Stay within RAM so page invalidation covers the whole trace.
+  if ((target & PHYSICAL_MEMORY_ADDRESS_MASK) >= Bus::RAM_SIZE)
+    return false;
+
+  // Loops back into the trace end it, the exit gets linked to the start instead.
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    if (cbi.pc == target)
+      return false;
+  }
+
+  *pc = target;
+  return true;
+}
+
+#ifdef WITH_RECOMPILER
+
 void FastCompileBlockFunction()
 {
   CodeBlock* block = LookupBlock(GetNextBlockKey());
-  if (block)
+  if (!block)
+  {
+    InterpretUncachedBlock();
+    return;
+  }
+
+  if (!block->host_code && !IsBlockDemoted(block) && ++block->execution_count >= RECOMPILER_TIER_UP_EXECUTION_COUNT)
+  {
+    if (!HasCodeSpaceForBlock(block))
+    {
+      // This deletes the block, the dispatcher will decode it again.
+      Log_WarningPrintf("Out of code space, flushing all blocks.");
+      Flush();
+      return;
+    }
+
+    if (!CompileBlockHostCode(block))
+    {
+      FlushBlock(block);
+      return;
+    }
+
+    SetFastMap(block->GetPC(), block->host_code);
+  }
+
+  if (block->host_code)
+  {
     block->host_code();
+    return;
+  }
+
+  if (g_settings.cpu_recompiler_icache)
+    CheckAndUpdateICacheTags(block->icache_line_count, block->uncached_fetch_ticks);
+
+  if (g_settings.gpu_pgxp_enable)
+  {
+    if (g_settings.gpu_pgxp_cpu)
+      InterpretCachedBlock<PGXPMode::CPU>(*block);
+    else
+      InterpretCachedBlock<PGXPMode::Memory>(*block);
+  }
   else
-    InterpretUncachedBlock();
+  {
+    InterpretCachedBlock<PGXPMode::Disabled>(*block);
+  }
 }
 
 #endif
 
+Stats GetStats()
+{
+  Stats stats = {};
+  s_blocks.EnumeratePages([&stats](u32 page_index, BlockTable::Page& page) {
+    for (const CodeBlock* block : page)
+    {
+      if (!block)
+        continue;
+
+      if (block->host_code)
+        stats.recompiled_blocks++;
+#ifdef WITH_RECOMPILER
+      else if (IsBlockDemoted(block))
+        stats.demoted_blocks++;
+#endif
+      else
+        stats.interpreted_blocks++;
+    }
+  });
+
+#ifdef WITH_RECOMPILER
+  stats.host_compile_count = s_host_compile_count;
+#endif
+  stats.code_change_count = s_code_change_count;
+  return stats;
+}
+
 void InvalidateBlocksWithPageIndex(u32 page_index)
 {
+  TRACE_SCOPE("CodeCache::InvalidateBlocks");
+
   DebugAssert(page_index < CPU_CODE_CACHE_PAGE_COUNT);
   auto& blocks = m_ram_block_map[page_index];
-  for (CodeBlock* block : blocks)
+  while (!blocks.empty())
   {
     // Invalidate forces the block to be checked again.
+    CodeBlock* block = blocks.back();
     Log_DebugPrintf("Invalidating block at 0x%08X", block->GetPC());
     block->invalidated = true;
 #ifdef WITH_RECOMPILER
     SetFastMap(block->GetPC(), FastCompileBlockFunction);
+
+    // Blocks jumping directly to this one have to go back through the link stub, so they pick up the new code.
+    if (s_use_recompiler)
+      UnlinkBlock(block);
 #endif
+
+    // Block will be re-added next execution. Remove it from every page it covers, not just this one.
+    RemoveBlockFromPageMap(block);
   }
 
-  // Block will be re-added next execution.
-  blocks.clear();
   Bus::ClearRAMCodePage(page_index);
 }
 
 void FlushBlock(CodeBlock* block)
 {
-  BlockMap::iterator iter = s_blocks.find(block->key.GetPC());
-  Assert(iter != s_blocks.end() && iter->second == block);
+  u32 table_page = 0, table_entry = 0;
+  const bool has_index = GetBlockTableIndex(block->key, &table_page, &table_entry);
+  Assert(has_index && s_blocks.Lookup(table_page, table_entry) == block);
   Log_DevPrintf("Flushing block at address 0x%08X", block->GetPC());
 
 #ifdef WITH_RECOMPILER
   SetFastMap(block->GetPC(), FastCompileBlockFunction);
+  RemoveBlockFromHostCodeMap(block);
 #endif
 
   // if it's been invalidated it won't be in the page map
-  if (block->invalidated)
+  if (!block->invalidated)
     RemoveBlockFromPageMap(block);
 
   UnlinkBlock(block);
 
-  s_blocks.erase(iter);
+  s_blocks.ClearEntry(table_page, table_entry);
   delete block;
 }
 
+template<typename Callback>
+void EnumerateBlockPages(const CodeBlock* block, Callback callback)
+{
+  u32 last_page = CPU_CODE_CACHE_PAGE_COUNT;
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    const u32 page = (cbi.pc & PHYSICAL_MEMORY_ADDRESS_MASK) / CPU_CODE_CACHE_PAGE_SIZE;
+    if (page != last_page && page < CPU_CODE_CACHE_PAGE_COUNT)
+      callback(page);
+
+    last_page = page;
+  }
+}
+
 void AddBlockToPageMap(CodeBlock* block)
 {
   if (!block->IsInRAM())
     return;
 
-  const u32 start_page = block->GetStartPageIndex();
-  const u32 end_page = block->GetEndPageIndex();
-  for (u32 page = start_page; page <= end_page; page++)
-  {
+  EnumerateBlockPages(block, [block](u32 page) {
     m_ram_block_map[page].push_back(block);
     Bus::SetRAMCodePage(page);
-  }
+  });
 }
 
 void RemoveBlockFromPageMap(CodeBlock* block)
@@ -564,15 +939,12 @@ void RemoveBlockFromPageMap(CodeBlock* block)
   if (!block->IsInRAM())
     return;
 
-  const u32 start_page = block->GetStartPageIndex();
-  const u32 end_page = block->GetEndPageIndex();
-  for (u32 page = start_page; page <= end_page; page++)
-  {
+  EnumerateBlockPages(block, [block](u32 page) {
     auto& page_blocks = m_ram_block_map[page];
     auto page_block_iter = std::find(page_blocks.begin(), page_blocks.end(), block);
     Assert(page_block_iter != page_blocks.end());
     page_blocks.erase(page_block_iter);
-  }
+  });
 }
 
 void LinkBlock(CodeBlock* from, CodeBlock* to)
@@ -584,6 +956,12 @@ void LinkBlock(CodeBlock* from, CodeBlock* to)
 
 void UnlinkBlock(CodeBlock* block)
 {
+#ifdef WITH_RECOMPILER
+  for (CodeBlock* predecessor : block->link_predecessors)
+    UnlinkBlockExits(predecessor, block);
+  UnlinkBlockExits(block, nullptr);
+#endif
+
   for (CodeBlock* predecessor : block->link_predecessors)
   {
     auto iter = std::find(predecessor->link_successors.begin(), predecessor->link_successors.end(), block);
@@ -601,4 +979,133 @@ void UnlinkBlock(CodeBlock* block)
   block->link_successors.clear();
 }
 
+#ifdef WITH_RECOMPILER
+
+void AddBlockToHostCodeMap(CodeBlock* block)
+{
+  if (!s_use_recompiler)
+    return;
+
+  auto ir = s_host_code_map.emplace(block->host_code, block);
+  Assert(ir.second);
+}
+
+void RemoveBlockFromHostCodeMap(CodeBlock* block)
+{
+  if (!s_use_recompiler)
+    return;
+
+  HostCodeMap::iterator hc_iter = s_host_code_map.find(block->host_code);
+  if (hc_iter != s_host_code_map.end() && hc_iter->second == block)
+    s_host_code_map.erase(hc_iter);
+}
+
+bool InitializeFastmem()
+{
+  if (!Common::PageFaultHandler::InstallHandler(&s_host_code_map, PageFaultHandler))
+  {
+    Log_ErrorPrintf("Failed to install page fault handler");
+    return false;
+  }
+
+  Bus::UpdateFastmemViews(true, g_state.cop0_regs.sr.Isc);
+  g_state.fastmem_base = Bus::GetFastmemBase();
+  if (!g_state.fastmem_base)
+  {
+    Log_ErrorPrintf("Failed to initialize fastmem views");
+    Common::PageFaultHandler::RemoveHandler(&s_host_code_map);
+    return false;
+  }
+
+  return true;
+}
+
+void ShutdownFastmem()
+{
+  Common::PageFaultHandler::RemoveHandler(&s_host_code_map);
+  Bus::UpdateFastmemViews(false, false);
+  g_state.fastmem_base = nullptr;
+}
+
+Common::PageFaultHandler::HandlerResult PageFaultHandler(void* exception_pc, void* fault_address, bool is_write)
+{
+  if (static_cast<u8*>(fault_address) < g_state.fastmem_base ||
+      (static_cast<u8*>(fault_address) - g_state.fastmem_base) >= static_cast<ptrdiff_t>(Bus::FASTMEM_REGION_SIZE))
+  {
+    return Common::PageFaultHandler::HandlerResult::ExecuteNextHandler;
+  }
+
+  // use upper_bound to find the next block after the pc
+  HostCodeMap::iterator iter =
+    s_host_code_map.upper_bound(reinterpret_cast<CodeBlock::HostCodePointer>(exception_pc));
+  if (iter == s_host_code_map.begin())
+    return Common::PageFaultHandler::HandlerResult::ExecuteNextHandler;
+
+  // then go back one to get to the block which contains the pc
+  --iter;
+
+  CodeBlock* block = iter->second;
+  for (auto bpi_iter = block->loadstore_backpatch_info.begin(); bpi_iter != block->loadstore_backpatch_info.end();
+       ++bpi_iter)
+  {
+    const LoadStoreBackpatchInfo& lbi = *bpi_iter;
+    if (lbi.host_pc == exception_pc)
+    {
+      // found it, do fixup
+      Recompiler::CodeGenerator::BackpatchLoadStore(lbi);
+
+      // remove the backpatch entry since we won't be coming back to this one
+      block->loadstore_backpatch_info.erase(bpi_iter);
+      return Common::PageFaultHandler::HandlerResult::ContinueExecution;
+    }
+  }
+
+  // we didn't find the pc in our list..
+  Log_ErrorPrintf("Loadstore PC not found for %p in block 0x%08X (%s of fastmem offset 0x%08X)", exception_pc,
+                  block->GetPC(), is_write ? "write" : "read",
+                  static_cast<u32>(static_cast<u8*>(fault_address) - g_state.fastmem_base));
+  return Common::PageFaultHandler::HandlerResult::ExecuteNextHandler;
+}
+
+void LinkBlockExit(CodeBlock* block, u32 exit_index)
+{
+  // Stale code can still reach its exits, don't link from it.
+  BlockExitLinkInfo& eli = block->exit_links[exit_index];
+  if (block->invalidated || eli.linked_block)
+    return;
+
+  // The block can't change the mode, so the successor runs in the same mode.
+  CodeBlockKey key = {};
+  key.SetPC(eli.target_pc);
+  key.user_mode = static_cast<bool>(block->key.user_mode);
+
+  u32 table_page, table_entry;
+  if (!GetBlockTableIndex(key, &table_page, &table_entry))
+    return;
+
+  // Leave compiling or revalidating the successor to the dispatcher, it'll be linked the next time the exit is taken.
+  CodeBlock* successor = s_blocks.Lookup(table_page, table_entry);
+  if (!successor || successor->key != key || successor->invalidated || !successor->host_code)
+    return;
+
+  Log_DebugPrintf("Linking exit %u of block %08X to %08X", exit_index, block->GetPC(), successor->GetPC());
+  Recompiler::CodeGenerator::PatchBlockExitJump(eli, reinterpret_cast<const void*>(successor->host_code));
+  eli.linked_block = successor;
+  LinkBlock(block, successor);
+}
+
+void UnlinkBlockExits(CodeBlock* block, CodeBlock* target)
+{
+  for (BlockExitLinkInfo& eli : block->exit_links)
+  {
+    if (!eli.linked_block || (target && eli.linked_block != target))
+      continue;
+
+    Recompiler::CodeGenerator::PatchBlockExitJump(eli, eli.host_stub_pc);
+    eli.linked_block = nullptr;
+  }
+}
+
+#endif
+
 } // namespace CPU::CodeCache
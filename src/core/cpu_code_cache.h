@@ -4,7 +4,6 @@
 #include "cpu_types.h"
 #include <array>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 namespace CPU {
@@ -47,6 +46,24 @@ struct CodeBlockInstruction
   bool can_trap : 1;
 };
 
+struct LoadStoreBackpatchInfo
+{
+  void* host_pc;          // pointer to the fastmem load/store instruction which can fault
+  void* host_slowmem_pc;  // pointer to the slowmem stub in far code
+  u32 host_code_size;     // size of the fastmem load/store, including padding
+  u32 guest_pc;           // guest pc of the load/store, for debugging
+};
+
+struct CodeBlock;
+
+struct BlockExitLinkInfo
+{
+  void* host_jump_pc;       // pointer to the patchable jump to the successor block
+  void* host_stub_pc;       // pointer to the link stub in far code, which the jump targets while unlinked
+  u32 target_pc;            // guest pc of the successor block
+  CodeBlock* linked_block;  // block the jump currently goes to, or nullptr if it goes to the link stub
+};
+
 struct CodeBlock
 {
   using HostCodePointer = void (*)();
@@ -61,17 +78,20 @@ struct CodeBlock
   std::vector<CodeBlock*> link_predecessors;
   std::vector<CodeBlock*> link_successors;
 
+#ifdef WITH_RECOMPILER
+  std::vector<LoadStoreBackpatchInfo> loadstore_backpatch_info;
+  std::vector<BlockExitLinkInfo> exit_links;
+#endif
+
   TickCount uncached_fetch_ticks = 0;
   u32 icache_line_count = 0;
+  u32 execution_count = 0; // times the block has been interpreted since it was last decoded
+  u32 recompile_count = 0; // times the block's code has changed since it was first compiled
+  bool contains_loadstore_instructions = false;
   bool invalidated = false;
 
   const u32 GetPC() const { return key.GetPC(); }
   const u32 GetSizeInBytes() const { return static_cast<u32>(instructions.size()) * sizeof(Instruction); }
-  const u32 GetStartPageIndex() const { return (key.GetPCPhysicalAddress() / CPU_CODE_CACHE_PAGE_SIZE); }
-  const u32 GetEndPageIndex() const
-  {
-    return ((key.GetPCPhysicalAddress() + GetSizeInBytes()) / CPU_CODE_CACHE_PAGE_SIZE);
-  }
   bool IsInRAM() const
   {
     // TODO: Constant
@@ -81,7 +101,7 @@ struct CodeBlock
 
 namespace CodeCache {
 
-void Initialize(bool use_recompiler);
+void Initialize(bool use_recompiler, bool use_fastmem);
 void Shutdown();
 void Execute();
 
@@ -92,16 +112,42 @@ void ExecuteRecompiler();
 /// Flushes the code cache, forcing all blocks to be recompiled.
 void Flush();
 
-/// Changes whether the recompiler is enabled.
-void SetUseRecompiler(bool enable);
+/// Changes whether the recompiler and fastmem are enabled.
+void SetUseRecompiler(bool enable, bool fastmem);
+
+/// Returns true if recompiled code is using fastmem for loads/stores.
+bool IsUsingFastmem();
 
 /// Invalidates all blocks which are in the range of the specified code page.
 void InvalidateBlocksWithPageIndex(u32 page_index);
 
+// With tiering, blocks are interpreted this many times before they're compiled to host code, and blocks whose code
+// has changed this many times are demoted to the interpreter for good.
+static constexpr u32 RECOMPILER_TIER_UP_EXECUTION_COUNT = 16;
+static constexpr u32 RECOMPILER_DEMOTE_RECOMPILE_COUNT = 8;
+
+struct Stats
+{
+  u32 interpreted_blocks;   // blocks which have not been executed enough times to be compiled yet
+  u32 recompiled_blocks;    // blocks which execute as host code
+  u32 demoted_blocks;       // blocks kept in the interpreter because their code keeps changing
+  u64 host_compile_count;   // blocks compiled to host code since the cache was initialized
+  u64 code_change_count;    // times a block was recompiled because its code changed
+};
+
+/// Returns the number of blocks in each execution tier, and how often blocks have been compiled.
+Stats GetStats();
+
 template<PGXPMode pgxp_mode>
 void InterpretCachedBlock(const CodeBlock& block);
 void InterpretUncachedBlock();
 
+#ifdef WITH_RECOMPILER
+/// Called by the link stub of a recompiled block exit, after the block's stack frame has been torn down. Patches the
+/// exit to jump directly to the successor block if it has already been compiled, otherwise returns to the dispatcher.
+void LinkBlockExit(CodeBlock* block, u32 exit_index);
+#endif
+
 }; // namespace CodeCache
 
 } // namespace CPU
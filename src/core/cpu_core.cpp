@@ -3,6 +3,8 @@
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/state_wrapper.h"
+#include "bus.h"
+#include "cpu_code_cache.h"
 #include "cpu_core_private.h"
 #include "cpu_disasm.h"
 #include "cpu_recompiler_thunks.h"
@@ -81,6 +83,7 @@ void Reset()
   g_state.cop0_regs.cause.bits = 0;
 
   ClearICache();
+  UpdateFastmemMapping();
 
   GTE::Reset();
 
@@ -90,6 +93,15 @@ void Reset()
     PGXP::Initialize();
 }
 
+void UpdateFastmemMapping()
+{
+  if (!CodeCache::IsUsingFastmem())
+    return;
+
+  Bus::UpdateFastmemViews(true, g_state.cop0_regs.sr.Isc);
+  g_state.fastmem_base = Bus::GetFastmemBase();
+}
+
 bool DoState(StateWrapper& sw)
 {
   sw.Do(&g_state.pending_ticks);
@@ -120,7 +132,7 @@ bool DoState(StateWrapper& sw)
   sw.Do(&g_state.next_load_delay_reg);
   sw.Do(&g_state.next_load_delay_value);
   sw.Do(&g_state.cache_control.bits);
-  sw.DoBytes(g_state.dcache.data(), g_state.dcache.size());
+  sw.DoBytes(Bus::g_scratchpad, DCACHE_SIZE);
 
   if (!GTE::DoState(sw))
     return false;
@@ -128,6 +140,7 @@ bool DoState(StateWrapper& sw)
   if (sw.IsReading())
   {
     ClearICache();
+    UpdateFastmemMapping();
     PGXP::Initialize();
   }
 
@@ -390,9 +403,12 @@ ALWAYS_INLINE_RELEASE static void WriteCop0Reg(Cop0Reg reg, u32 value)
 
     case Cop0Reg::SR:
     {
+      const bool old_isc = g_state.cop0_regs.sr.Isc;
       g_state.cop0_regs.sr.bits =
         (g_state.cop0_regs.sr.bits & ~Cop0Registers::SR::WRITE_MASK) | (value & Cop0Registers::SR::WRITE_MASK);
       Log_DebugPrintf("COP0 SR <- %08X (now %08X)", value, g_state.cop0_regs.sr.bits);
+      if (g_state.cop0_regs.sr.Isc != old_isc)
+        UpdateFastmemMapping();
     }
     break;
 
@@ -1514,6 +1530,70 @@ bool InterpretInstructionPGXP()
   return g_state.exception_raised;
 }
 
+bool InterpretInstructionPGXPCPU()
+{
+  ExecuteInstruction<PGXPMode::CPU>();
+  return g_state.exception_raised;
+}
+
+void PGXPMultiplyDivide(u32 instr, u32 rsVal, u32 rtVal)
+{
+  const Instruction inst{instr};
+  switch (inst.r.funct)
+  {
+    case InstructionFunct::mult:
+    {
+      const u64 result =
+        static_cast<u64>(static_cast<s64>(SignExtend64(rsVal)) * static_cast<s64>(SignExtend64(rtVal)));
+      PGXP::CPU_MULT(instr, Truncate32(result >> 32), Truncate32(result), rsVal, rtVal);
+    }
+    break;
+
+    case InstructionFunct::multu:
+    {
+      const u64 result = ZeroExtend64(rsVal) * ZeroExtend64(rtVal);
+      PGXP::CPU_MULTU(instr, Truncate32(result >> 32), Truncate32(result), rsVal, rtVal);
+    }
+    break;
+
+    case InstructionFunct::div:
+    {
+      const s32 num = static_cast<s32>(rsVal);
+      const s32 denom = static_cast<s32>(rtVal);
+      u32 lo, hi;
+      if (denom == 0)
+      {
+        lo = (num >= 0) ? UINT32_C(0xFFFFFFFF) : UINT32_C(1);
+        hi = static_cast<u32>(num);
+      }
+      else if (static_cast<u32>(num) == UINT32_C(0x80000000) && denom == -1)
+      {
+        lo = UINT32_C(0x80000000);
+        hi = 0;
+      }
+      else
+      {
+        lo = static_cast<u32>(num / denom);
+        hi = static_cast<u32>(num % denom);
+      }
+      PGXP::CPU_DIV(instr, hi, lo, rsVal, rtVal);
+    }
+    break;
+
+    case InstructionFunct::divu:
+    {
+      const u32 lo = (rtVal == 0) ? UINT32_C(0xFFFFFFFF) : (rsVal / rtVal);
+      const u32 hi = (rtVal == 0) ? rsVal : (rsVal % rtVal);
+      PGXP::CPU_DIVU(instr, hi, lo, rsVal, rtVal);
+    }
+    break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+}
+
 } // namespace Recompiler::Thunks
 
 } // namespace CPU
\ No newline at end of file
@@ -76,11 +76,12 @@ struct State
 
   CacheControl cache_control{ 0 };
 
+  // base pointer for fastmem loads/stores in recompiled code, null when fastmem is not in use
+  u8* fastmem_base = nullptr;
+
   // GTE registers are stored here so we can access them on ARM with a single instruction
   GTE::Regs gte_regs = {};
 
-  // data cache (used as scratchpad)
-  std::array<u8, DCACHE_SIZE> dcache = {};
   std::array<u32, ICACHE_LINES> icache_tags = {};
   std::array<u8, ICACHE_SIZE> icache_data = {};
 };
@@ -93,6 +94,9 @@ void Reset();
 bool DoState(StateWrapper& sw);
 void ClearICache();
 
+/// Updates the fastmem views after the cache isolation bit in SR changes.
+void UpdateFastmemMapping();
+
 /// Executes interpreter loop.
 void Execute();
 
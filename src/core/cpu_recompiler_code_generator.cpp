@@ -1,4 +1,5 @@
 #include "cpu_recompiler_code_generator.h"
+#include "bus.h"
 #include "common/log.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
@@ -14,12 +15,93 @@ Log_SetChannel(CPU::Recompiler);
 
 namespace CPU::Recompiler {
 
+// PGXP CPU-mode handler for an ALU instruction. The handlers take (instr, result, operands...) in the same order
+// as the interpreter passes them, so they are called before the destination register is overwritten.
+static const void* GetPGXPCPUFunction(const Instruction instruction)
+{
+#define PGXP_FUNC(name) reinterpret_cast<const void*>(&PGXP::CPU_##name)
+  switch (instruction.op)
+  {
+    case InstructionOp::andi:
+      return PGXP_FUNC(ANDI);
+    case InstructionOp::ori:
+      return PGXP_FUNC(ORI);
+    case InstructionOp::xori:
+      return PGXP_FUNC(XORI);
+    case InstructionOp::addi:
+      return PGXP_FUNC(ADDI);
+    case InstructionOp::addiu:
+      return PGXP_FUNC(ADDIU);
+    case InstructionOp::slti:
+      return PGXP_FUNC(SLTI);
+    case InstructionOp::sltiu:
+      return PGXP_FUNC(SLTIU);
+
+    case InstructionOp::funct:
+    {
+      switch (instruction.r.funct)
+      {
+        case InstructionFunct::and_:
+          return PGXP_FUNC(AND_);
+        case InstructionFunct::or_:
+          return PGXP_FUNC(OR_);
+        case InstructionFunct::xor_:
+          return PGXP_FUNC(XOR_);
+        case InstructionFunct::nor:
+          return PGXP_FUNC(NOR);
+        case InstructionFunct::add:
+          return PGXP_FUNC(ADD);
+        case InstructionFunct::addu:
+          return PGXP_FUNC(ADDU);
+        case InstructionFunct::sub:
+          return PGXP_FUNC(SUB);
+        case InstructionFunct::subu:
+          return PGXP_FUNC(SUBU);
+        case InstructionFunct::slt:
+          return PGXP_FUNC(SLT);
+        case InstructionFunct::sltu:
+          return PGXP_FUNC(SLTU);
+        case InstructionFunct::sll:
+          return PGXP_FUNC(SLL);
+        case InstructionFunct::srl:
+          return PGXP_FUNC(SRL);
+        case InstructionFunct::sra:
+          return PGXP_FUNC(SRA);
+        case InstructionFunct::sllv:
+          return PGXP_FUNC(SLLV);
+        case InstructionFunct::srlv:
+          return PGXP_FUNC(SRLV);
+        case InstructionFunct::srav:
+          return PGXP_FUNC(SRAV);
+        case InstructionFunct::mfhi:
+          return PGXP_FUNC(MFHI);
+        case InstructionFunct::mthi:
+          return PGXP_FUNC(MTHI);
+        case InstructionFunct::mflo:
+          return PGXP_FUNC(MFLO);
+        case InstructionFunct::mtlo:
+          return PGXP_FUNC(MTLO);
+        default:
+          break;
+      }
+    }
+    break;
+
+    default:
+      break;
+  }
+#undef PGXP_FUNC
+
+  UnreachableCode();
+  return nullptr;
+}
+
 u32 CodeGenerator::CalculateRegisterOffset(Reg reg)
 {
   return u32(offsetof(State, regs.r[0]) + (static_cast<u32>(reg) * sizeof(u32)));
 }
 
-bool CodeGenerator::CompileBlock(const CodeBlock* block, CodeBlock::HostCodePointer* out_host_code,
+bool CodeGenerator::CompileBlock(CodeBlock* block, CodeBlock::HostCodePointer* out_host_code,
                                  u32* out_host_code_size)
 {
   // TODO: Align code buffer.
@@ -27,6 +109,8 @@ bool CodeGenerator::CompileBlock(const CodeBlock* block, CodeBlock::HostCodePoin
   m_block = block;
   m_block_start = block->instructions.data();
   m_block_end = block->instructions.data() + block->instructions.size();
+  m_fastmem_enabled = CodeCache::IsUsingFastmem() && block->contains_loadstore_instructions;
+  AnalyzeBlockInstructions(m_block_start, m_block_end, g_settings.cpu_recompiler_memory_exceptions, &m_block_analysis);
 
   EmitBeginBlock();
   BlockPrologue();
@@ -40,8 +124,17 @@ bool CodeGenerator::CompileBlock(const CodeBlock* block, CodeBlock::HostCodePoin
     Log_DebugPrintf("Compiling instruction '%s'", disasm.GetCharArray());
 #endif
 
+    // Traces continue at the branch target after a delay slot, which is like entering a new block.
+    if (cbi != m_block_start && cbi[-1].is_branch_delay_slot && !cbi[-1].is_branch_instruction)
+    {
+      DebugAssert(m_pc_offset == 0);
+      EmitStoreCPUStructField(offsetof(State, current_instruction_pc), Value::FromConstantU32(cbi->pc));
+    }
+
+    m_register_cache.SetDeadGuestRegisters(GetInstructionAnalysis(*cbi).dead_registers);
     if (!CompileInstruction(*cbi))
     {
+      m_register_cache.SetDeadGuestRegisters(0);
       m_block_end = nullptr;
       m_block_start = nullptr;
       m_block = nullptr;
@@ -51,6 +144,7 @@ bool CodeGenerator::CompileBlock(const CodeBlock* block, CodeBlock::HostCodePoin
     cbi++;
   }
 
+  m_register_cache.SetDeadGuestRegisters(0);
   BlockEpilogue();
   EmitEndBlock();
 
@@ -866,6 +960,96 @@ void CodeGenerator::BlockEpilogue()
     m_register_cache.WriteLoadDelayToCPU(true);
 
   AddPendingCycles(true);
+
+  EmitBlockExitLinks();
+}
+
+u32 CodeGenerator::GetConstantBlockExits(std::array<u32, 2>* exit_pcs) const
+{
+  // only handle blocks ending in a branch and its delay slot, not branches in delay slots
+  if ((m_block_end - m_block_start) < 2)
+    return 0;
+
+  const CodeBlockInstruction& branch = m_block_end[-2];
+  const CodeBlockInstruction& delay_slot = m_block_end[-1];
+  if (!branch.is_branch_instruction || branch.is_branch_delay_slot || !delay_slot.is_branch_delay_slot ||
+      delay_slot.is_branch_instruction)
+  {
+    return 0;
+  }
+
+  // cop0 instructions can switch between user and kernel mode, which changes the key of the next block
+  for (const CodeBlockInstruction* cbi = m_block_start; cbi != m_block_end; cbi++)
+  {
+    if (cbi->instruction.op == InstructionOp::cop0)
+      return 0;
+  }
+
+  switch (branch.instruction.op)
+  {
+    case InstructionOp::j:
+    case InstructionOp::jal:
+      (*exit_pcs)[0] = ((branch.pc + 4) & UINT32_C(0xF0000000)) | (branch.instruction.j.target << 2);
+      return 1;
+
+    case InstructionOp::b:
+    case InstructionOp::beq:
+    case InstructionOp::bne:
+    case InstructionOp::bgtz:
+    case InstructionOp::blez:
+      (*exit_pcs)[0] = branch.pc + 4 + (branch.instruction.i.imm_sext32() << 2);
+      (*exit_pcs)[1] = branch.pc + 8;
+      return 2;
+
+    default:
+      // jr/jalr
+      return 0;
+  }
+}
+
+void CodeGenerator::EmitBlockExitLinks()
+{
+  std::array<u32, 2> exit_pcs;
+  const u32 num_exits = GetConstantBlockExits(&exit_pcs);
+  if (num_exits == 0)
+    return;
+
+  // Allocate everything up front, so any callee-saved registers are pushed on all paths.
+  Value temp1 = m_register_cache.AllocateScratch(RegSize_32);
+  Value temp2 = m_register_cache.AllocateScratch(RegSize_32);
+
+  // Same checks as the dispatcher: return to it when events are due, or an interrupt is pending.
+  LabelType no_link;
+  EmitLoadCPUStructField(temp1.host_reg, RegSize_32, offsetof(State, pending_ticks));
+  EmitLoadCPUStructField(temp2.host_reg, RegSize_32, offsetof(State, downcount));
+  EmitConditionalBranch(Condition::GreaterEqual, false, temp1.host_reg, temp2, &no_link);
+
+  LabelType interrupts_disabled;
+  EmitLoadCPUStructField(temp1.host_reg, RegSize_32, offsetof(State, cop0_regs.sr.bits));
+  EmitBranchIfBitClear(temp1.host_reg, RegSize_32, 0, &interrupts_disabled);
+  EmitLoadCPUStructField(temp2.host_reg, RegSize_32, offsetof(State, cop0_regs.cause.bits));
+  EmitAnd(temp2.host_reg, temp2.host_reg, temp1);
+  EmitAnd(temp2.host_reg, temp2.host_reg, Value::FromConstantU32(UINT32_C(0xFF) << 8));
+  EmitConditionalBranch(Condition::NotZero, false, temp2.host_reg, RegSize_32, &no_link);
+  EmitBindLabel(&interrupts_disabled);
+  EmitStoreCPUStructField(offsetof(State, interrupt_delay), Value::FromConstantU8(0));
+
+  if (num_exits > 1)
+  {
+    LabelType not_taken;
+    EmitLoadGuestRegister(temp1.host_reg, Reg::pc);
+    EmitConditionalBranch(Condition::NotEqual, false, temp1.host_reg, Value::FromConstantU32(exit_pcs[0]),
+                          &not_taken);
+    EmitLinkableBlockExit(exit_pcs[0]);
+    EmitBindLabel(&not_taken);
+    EmitLinkableBlockExit(exit_pcs[1]);
+  }
+  else
+  {
+    EmitLinkableBlockExit(exit_pcs[0]);
+  }
+
+  EmitBindLabel(&no_link);
 }
 
 void CodeGenerator::InstructionPrologue(const CodeBlockInstruction& cbi, TickCount cycles,
@@ -943,6 +1127,79 @@ void CodeGenerator::InstructionEpilogue(const CodeBlockInstruction& cbi)
   }
 }
 
+Value CodeGenerator::GetLoadStoreAddress(const CodeBlockInstruction& cbi)
+{
+  // The register cache loses constants when they're flushed, the analysis doesn't.
+  const InstructionAnalysis& ia = GetInstructionAnalysis(cbi);
+  if (ia.has_known_address)
+    return Value::FromConstantU32(ia.known_address);
+
+  Value base = m_register_cache.ReadGuestRegister(cbi.instruction.i.rs);
+  Value offset = Value::FromConstantU32(cbi.instruction.i.imm_sext32());
+  return AddValues(base, offset, false);
+}
+
+Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const Value& address, RegSize size)
+{
+  // Loads from a known RAM/scratchpad address can read the backing memory directly, there's no side effects.
+  if (address.IsConstant())
+  {
+    TickCount read_ticks;
+    const void* ptr =
+      Bus::GetDirectReadPointer(static_cast<u32>(address.constant_value), 1u << static_cast<u32>(size), &read_ticks);
+    if (ptr)
+    {
+      Value result = m_register_cache.AllocateScratch(RegSize_32);
+      EmitLoadGlobal(result.GetHostRegister(), size, ptr);
+      m_delayed_cycles_add += read_ticks;
+      if (size != RegSize_32)
+        ConvertValueSizeInPlace(&result, size, false);
+
+      return result;
+    }
+  }
+
+  if (m_fastmem_enabled &&
+      (!address.IsConstant() || Bus::CanUseFastmemForAddress(static_cast<u32>(address.constant_value))))
+  {
+    Value result = m_register_cache.AllocateScratch(RegSize_32);
+    EmitLoadGuestMemoryFastmem(cbi, address, size, result);
+    if (size != RegSize_32)
+      ConvertValueSizeInPlace(&result, size, false);
+
+    return result;
+  }
+
+  AddPendingCycles(true);
+
+  // We need to use the full 64 bits here since we test the sign bit result.
+  Value result =
+    m_register_cache.AllocateScratch(g_settings.cpu_recompiler_memory_exceptions ? RegSize_64 : RegSize_32);
+  m_register_cache.FlushCallerSavedGuestRegisters(true, true);
+  EmitLoadGuestMemorySlowmem(cbi, address, size, result, false);
+
+  // Downcast to ignore upper 56/48/32 bits. This should be a noop.
+  if (result.size != size)
+    ConvertValueSizeInPlace(&result, size, false);
+
+  return result;
+}
+
+void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const Value& address, const Value& value)
+{
+  if (m_fastmem_enabled &&
+      (!address.IsConstant() || Bus::CanUseFastmemForAddress(static_cast<u32>(address.constant_value))))
+  {
+    EmitStoreGuestMemoryFastmem(cbi, address, value);
+    return;
+  }
+
+  AddPendingCycles(true);
+
+  m_register_cache.FlushCallerSavedGuestRegisters(true, true);
+  EmitStoreGuestMemorySlowmem(cbi, address, value, false);
+}
+
 void CodeGenerator::AddPendingCycles(bool commit)
 {
   if (m_delayed_cycles_add == 0)
@@ -1013,18 +1270,20 @@ bool CodeGenerator::Compile_Fallback(const CodeBlockInstruction& cbi)
   EmitStoreCPUStructField(offsetof(State, current_instruction.bits), Value::FromConstantU32(cbi.instruction.bits));
 
   // emit the function call
+  const auto interpret_func =
+    g_settings.gpu_pgxp_enable ?
+      (g_settings.gpu_pgxp_cpu ? &Thunks::InterpretInstructionPGXPCPU : &Thunks::InterpretInstructionPGXP) :
+      &Thunks::InterpretInstruction;
   if (CanInstructionTrap(cbi.instruction, m_block->key.user_mode))
   {
     // TODO: Use carry flag or something here too
     Value return_value = m_register_cache.AllocateScratch(RegSize_8);
-    EmitFunctionCall(&return_value,
-                     g_settings.gpu_pgxp_enable ? &Thunks::InterpretInstructionPGXP : &Thunks::InterpretInstruction);
+    EmitFunctionCall(&return_value, interpret_func);
     EmitExceptionExitOnBool(return_value);
   }
   else
   {
-    EmitFunctionCall(nullptr,
-                     g_settings.gpu_pgxp_enable ? &Thunks::InterpretInstructionPGXP : &Thunks::InterpretInstruction);
+    EmitFunctionCall(nullptr, interpret_func);
   }
 
   m_current_instruction_in_branch_delay_slot_dirty = cbi.is_branch_instruction;
@@ -1103,6 +1362,20 @@ bool CodeGenerator::Compile_Bitwise(const CodeBlockInstruction& cbi)
       break;
   }
 
+  if (g_settings.UsingPGXPCPUMode())
+  {
+    if (op != InstructionOp::funct)
+    {
+      EmitFunctionCallPtr(nullptr, GetPGXPCPUFunction(cbi.instruction), Value::FromConstantU32(cbi.instruction.bits),
+                          result, lhs);
+    }
+    else
+    {
+      EmitFunctionCallPtr(nullptr, GetPGXPCPUFunction(cbi.instruction), Value::FromConstantU32(cbi.instruction.bits),
+                          result, lhs, rhs);
+    }
+  }
+
   m_register_cache.WriteGuestRegister(dest, std::move(result));
 
   InstructionEpilogue(cbi);
@@ -1152,6 +1425,20 @@ bool CodeGenerator::Compile_Shift(const CodeBlockInstruction& cbi)
       break;
   }
 
+  if (g_settings.UsingPGXPCPUMode())
+  {
+    if (funct == InstructionFunct::sll || funct == InstructionFunct::srl || funct == InstructionFunct::sra)
+    {
+      EmitFunctionCallPtr(nullptr, GetPGXPCPUFunction(cbi.instruction), Value::FromConstantU32(cbi.instruction.bits),
+                          result, rt);
+    }
+    else
+    {
+      EmitFunctionCallPtr(nullptr, GetPGXPCPUFunction(cbi.instruction), Value::FromConstantU32(cbi.instruction.bits),
+                          result, rt, shamt);
+    }
+  }
+
   m_register_cache.WriteGuestRegister(cbi.instruction.r.rd, std::move(result));
 
   InstructionEpilogue(cbi);
@@ -1163,9 +1450,7 @@ bool CodeGenerator::Compile_Load(const CodeBlockInstruction& cbi)
   InstructionPrologue(cbi, 1);
 
   // rt <- mem[rs + sext(imm)]
-  Value base = m_register_cache.ReadGuestRegister(cbi.instruction.i.rs);
-  Value offset = Value::FromConstantU32(cbi.instruction.i.imm_sext32());
-  Value address = AddValues(base, offset, false);
+  Value address = GetLoadStoreAddress(cbi);
 
   Value result;
   switch (cbi.instruction.op)
@@ -1215,9 +1500,7 @@ bool CodeGenerator::Compile_Store(const CodeBlockInstruction& cbi)
   InstructionPrologue(cbi, 1);
 
   // mem[rs + sext(imm)] <- rt
-  Value base = m_register_cache.ReadGuestRegister(cbi.instruction.i.rs);
-  Value offset = Value::FromConstantU32(cbi.instruction.i.imm_sext32());
-  Value address = AddValues(base, offset, false);
+  Value address = GetLoadStoreAddress(cbi);
   Value value = m_register_cache.ReadGuestRegister(cbi.instruction.i.rt);
 
   switch (cbi.instruction.op)
@@ -1265,6 +1548,19 @@ bool CodeGenerator::Compile_MoveHiLo(const CodeBlockInstruction& cbi)
 {
   InstructionPrologue(cbi, 1);
 
+  if (g_settings.UsingPGXPCPUMode())
+  {
+    // handlers take (instr, dest, src), and only use the source value for validation
+    const bool from_hilo =
+      (cbi.instruction.r.funct == InstructionFunct::mfhi || cbi.instruction.r.funct == InstructionFunct::mflo);
+    const Value src =
+      from_hilo ? m_register_cache.ReadGuestRegister((cbi.instruction.r.funct == InstructionFunct::mfhi) ? Reg::hi :
+                                                                                                          Reg::lo) :
+                  m_register_cache.ReadGuestRegister(cbi.instruction.r.rs);
+    EmitFunctionCallPtr(nullptr, GetPGXPCPUFunction(cbi.instruction), Value::FromConstantU32(cbi.instruction.bits), src,
+                        src);
+  }
+
   switch (cbi.instruction.r.funct)
   {
     case InstructionFunct::mfhi:
@@ -1332,6 +1628,20 @@ bool CodeGenerator::Compile_Add(const CodeBlockInstruction& cbi)
   if (check_overflow)
     GenerateExceptionExit(cbi, Exception::Ov, Condition::Overflow);
 
+  if (g_settings.UsingPGXPCPUMode())
+  {
+    if (cbi.instruction.op != InstructionOp::funct)
+    {
+      EmitFunctionCallPtr(nullptr, GetPGXPCPUFunction(cbi.instruction), Value::FromConstantU32(cbi.instruction.bits),
+                          result, lhs);
+    }
+    else
+    {
+      EmitFunctionCallPtr(nullptr, GetPGXPCPUFunction(cbi.instruction), Value::FromConstantU32(cbi.instruction.bits),
+                          result, lhs, rhs);
+    }
+  }
+
   m_register_cache.WriteGuestRegister(dest, std::move(result));
 
   InstructionEpilogue(cbi);
@@ -1352,6 +1662,12 @@ bool CodeGenerator::Compile_Subtract(const CodeBlockInstruction& cbi)
   if (check_overflow)
     GenerateExceptionExit(cbi, Exception::Ov, Condition::Overflow);
 
+  if (g_settings.UsingPGXPCPUMode())
+  {
+    EmitFunctionCallPtr(nullptr, GetPGXPCPUFunction(cbi.instruction), Value::FromConstantU32(cbi.instruction.bits),
+                        result, lhs, rhs);
+  }
+
   m_register_cache.WriteGuestRegister(cbi.instruction.r.rd, std::move(result));
 
   InstructionEpilogue(cbi);
@@ -1363,8 +1679,12 @@ bool CodeGenerator::Compile_Multiply(const CodeBlockInstruction& cbi)
   InstructionPrologue(cbi, 1);
 
   const bool signed_multiply = (cbi.instruction.r.funct == InstructionFunct::mult);
-  std::pair<Value, Value> result = MulValues(m_register_cache.ReadGuestRegister(cbi.instruction.r.rs),
-                                             m_register_cache.ReadGuestRegister(cbi.instruction.r.rt), signed_multiply);
+  Value rs = m_register_cache.ReadGuestRegister(cbi.instruction.r.rs);
+  Value rt = m_register_cache.ReadGuestRegister(cbi.instruction.r.rt);
+  if (g_settings.UsingPGXPCPUMode())
+    EmitFunctionCall(nullptr, &Thunks::PGXPMultiplyDivide, Value::FromConstantU32(cbi.instruction.bits), rs, rt);
+
+  std::pair<Value, Value> result = MulValues(rs, rt, signed_multiply);
   m_register_cache.WriteGuestRegister(Reg::hi, std::move(result.first));
   m_register_cache.WriteGuestRegister(Reg::lo, std::move(result.second));
 
@@ -1423,6 +1743,9 @@ bool CodeGenerator::Compile_Divide(const CodeBlockInstruction& cbi)
 
   Value num = m_register_cache.ReadGuestRegister(cbi.instruction.r.rs);
   Value denom = m_register_cache.ReadGuestRegister(cbi.instruction.r.rt);
+  if (g_settings.UsingPGXPCPUMode())
+    EmitFunctionCall(nullptr, &Thunks::PGXPMultiplyDivide, Value::FromConstantU32(cbi.instruction.bits), num, denom);
+
   if (num.IsConstant() && denom.IsConstant())
   {
     const auto [lo, hi] = MIPSDivide(static_cast<u32>(num.constant_value), static_cast<u32>(denom.constant_value));
@@ -1480,6 +1803,9 @@ bool CodeGenerator::Compile_SignedDivide(const CodeBlockInstruction& cbi)
 
   Value num = m_register_cache.ReadGuestRegister(cbi.instruction.r.rs);
   Value denom = m_register_cache.ReadGuestRegister(cbi.instruction.r.rt);
+  if (g_settings.UsingPGXPCPUMode())
+    EmitFunctionCall(nullptr, &Thunks::PGXPMultiplyDivide, Value::FromConstantU32(cbi.instruction.bits), num, denom);
+
   if (num.IsConstant() && denom.IsConstant())
   {
     const auto [lo, hi] = MIPSDivide(num.GetS32ConstantValue(), denom.GetS32ConstantValue());
@@ -1592,6 +1918,20 @@ bool CodeGenerator::Compile_SetLess(const CodeBlockInstruction& cbi)
   Value result = m_register_cache.AllocateScratch(RegSize_32);
   EmitCmp(lhs.host_reg, rhs);
   EmitSetConditionResult(result.host_reg, result.size, signed_comparison ? Condition::Less : Condition::Below);
+
+  if (g_settings.UsingPGXPCPUMode())
+  {
+    if (cbi.instruction.op != InstructionOp::funct)
+    {
+      EmitFunctionCallPtr(nullptr, GetPGXPCPUFunction(cbi.instruction), Value::FromConstantU32(cbi.instruction.bits),
+                          result, lhs);
+    }
+    else
+    {
+      EmitFunctionCallPtr(nullptr, GetPGXPCPUFunction(cbi.instruction), Value::FromConstantU32(cbi.instruction.bits),
+                          result, lhs, rhs);
+    }
+  }
   m_register_cache.WriteGuestRegister(dest, std::move(result));
 
   InstructionEpilogue(cbi);
@@ -1797,8 +2137,11 @@ bool CodeGenerator::Compile_lui(const CodeBlockInstruction& cbi)
   InstructionPrologue(cbi, 1);
 
   // rt <- (imm << 16)
-  m_register_cache.WriteGuestRegister(cbi.instruction.i.rt,
-                                      Value::FromConstantU32(cbi.instruction.i.imm_zext32() << 16));
+  const u32 value = cbi.instruction.i.imm_zext32() << 16;
+  m_register_cache.WriteGuestRegister(cbi.instruction.i.rt, Value::FromConstantU32(value));
+
+  if (g_settings.UsingPGXPCPUMode())
+    EmitFunctionCall(nullptr, PGXP::CPU_LUI, Value::FromConstantU32(cbi.instruction.bits), Value::FromConstantU32(value));
 
   InstructionEpilogue(cbi);
   return true;
@@ -1881,6 +2224,9 @@ bool CodeGenerator::Compile_cop0(const CodeBlockInstruction& cbi)
           // coprocessor loads are load-delayed
           Value value = m_register_cache.AllocateScratch(RegSize_32);
           EmitLoadCPUStructField(value.host_reg, value.size, offset);
+
+          if (g_settings.UsingPGXPCPUMode())
+            EmitFunctionCall(nullptr, PGXP::CPU_MFC0, Value::FromConstantU32(cbi.instruction.bits), value, value);
           m_register_cache.WriteGuestRegisterDelayed(cbi.instruction.r.rt, std::move(value));
         }
         else
@@ -1892,10 +2238,38 @@ bool CodeGenerator::Compile_cop0(const CodeBlockInstruction& cbi)
             if (write_mask != UINT32_C(0xFFFFFFFF))
             {
               // need to adjust the mask
-              value = AndValues(value, Value::FromConstantU32(write_mask));
+              Value masked_value = AndValues(value, Value::FromConstantU32(write_mask));
+              if (g_settings.UsingPGXPCPUMode())
+              {
+                EmitFunctionCall(nullptr, PGXP::CPU_MTC0, Value::FromConstantU32(cbi.instruction.bits), masked_value,
+                                 value);
+              }
+
+              value = std::move(masked_value);
+            }
+            else if (g_settings.UsingPGXPCPUMode())
+            {
+              EmitFunctionCall(nullptr, PGXP::CPU_MTC0, Value::FromConstantU32(cbi.instruction.bits), value, value);
             }
 
-            EmitStoreCPUStructField(offset, value);
+            if (reg == Cop0Reg::SR && CodeCache::IsUsingFastmem())
+            {
+              // remap fastmem when the cache isolation bit changes
+              Value old_value = m_register_cache.AllocateScratch(RegSize_32);
+              EmitLoadCPUStructField(old_value.host_reg, RegSize_32, offset);
+              EmitStoreCPUStructField(offset, value);
+              EmitXor(old_value.host_reg, old_value.host_reg, value);
+
+              LabelType skip_fastmem_update;
+              EmitBranchIfBitClear(old_value.host_reg, RegSize_32, 16, &skip_fastmem_update);
+              EmitFunctionCall(nullptr, &UpdateFastmemMapping);
+              EmitUpdateFastmemBase();
+              EmitBindLabel(&skip_fastmem_update);
+            }
+            else
+            {
+              EmitStoreCPUStructField(offset, value);
+            }
           }
         }
 
@@ -1994,7 +2368,7 @@ Value CodeGenerator::DoGTERegisterRead(u32 index)
 
     default:
     {
-      EmitLoadCPUStructField(value.host_reg, RegSize_32, offsetof(State, gte_regs.r32[index]));
+      EmitLoadCPUStructField(value.host_reg, RegSize_32, offsetof(State, gte_regs.r32[0]) + (sizeof(u32) * index));
     }
     break;
   }
@@ -2023,7 +2397,7 @@ void CodeGenerator::DoGTERegisterWrite(u32 index, const Value& value)
     {
       // sign-extend z component of vector registers
       Value temp = ConvertValueSize(value.ViewAsSize(RegSize_16), RegSize_32, true);
-      EmitStoreCPUStructField(offsetof(State, gte_regs.r32[index]), temp);
+      EmitStoreCPUStructField(offsetof(State, gte_regs.r32[0]) + (sizeof(u32) * index), temp);
       return;
     }
     break;
@@ -2036,7 +2410,7 @@ void CodeGenerator::DoGTERegisterWrite(u32 index, const Value& value)
     {
       // zero-extend unsigned values
       Value temp = ConvertValueSize(value.ViewAsSize(RegSize_16), RegSize_32, false);
-      EmitStoreCPUStructField(offsetof(State, gte_regs.r32[index]), temp);
+      EmitStoreCPUStructField(offsetof(State, gte_regs.r32[0]) + (sizeof(u32) * index), temp);
       return;
     }
     break;
@@ -2078,7 +2452,7 @@ void CodeGenerator::DoGTERegisterWrite(u32 index, const Value& value)
     default:
     {
       // written as-is, 2x16 or 1x32 bits
-      EmitStoreCPUStructField(offsetof(State, gte_regs.r32[index]), value);
+      EmitStoreCPUStructField(offsetof(State, gte_regs.r32[0]) + (sizeof(u32) * index), value);
       return;
     }
   }
@@ -2091,8 +2465,7 @@ bool CodeGenerator::Compile_cop2(const CodeBlockInstruction& cbi)
     InstructionPrologue(cbi, 1);
 
     const u32 reg = static_cast<u32>(cbi.instruction.i.rt.GetValue());
-    Value address = AddValues(m_register_cache.ReadGuestRegister(cbi.instruction.i.rs),
-                              Value::FromConstantU32(cbi.instruction.i.imm_sext32()), false);
+    Value address = GetLoadStoreAddress(cbi);
     if (cbi.instruction.op == InstructionOp::lwc2)
     {
       Value value = EmitLoadGuestMemory(cbi, address, RegSize_32);
@@ -2,9 +2,11 @@
 #include <array>
 #include <initializer_list>
 #include <utility>
+#include <vector>
 
 #include "common/jit_code_buffer.h"
 
+#include "cpu_block_analysis.h"
 #include "cpu_code_cache.h"
 #include "cpu_recompiler_register_cache.h"
 #include "cpu_recompiler_thunks.h"
@@ -23,7 +25,13 @@ public:
   static const char* GetHostRegName(HostReg reg, RegSize size = HostPointerSize);
   static void AlignCodeBuffer(JitCodeBuffer* code_buffer);
 
-  bool CompileBlock(const CodeBlock* block, CodeBlock::HostCodePointer* out_host_code, u32* out_host_code_size);
+  bool CompileBlock(CodeBlock* block, CodeBlock::HostCodePointer* out_host_code, u32* out_host_code_size);
+
+  /// Rewrites a faulting fastmem load/store to jump to its slowmem stub.
+  static void BackpatchLoadStore(const LoadStoreBackpatchInfo& lbi);
+
+  /// Points the jump of a linkable block exit at the specified host code.
+  static void PatchBlockExitJump(const BlockExitLinkInfo& eli, const void* target);
 
   //////////////////////////////////////////////////////////////////////////
   // Code Generation
@@ -32,6 +40,7 @@ public:
   void EmitEndBlock();
   void EmitExceptionExit();
   void EmitExceptionExitOnBool(const Value& value);
+  void EmitLinkableBlockExit(u32 target_pc);
   void FinalizeBlock(CodeBlock::HostCodePointer* out_host_code, u32* out_host_code_size);
 
   void EmitSignExtend(HostReg to_reg, RegSize to_size, HostReg from_reg, RegSize from_size);
@@ -62,6 +71,7 @@ public:
   void EmitMoveNextInterpreterLoadDelay();
   void EmitCancelInterpreterLoadDelayForReg(Reg reg);
   void EmitICacheCheckAndUpdate();
+  void EmitUpdateFastmemBase();
   void EmitLoadCPUStructField(HostReg host_reg, RegSize size, u32 offset);
   void EmitStoreCPUStructField(u32 offset, const Value& value);
   void EmitAddCPUStructField(u32 offset, const Value& value);
@@ -70,7 +80,13 @@ public:
 
   // Automatically generates an exception handler.
   Value EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const Value& address, RegSize size);
+  void EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size, Value& result);
+  void EmitLoadGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size, Value& result,
+                                  bool in_far_code);
   void EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const Value& address, const Value& value);
+  void EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, const Value& value);
+  void EmitStoreGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address, const Value& value,
+                                   bool in_far_code);
 
   // Unconditional branch to pointer. May allocate a scratch register.
   void EmitBranch(const void* address, bool allow_scratch = true);
@@ -167,6 +183,8 @@ private:
   // branch target, memory address, etc
   void BlockPrologue();
   void BlockEpilogue();
+  u32 GetConstantBlockExits(std::array<u32, 2>* exit_pcs) const;
+  void EmitBlockExitLinks();
   void InstructionPrologue(const CodeBlockInstruction& cbi, TickCount cycles, bool force_sync = false);
   void InstructionEpilogue(const CodeBlockInstruction& cbi);
   void AddPendingCycles(bool commit);
@@ -176,6 +194,14 @@ private:
   void UpdateCurrentInstructionPC(bool commit);
   void WriteNewPC(const Value& value, bool commit);
 
+  const InstructionAnalysis& GetInstructionAnalysis(const CodeBlockInstruction& cbi) const
+  {
+    return m_block_analysis[static_cast<size_t>(&cbi - m_block_start)];
+  }
+
+  /// Returns the address accessed by a load/store, folding in any constants known from the block analysis.
+  Value GetLoadStoreAddress(const CodeBlockInstruction& cbi);
+
   Value DoGTERegisterRead(u32 index);
   void DoGTERegisterWrite(u32 index, const Value& value);
 
@@ -201,9 +227,10 @@ private:
   bool Compile_cop2(const CodeBlockInstruction& cbi);
 
   JitCodeBuffer* m_code_buffer;
-  const CodeBlock* m_block = nullptr;
+  CodeBlock* m_block = nullptr;
   const CodeBlockInstruction* m_block_start = nullptr;
   const CodeBlockInstruction* m_block_end = nullptr;
+  std::vector<InstructionAnalysis> m_block_analysis;
   RegisterCache m_register_cache;
   CodeEmitter m_near_emitter;
   CodeEmitter m_far_emitter;
@@ -220,6 +247,9 @@ private:
   bool m_current_instruction_was_branch_taken_dirty = false;
   bool m_load_delay_dirty = false;
   bool m_next_load_delay_dirty = false;
+
+  // whether loads/stores in this block go through fastmem.
+  bool m_fastmem_enabled = false;
 };
 
 } // namespace CPU::Recompiler
@@ -1,6 +1,7 @@
 #include "common/align.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "bus.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "cpu_recompiler_code_generator.h"
@@ -13,6 +14,7 @@ namespace a64 = vixl::aarch64;
 namespace CPU::Recompiler {
 
 constexpr HostReg RCPUPTR = 19;
+constexpr HostReg RMEMBASEPTR = 27;
 constexpr HostReg RRETURN = 0;
 constexpr HostReg RARG1 = 0;
 constexpr HostReg RARG2 = 1;
@@ -74,6 +76,11 @@ static const a64::XRegister GetCPUPtrReg()
   return GetHostReg64(RCPUPTR);
 }
 
+static const a64::XRegister GetFastmemBasePtrReg()
+{
+  return GetHostReg64(RMEMBASEPTR);
+}
+
 CodeGenerator::CodeGenerator(JitCodeBuffer* code_buffer)
   : m_code_buffer(code_buffer), m_register_cache(*this),
     m_near_emitter(static_cast<vixl::byte*>(code_buffer->GetFreeCodePointer()), code_buffer->GetFreeCodeSpace(),
@@ -164,6 +171,13 @@ Value CodeGenerator::GetValueInHostRegister(const Value& value, bool allow_zero_
   return new_value;
 }
 
+static s64 GetBranchDisplacement(const void* current, const void* target)
+{
+  Assert(Common::IsAlignedPow2(reinterpret_cast<size_t>(current), 4));
+  Assert(Common::IsAlignedPow2(reinterpret_cast<size_t>(target), 4));
+  return static_cast<s64>((reinterpret_cast<ptrdiff_t>(target) - reinterpret_cast<ptrdiff_t>(current)) >> 2);
+}
+
 void CodeGenerator::EmitBeginBlock()
 {
   m_emit->Sub(a64::sp, a64::sp, FUNCTION_STACK_SIZE);
@@ -176,10 +190,21 @@ void CodeGenerator::EmitBeginBlock()
   const bool cpu_reg_allocated = m_register_cache.AllocateHostReg(RCPUPTR);
   DebugAssert(cpu_reg_allocated);
   m_emit->Mov(GetCPUPtrReg(), reinterpret_cast<size_t>(&g_state));
+
+  // If there's loadstore instructions, preload the fastmem base.
+  if (m_fastmem_enabled)
+  {
+    const bool fastmem_reg_allocated = m_register_cache.AllocateHostReg(RMEMBASEPTR);
+    DebugAssert(fastmem_reg_allocated);
+    EmitUpdateFastmemBase();
+  }
 }
 
 void CodeGenerator::EmitEndBlock()
 {
+  if (m_fastmem_enabled)
+    m_register_cache.FreeHostReg(RMEMBASEPTR);
+
   m_register_cache.FreeHostReg(RCPUPTR);
   m_register_cache.PopCalleeSavedRegisters(true);
 
@@ -221,6 +246,45 @@ void CodeGenerator::EmitExceptionExitOnBool(const Value& value)
   m_register_cache.PopState();
 }
 
+void CodeGenerator::EmitLinkableBlockExit(u32 target_pc)
+{
+  BlockExitLinkInfo eli;
+  eli.target_pc = target_pc;
+  eli.linked_block = nullptr;
+  const u32 exit_index = static_cast<u32>(m_block->exit_links.size());
+
+  // the dispatcher sets this before calling the block
+  EmitStoreCPUStructField(offsetof(State, current_instruction_pc), Value::FromConstantU32(target_pc));
+
+  // tear down our frame, the successor sets up its own and returns to the dispatcher
+  m_register_cache.PopCalleeSavedRegisters(false);
+  m_emit->Add(a64::sp, a64::sp, FUNCTION_STACK_SIZE);
+
+  // jump to the link stub until the successor is linked
+  eli.host_jump_pc = GetCurrentNearCodePointer();
+  eli.host_stub_pc = GetCurrentFarCodePointer();
+  m_emit->b(GetBranchDisplacement(eli.host_jump_pc, eli.host_stub_pc));
+
+  // the stub tail calls into the code cache, which returns to the dispatcher
+  SwitchToFarCode();
+  m_emit->Mov(GetHostReg64(RARG1), reinterpret_cast<uintptr_t>(m_block));
+  m_emit->Mov(GetHostReg32(RARG2), exit_index);
+  const void* link_function = reinterpret_cast<const void*>(&CodeCache::LinkBlockExit);
+  const s64 displacement = GetBranchDisplacement(GetCurrentCodePointer(), link_function);
+  if (vixl::IsInt26(displacement))
+  {
+    m_emit->b(displacement);
+  }
+  else
+  {
+    m_emit->Mov(GetHostReg64(RARG3), reinterpret_cast<uintptr_t>(link_function));
+    m_emit->Br(GetHostReg64(RARG3));
+  }
+  SwitchToNearCode();
+
+  m_block->exit_links.push_back(eli);
+}
+
 void CodeGenerator::FinalizeBlock(CodeBlock::HostCodePointer* out_host_code, u32* out_host_code_size)
 {
   m_near_emitter.FinalizeCode();
@@ -957,13 +1021,6 @@ void CodeGenerator::RestoreStackAfterCall(u32 adjust_size)
   m_register_cache.PopCallerSavedRegisters();
 }
 
-static s64 GetBranchDisplacement(const void* current, const void* target)
-{
-  Assert(Common::IsAlignedPow2(reinterpret_cast<size_t>(current), 4));
-  Assert(Common::IsAlignedPow2(reinterpret_cast<size_t>(target), 4));
-  return static_cast<s64>((reinterpret_cast<ptrdiff_t>(target) - reinterpret_cast<ptrdiff_t>(current)) >> 2);
-}
-
 void CodeGenerator::EmitFunctionCallPtr(Value* return_value, const void* ptr)
 {
   if (return_value)
@@ -1280,15 +1337,76 @@ void CodeGenerator::EmitAddCPUStructField(u32 offset, const Value& value)
   }
 }
 
-Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const Value& address, RegSize size)
+void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
+                                               Value& result)
 {
-  AddPendingCycles(true);
+  // fastmem
+  LoadStoreBackpatchInfo bpi;
+  bpi.guest_pc = cbi.pc;
+
+  // the upper 32 bits of the address are ignored by the uxtw extend
+  const Value address_reg = GetValueInHostRegister(address);
+  const a64::MemOperand actual_address =
+    a64::MemOperand(GetFastmemBasePtrReg(), GetHostReg32(address_reg.host_reg), a64::UXTW);
+
+  bpi.host_pc = GetCurrentNearCodePointer();
+
+  switch (size)
+  {
+    case RegSize_8:
+      m_emit->ldrb(GetHostReg32(result.host_reg), actual_address);
+      break;
+
+    case RegSize_16:
+      m_emit->ldrh(GetHostReg32(result.host_reg), actual_address);
+      break;
+
+    case RegSize_32:
+      m_emit->ldr(GetHostReg32(result.host_reg), actual_address);
+      break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+
+  bpi.host_code_size =
+    static_cast<u32>(static_cast<u8*>(GetCurrentNearCodePointer()) - static_cast<u8*>(bpi.host_pc));
+
+  // generate slowmem fallback
+  bpi.host_slowmem_pc = GetCurrentFarCodePointer();
+  SwitchToFarCode();
+  m_register_cache.PushState();
+
+  // the handler may read pending_ticks, so sync them up, then remove them again (including the fastmem read ticks)
+  // afterwards, since the near code adds them when the delayed cycles are committed
+  if (m_delayed_cycles_add > 0)
+  {
+    EmitAddCPUStructField(offsetof(State, pending_ticks),
+                          Value::FromConstantU32(static_cast<u32>(m_delayed_cycles_add)));
+  }
+  m_delayed_cycles_add += Bus::RAM_READ_TICKS;
+
+  EmitLoadGuestMemorySlowmem(cbi, address, size, result, true);
+
+  EmitAddCPUStructField(offsetof(State, pending_ticks),
+                        Value::FromConstantU32(static_cast<u32>(-m_delayed_cycles_add)));
+
+  // return to the block code
+  EmitBranch(GetCurrentNearCodePointer(), false);
 
+  m_register_cache.PopState();
+  SwitchToNearCode();
+
+  m_block->loadstore_backpatch_info.push_back(bpi);
+}
+
+void CodeGenerator::EmitLoadGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
+                                               Value& result, bool in_far_code)
+{
   if (g_settings.cpu_recompiler_memory_exceptions)
   {
-    // We need to use the full 64 bits here since we test the sign bit result.
-    Value result = m_register_cache.AllocateScratch(RegSize_64);
-    m_register_cache.FlushCallerSavedGuestRegisters(true, true);
+    Assert(!in_far_code);
 
     // NOTE: This can leave junk in the upper bits
     switch (size)
@@ -1332,34 +1450,9 @@ Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const
     SwitchToNearCode();
 
     m_register_cache.PopState();
-
-    // Downcast to ignore upper 56/48/32 bits. This should be a noop.
-    switch (size)
-    {
-      case RegSize_8:
-        ConvertValueSizeInPlace(&result, RegSize_8, false);
-        break;
-
-      case RegSize_16:
-        ConvertValueSizeInPlace(&result, RegSize_16, false);
-        break;
-
-      case RegSize_32:
-        ConvertValueSizeInPlace(&result, RegSize_32, false);
-        break;
-
-      default:
-        UnreachableCode();
-        break;
-    }
-
-    return result;
   }
   else
   {
-    Value result = m_register_cache.AllocateScratch(RegSize_32);
-    m_register_cache.FlushCallerSavedGuestRegisters(true, true);
-
     switch (size)
     {
       case RegSize_8:
@@ -1378,39 +1471,82 @@ Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const
         UnreachableCode();
         break;
     }
+  }
+}
 
-    // Downcast to ignore upper 56/48/32 bits. This should be a noop.
-    switch (size)
-    {
-      case RegSize_8:
-        ConvertValueSizeInPlace(&result, RegSize_8, false);
-        break;
+void CodeGenerator::EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address,
+                                                const Value& value)
+{
+  // fastmem
+  LoadStoreBackpatchInfo bpi;
+  bpi.guest_pc = cbi.pc;
 
-      case RegSize_16:
-        ConvertValueSizeInPlace(&result, RegSize_16, false);
-        break;
+  const Value address_reg = GetValueInHostRegister(address);
+  const Value value_reg = GetValueInHostRegister(value);
+  const a64::MemOperand actual_address =
+    a64::MemOperand(GetFastmemBasePtrReg(), GetHostReg32(address_reg.host_reg), a64::UXTW);
 
-      case RegSize_32:
-        break;
+  bpi.host_pc = GetCurrentNearCodePointer();
 
-      default:
-        UnreachableCode();
-        break;
-    }
+  switch (value.size)
+  {
+    case RegSize_8:
+      m_emit->strb(GetHostReg32(value_reg.host_reg), actual_address);
+      break;
 
-    return result;
+    case RegSize_16:
+      m_emit->strh(GetHostReg32(value_reg.host_reg), actual_address);
+      break;
+
+    case RegSize_32:
+      m_emit->str(GetHostReg32(value_reg.host_reg), actual_address);
+      break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+
+  bpi.host_code_size =
+    static_cast<u32>(static_cast<u8*>(GetCurrentNearCodePointer()) - static_cast<u8*>(bpi.host_pc));
+
+  // generate slowmem fallback
+  bpi.host_slowmem_pc = GetCurrentFarCodePointer();
+  SwitchToFarCode();
+  m_register_cache.PushState();
+
+  // the handler may read pending_ticks, so sync them up, then remove them again afterwards
+  if (m_delayed_cycles_add > 0)
+  {
+    EmitAddCPUStructField(offsetof(State, pending_ticks),
+                          Value::FromConstantU32(static_cast<u32>(m_delayed_cycles_add)));
   }
+
+  EmitStoreGuestMemorySlowmem(cbi, address, value, true);
+
+  if (m_delayed_cycles_add > 0)
+  {
+    EmitAddCPUStructField(offsetof(State, pending_ticks),
+                          Value::FromConstantU32(static_cast<u32>(-m_delayed_cycles_add)));
+  }
+
+  // return to the block code
+  EmitBranch(GetCurrentNearCodePointer(), false);
+
+  m_register_cache.PopState();
+  SwitchToNearCode();
+
+  m_block->loadstore_backpatch_info.push_back(bpi);
 }
 
-void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const Value& address, const Value& value)
+void CodeGenerator::EmitStoreGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address,
+                                                const Value& value, bool in_far_code)
 {
-  AddPendingCycles(true);
-
   if (g_settings.cpu_recompiler_memory_exceptions)
   {
-    Value result = m_register_cache.AllocateScratch(RegSize_32);
-    m_register_cache.FlushCallerSavedGuestRegisters(true, true);
+    Assert(!in_far_code);
 
+    Value result = m_register_cache.AllocateScratch(RegSize_32);
     switch (value.size)
     {
       case RegSize_8:
@@ -1454,8 +1590,6 @@ void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const
   }
   else
   {
-    m_register_cache.FlushCallerSavedGuestRegisters(true, true);
-
     switch (value.size)
     {
       case RegSize_8:
@@ -1477,9 +1611,61 @@ void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const
   }
 }
 
+void CodeGenerator::BackpatchLoadStore(const LoadStoreBackpatchInfo& lbi)
+{
+  // turn it into a jump to the slowmem handler
+  const s64 displacement = GetBranchDisplacement(lbi.host_pc, lbi.host_slowmem_pc);
+  Assert(a64::Instruction::IsValidImmPCOffset(a64::UncondBranchType, displacement));
+
+  a64::Assembler emit(static_cast<vixl::byte*>(lbi.host_pc), lbi.host_code_size, a64::PositionDependentCode);
+  emit.b(displacement);
+  emit.FinalizeCode();
+  Assert(static_cast<u32>(emit.GetCursorOffset()) == lbi.host_code_size);
+
+  JitCodeBuffer::FlushInstructionCache(lbi.host_pc, lbi.host_code_size);
+}
+
+void CodeGenerator::PatchBlockExitJump(const BlockExitLinkInfo& eli, const void* target)
+{
+  const s64 displacement = GetBranchDisplacement(eli.host_jump_pc, target);
+  Assert(a64::Instruction::IsValidImmPCOffset(a64::UncondBranchType, displacement));
+
+  a64::Assembler emit(static_cast<vixl::byte*>(eli.host_jump_pc), sizeof(u32), a64::PositionDependentCode);
+  emit.b(displacement);
+  emit.FinalizeCode();
+
+  JitCodeBuffer::FlushInstructionCache(eli.host_jump_pc, sizeof(u32));
+}
+
 void CodeGenerator::EmitLoadGlobal(HostReg host_reg, RegSize size, const void* ptr)
 {
-  Panic("Not implemented");
+  // use the destination register for the address, saves allocating a temporary
+  m_emit->Mov(GetHostReg64(host_reg), reinterpret_cast<uintptr_t>(ptr));
+
+  switch (size)
+  {
+    case RegSize_8:
+      m_emit->Ldrb(GetHostReg8(host_reg), a64::MemOperand(GetHostReg64(host_reg)));
+      break;
+
+    case RegSize_16:
+      m_emit->Ldrh(GetHostReg16(host_reg), a64::MemOperand(GetHostReg64(host_reg)));
+      break;
+
+    case RegSize_32:
+      m_emit->Ldr(GetHostReg32(host_reg), a64::MemOperand(GetHostReg64(host_reg)));
+      break;
+
+    case RegSize_64:
+      m_emit->Ldr(GetHostReg64(host_reg), a64::MemOperand(GetHostReg64(host_reg)));
+      break;
+
+    default:
+    {
+      UnreachableCode();
+    }
+    break;
+  }
 }
 
 void CodeGenerator::EmitStoreGlobal(void* ptr, const Value& value)
@@ -1562,6 +1748,14 @@ void CodeGenerator::EmitCancelInterpreterLoadDelayForReg(Reg reg)
   m_emit->Bind(&skip_cancel);
 }
 
+void CodeGenerator::EmitUpdateFastmemBase()
+{
+  if (!m_fastmem_enabled)
+    return;
+
+  m_emit->Ldr(GetFastmemBasePtrReg(), a64::MemOperand(GetCPUPtrReg(), offsetof(State, fastmem_base)));
+}
+
 void CodeGenerator::EmitBranch(const void* address, bool allow_scratch)
 {
   const s64 jump_distance =
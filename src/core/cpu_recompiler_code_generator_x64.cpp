@@ -1,4 +1,5 @@
 #include "common/align.h"
+#include "bus.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "cpu_recompiler_code_generator.h"
@@ -16,6 +17,7 @@ constexpr HostReg RARG3 = Xbyak::Operand::R8;
 constexpr HostReg RARG4 = Xbyak::Operand::R9;
 constexpr u32 FUNCTION_CALL_SHADOW_SPACE = 32;
 constexpr u64 FUNCTION_CALL_STACK_ALIGNMENT = 16;
+constexpr HostReg RMEMBASEPTR = Xbyak::Operand::RBX;
 #elif defined(ABI_SYSV)
 constexpr HostReg RCPUPTR = Xbyak::Operand::RBP;
 constexpr HostReg RRETURN = Xbyak::Operand::RAX;
@@ -25,8 +27,12 @@ constexpr HostReg RARG3 = Xbyak::Operand::RDX;
 constexpr HostReg RARG4 = Xbyak::Operand::RCX;
 constexpr u32 FUNCTION_CALL_SHADOW_SPACE = 0;
 constexpr u64 FUNCTION_CALL_STACK_ALIGNMENT = 16;
+constexpr HostReg RMEMBASEPTR = Xbyak::Operand::RBX;
 #endif
 
+// Size of a jmp rel32, which fastmem loads/stores are padded to.
+constexpr u32 BACKPATCH_JMP_SIZE = 5;
+
 static const Xbyak::Reg8 GetHostReg8(HostReg reg)
 {
   return Xbyak::Reg8(reg, reg >= Xbyak::Operand::SPL);
@@ -76,6 +82,11 @@ static const Xbyak::Reg64 GetCPUPtrReg()
   return GetHostReg64(RCPUPTR);
 }
 
+static const Xbyak::Reg64 GetFastmemBasePtrReg()
+{
+  return GetHostReg64(RMEMBASEPTR);
+}
+
 CodeGenerator::CodeGenerator(JitCodeBuffer* code_buffer)
   : m_code_buffer(code_buffer), m_register_cache(*this),
     m_near_emitter(code_buffer->GetFreeCodeSpace(), code_buffer->GetFreeCodePointer()),
@@ -191,10 +202,21 @@ void CodeGenerator::EmitBeginBlock()
   const bool cpu_reg_allocated = m_register_cache.AllocateHostReg(RCPUPTR);
   DebugAssert(cpu_reg_allocated);
   m_emit->mov(GetCPUPtrReg(), reinterpret_cast<size_t>(&g_state));
+
+  // If there's loadstore instructions, preload the fastmem base.
+  if (m_fastmem_enabled)
+  {
+    const bool fastmem_reg_allocated = m_register_cache.AllocateHostReg(RMEMBASEPTR);
+    DebugAssert(fastmem_reg_allocated);
+    EmitUpdateFastmemBase();
+  }
 }
 
 void CodeGenerator::EmitEndBlock()
 {
+  if (m_fastmem_enabled)
+    m_register_cache.FreeHostReg(RMEMBASEPTR);
+
   m_register_cache.FreeHostReg(RCPUPTR);
   m_register_cache.PopCalleeSavedRegisters(true);
 
@@ -232,6 +254,35 @@ void CodeGenerator::EmitExceptionExitOnBool(const Value& value)
   m_register_cache.PopState();
 }
 
+void CodeGenerator::EmitLinkableBlockExit(u32 target_pc)
+{
+  BlockExitLinkInfo eli;
+  eli.target_pc = target_pc;
+  eli.linked_block = nullptr;
+  const u32 exit_index = static_cast<u32>(m_block->exit_links.size());
+
+  // the dispatcher sets this before calling the block
+  EmitStoreCPUStructField(offsetof(State, current_instruction_pc), Value::FromConstantU32(target_pc));
+
+  // tear down our frame, the successor sets up its own and returns to the dispatcher
+  m_register_cache.PopCalleeSavedRegisters(false);
+
+  // jump to the link stub until the successor is linked
+  eli.host_jump_pc = GetCurrentNearCodePointer();
+  eli.host_stub_pc = GetCurrentFarCodePointer();
+  m_emit->jmp(eli.host_stub_pc, Xbyak::CodeGenerator::T_NEAR);
+
+  // the stub tail calls into the code cache, which returns to the dispatcher
+  SwitchToFarCode();
+  m_emit->mov(GetHostReg64(RARG1), reinterpret_cast<size_t>(m_block));
+  m_emit->mov(GetHostReg32(RARG2), exit_index);
+  m_emit->mov(GetHostReg64(RRETURN), reinterpret_cast<size_t>(&CodeCache::LinkBlockExit));
+  m_emit->jmp(GetHostReg64(RRETURN));
+  SwitchToNearCode();
+
+  m_block->exit_links.push_back(eli);
+}
+
 void CodeGenerator::FinalizeBlock(CodeBlock::HostCodePointer* out_host_code, u32* out_host_code_size)
 {
   m_near_emitter.ready();
@@ -1736,15 +1787,101 @@ void CodeGenerator::EmitAddCPUStructField(u32 offset, const Value& value)
   }
 }
 
-Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const Value& address, RegSize size)
+void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
+                                               Value& result)
 {
-  AddPendingCycles(true);
+  // fastmem
+  LoadStoreBackpatchInfo bpi;
+  bpi.guest_pc = cbi.pc;
 
+  // can't use a disp32 for addresses with the upper bit set, since it'll be sign-extended
+  Value temp_address;
+  HostReg address_reg = HostReg_Invalid;
+  u32 address_disp = 0;
+  if (address.IsConstant())
+  {
+    if (address.constant_value < UINT64_C(0x80000000))
+    {
+      address_disp = static_cast<u32>(address.constant_value);
+    }
+    else
+    {
+      temp_address = m_register_cache.AllocateScratch(RegSize_32);
+      m_emit->mov(GetHostReg32(temp_address), static_cast<u32>(address.constant_value));
+      address_reg = temp_address.host_reg;
+    }
+  }
+  else
+  {
+    address_reg = address.host_reg;
+  }
+
+  const Xbyak::RegExp actual_address = (address_reg != HostReg_Invalid) ?
+                                         (GetFastmemBasePtrReg() + GetHostReg64(address_reg)) :
+                                         (GetFastmemBasePtrReg() + address_disp);
+
+  bpi.host_pc = GetCurrentNearCodePointer();
+
+  switch (size)
+  {
+    case RegSize_8:
+      m_emit->movzx(GetHostReg32(result.host_reg), m_emit->byte[actual_address]);
+      break;
+
+    case RegSize_16:
+      m_emit->movzx(GetHostReg32(result.host_reg), m_emit->word[actual_address]);
+      break;
+
+    case RegSize_32:
+      m_emit->mov(GetHostReg32(result.host_reg), m_emit->dword[actual_address]);
+      break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+
+  // need to pad the load so the backpatched jump fits
+  while ((static_cast<u8*>(GetCurrentNearCodePointer()) - static_cast<u8*>(bpi.host_pc)) < BACKPATCH_JMP_SIZE)
+    m_emit->nop();
+
+  bpi.host_code_size =
+    static_cast<u32>(static_cast<u8*>(GetCurrentNearCodePointer()) - static_cast<u8*>(bpi.host_pc));
+
+  // generate slowmem fallback
+  bpi.host_slowmem_pc = GetCurrentFarCodePointer();
+  SwitchToFarCode();
+  m_register_cache.PushState();
+
+  // the handler may read pending_ticks, so sync them up, then remove them again (including the fastmem read ticks)
+  // afterwards, since the near code adds them when the delayed cycles are committed
+  if (m_delayed_cycles_add > 0)
+  {
+    EmitAddCPUStructField(offsetof(State, pending_ticks),
+                          Value::FromConstantU32(static_cast<u32>(m_delayed_cycles_add)));
+  }
+  m_delayed_cycles_add += Bus::RAM_READ_TICKS;
+
+  EmitLoadGuestMemorySlowmem(cbi, address, size, result, true);
+
+  EmitAddCPUStructField(offsetof(State, pending_ticks),
+                        Value::FromConstantU32(static_cast<u32>(-m_delayed_cycles_add)));
+
+  // return to the block code
+  m_emit->jmp(GetCurrentNearCodePointer());
+
+  m_register_cache.PopState();
+  SwitchToNearCode();
+
+  m_block->loadstore_backpatch_info.push_back(bpi);
+}
+
+void CodeGenerator::EmitLoadGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
+                                               Value& result, bool in_far_code)
+{
   if (g_settings.cpu_recompiler_memory_exceptions)
   {
-    // We need to use the full 64 bits here since we test the sign bit result.
-    Value result = m_register_cache.AllocateScratch(RegSize_64);
-    m_register_cache.FlushCallerSavedGuestRegisters(true, true);
+    Assert(!in_far_code);
 
     // NOTE: This can leave junk in the upper bits
     switch (size)
@@ -1786,85 +1923,143 @@ Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const
     SwitchToNearCode();
 
     m_register_cache.PopState();
-
-    // Downcast to ignore upper 56/48/32 bits. This should be a noop.
+  }
+  else
+  {
     switch (size)
     {
       case RegSize_8:
-        ConvertValueSizeInPlace(&result, RegSize_8, false);
+        EmitFunctionCall(&result, &Thunks::UncheckedReadMemoryByte, address);
         break;
 
       case RegSize_16:
-        ConvertValueSizeInPlace(&result, RegSize_16, false);
+        EmitFunctionCall(&result, &Thunks::UncheckedReadMemoryHalfWord, address);
         break;
 
       case RegSize_32:
-        ConvertValueSizeInPlace(&result, RegSize_32, false);
+        EmitFunctionCall(&result, &Thunks::UncheckedReadMemoryWord, address);
         break;
 
       default:
         UnreachableCode();
         break;
     }
+  }
+}
+
+void CodeGenerator::EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address,
+                                                const Value& value)
+{
+  // fastmem
+  LoadStoreBackpatchInfo bpi;
+  bpi.guest_pc = cbi.pc;
 
-    return result;
+  // can't use a disp32 for addresses with the upper bit set, since it'll be sign-extended
+  Value temp_address;
+  HostReg address_reg = HostReg_Invalid;
+  u32 address_disp = 0;
+  if (address.IsConstant())
+  {
+    if (address.constant_value < UINT64_C(0x80000000))
+    {
+      address_disp = static_cast<u32>(address.constant_value);
+    }
+    else
+    {
+      temp_address = m_register_cache.AllocateScratch(RegSize_32);
+      m_emit->mov(GetHostReg32(temp_address), static_cast<u32>(address.constant_value));
+      address_reg = temp_address.host_reg;
+    }
   }
   else
   {
-    Value result = m_register_cache.AllocateScratch(RegSize_32);
-    m_register_cache.FlushCallerSavedGuestRegisters(true, true);
+    address_reg = address.host_reg;
+  }
 
-    switch (size)
-    {
-      case RegSize_8:
-        EmitFunctionCall(&result, &Thunks::UncheckedReadMemoryByte, address);
-        break;
+  const Xbyak::RegExp actual_address = (address_reg != HostReg_Invalid) ?
+                                         (GetFastmemBasePtrReg() + GetHostReg64(address_reg)) :
+                                         (GetFastmemBasePtrReg() + address_disp);
 
-      case RegSize_16:
-        EmitFunctionCall(&result, &Thunks::UncheckedReadMemoryHalfWord, address);
-        break;
+  bpi.host_pc = GetCurrentNearCodePointer();
 
-      case RegSize_32:
-        EmitFunctionCall(&result, &Thunks::UncheckedReadMemoryWord, address);
-        break;
+  switch (value.size)
+  {
+    case RegSize_8:
+    {
+      if (value.IsConstant())
+        m_emit->mov(m_emit->byte[actual_address], static_cast<u32>(value.constant_value & 0xFFu));
+      else
+        m_emit->mov(m_emit->byte[actual_address], GetHostReg8(value.host_reg));
+    }
+    break;
 
-      default:
-        UnreachableCode();
-        break;
+    case RegSize_16:
+    {
+      if (value.IsConstant())
+        m_emit->mov(m_emit->word[actual_address], static_cast<u32>(value.constant_value & 0xFFFFu));
+      else
+        m_emit->mov(m_emit->word[actual_address], GetHostReg16(value.host_reg));
     }
+    break;
 
-    // Downcast to ignore upper 56/48/32 bits. This should be a noop.
-    switch (size)
+    case RegSize_32:
     {
-      case RegSize_8:
-        ConvertValueSizeInPlace(&result, RegSize_8, false);
-        break;
+      if (value.IsConstant())
+        m_emit->mov(m_emit->dword[actual_address], static_cast<u32>(value.constant_value));
+      else
+        m_emit->mov(m_emit->dword[actual_address], GetHostReg32(value.host_reg));
+    }
+    break;
 
-      case RegSize_16:
-        ConvertValueSizeInPlace(&result, RegSize_16, false);
-        break;
+    default:
+      UnreachableCode();
+      break;
+  }
 
-      case RegSize_32:
-        break;
+  // need to pad the store so the backpatched jump fits
+  while ((static_cast<u8*>(GetCurrentNearCodePointer()) - static_cast<u8*>(bpi.host_pc)) < BACKPATCH_JMP_SIZE)
+    m_emit->nop();
 
-      default:
-        UnreachableCode();
-        break;
-    }
+  bpi.host_code_size =
+    static_cast<u32>(static_cast<u8*>(GetCurrentNearCodePointer()) - static_cast<u8*>(bpi.host_pc));
 
-    return result;
+  // generate slowmem fallback
+  bpi.host_slowmem_pc = GetCurrentFarCodePointer();
+  SwitchToFarCode();
+  m_register_cache.PushState();
+
+  // the handler may read pending_ticks, so sync them up, then remove them again afterwards
+  if (m_delayed_cycles_add > 0)
+  {
+    EmitAddCPUStructField(offsetof(State, pending_ticks),
+                          Value::FromConstantU32(static_cast<u32>(m_delayed_cycles_add)));
+  }
+
+  EmitStoreGuestMemorySlowmem(cbi, address, value, true);
+
+  if (m_delayed_cycles_add > 0)
+  {
+    EmitAddCPUStructField(offsetof(State, pending_ticks),
+                          Value::FromConstantU32(static_cast<u32>(-m_delayed_cycles_add)));
   }
+
+  // return to the block code
+  m_emit->jmp(GetCurrentNearCodePointer());
+
+  m_register_cache.PopState();
+  SwitchToNearCode();
+
+  m_block->loadstore_backpatch_info.push_back(bpi);
 }
 
-void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const Value& address, const Value& value)
+void CodeGenerator::EmitStoreGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address,
+                                                const Value& value, bool in_far_code)
 {
-  AddPendingCycles(true);
-
   if (g_settings.cpu_recompiler_memory_exceptions)
   {
-    Value result = m_register_cache.AllocateScratch(RegSize_32);
-    m_register_cache.FlushCallerSavedGuestRegisters(true, true);
+    Assert(!in_far_code);
 
+    Value result = m_register_cache.AllocateScratch(RegSize_32);
     switch (value.size)
     {
       case RegSize_8:
@@ -1906,8 +2101,6 @@ void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const
   }
   else
   {
-    m_register_cache.FlushCallerSavedGuestRegisters(true, true);
-
     switch (value.size)
     {
       case RegSize_8:
@@ -1929,6 +2122,28 @@ void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const
   }
 }
 
+void CodeGenerator::BackpatchLoadStore(const LoadStoreBackpatchInfo& lbi)
+{
+  // turn it into a jump to the slowmem handler
+  Xbyak::CodeGenerator cg(lbi.host_code_size, lbi.host_pc);
+  cg.jmp(lbi.host_slowmem_pc);
+
+  const s32 nops = static_cast<s32>(lbi.host_code_size) -
+                   static_cast<s32>(static_cast<ptrdiff_t>(cg.getCurr() - static_cast<u8*>(lbi.host_pc)));
+  Assert(nops >= 0);
+  for (s32 i = 0; i < nops; i++)
+    cg.nop();
+
+  JitCodeBuffer::FlushInstructionCache(lbi.host_pc, lbi.host_code_size);
+}
+
+void CodeGenerator::PatchBlockExitJump(const BlockExitLinkInfo& eli, const void* target)
+{
+  Xbyak::CodeGenerator cg(BACKPATCH_JMP_SIZE, eli.host_jump_pc);
+  cg.jmp(target, Xbyak::CodeGenerator::T_NEAR);
+  JitCodeBuffer::FlushInstructionCache(eli.host_jump_pc, BACKPATCH_JMP_SIZE);
+}
+
 void CodeGenerator::EmitLoadGlobal(HostReg host_reg, RegSize size, const void* ptr)
 {
   const s64 displacement =
@@ -2233,6 +2448,14 @@ void CodeGenerator::EmitICacheCheckAndUpdate()
   m_register_cache.UnunhibitAllocation();
 }
 
+void CodeGenerator::EmitUpdateFastmemBase()
+{
+  if (!m_fastmem_enabled)
+    return;
+
+  m_emit->mov(GetFastmemBasePtrReg(), m_emit->qword[GetCPUPtrReg() + offsetof(State, fastmem_base)]);
+}
+
 void CodeGenerator::EmitBranch(const void* address, bool allow_scratch)
 {
   const s64 jump_distance =
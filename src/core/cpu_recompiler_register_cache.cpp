@@ -686,7 +686,13 @@ void RegisterCache::FlushLoadDelay(bool clear)
 void RegisterCache::FlushGuestRegister(Reg guest_reg, bool invalidate, bool clear_dirty)
 {
   Value& cache_value = m_state.guest_reg_state[static_cast<u8>(guest_reg)];
-  if (cache_value.IsDirty())
+  if (cache_value.IsDirty() && invalidate && (m_dead_guest_registers & GetRegisterMask(guest_reg)) != 0)
+  {
+    // the value is never read, so don't bother writing it back
+    Log_DebugPrintf("Discarding dead guest register %s", GetRegName(guest_reg));
+    cache_value.ClearDirty();
+  }
+  else if (cache_value.IsDirty())
   {
     if (cache_value.IsInHostRegister())
     {
@@ -312,6 +312,10 @@ public:
   void FlushLoadDelay(bool clear);
 
   void FlushGuestRegister(Reg guest_reg, bool invalidate, bool clear_dirty);
+
+  /// Sets the guest registers which are overwritten before being read again, by GetRegisterMask(). Dirty values in
+  /// these registers are discarded instead of written back when they're flushed and invalidated.
+  void SetDeadGuestRegisters(u64 mask) { m_dead_guest_registers = mask; }
   void InvalidateGuestRegister(Reg guest_reg);
 
   void InvalidateAllNonDirtyGuestRegisters();
@@ -354,6 +358,8 @@ private:
   } m_state;
 
   std::stack<RegAllocState> m_state_stack;
+
+  u64 m_dead_guest_registers = 0;
 };
 
 } // namespace CPU::Recompiler
\ No newline at end of file
@@ -14,8 +14,12 @@ namespace Recompiler::Thunks {
 //////////////////////////////////////////////////////////////////////////
 bool InterpretInstruction();
 bool InterpretInstructionPGXP();
+bool InterpretInstructionPGXPCPU();
 void CheckAndUpdateICache(u32 pc, u32 line_count);
 
+// PGXP CPU-mode tracking for mult/div, which computes hi/lo itself to stay within four arguments.
+void PGXPMultiplyDivide(u32 instr, u32 rsVal, u32 rtVal);
+
 // Memory access functions for the JIT - MSB is set on exception.
 u64 ReadMemoryByte(u32 address);
 u64 ReadMemoryHalfWord(u32 address);
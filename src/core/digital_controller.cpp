@@ -37,6 +37,12 @@ bool DigitalController::DoState(StateWrapper& sw)
   return true;
 }
 
+bool DigitalController::DoInputState(StateWrapper& sw)
+{
+  sw.Do(&m_button_state);
+  return !sw.HasError();
+}
+
 void DigitalController::SetAxisState(s32 axis_code, float value) {}
 
 void DigitalController::SetButtonState(Button button, bool pressed)
@@ -44,6 +44,7 @@ public:
 
   void Reset() override;
   bool DoState(StateWrapper& sw) override;
+  bool DoInputState(StateWrapper& sw) override;
 
   void SetAxisState(s32 axis_code, float value) override;
   void SetButtonState(s32 button_code, bool pressed) override;
@@ -6,6 +6,7 @@
 #include "common/file_system.h"
 #include "common/iso_reader.h"
 #include "common/log.h"
+#include "common/mapped_file.h"
 #include "common/progress_callback.h"
 #include "common/string_util.h"
 #include "host_interface.h"
@@ -13,8 +14,11 @@
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
 #include <string_view>
+#include <thread>
 #include <tinyxml2.h>
 #include <utility>
 Log_SetChannel(GameList);
@@ -36,6 +40,13 @@ const char* GameList::EntryCompatibilityRatingToString(GameListCompatibilityRati
   return names[static_cast<int>(rating)];
 }
 
+const char* GameList::VerificationResultToString(GameListVerificationResult result)
+{
+  static std::array<const char*, static_cast<int>(GameListVerificationResult::Count)> names = {
+    {"NotInDatabase", "Verified", "Mismatch", "ReadError"}};
+  return names[static_cast<int>(result)];
+}
+
 std::string GameList::GetGameCodeForPath(const char* image_path)
 {
   std::unique_ptr<CDImage> cdi = CDImage::Open(image_path);
@@ -348,6 +359,7 @@ bool GameList::GetExeListEntry(const char* path, GameListEntry* entry)
   entry->region = DiscRegion::Other;
   entry->total_size = ZeroExtend64(file_size);
   entry->last_modified_time = ffd.ModificationTime.AsUnixTimestamp();
+  entry->file_size = ffd.Size;
   entry->type = GameListEntryType::PSExe;
   entry->compatibility_rating = GameListCompatibilityRating::Unknown;
 
@@ -370,6 +382,7 @@ bool GameList::GetM3UListEntry(const char* path, GameListEntry* entry)
   entry->region = DiscRegion::Other;
   entry->total_size = 0;
   entry->last_modified_time = ffd.ModificationTime.AsUnixTimestamp();
+  entry->file_size = ffd.Size;
   entry->type = GameListEntryType::Playlist;
   entry->compatibility_rating = GameListCompatibilityRating::Unknown;
 
@@ -465,44 +478,112 @@ bool GameList::GetGameListEntry(const std::string& path, GameListEntry* entry)
     return false;
 
   entry->last_modified_time = ffd.ModificationTime.AsUnixTimestamp();
+  entry->file_size = ffd.Size;
   return true;
 }
 
-bool GameList::GetGameListEntryFromCache(const std::string& path, GameListEntry* entry)
+// FNV-1a, the hashes are stored in the cache so they have to be the same on every run.
+static u64 GetCachePathHash(const std::string& path)
 {
-  auto iter = m_cache_map.find(path);
-  if (iter == m_cache_map.end())
+  u64 hash = UINT64_C(0xcbf29ce484222325);
+  for (const char ch : path)
+  {
+    hash ^= static_cast<u8>(ch);
+    hash *= UINT64_C(0x100000001b3);
+  }
+
+  return hash;
+}
+
+bool GameList::GetGameListEntryFromCache(const std::string& path, u64 last_modified_time, u64 file_size,
+                                         GameListEntry* entry)
+{
+  if (!m_cache_index)
     return false;
 
-  *entry = std::move(iter->second);
-  m_cache_map.erase(iter);
-  return true;
+  const u64 path_hash = GetCachePathHash(path);
+  const CacheIndexEntry* end = m_cache_index + m_cache_entry_count;
+  const CacheIndexEntry* iter =
+    std::lower_bound(m_cache_index, end, path_hash,
+                     [](const CacheIndexEntry& ie, u64 hash) { return ie.path_hash < hash; });
+  for (; iter != end && iter->path_hash == path_hash; ++iter)
+  {
+    // anything which changed on disk has to be scanned again
+    if (iter->last_modified_time != last_modified_time || iter->file_size != file_size)
+      continue;
+
+    if (iter->offset >= m_cache_file->GetSize())
+    {
+      Log_WarningPrintf("Game list cache entry is corrupted (offset)");
+      return false;
+    }
+
+    ReadOnlyMemoryByteStream stream(m_cache_file->GetData() + iter->offset,
+                                    static_cast<u32>(m_cache_file->GetSize() - iter->offset));
+    if (!ReadEntryFromCache(&stream, entry))
+    {
+      Log_WarningPrintf("Game list cache entry is corrupted");
+      return false;
+    }
+
+    if (entry->path == path)
+      return true;
+  }
+
+  return false;
 }
 
 void GameList::LoadCache()
 {
+  CloseCache();
   if (m_cache_filename.empty())
     return;
 
-  std::unique_ptr<ByteStream> stream =
-    FileSystem::OpenFile(m_cache_filename.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
-  if (!stream)
+  std::FILE* fp = FileSystem::OpenCFile(m_cache_filename.c_str(), "rb");
+  if (!fp)
+    return;
+
+  m_cache_file = std::make_unique<Common::MappedFile>();
+  const bool mapped = m_cache_file->Map(fp);
+  std::fclose(fp);
+  if (!mapped)
+  {
+    m_cache_file.reset();
+    return;
+  }
+
+  CacheHeader header;
+  if (m_cache_file->GetSize() < sizeof(header))
+  {
+    Log_WarningPrintf("Deleting corrupted cache file '%s'", m_cache_filename.c_str());
+    DeleteCacheFile();
     return;
+  }
 
-  if (!LoadEntriesFromCache(stream.get()))
+  std::memcpy(&header, m_cache_file->GetData(), sizeof(header));
+  if (header.signature != GAME_LIST_CACHE_SIGNATURE || header.version != GAME_LIST_CACHE_VERSION ||
+      (sizeof(header) + static_cast<u64>(header.entry_count) * sizeof(CacheIndexEntry)) > m_cache_file->GetSize())
   {
     Log_WarningPrintf("Deleting corrupted cache file '%s'", m_cache_filename.c_str());
-    stream.reset();
-    m_cache_map.clear();
     DeleteCacheFile();
     return;
   }
+
+  m_cache_index = reinterpret_cast<const CacheIndexEntry*>(m_cache_file->GetData() + sizeof(header));
+  m_cache_entry_count = header.entry_count;
+}
+
+void GameList::CloseCache()
+{
+  m_cache_index = nullptr;
+  m_cache_entry_count = 0;
+  m_cache_file.reset();
 }
 
 static bool ReadString(ByteStream* stream, std::string* dest)
 {
   u32 size;
-  if (!stream->Read2(&size, sizeof(size)))
+  if (!stream->Read2(&size, sizeof(size)) || size > (stream->GetSize() - stream->GetPosition()))
     return false;
 
   dest->resize(size);
@@ -517,11 +598,6 @@ static bool ReadU8(ByteStream* stream, u8* dest)
   return stream->Read2(dest, sizeof(u8));
 }
 
-static bool ReadU32(ByteStream* stream, u32* dest)
-{
-  return stream->Read2(dest, sizeof(u32));
-}
-
 static bool ReadU64(ByteStream* stream, u64* dest)
 {
   return stream->Read2(dest, sizeof(u64));
@@ -538,99 +614,31 @@ static bool WriteU8(ByteStream* stream, u8 dest)
   return stream->Write2(&dest, sizeof(u8));
 }
 
-static bool WriteU32(ByteStream* stream, u32 dest)
-{
-  return stream->Write2(&dest, sizeof(u32));
-}
-
 static bool WriteU64(ByteStream* stream, u64 dest)
 {
   return stream->Write2(&dest, sizeof(u64));
 }
 
-bool GameList::LoadEntriesFromCache(ByteStream* stream)
+bool GameList::ReadEntryFromCache(ByteStream* stream, GameListEntry* entry)
 {
-  u32 file_signature, file_version;
-  if (!ReadU32(stream, &file_signature) || !ReadU32(stream, &file_version) ||
-      file_signature != GAME_LIST_CACHE_SIGNATURE || file_version != GAME_LIST_CACHE_VERSION)
+  u8 region;
+  u8 type;
+  u8 compatibility_rating;
+
+  if (!ReadString(stream, &entry->path) || !ReadString(stream, &entry->code) || !ReadString(stream, &entry->title) ||
+      !ReadU64(stream, &entry->total_size) || !ReadU64(stream, &entry->last_modified_time) ||
+      !ReadU64(stream, &entry->file_size) || !ReadU8(stream, &region) ||
+      region >= static_cast<u8>(DiscRegion::Count) || !ReadU8(stream, &type) ||
+      type > static_cast<u8>(GameListEntryType::Playlist) || !ReadU8(stream, &compatibility_rating) ||
+      compatibility_rating >= static_cast<u8>(GameListCompatibilityRating::Count))
   {
-    Log_WarningPrintf("Game list cache is corrupted");
-    return false;
-  }
-
-  while (stream->GetPosition() != stream->GetSize())
-  {
-    std::string path;
-    std::string code;
-    std::string title;
-    u64 total_size;
-    u64 last_modified_time;
-    u8 region;
-    u8 type;
-    u8 compatibility_rating;
-
-    if (!ReadString(stream, &path) || !ReadString(stream, &code) || !ReadString(stream, &title) ||
-        !ReadU64(stream, &total_size) || !ReadU64(stream, &last_modified_time) || !ReadU8(stream, &region) ||
-        region >= static_cast<u8>(DiscRegion::Count) || !ReadU8(stream, &type) ||
-        type > static_cast<u8>(GameListEntryType::Playlist) || !ReadU8(stream, &compatibility_rating) ||
-        compatibility_rating >= static_cast<u8>(GameListCompatibilityRating::Count))
-    {
-      Log_WarningPrintf("Game list cache entry is corrupted");
-      return false;
-    }
-
-    GameListEntry ge;
-    ge.path = path;
-    ge.code = std::move(code);
-    ge.title = std::move(title);
-    ge.total_size = total_size;
-    ge.last_modified_time = last_modified_time;
-    ge.region = static_cast<DiscRegion>(region);
-    ge.type = static_cast<GameListEntryType>(type);
-    ge.compatibility_rating = static_cast<GameListCompatibilityRating>(compatibility_rating);
-
-    if (!ge.settings.LoadFromStream(stream))
-    {
-      Log_WarningPrintf("Game list cache entry is corrupted (settings)");
-      return false;
-    }
-
-    auto iter = m_cache_map.find(ge.path);
-    if (iter != m_cache_map.end())
-      iter->second = std::move(ge);
-    else
-      m_cache_map.emplace(std::move(path), std::move(ge));
-  }
-
-  return true;
-}
-
-bool GameList::OpenCacheForWriting()
-{
-  if (m_cache_filename.empty())
     return false;
-
-  Assert(!m_cache_write_stream);
-  m_cache_write_stream =
-    FileSystem::OpenFile(m_cache_filename.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE |
-                                                     BYTESTREAM_OPEN_APPEND | BYTESTREAM_OPEN_STREAMED);
-  if (!m_cache_write_stream)
-    return false;
-
-  if (m_cache_write_stream->GetPosition() == 0)
-  {
-    // new cache file, write header
-    if (!WriteU32(m_cache_write_stream.get(), GAME_LIST_CACHE_SIGNATURE) ||
-        !WriteU32(m_cache_write_stream.get(), GAME_LIST_CACHE_VERSION))
-    {
-      Log_ErrorPrintf("Failed to write game list cache header");
-      m_cache_write_stream.reset();
-      FileSystem::DeleteFile(m_cache_filename.c_str());
-      return false;
-    }
   }
 
-  return true;
+  entry->region = static_cast<DiscRegion>(region);
+  entry->type = static_cast<GameListEntryType>(type);
+  entry->compatibility_rating = static_cast<GameListCompatibilityRating>(compatibility_rating);
+  return entry->settings.LoadFromStream(stream);
 }
 
 bool GameList::WriteEntryToCache(const GameListEntry* entry, ByteStream* stream)
@@ -640,6 +648,7 @@ bool GameList::WriteEntryToCache(const GameListEntry* entry, ByteStream* stream)
   result &= WriteString(stream, entry->title);
   result &= WriteU64(stream, entry->total_size);
   result &= WriteU64(stream, entry->last_modified_time);
+  result &= WriteU64(stream, entry->file_size);
   result &= WriteU8(stream, static_cast<u8>(entry->region));
   result &= WriteU8(stream, static_cast<u8>(entry->type));
   result &= WriteU8(stream, static_cast<u8>(entry->compatibility_rating));
@@ -647,43 +656,57 @@ bool GameList::WriteEntryToCache(const GameListEntry* entry, ByteStream* stream)
   return result;
 }
 
-void GameList::FlushCacheFileStream()
+void GameList::RewriteCacheFile()
 {
-  if (!m_cache_write_stream)
+  // the file can't be replaced while it's mapped on Windows
+  CloseCache();
+  m_cache_dirty = false;
+  if (m_cache_filename.empty())
     return;
 
-  m_cache_write_stream->Flush();
-}
+  const u64 entries_offset = sizeof(CacheHeader) + sizeof(CacheIndexEntry) * m_entries.size();
+  std::unique_ptr<GrowableMemoryByteStream> entries_stream = ByteStream_CreateGrowableMemoryStream();
+  std::vector<CacheIndexEntry> index;
+  index.reserve(m_entries.size());
+  for (const GameListEntry& entry : m_entries)
+  {
+    index.push_back({GetCachePathHash(entry.path), entry.last_modified_time, entry.file_size,
+                     entries_offset + entries_stream->GetPosition()});
+    if (!WriteEntryToCache(&entry, entries_stream.get()))
+    {
+      Log_ErrorPrintf("Failed to write '%s' to new cache file", entry.title.c_str());
+      return;
+    }
+  }
 
-void GameList::CloseCacheFileStream()
-{
-  if (!m_cache_write_stream)
-    return;
+  std::sort(index.begin(), index.end(),
+            [](const CacheIndexEntry& lhs, const CacheIndexEntry& rhs) { return lhs.path_hash < rhs.path_hash; });
 
-  m_cache_write_stream->Commit();
-  m_cache_write_stream.reset();
-}
+  std::unique_ptr<ByteStream> stream =
+    FileSystem::OpenFile(m_cache_filename.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE |
+                                                     BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_ATOMIC_UPDATE |
+                                                     BYTESTREAM_OPEN_STREAMED);
+  if (!stream)
+  {
+    Log_ErrorPrintf("Failed to open game list cache '%s' for writing", m_cache_filename.c_str());
+    return;
+  }
 
-void GameList::RewriteCacheFile()
-{
-  CloseCacheFileStream();
-  DeleteCacheFile();
-  if (OpenCacheForWriting())
+  const CacheHeader header = {GAME_LIST_CACHE_SIGNATURE, GAME_LIST_CACHE_VERSION, static_cast<u32>(m_entries.size()),
+                              0};
+  const u32 index_size = static_cast<u32>(sizeof(CacheIndexEntry) * index.size());
+  const u32 entries_size = static_cast<u32>(entries_stream->GetSize());
+  if (!stream->Write2(&header, sizeof(header)) || (index_size > 0 && !stream->Write2(index.data(), index_size)) ||
+      (entries_size > 0 && !stream->Write2(entries_stream->GetMemoryPointer(), entries_size)) || !stream->Commit())
   {
-    for (const auto& it : m_entries)
-    {
-      if (!WriteEntryToCache(&it, m_cache_write_stream.get()))
-      {
-        Log_ErrorPrintf("Failed to write '%s' to new cache file", it.title.c_str());
-        break;
-      }
-    }
+    Log_ErrorPrintf("Failed to write game list cache '%s'", m_cache_filename.c_str());
+    stream->Discard();
   }
 }
 
 void GameList::DeleteCacheFile()
 {
-  Assert(!m_cache_write_stream);
+  CloseCache();
   if (!FileSystem::FileExists(m_cache_filename.c_str()))
     return;
 
@@ -693,7 +716,8 @@ void GameList::DeleteCacheFile()
     Log_WarningPrintf("Failed to delete game list cache '%s'", m_cache_filename.c_str());
 }
 
-void GameList::ScanDirectory(const char* path, bool recursive, ProgressCallback* progress)
+void GameList::ScanDirectory(const char* path, bool recursive, std::unordered_set<std::string>* known_paths,
+                             ProgressCallback* progress)
 {
   Log_DevPrintf("Scanning %s%s", path, recursive ? " (recursively)" : "");
 
@@ -703,10 +727,17 @@ void GameList::ScanDirectory(const char* path, bool recursive, ProgressCallback*
   FileSystem::FindResultsArray files;
   FileSystem::FindFiles(path, "*", FILESYSTEM_FIND_FILES | (recursive ? FILESYSTEM_FIND_RECURSIVE : 0), &files);
 
-  GameListEntry entry;
   progress->SetProgressRange(static_cast<u32>(files.size()));
   progress->SetProgressValue(0);
 
+  // cached entries are filled in straight away, the rest are left empty for the scan below
+  std::vector<GameListEntry> entries;
+  std::vector<u8> entries_valid;
+  std::vector<std::string> scan_paths;
+  std::vector<size_t> scan_entry_indices;
+  entries.reserve(files.size());
+  entries_valid.reserve(files.size());
+
   for (const FILESYSTEM_FIND_DATA& ffd : files)
   {
     // if this is a .bin, check if we have a .cue. if there is one, skip it
@@ -727,48 +758,118 @@ void GameList::ScanDirectory(const char* path, bool recursive, ProgressCallback*
 #endif
     }
 
-    std::string entry_path(ffd.FileName);
-    if (std::any_of(m_entries.begin(), m_entries.end(),
-                    [&entry_path](const GameListEntry& other) { return other.path == entry_path; }))
+    if (!known_paths->insert(ffd.FileName).second)
+      continue;
+
+    GameListEntry& entry = entries.emplace_back();
+    if (GetGameListEntryFromCache(ffd.FileName, ffd.ModificationTime.AsUnixTimestamp(), ffd.Size, &entry))
     {
+      entries_valid.push_back(true);
       continue;
     }
-    Log_DebugPrintf("Trying '%s'...", entry_path.c_str());
 
-    // try opening the image
-    if (!GetGameListEntryFromCache(entry_path, &entry) ||
-        entry.last_modified_time != ffd.ModificationTime.AsUnixTimestamp())
-    {
-      const char* file_part_slash =
-        std::max(std::strrchr(entry_path.c_str(), '/'), std::strrchr(entry_path.c_str(), '\\'));
-      progress->SetFormattedStatusText("Scanning '%s'...",
-                                       file_part_slash ? (file_part_slash + 1) : entry_path.c_str());
-      progress->IncrementProgressValue();
+    Log_DebugPrintf("Trying '%s'...", ffd.FileName.c_str());
+    entries_valid.push_back(false);
+    scan_paths.push_back(ffd.FileName);
+    scan_entry_indices.push_back(entries.size() - 1);
+  }
 
-      if (GetGameListEntry(entry_path, &entry))
-      {
-        if (m_cache_write_stream || OpenCacheForWriting())
-        {
-          if (!WriteEntryToCache(&entry, m_cache_write_stream.get()))
-            Log_WarningPrintf("Failed to write entry '%s' to cache", entry.path.c_str());
-        }
-      }
-      else
-      {
-        continue;
-      }
-    }
+  std::vector<GameListEntry> scanned_entries;
+  std::vector<u8> scanned_entries_valid;
+  ScanFiles(scan_paths, &scanned_entries, &scanned_entries_valid,
+            static_cast<u32>(files.size() - scan_paths.size()), progress);
+  for (size_t i = 0; i < scan_paths.size(); i++)
+  {
+    if (!scanned_entries_valid[i])
+      continue;
 
-    m_entries.push_back(std::move(entry));
-    entry = {};
+    entries[scan_entry_indices[i]] = std::move(scanned_entries[i]);
+    entries_valid[scan_entry_indices[i]] = true;
+    m_cache_dirty = true;
   }
 
-  FlushCacheFileStream();
+  for (size_t i = 0; i < entries.size(); i++)
+  {
+    if (entries_valid[i])
+      m_entries.push_back(std::move(entries[i]));
+  }
 
   progress->SetProgressValue(static_cast<u32>(files.size()));
   progress->PopState();
 }
 
+void GameList::ScanFiles(const std::vector<std::string>& paths, std::vector<GameListEntry>* entries,
+                         std::vector<u8>* valid, u32 progress_start, ProgressCallback* progress)
+{
+  entries->resize(paths.size());
+  valid->assign(paths.size(), false);
+  if (paths.empty())
+    return;
+
+  // the workers look entries up in these, so they can't be loaded lazily
+  LoadDatabase();
+  LoadCompatibilityList();
+  LoadGameSettings();
+
+  // opening an image is mostly waiting on the disk, so the worker count also caps the number of files open at once
+  const u32 hardware_threads = std::thread::hardware_concurrency();
+  const u32 num_workers =
+    std::min(std::clamp<u32>(hardware_threads, 1, MAX_SCAN_THREADS), static_cast<u32>(paths.size()));
+
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  size_t next_path = 0;
+  size_t completed = 0;
+  size_t last_completed_path = 0;
+
+  std::vector<std::thread> workers;
+  workers.reserve(num_workers);
+  for (u32 i = 0; i < num_workers; i++)
+  {
+    workers.emplace_back([this, &paths, entries, valid, &mutex, &done_cv, &next_path, &completed,
+                          &last_completed_path]() {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (next_path != paths.size())
+      {
+        const size_t index = next_path++;
+        lock.unlock();
+
+        GameListEntry entry;
+        const bool result = GetGameListEntry(paths[index], &entry);
+
+        lock.lock();
+        (*entries)[index] = std::move(entry);
+        (*valid)[index] = result;
+        last_completed_path = index;
+        completed++;
+        done_cv.notify_one();
+      }
+    });
+  }
+
+  // the progress callback usually drives a dialog, so it's only updated from this thread
+  std::unique_lock<std::mutex> lock(mutex);
+  size_t reported = 0;
+  while (reported != paths.size())
+  {
+    done_cv.wait(lock, [&completed, reported]() { return completed != reported; });
+    reported = completed;
+
+    const std::string& path = paths[last_completed_path];
+    lock.unlock();
+
+    const char* file_part_slash = std::max(std::strrchr(path.c_str(), '/'), std::strrchr(path.c_str(), '\\'));
+    progress->SetFormattedStatusText("Scanning '%s'...", file_part_slash ? (file_part_slash + 1) : path.c_str());
+    progress->SetProgressValue(progress_start + static_cast<u32>(reported));
+
+    lock.lock();
+  }
+  lock.unlock();
+
+  for (std::thread& worker : workers)
+    worker.join();
+}
+
 class GameList::RedumpDatVisitor final : public tinyxml2::XMLVisitor
 {
 public:
@@ -814,6 +915,27 @@ public:
     if (!serial_text)
       return false;
 
+    // the cue sheet is listed too, but only the tracks are hashed
+    std::vector<CDImageHasher::Hash> track_hashes;
+    for (const tinyxml2::XMLElement* rom_elem = element.FirstChildElement("rom"); rom_elem;
+         rom_elem = rom_elem->NextSiblingElement("rom"))
+    {
+      const char* rom_name = rom_elem->Attribute("name");
+      const char* rom_md5 = rom_elem->Attribute("md5");
+      const char* rom_extension = rom_name ? std::strrchr(rom_name, '.') : nullptr;
+      if (!rom_extension || StringUtil::Strcasecmp(rom_extension, ".bin") != 0 || !rom_md5)
+        continue;
+
+      CDImageHasher::Hash hash;
+      if (!CDImageHasher::HashFromString(rom_md5, &hash))
+      {
+        track_hashes.clear();
+        break;
+      }
+
+      track_hashes.push_back(hash);
+    }
+
     // Handle entries like <serial>SCES-00984, SCES-00984#</serial>
     const char* start = serial_text;
     const char* end = std::strchr(start, ',');
@@ -827,9 +949,12 @@ public:
         gde.code = std::move(code);
         gde.region = GameList::GetRegionForCode(gde.code);
         gde.title = name;
-        m_database.emplace(gde.code, std::move(gde));
+        iter = m_database.emplace(gde.code, std::move(gde)).first;
       }
 
+      if (!track_hashes.empty())
+        iter->second.track_hashes.push_back(track_hashes);
+
       if (!end)
         break;
 
@@ -934,22 +1059,80 @@ void GameList::Refresh(bool invalidate_cache, bool invalidate_database, Progress
     ClearDatabase();
 
   m_entries.clear();
+  m_cache_dirty = false;
 
   if (!m_search_directories.empty())
   {
     progress->SetProgressRange(static_cast<u32>(m_search_directories.size()));
     progress->SetProgressValue(0);
 
+    std::unordered_set<std::string> known_paths;
     for (DirectoryEntry& de : m_search_directories)
     {
-      ScanDirectory(de.path.c_str(), de.recursive, progress);
+      ScanDirectory(de.path.c_str(), de.recursive, &known_paths, progress);
       progress->IncrementProgressValue();
     }
   }
 
-  // don't need unused cache entries
-  CloseCacheFileStream();
-  m_cache_map.clear();
+  // unused cache entries are dropped by rewriting it
+  if (m_cache_dirty || m_entries.size() != m_cache_entry_count)
+    RewriteCacheFile();
+  else
+    CloseCache();
+}
+
+std::vector<GameListVerificationResult> GameList::VerifyEntries(ProgressCallback* progress /* = nullptr */)
+{
+  if (!progress)
+    progress = ProgressCallback::NullProgressCallback;
+
+  // discs are verified one at a time, the hasher already keeps the disk busy
+  std::vector<GameListVerificationResult> results(m_entries.size(), GameListVerificationResult::NotInDatabase);
+  progress->SetProgressRange(static_cast<u32>(m_entries.size()));
+  progress->SetProgressValue(0);
+
+  for (size_t i = 0; i < m_entries.size(); i++)
+  {
+    const GameListEntry& entry = m_entries[i];
+    progress->SetProgressValue(static_cast<u32>(i));
+    if (entry.type != GameListEntryType::Disc || entry.code.empty())
+      continue;
+
+    const GameListDatabaseEntry* database_entry = GetDatabaseEntryForCode(entry.code);
+    if (!database_entry || database_entry->track_hashes.empty())
+      continue;
+
+    progress->SetFormattedStatusText("Verifying '%s'...", entry.title.c_str());
+    progress->PushState();
+
+    std::vector<CDImageHasher::Hash> track_hashes;
+    std::unique_ptr<CDImage> image = CDImage::Open(entry.path.c_str());
+    const bool hashed = image && CDImageHasher::GetTrackHashes(image.get(), &track_hashes, progress);
+    image.reset();
+
+    progress->PopState();
+
+    if (!hashed)
+    {
+      Log_WarningPrintf("Failed to hash '%s'", entry.path.c_str());
+      results[i] = GameListVerificationResult::ReadError;
+      continue;
+    }
+
+    if (std::find(database_entry->track_hashes.begin(), database_entry->track_hashes.end(), track_hashes) !=
+        database_entry->track_hashes.end())
+    {
+      results[i] = GameListVerificationResult::Verified;
+    }
+    else
+    {
+      Log_WarningPrintf("'%s' doesn't match any dump of '%s'", entry.path.c_str(), entry.code.c_str());
+      results[i] = GameListVerificationResult::Mismatch;
+    }
+  }
+
+  progress->SetProgressValue(static_cast<u32>(m_entries.size()));
+  return results;
 }
 
 void GameList::UpdateCompatibilityEntry(GameListCompatibilityEntry new_entry, bool save_to_list /*= true*/)
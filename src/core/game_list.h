@@ -1,4 +1,5 @@
 #pragma once
+#include "common/cd_image_hasher.h"
 #include "game_settings.h"
 #include "types.h"
 #include <memory>
@@ -6,12 +7,17 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class CDImage;
 class ByteStream;
 class ProgressCallback;
 
+namespace Common {
+class MappedFile;
+}
+
 class SettingsInterface;
 
 enum class GameListEntryType
@@ -32,11 +38,23 @@ enum class GameListCompatibilityRating
   Count,
 };
 
+enum class GameListVerificationResult
+{
+  NotInDatabase, // also used for anything which isn't a disc
+  Verified,
+  Mismatch,
+  ReadError,
+  Count
+};
+
 struct GameListDatabaseEntry
 {
   std::string code;
   std::string title;
   DiscRegion region;
+
+  // MD5 of each track, for every dump with this serial
+  std::vector<std::vector<CDImageHasher::Hash>> track_hashes;
 };
 
 struct GameListEntry
@@ -46,6 +64,7 @@ struct GameListEntry
   std::string title;
   u64 total_size;
   u64 last_modified_time;
+  u64 file_size;
   DiscRegion region;
   GameListEntryType type;
   GameListCompatibilityRating compatibility_rating;
@@ -73,6 +92,7 @@ public:
 
   static const char* EntryTypeToString(GameListEntryType type);
   static const char* EntryCompatibilityRatingToString(GameListCompatibilityRating rating);
+  static const char* VerificationResultToString(GameListVerificationResult result);
 
   /// Returns true if the filename is a PlayStation executable we can inject.
   static bool IsExeFileName(const char* path);
@@ -120,6 +140,10 @@ public:
   void AddDirectory(std::string path, bool recursive);
   void Refresh(bool invalidate_cache, bool invalidate_database, ProgressCallback* progress = nullptr);
 
+  /// Hashes the tracks of every disc in the list and compares them against the dumps in the database. Returns a
+  /// result for each entry, in the same order as GetEntries().
+  std::vector<GameListVerificationResult> VerifyEntries(ProgressCallback* progress = nullptr);
+
   void UpdateCompatibilityEntry(GameListCompatibilityEntry new_entry, bool save_to_list = true);
 
   static std::string ExportCompatibilityEntry(const GameListCompatibilityEntry* entry);
@@ -132,11 +156,29 @@ private:
   enum : u32
   {
     GAME_LIST_CACHE_SIGNATURE = 0x45434C47,
-    GAME_LIST_CACHE_VERSION = 6
+    GAME_LIST_CACHE_VERSION = 7,
+    MAX_SCAN_THREADS = 8
+  };
+
+  // The cache file is a header, then an index sorted by path hash, then the entries themselves. It's mapped rather
+  // than read, so a refresh only has to decode the entries which are still present.
+  struct CacheHeader
+  {
+    u32 signature;
+    u32 version;
+    u32 entry_count;
+    u32 reserved;
+  };
+
+  struct CacheIndexEntry
+  {
+    u64 path_hash;
+    u64 last_modified_time;
+    u64 file_size;
+    u64 offset;
   };
 
   using DatabaseMap = std::unordered_map<std::string, GameListDatabaseEntry>;
-  using CacheMap = std::unordered_map<std::string, GameListEntry>;
   using CompatibilityMap = std::unordered_map<std::string, GameListCompatibilityEntry>;
 
   struct DirectoryEntry
@@ -154,15 +196,17 @@ private:
   bool GetM3UListEntry(const char* path, GameListEntry* entry);
 
   bool GetGameListEntry(const std::string& path, GameListEntry* entry);
-  bool GetGameListEntryFromCache(const std::string& path, GameListEntry* entry);
-  void ScanDirectory(const char* path, bool recursive, ProgressCallback* progress);
+  bool GetGameListEntryFromCache(const std::string& path, u64 last_modified_time, u64 file_size,
+                                 GameListEntry* entry);
+  void ScanDirectory(const char* path, bool recursive, std::unordered_set<std::string>* known_paths,
+                     ProgressCallback* progress);
+  void ScanFiles(const std::vector<std::string>& paths, std::vector<GameListEntry>* entries, std::vector<u8>* valid,
+                 u32 progress_start, ProgressCallback* progress);
 
   void LoadCache();
-  bool LoadEntriesFromCache(ByteStream* stream);
-  bool OpenCacheForWriting();
-  bool WriteEntryToCache(const GameListEntry* entry, ByteStream* stream);
-  void FlushCacheFileStream();
-  void CloseCacheFileStream();
+  void CloseCache();
+  static bool ReadEntryFromCache(ByteStream* stream, GameListEntry* entry);
+  static bool WriteEntryToCache(const GameListEntry* entry, ByteStream* stream);
   void RewriteCacheFile();
   void DeleteCacheFile();
 
@@ -177,10 +221,12 @@ private:
 
   DatabaseMap m_database;
   EntryList m_entries;
-  CacheMap m_cache_map;
   CompatibilityMap m_compatibility_list;
   GameSettings::Database m_game_settings;
-  std::unique_ptr<ByteStream> m_cache_write_stream;
+  std::unique_ptr<Common::MappedFile> m_cache_file;
+  const CacheIndexEntry* m_cache_index = nullptr;
+  u32 m_cache_entry_count = 0;
+  bool m_cache_dirty = false;
 
   std::vector<DirectoryEntry> m_search_directories;
   std::string m_cache_filename;
@@ -7,6 +7,7 @@
 #include "host_interface.h"
 #include "interrupt_controller.h"
 #include "stb_image_write.h"
+#include "subsystem_timing.h"
 #include "system.h"
 #include "timers.h"
 #include <cmath>
@@ -28,9 +29,13 @@ bool GPU::Initialize(HostDisplay* host_display)
   m_force_ntsc_timings = g_settings.gpu_force_ntsc_timings;
   m_crtc_state.display_aspect_ratio = Settings::GetDisplayAspectRatioValue(g_settings.display_aspect_ratio);
   m_crtc_tick_event = TimingEvents::CreateTimingEvent(
-    "GPU CRTC Tick", 1, 1, std::bind(&GPU::CRTCTickEvent, this, std::placeholders::_1), true);
+    "GPU CRTC Tick", 1, 1,
+    [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<GPU*>(param)->CRTCTickEvent(ticks); }, this,
+    true);
   m_command_tick_event = TimingEvents::CreateTimingEvent(
-    "GPU Command Tick", 1, 1, std::bind(&GPU::CommandTickEvent, this, std::placeholders::_1), true);
+    "GPU Command Tick", 1, 1,
+    [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<GPU*>(param)->CommandTickEvent(ticks); }, this,
+    true);
   m_fifo_size = g_settings.gpu_fifo_size;
   m_max_run_ahead = g_settings.gpu_max_run_ahead;
   m_console_is_pal = System::IsPALRegion();
@@ -104,7 +109,7 @@ void GPU::SoftReset()
   UpdateCommandTickEvent();
 }
 
-bool GPU::DoState(StateWrapper& sw)
+bool GPU::DoState(StateWrapper& sw, bool include_vram)
 {
   if (sw.IsReading())
   {
@@ -201,27 +206,51 @@ bool GPU::DoState(StateWrapper& sw)
   if (!sw.DoMarker("GPU-VRAM"))
     return false;
 
-  if (sw.IsReading())
+  // Only present when VRAM is left out, so full states are unaffected. Renderers without snapshots still serialize it.
+  bool vram_in_snapshot = false;
+  if (!include_vram)
   {
-    // Need to clear the mask bits since we want to pull it in from the copy.
-    const u32 old_GPUSTAT = m_GPUSTAT.bits;
-    m_GPUSTAT.check_mask_before_draw = false;
-    m_GPUSTAT.set_mask_while_drawing = false;
+    if (sw.IsWriting())
+    {
+      FlushRender();
+      vram_in_snapshot = SaveVRAMSnapshot();
+    }
 
-    // Still need a temporary here.
-    HeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> temp;
-    sw.DoBytes(temp.data(), VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
-    UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, temp.data());
+    sw.Do(&vram_in_snapshot);
+  }
 
-    // Restore mask setting.
-    m_GPUSTAT.bits = old_GPUSTAT;
+  if (sw.IsReading())
+  {
+    if (vram_in_snapshot)
+    {
+      if (!RestoreVRAMSnapshot())
+      {
+        Log_ErrorPrintf("Failed to restore VRAM snapshot");
+        return false;
+      }
+    }
+    else
+    {
+      // Need to clear the mask bits since we want to pull it in from the copy.
+      const u32 old_GPUSTAT = m_GPUSTAT.bits;
+      m_GPUSTAT.check_mask_before_draw = false;
+      m_GPUSTAT.set_mask_while_drawing = false;
+
+      // Still need a temporary here.
+      HeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> temp;
+      sw.DoBytes(temp.data(), VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
+      UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, temp.data());
+
+      // Restore mask setting.
+      m_GPUSTAT.bits = old_GPUSTAT;
+    }
 
     UpdateCRTCConfig();
     UpdateDisplay();
     UpdateCRTCTickEvent();
     UpdateCommandTickEvent();
   }
-  else
+  else if (!vram_in_snapshot)
   {
     ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
     sw.DoBytes(m_vram_ptr, VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
@@ -346,6 +375,8 @@ void GPU::WriteRegister(u32 offset, u32 value)
 
 void GPU::DMARead(u32* words, u32 word_count)
 {
+  SubsystemTiming::ScopedTimer subsystem_timer(SubsystemTiming::Subsystem::GPU);
+
   if (m_GPUSTAT.dma_direction != DMADirection::GPUREADtoCPU)
   {
     Log_ErrorPrintf("Invalid DMA direction from GPU DMA read");
@@ -676,6 +707,8 @@ bool GPU::IsCommandCompletionPending() const
 
 void GPU::CRTCTickEvent(TickCount ticks)
 {
+  SubsystemTiming::ScopedTimer subsystem_timer(SubsystemTiming::Subsystem::GPU);
+
   // convert cpu/master clock to GPU ticks, accounting for partial cycles because of the non-integer divider
   {
     const TickCount gpu_ticks = SystemTicksToCRTCTicks(ticks, &m_crtc_state.fractional_ticks);
@@ -1454,3 +1487,13 @@ void GPU::DrawDebugStateWindow()
 }
 
 void GPU::DrawRendererStats(bool is_idle_frame) {}
+
+bool GPU::SaveVRAMSnapshot()
+{
+  return false;
+}
+
+bool GPU::RestoreVRAMSnapshot()
+{
+  return false;
+}
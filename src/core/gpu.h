@@ -123,7 +123,10 @@ public:
 
   virtual bool Initialize(HostDisplay* host_display);
   virtual void Reset();
-  virtual bool DoState(StateWrapper& sw);
+
+  /// When include_vram is false, VRAM is kept in a snapshot by the renderer instead of being serialized, which only the
+  /// next load in this session can use. The hardware renderers keep the snapshot on the host GPU, avoiding a readback.
+  virtual bool DoState(StateWrapper& sw, bool include_vram);
 
   // Graphics API state reset/restore - call when drawing the UI etc.
   virtual void ResetGraphicsAPIState();
@@ -436,6 +439,10 @@ protected:
   virtual void UpdateDisplay();
   virtual void DrawRendererStats(bool is_idle_frame);
 
+  // Copies VRAM to/from a snapshot kept by the renderer, for DoState() without VRAM. Returns false if unsupported.
+  virtual bool SaveVRAMSnapshot();
+  virtual bool RestoreVRAMSnapshot();
+
   // These are **very** approximate.
   ALWAYS_INLINE void AddDrawTriangleTicks(u32 width, u32 height, bool shaded, bool textured, bool semitransparent)
   {
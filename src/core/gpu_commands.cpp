@@ -1,8 +1,10 @@
 #include "common/assert.h"
 #include "common/log.h"
 #include "common/string_util.h"
+#include "common/trace.h"
 #include "gpu.h"
 #include "interrupt_controller.h"
+#include "subsystem_timing.h"
 #include "system.h"
 Log_SetChannel(GPU);
 
@@ -23,6 +25,9 @@ static constexpr u32 ReplaceZero(u32 value, u32 value_for_zero)
 
 void GPU::ExecuteCommands()
 {
+  SubsystemTiming::ScopedTimer subsystem_timer(SubsystemTiming::Subsystem::GPU);
+  TRACE_SCOPE("GPU::ExecuteCommands");
+
   m_syncing = true;
 
   for (;;)
@@ -1,7 +1,9 @@
 #include "gpu_hw.h"
+#include "common/align.h"
 #include "common/assert.h"
 #include "common/log.h"
 #include "common/state_wrapper.h"
+#include "common/trace.h"
 #include "cpu_core.h"
 #include "imgui.h"
 #include "pgxp.h"
@@ -32,7 +34,11 @@ GPU_HW::GPU_HW() : GPU()
   m_vram_ptr = m_vram_shadow.data();
 }
 
-GPU_HW::~GPU_HW() = default;
+GPU_HW::~GPU_HW()
+{
+  // backends must stop the thread before their resources are destroyed
+  Assert(!IsUsingGPUThread());
+}
 
 bool GPU_HW::IsHardwareRenderer() const
 {
@@ -68,11 +74,14 @@ void GPU_HW::Reset()
   m_current_depth = 1;
 
   SetFullVRAMDirtyRectangle();
+
+  // backends clear their framebuffers directly after this
+  SyncGPUThread();
 }
 
-bool GPU_HW::DoState(StateWrapper& sw)
+bool GPU_HW::DoState(StateWrapper& sw, bool include_vram)
 {
-  if (!GPU::DoState(sw))
+  if (!GPU::DoState(sw, include_vram))
     return false;
 
   // invalidate the whole VRAM read texture when loading state
@@ -86,6 +95,22 @@ bool GPU_HW::DoState(StateWrapper& sw)
   return true;
 }
 
+void GPU_HW::ResetGraphicsAPIState()
+{
+  GPU::ResetGraphicsAPIState();
+
+  // the host display takes over the context until the next frame
+  SyncGPUThread();
+}
+
+void GPU_HW::UpdateSettings()
+{
+  GPU::UpdateSettings();
+
+  // backends recreate resources from the CPU thread, and restart the thread afterwards
+  StopGPUThread();
+}
+
 void GPU_HW::UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed)
 {
   const u32 resolution_scale = CalculateResolutionScale();
@@ -154,6 +179,7 @@ void GPU_HW::PrintSettingsToLog()
 void GPU_HW::UpdateVRAMReadTexture()
 {
   m_renderer_stats.num_vram_read_texture_updates++;
+  PushGPUThreadCommand([this, dirty_rect = m_vram_dirty_rect]() { ExecuteUpdateVRAMReadTexture(dirty_rect); });
   ClearVRAMDirtyRectangle();
 }
 
@@ -688,10 +714,10 @@ void GPU_HW::LoadVertices()
 
 void GPU_HW::CalcScissorRect(int* left, int* top, int* right, int* bottom)
 {
-  *left = m_drawing_area.left * m_resolution_scale;
-  *right = std::max<u32>((m_drawing_area.right + 1) * m_resolution_scale, *left + 1);
-  *top = m_drawing_area.top * m_resolution_scale;
-  *bottom = std::max<u32>((m_drawing_area.bottom + 1) * m_resolution_scale, *top + 1);
+  *left = m_scissor_drawing_area.left * m_resolution_scale;
+  *right = std::max<u32>((m_scissor_drawing_area.right + 1) * m_resolution_scale, *left + 1);
+  *top = m_scissor_drawing_area.top * m_resolution_scale;
+  *bottom = std::max<u32>((m_scissor_drawing_area.bottom + 1) * m_resolution_scale, *top + 1);
 }
 
 GPU_HW::VRAMFillUBOData GPU_HW::GetVRAMFillUBOData(u32 x, u32 y, u32 width, u32 height, u32 color) const
@@ -788,7 +814,7 @@ void GPU_HW::EnsureVertexBufferSpace(u32 required_vertices)
     FlushRender();
   }
 
-  MapBatchVertexPointer(required_vertices);
+  MapBatchVertices(required_vertices);
 }
 
 void GPU_HW::EnsureVertexBufferSpaceForCurrentCommand()
@@ -822,14 +848,14 @@ void GPU_HW::EnsureVertexBufferSpaceForCurrentCommand()
     FlushRender();
   }
 
-  MapBatchVertexPointer(required_vertices);
+  MapBatchVertices(required_vertices);
 }
 
 void GPU_HW::ResetBatchVertexDepth()
 {
   Log_PerfPrint("Resetting batch vertex depth");
   FlushRender();
-  UpdateDepthBufferFromMaskBit();
+  PushGPUThreadCommand([this]() { UpdateDepthBufferFromMaskBit(); });
 
   m_current_depth = 1;
 }
@@ -956,13 +982,59 @@ void GPU_HW::DispatchRenderCommand()
   LoadVertices();
 }
 
+void GPU_HW::MapBatchVertices(u32 required_vertices)
+{
+  if (!IsUsingGPUThread())
+  {
+    MapBatchVertexPointer(required_vertices);
+    return;
+  }
+
+  // the backend's vertex buffer can't be touched from this thread, so the batch is built in system memory instead
+  DebugAssert(!m_batch_start_vertex_ptr && required_vertices <= MAX_BATCH_VERTEX_COUNT);
+  m_batch_start_vertex_ptr = m_batch_staging_vertices.get();
+  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
+  m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + MAX_BATCH_VERTEX_COUNT;
+  m_batch_base_vertex = 0;
+}
+
+void GPU_HW::UnmapBatchVertices(u32 used_vertices)
+{
+  if (!IsUsingGPUThread())
+  {
+    UnmapBatchVertexPointer(used_vertices);
+    return;
+  }
+
+  DebugAssert(m_batch_start_vertex_ptr);
+  m_batch_start_vertex_ptr = nullptr;
+  m_batch_end_vertex_ptr = nullptr;
+  m_batch_current_vertex_ptr = nullptr;
+}
+
+void GPU_HW::DrawBatch(const BatchConfig& batch, u32 base_vertex, u32 num_vertices)
+{
+  if (batch.NeedsTwoPassRendering())
+  {
+    DrawBatchVertices(batch, BatchRenderMode::OnlyTransparent, base_vertex, num_vertices);
+    DrawBatchVertices(batch, BatchRenderMode::OnlyOpaque, base_vertex, num_vertices);
+  }
+  else
+  {
+    DrawBatchVertices(batch, batch.GetRenderMode(), base_vertex, num_vertices);
+  }
+}
+
 void GPU_HW::FlushRender()
 {
   if (!m_batch_current_vertex_ptr)
     return;
 
+  TRACE_SCOPE("GPU_HW::FlushRender");
+
   const u32 vertex_count = GetBatchVertexCount();
-  UnmapBatchVertexPointer(vertex_count);
+  const BatchVertex* vertices = m_batch_start_vertex_ptr;
+  UnmapBatchVertices(vertex_count);
 
   if (vertex_count == 0)
     return;
@@ -970,26 +1042,259 @@ void GPU_HW::FlushRender()
   if (m_drawing_area_changed)
   {
     m_drawing_area_changed = false;
-    SetScissorFromDrawingArea();
+    PushGPUThreadCommand([this, drawing_area = m_drawing_area]() {
+      m_scissor_drawing_area = drawing_area;
+      SetScissorFromDrawingArea();
+    });
   }
 
   if (m_batch_ubo_dirty)
   {
-    UploadUniformBuffer(&m_batch_ubo_data, sizeof(m_batch_ubo_data));
+    PushGPUThreadCommand(
+      [this, ubo_data = m_batch_ubo_data]() { UploadUniformBuffer(&ubo_data, sizeof(ubo_data)); });
+    m_renderer_stats.num_uniform_buffer_updates++;
     m_batch_ubo_dirty = false;
   }
 
-  if (m_batch.NeedsTwoPassRendering())
+  m_renderer_stats.num_batches += m_batch.NeedsTwoPassRendering() ? 2 : 1;
+
+  if (IsUsingGPUThread())
   {
-    m_renderer_stats.num_batches += 2;
-    DrawBatchVertices(BatchRenderMode::OnlyTransparent, m_batch_base_vertex, vertex_count);
-    DrawBatchVertices(BatchRenderMode::OnlyOpaque, m_batch_base_vertex, vertex_count);
+    PushGPUThreadCommandWithData(vertices, vertex_count * sizeof(BatchVertex),
+                                 [this, batch = m_batch, vertex_count](const void* data) {
+                                   const u32 base_vertex =
+                                     UploadBatchVertices(static_cast<const BatchVertex*>(data), vertex_count);
+                                   DrawBatch(batch, base_vertex, vertex_count);
+                                 });
   }
   else
   {
-    m_renderer_stats.num_batches++;
-    DrawBatchVertices(m_batch.GetRenderMode(), m_batch_base_vertex, vertex_count);
+    DrawBatch(m_batch, m_batch_base_vertex, vertex_count);
+  }
+}
+
+void GPU_HW::StartGPUThread()
+{
+  if (IsUsingGPUThread() || !g_settings.gpu_use_hw_thread)
+    return;
+
+  if (!m_host_display->SupportsThreadedRendering())
+  {
+    Log_WarningPrintf("Host display does not support threaded rendering, not starting GPU thread");
+    return;
+  }
+
+  Log_InfoPrintf("Starting GPU thread");
+  m_batch_staging_vertices = std::make_unique<BatchVertex[]>(MAX_BATCH_VERTEX_COUNT);
+
+  // this can be called between frames, so rather than flushing, move the batch in progress to the staging buffer
+  if (m_batch_current_vertex_ptr)
+  {
+    const u32 vertex_count = GetBatchVertexCount();
+    std::memcpy(m_batch_staging_vertices.get(), m_batch_start_vertex_ptr, sizeof(BatchVertex) * vertex_count);
+    UnmapBatchVertexPointer(0);
+    m_batch_start_vertex_ptr = m_batch_staging_vertices.get();
+    m_batch_current_vertex_ptr = m_batch_start_vertex_ptr + vertex_count;
+    m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + MAX_BATCH_VERTEX_COUNT;
+    m_batch_base_vertex = 0;
+  }
+
+  m_gpu_thread_buffer = std::make_unique<u8[]>(GPU_THREAD_BUFFER_SIZE);
+  m_gpu_thread = std::thread(&GPU_HW::GPUThreadEntryPoint, this);
+}
+
+void GPU_HW::StopGPUThread()
+{
+  if (!IsUsingGPUThread())
+    return;
+
+  SyncGPUThread();
+
+  {
+    std::unique_lock<std::mutex> lock(m_gpu_thread_mutex);
+    m_gpu_thread_shutdown = true;
+    m_gpu_thread_sleeping.store(false);
+    m_gpu_thread_wake_cv.notify_one();
+  }
+
+  m_gpu_thread.join();
+  m_gpu_thread_shutdown = false;
+  m_gpu_thread_write_position.store(0);
+  m_gpu_thread_read_position.store(0);
+  m_gpu_thread_buffer.reset();
+
+  // and back to the backend's buffer
+  if (m_batch_current_vertex_ptr)
+  {
+    const u32 vertex_count = GetBatchVertexCount();
+    m_batch_start_vertex_ptr = nullptr;
+    m_batch_end_vertex_ptr = nullptr;
+    m_batch_current_vertex_ptr = nullptr;
+    MapBatchVertexPointer(std::max<u32>(vertex_count, 1));
+    std::memcpy(m_batch_start_vertex_ptr, m_batch_staging_vertices.get(), sizeof(BatchVertex) * vertex_count);
+    m_batch_current_vertex_ptr = m_batch_start_vertex_ptr + vertex_count;
+  }
+
+  m_batch_staging_vertices.reset();
+  Log_InfoPrintf("GPU thread stopped");
+}
+
+void GPU_HW::SyncGPUThread()
+{
+  if (!m_gpu_thread_owns_context)
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(m_gpu_thread_mutex);
+    m_gpu_thread_sync_requested.store(true);
+    m_gpu_thread_sleeping.store(false);
+    m_gpu_thread_wake_cv.notify_one();
+    m_gpu_thread_sync_cv.wait(lock, [this]() { return !m_gpu_thread_sync_requested.load(); });
+  }
+
+  m_gpu_thread_owns_context = false;
+  if (!m_host_display->MakeRenderContextCurrent())
+    Panic("Failed to make render context current after GPU thread sync");
+}
+
+GPU_HW::GPUThreadCommand* GPU_HW::AllocateGPUThreadCommand(u32 size)
+{
+  // hand the context over to the GPU thread, it'll take it when it picks up this command
+  if (!m_gpu_thread_owns_context)
+  {
+    m_host_display->DoneRenderContextCurrent();
+    m_gpu_thread_owns_context = true;
+  }
+
+  const u32 command_size = Common::AlignUpPow2(static_cast<u32>(sizeof(GPUThreadCommand)) + size,
+                                               static_cast<u32>(GPU_THREAD_COMMAND_ALIGNMENT));
+  Assert(command_size <= (GPU_THREAD_BUFFER_SIZE / 2));
+
+  u64 write_position = m_gpu_thread_write_position.load(std::memory_order_relaxed);
+  const u32 offset = static_cast<u32>(write_position % GPU_THREAD_BUFFER_SIZE);
+  const u32 padding_size = ((offset + command_size) > GPU_THREAD_BUFFER_SIZE) ? (GPU_THREAD_BUFFER_SIZE - offset) : 0;
+
+  // wait for the GPU thread to free up enough space
+  while ((write_position + padding_size + command_size -
+          m_gpu_thread_read_position.load(std::memory_order_acquire)) > GPU_THREAD_BUFFER_SIZE)
+  {
+    if (m_gpu_thread_sleeping.load())
+      WakeGPUThread();
+
+    std::this_thread::yield();
+  }
+
+  if (padding_size > 0)
+  {
+    GPUThreadCommand* padding = reinterpret_cast<GPUThreadCommand*>(&m_gpu_thread_buffer[offset]);
+    padding->execute = nullptr;
+    padding->size = padding_size;
+    write_position += padding_size;
+    m_gpu_thread_write_position.store(write_position, std::memory_order_release);
+  }
+
+  GPUThreadCommand* cmd =
+    reinterpret_cast<GPUThreadCommand*>(&m_gpu_thread_buffer[write_position % GPU_THREAD_BUFFER_SIZE]);
+  cmd->size = command_size;
+  return cmd;
+}
+
+void GPU_HW::SubmitGPUThreadCommand(GPUThreadCommand* cmd)
+{
+  m_gpu_thread_write_position.fetch_add(cmd->size);
+
+  // pairs with the sleeping flag being set before the write position is re-checked in the GPU thread
+  if (m_gpu_thread_sleeping.load())
+    WakeGPUThread();
+}
+
+void GPU_HW::WakeGPUThread()
+{
+  std::unique_lock<std::mutex> lock(m_gpu_thread_mutex);
+  m_gpu_thread_sleeping.store(false);
+  m_gpu_thread_wake_cv.notify_one();
+}
+
+void GPU_HW::GPUThreadEntryPoint()
+{
+  TRACE_THREAD_NAME("GPU Thread");
+
+  bool has_context = false;
+  u32 spin_count = 0;
+
+  for (;;)
+  {
+    const u64 write_position = m_gpu_thread_write_position.load(std::memory_order_acquire);
+    u64 read_position = m_gpu_thread_read_position.load(std::memory_order_relaxed);
+    if (read_position != write_position)
+    {
+      if (!has_context)
+      {
+        if (!m_host_display->MakeRenderContextCurrent())
+          Panic("Failed to make render context current on GPU thread");
+
+        has_context = true;
+      }
+
+      TRACE_SCOPE("GPU_HW::ExecuteThreadCommands");
+      do
+      {
+        GPUThreadCommand* cmd =
+          reinterpret_cast<GPUThreadCommand*>(&m_gpu_thread_buffer[read_position % GPU_THREAD_BUFFER_SIZE]);
+        if (cmd->execute)
+          cmd->execute(cmd);
+
+        read_position += cmd->size;
+        m_gpu_thread_read_position.store(read_position, std::memory_order_release);
+      } while (read_position != write_position);
+
+      spin_count = 0;
+      continue;
+    }
+
+    // commands tend to come in bursts, so spin for a bit before going to sleep
+    if (spin_count < GPU_THREAD_SPIN_COUNT && !m_gpu_thread_sync_requested.load(std::memory_order_relaxed))
+    {
+      spin_count++;
+      std::this_thread::yield();
+      continue;
+    }
+
+    spin_count = 0;
+
+    std::unique_lock<std::mutex> lock(m_gpu_thread_mutex);
+    if (m_gpu_thread_sync_requested.load())
+    {
+      // commands queued after we last checked have to run before the CPU thread can continue
+      if (m_gpu_thread_write_position.load() != read_position)
+        continue;
+
+      if (has_context)
+      {
+        m_host_display->DoneRenderContextCurrent();
+        has_context = false;
+      }
+
+      m_gpu_thread_sync_requested.store(false);
+      m_gpu_thread_sync_cv.notify_one();
+      continue;
+    }
+
+    if (m_gpu_thread_shutdown)
+      break;
+
+    m_gpu_thread_sleeping.store(true);
+    if (m_gpu_thread_write_position.load() != read_position)
+    {
+      m_gpu_thread_sleeping.store(false);
+      continue;
+    }
+
+    m_gpu_thread_wake_cv.wait(lock, [this]() { return !m_gpu_thread_sleeping.load(); });
   }
+
+  if (has_context)
+    m_host_display->DoneRenderContextCurrent();
 }
 
 void GPU_HW::DrawRendererStats(bool is_idle_frame)
@@ -2,9 +2,16 @@
 #include "common/heap_array.h"
 #include "gpu.h"
 #include "host_display.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -33,7 +40,9 @@ public:
 
   virtual bool Initialize(HostDisplay* host_display) override;
   virtual void Reset() override;
-  virtual bool DoState(StateWrapper& sw) override;
+  virtual bool DoState(StateWrapper& sw, bool include_vram) override;
+  virtual void ResetGraphicsAPIState() override;
+  virtual void UpdateSettings() override;
   
   void UpdateResolutionScale() override final;
   std::tuple<u32, u32> GetEffectiveDisplayResolution() override final;
@@ -45,6 +54,9 @@ protected:
     VERTEX_BUFFER_SIZE = 1 * 1024 * 1024,
     UNIFORM_BUFFER_SIZE = 512 * 1024,
     MAX_BATCH_VERTEX_COUNTER_IDS = 65536 - 2,
+    GPU_THREAD_BUFFER_SIZE = 16 * 1024 * 1024,
+    GPU_THREAD_COMMAND_ALIGNMENT = 16,
+    GPU_THREAD_SPIN_COUNT = 256,
     MAX_VERTICES_FOR_RECTANGLE = 6 * (((MAX_PRIMITIVE_WIDTH + (TEXTURE_PAGE_WIDTH - 1)) / TEXTURE_PAGE_WIDTH) + 1u) *
                                  (((MAX_PRIMITIVE_HEIGHT + (TEXTURE_PAGE_HEIGHT - 1)) / TEXTURE_PAGE_HEIGHT) + 1u)
   };
@@ -177,13 +189,20 @@ protected:
 
   void UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed);
 
-  virtual void UpdateVRAMReadTexture();
+  /// Copies the dirty area of VRAM to the read texture, and clears the dirty rectangle.
+  void UpdateVRAMReadTexture();
+
+  // These only make graphics API calls, and are run on the GPU thread when it is active. They must only read state
+  // which is passed in, or which doesn't change without the GPU thread being synchronized first.
+  virtual void ExecuteUpdateVRAMReadTexture(const Common::Rectangle<u32>& dirty_rect) = 0;
   virtual void UpdateDepthBufferFromMaskBit() = 0;
   virtual void SetScissorFromDrawingArea() = 0;
   virtual void MapBatchVertexPointer(u32 required_vertices) = 0;
   virtual void UnmapBatchVertexPointer(u32 used_vertices) = 0;
+  virtual u32 UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices) = 0;
   virtual void UploadUniformBuffer(const void* uniforms, u32 uniforms_size) = 0;
-  virtual void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) = 0;
+  virtual void DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                                 u32 num_vertices) = 0;
 
   u32 CalculateResolutionScale() const;
 
@@ -230,6 +249,7 @@ protected:
   void FlushRender() override;
   void DrawRendererStats(bool is_idle_frame) override;
 
+  /// Computes the scissor rectangle for the drawing area last passed to SetScissorFromDrawingArea().
   void CalcScissorRect(int* left, int* top, int* right, int* bottom);
 
   std::tuple<s32, s32> ScaleVRAMCoordinates(s32 x, s32 y) const
@@ -257,6 +277,68 @@ protected:
   static void ComputePolygonUVLimits(BatchVertex* vertices, u32 num_vertices);
   static bool AreUVLimitsNeeded();
 
+  //////////////////////////////////////////////////////////////////////////
+  // GPU Thread
+  //////////////////////////////////////////////////////////////////////////
+  bool IsUsingGPUThread() const { return m_gpu_thread.joinable(); }
+
+  /// Starts the GPU thread if threaded rendering is enabled, and the host display allows it. Backends call this once
+  /// all of their resources have been created.
+  void StartGPUThread();
+  void StopGPUThread();
+
+  /// Blocks until the GPU thread has executed all queued commands, and takes the render context back. Graphics API
+  /// calls can be made directly from the CPU thread afterwards, until the next command is queued.
+  void SyncGPUThread();
+
+  /// Queues func to be run on the GPU thread, or runs it immediately when the GPU thread isn't being used. Anything
+  /// it needs from the GPU state must be captured by value.
+  template<typename T>
+  void PushGPUThreadCommand(T&& func)
+  {
+    if (!IsUsingGPUThread())
+    {
+      func();
+      return;
+    }
+
+    using Func = std::decay_t<T>;
+    static_assert(alignof(Func) <= GPU_THREAD_COMMAND_ALIGNMENT, "command is over-aligned");
+    GPUThreadCommand* cmd = AllocateGPUThreadCommand(sizeof(Func));
+    new (cmd + 1) Func(std::forward<T>(func));
+    cmd->execute = [](GPUThreadCommand* cmd) {
+      Func* func = reinterpret_cast<Func*>(cmd + 1);
+      (*func)();
+      func->~Func();
+    };
+    SubmitGPUThreadCommand(cmd);
+  }
+
+  /// Same as PushGPUThreadCommand(), but data is copied to the command buffer, and passed to func(const void* data).
+  template<typename T>
+  void PushGPUThreadCommandWithData(const void* data, u32 data_size, T&& func)
+  {
+    if (!IsUsingGPUThread())
+    {
+      func(data);
+      return;
+    }
+
+    using Func = std::decay_t<T>;
+    static_assert(alignof(Func) <= GPU_THREAD_COMMAND_ALIGNMENT, "command is over-aligned");
+    static constexpr u32 data_offset = (sizeof(Func) + (GPU_THREAD_COMMAND_ALIGNMENT - 1)) &
+                                       ~static_cast<u32>(GPU_THREAD_COMMAND_ALIGNMENT - 1);
+    GPUThreadCommand* cmd = AllocateGPUThreadCommand(data_offset + data_size);
+    new (cmd + 1) Func(std::forward<T>(func));
+    std::memcpy(reinterpret_cast<u8*>(cmd + 1) + data_offset, data, data_size);
+    cmd->execute = [](GPUThreadCommand* cmd) {
+      Func* func = reinterpret_cast<Func*>(cmd + 1);
+      (*func)(static_cast<const void*>(reinterpret_cast<const u8*>(cmd + 1) + data_offset));
+      func->~Func();
+    };
+    SubmitGPUThreadCommand(cmd);
+  }
+
   HeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> m_vram_shadow;
 
   BatchVertex* m_batch_start_vertex_ptr = nullptr;
@@ -280,6 +362,9 @@ protected:
   // Bounding box of VRAM area that the GPU has drawn into.
   Common::Rectangle<u32> m_vram_dirty_rect;
 
+  // Drawing area the scissor is set from. Only accessed by the thread making graphics API calls.
+  Common::Rectangle<u32> m_scissor_drawing_area;
+
   // Statistics
   RendererStats m_renderer_stats = {};
   RendererStats m_last_renderer_stats = {};
@@ -294,8 +379,25 @@ private:
     MAX_BATCH_VERTEX_COUNT = VERTEX_BUFFER_SIZE / sizeof(BatchVertex)
   };
 
+  /// Commands in the GPU thread buffer are a header followed by the closure, and any data copied with it. A null
+  /// execute function marks padding up to the end of the buffer.
+  struct alignas(GPU_THREAD_COMMAND_ALIGNMENT) GPUThreadCommand
+  {
+    void (*execute)(GPUThreadCommand* cmd);
+    u32 size;
+  };
+
   void LoadVertices();
 
+  void MapBatchVertices(u32 required_vertices);
+  void UnmapBatchVertices(u32 used_vertices);
+  void DrawBatch(const BatchConfig& batch, u32 base_vertex, u32 num_vertices);
+
+  GPUThreadCommand* AllocateGPUThreadCommand(u32 size);
+  void SubmitGPUThreadCommand(GPUThreadCommand* cmd);
+  void WakeGPUThread();
+  void GPUThreadEntryPoint();
+
   ALWAYS_INLINE void AddVertex(const BatchVertex& v)
   {
     std::memcpy(m_batch_current_vertex_ptr, &v, sizeof(BatchVertex));
@@ -310,4 +412,22 @@ private:
   }
 
   void PrintSettingsToLog();
+
+  // vertices are written here when using the GPU thread, and copied into the command buffer when the batch is flushed
+  std::unique_ptr<BatchVertex[]> m_batch_staging_vertices;
+
+  std::unique_ptr<u8[]> m_gpu_thread_buffer;
+  std::atomic<u64> m_gpu_thread_write_position{0};
+  std::atomic<u64> m_gpu_thread_read_position{0};
+
+  std::thread m_gpu_thread;
+  std::mutex m_gpu_thread_mutex;
+  std::condition_variable m_gpu_thread_wake_cv;
+  std::condition_variable m_gpu_thread_sync_cv;
+  std::atomic_bool m_gpu_thread_sleeping{false};
+  std::atomic_bool m_gpu_thread_sync_requested{false};
+  bool m_gpu_thread_shutdown = false;
+
+  // set when the render context has been released by the CPU thread for the GPU thread to use
+  bool m_gpu_thread_owns_context = false;
 };
@@ -112,6 +112,7 @@ void GPU_HW_D3D11::RestoreGraphicsAPIState()
   m_context->OMSetRenderTargets(1, m_vram_texture.GetD3DRTVArray(), m_vram_depth_view.Get());
   m_context->RSSetState(m_cull_none_rasterizer_state.Get());
   SetViewport(0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  m_scissor_drawing_area = m_drawing_area;
   SetScissorFromDrawingArea();
   m_batch_ubo_dirty = true;
 }
@@ -168,6 +169,15 @@ void GPU_HW_D3D11::UnmapBatchVertexPointer(u32 used_vertices)
   m_batch_current_vertex_ptr = nullptr;
 }
 
+u32 GPU_HW_D3D11::UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices)
+{
+  const u32 size = num_vertices * sizeof(BatchVertex);
+  const D3D11::StreamBuffer::MappingResult res = m_vertex_stream_buffer.Map(m_context.Get(), sizeof(BatchVertex), size);
+  std::memcpy(res.pointer, vertices, size);
+  m_vertex_stream_buffer.Unmap(m_context.Get(), size);
+  return res.index_aligned;
+}
+
 void GPU_HW_D3D11::SetCapabilities()
 {
   const u32 max_texture_size = D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION;
@@ -246,6 +256,7 @@ void GPU_HW_D3D11::DestroyFramebuffer()
   m_vram_encoding_texture.Destroy();
   m_display_texture.Destroy();
   m_vram_readback_texture.Destroy();
+  m_vram_snapshot_texture.Destroy();
 }
 
 bool GPU_HW_D3D11::CreateVertexBuffer()
@@ -506,8 +517,6 @@ void GPU_HW_D3D11::UploadUniformBuffer(const void* data, u32 data_size)
 
   m_context->VSSetConstantBuffers(0, 1, m_uniform_stream_buffer.GetD3DBufferArray());
   m_context->PSSetConstantBuffers(0, 1, m_uniform_stream_buffer.GetD3DBufferArray());
-
-  m_renderer_stats.num_uniform_buffer_updates++;
 }
 
 void GPU_HW_D3D11::SetViewport(u32 x, u32 y, u32 width, u32 height)
@@ -564,22 +573,23 @@ void GPU_HW_D3D11::DrawUtilityShader(ID3D11PixelShader* shader, const void* unif
   m_context->Draw(3, 0);
 }
 
-void GPU_HW_D3D11::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices)
+void GPU_HW_D3D11::DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                                     u32 num_vertices)
 {
-  const bool textured = (m_batch.texture_mode != TextureMode::Disabled);
+  const bool textured = (batch.texture_mode != TextureMode::Disabled);
 
   m_context->VSSetShader(m_batch_vertex_shaders[BoolToUInt8(textured)].Get(), nullptr, 0);
 
-  m_context->PSSetShader(m_batch_pixel_shaders[static_cast<u8>(render_mode)][static_cast<u8>(m_batch.texture_mode)]
-                                              [BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)]
+  m_context->PSSetShader(m_batch_pixel_shaders[static_cast<u8>(render_mode)][static_cast<u8>(batch.texture_mode)]
+                                              [BoolToUInt8(batch.dithering)][BoolToUInt8(batch.interlacing)]
                                                 .Get(),
                          nullptr, 0);
 
   const TransparencyMode transparency_mode =
-    (render_mode == BatchRenderMode::OnlyOpaque) ? TransparencyMode::Disabled : m_batch.transparency_mode;
+    (render_mode == BatchRenderMode::OnlyOpaque) ? TransparencyMode::Disabled : batch.transparency_mode;
   m_context->OMSetBlendState(m_batch_blend_states[static_cast<u8>(transparency_mode)].Get(), nullptr, 0xFFFFFFFFu);
   m_context->OMSetDepthStencilState(
-    m_batch.check_mask_before_draw ? m_depth_test_less_state.Get() : m_depth_test_always_state.Get(), 0);
+    batch.check_mask_before_draw ? m_depth_test_less_state.Get() : m_depth_test_always_state.Get(), 0);
 
   m_context->Draw(num_vertices, base_vertex);
 }
@@ -797,14 +807,12 @@ void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
   m_context->CopySubresourceRegion(m_vram_texture, 0, dst_x, dst_y, 0, m_vram_read_texture, 0, &src_box);
 }
 
-void GPU_HW_D3D11::UpdateVRAMReadTexture()
+void GPU_HW_D3D11::ExecuteUpdateVRAMReadTexture(const Common::Rectangle<u32>& dirty_rect)
 {
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
+  const auto scaled_rect = dirty_rect * m_resolution_scale;
   const CD3D11_BOX src_box(scaled_rect.left, scaled_rect.top, 0, scaled_rect.right, scaled_rect.bottom, 1);
   m_context->CopySubresourceRegion(m_vram_read_texture, 0, scaled_rect.left, scaled_rect.top, 0, m_vram_texture, 0,
                                    &src_box);
-
-  GPU_HW::UpdateVRAMReadTexture();
 }
 
 void GPU_HW_D3D11::UpdateDepthBufferFromMaskBit()
@@ -822,6 +830,30 @@ void GPU_HW_D3D11::UpdateDepthBufferFromMaskBit()
   RestoreGraphicsAPIState();
 }
 
+bool GPU_HW_D3D11::SaveVRAMSnapshot()
+{
+  if (!m_vram_snapshot_texture && !m_vram_snapshot_texture.Create(m_device.Get(), m_vram_texture.GetWidth(),
+                                                                  m_vram_texture.GetHeight(),
+                                                                  m_vram_texture.GetFormat(), 0))
+  {
+    Log_ErrorPrintf("Failed to create VRAM snapshot texture");
+    return false;
+  }
+
+  m_context->CopyResource(m_vram_snapshot_texture, m_vram_texture);
+  return true;
+}
+
+bool GPU_HW_D3D11::RestoreVRAMSnapshot()
+{
+  if (!m_vram_snapshot_texture)
+    return false;
+
+  // the depth buffer is regenerated from the mask bits afterwards
+  m_context->CopyResource(m_vram_texture, m_vram_snapshot_texture);
+  return true;
+}
+
 std::unique_ptr<GPU> GPU::CreateHardwareD3D11Renderer()
 {
   return std::make_unique<GPU_HW_D3D11>();
@@ -33,13 +33,17 @@ protected:
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
-  void UpdateVRAMReadTexture() override;
+  void ExecuteUpdateVRAMReadTexture(const Common::Rectangle<u32>& dirty_rect) override;
   void UpdateDepthBufferFromMaskBit() override;
   void SetScissorFromDrawingArea() override;
   void MapBatchVertexPointer(u32 required_vertices) override;
   void UnmapBatchVertexPointer(u32 used_vertices) override;
+  u32 UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices) override;
   void UploadUniformBuffer(const void* data, u32 data_size) override;
-  void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) override;
+  void DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                         u32 num_vertices) override;
+  bool SaveVRAMSnapshot() override;
+  bool RestoreVRAMSnapshot() override;
 
 private:
   enum : u32
@@ -84,6 +88,7 @@ private:
   D3D11::Texture m_vram_read_texture;
   D3D11::Texture m_vram_encoding_texture;
   D3D11::Texture m_display_texture;
+  D3D11::Texture m_vram_snapshot_texture;
 
   D3D11::StreamBuffer m_vertex_stream_buffer;
 
@@ -10,6 +10,8 @@ GPU_HW_OpenGL::GPU_HW_OpenGL() : GPU_HW() {}
 
 GPU_HW_OpenGL::~GPU_HW_OpenGL()
 {
+  StopGPUThread();
+
   // Destroy objects which don't have destructors to clean them up
   if (m_vram_fbo_id != 0)
     glDeleteFramebuffers(1, &m_vram_fbo_id);
@@ -78,6 +80,7 @@ bool GPU_HW_OpenGL::Initialize(HostDisplay* host_display)
   }
 
   RestoreGraphicsAPIState();
+  StartGPUThread();
   return true;
 }
 
@@ -101,6 +104,15 @@ void GPU_HW_OpenGL::ResetGraphicsAPIState()
 }
 
 void GPU_HW_OpenGL::RestoreGraphicsAPIState()
+{
+  m_batch_ubo_dirty = true;
+  PushGPUThreadCommand([this, drawing_area = m_drawing_area]() {
+    m_scissor_drawing_area = drawing_area;
+    ExecuteRestoreGraphicsAPIState();
+  });
+}
+
+void GPU_HW_OpenGL::ExecuteRestoreGraphicsAPIState()
 {
   glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_vram_fbo_id);
   glViewport(0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
@@ -115,7 +127,6 @@ void GPU_HW_OpenGL::RestoreGraphicsAPIState()
   glBindVertexArray(m_vao_id);
 
   SetScissorFromDrawingArea();
-  m_batch_ubo_dirty = true;
 }
 
 void GPU_HW_OpenGL::UpdateSettings()
@@ -140,6 +151,8 @@ void GPU_HW_OpenGL::UpdateSettings()
     UpdateDisplay();
     ResetGraphicsAPIState();
   }
+
+  StartGPUThread();
 }
 
 void GPU_HW_OpenGL::MapBatchVertexPointer(u32 required_vertices)
@@ -166,6 +179,16 @@ void GPU_HW_OpenGL::UnmapBatchVertexPointer(u32 used_vertices)
   m_batch_current_vertex_ptr = nullptr;
 }
 
+u32 GPU_HW_OpenGL::UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices)
+{
+  const u32 size = num_vertices * sizeof(BatchVertex);
+  const GL::StreamBuffer::MappingResult res = m_vertex_stream_buffer->Map(sizeof(BatchVertex), size);
+  std::memcpy(res.pointer, vertices, size);
+  m_vertex_stream_buffer->Unmap(size);
+  m_vertex_stream_buffer->Bind();
+  return res.index_aligned;
+}
+
 std::tuple<s32, s32> GPU_HW_OpenGL::ConvertToFramebufferCoordinates(s32 x, s32 y)
 {
   return std::make_tuple(x, static_cast<s32>(static_cast<s32>(VRAM_HEIGHT) - y));
@@ -238,6 +261,7 @@ bool GPU_HW_OpenGL::CreateFramebuffer()
   // save old vram texture/fbo, in case we're changing scale
   GL::Texture old_vram_texture = std::move(m_vram_texture);
   GLuint old_vram_fbo = m_vram_fbo_id;
+  m_vram_snapshot_texture.Destroy();
 
   // scale vram size to internal resolution
   const u32 texture_width = VRAM_WIDTH * m_resolution_scale;
@@ -527,16 +551,17 @@ bool GPU_HW_OpenGL::CompilePrograms()
   return true;
 }
 
-void GPU_HW_OpenGL::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices)
+void GPU_HW_OpenGL::DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                                      u32 num_vertices)
 {
-  const GL::Program& prog = m_render_programs[static_cast<u8>(render_mode)][static_cast<u8>(m_batch.texture_mode)]
-                                             [BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)];
+  const GL::Program& prog = m_render_programs[static_cast<u8>(render_mode)][static_cast<u8>(batch.texture_mode)]
+                                             [BoolToUInt8(batch.dithering)][BoolToUInt8(batch.interlacing)];
   prog.Bind();
 
-  if (m_batch.texture_mode != TextureMode::Disabled)
+  if (batch.texture_mode != TextureMode::Disabled)
     m_vram_read_texture.Bind();
 
-  if (m_batch.transparency_mode == TransparencyMode::Disabled || render_mode == BatchRenderMode::OnlyOpaque)
+  if (batch.transparency_mode == TransparencyMode::Disabled || render_mode == BatchRenderMode::OnlyOpaque)
   {
     glDisable(GL_BLEND);
   }
@@ -544,14 +569,14 @@ void GPU_HW_OpenGL::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vert
   {
     glEnable(GL_BLEND);
     glBlendEquationSeparate(
-      m_batch.transparency_mode == TransparencyMode::BackgroundMinusForeground ? GL_FUNC_REVERSE_SUBTRACT : GL_FUNC_ADD,
+      batch.transparency_mode == TransparencyMode::BackgroundMinusForeground ? GL_FUNC_REVERSE_SUBTRACT : GL_FUNC_ADD,
       GL_FUNC_ADD);
     glBlendFuncSeparate(GL_ONE, m_supports_dual_source_blend ? GL_SRC1_ALPHA : GL_SRC_ALPHA, GL_ONE, GL_ZERO);
   }
 
-  glDepthFunc(m_GPUSTAT.check_mask_before_draw ? GL_GEQUAL : GL_ALWAYS);
+  glDepthFunc(batch.check_mask_before_draw ? GL_GEQUAL : GL_ALWAYS);
 
-  glDrawArrays(GL_TRIANGLES, m_batch_base_vertex, num_vertices);
+  glDrawArrays(GL_TRIANGLES, base_vertex, num_vertices);
 }
 
 void GPU_HW_OpenGL::SetScissorFromDrawingArea()
@@ -575,26 +600,29 @@ void GPU_HW_OpenGL::UploadUniformBuffer(const void* data, u32 data_size)
   m_uniform_stream_buffer->Unmap(data_size);
 
   glBindBufferRange(GL_UNIFORM_BUFFER, 1, m_uniform_stream_buffer->GetGLBufferId(), res.buffer_offset, data_size);
-
-  m_renderer_stats.num_uniform_buffer_updates++;
 }
 
 void GPU_HW_OpenGL::ClearDisplay()
 {
   GPU_HW::ClearDisplay();
 
-  m_display_texture.BindFramebuffer(GL_DRAW_FRAMEBUFFER);
-  glDisable(GL_SCISSOR_TEST);
-  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-  glClear(GL_COLOR_BUFFER_BIT);
-  glEnable(GL_SCISSOR_TEST);
-  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_vram_fbo_id);
+  PushGPUThreadCommand([this]() {
+    m_display_texture.BindFramebuffer(GL_DRAW_FRAMEBUFFER);
+    glDisable(GL_SCISSOR_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glEnable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_vram_fbo_id);
+  });
 }
 
 void GPU_HW_OpenGL::UpdateDisplay()
 {
   GPU_HW::UpdateDisplay();
 
+  // the display texture is handed to the host display, so everything up to this point has to be drawn
+  SyncGPUThread();
+
   if (g_settings.debugging.show_vram)
   {
     m_host_display->SetDisplayTexture(reinterpret_cast<void*>(static_cast<uintptr_t>(m_vram_texture.GetGLId())),
@@ -676,6 +704,8 @@ void GPU_HW_OpenGL::UpdateDisplay()
 
 void GPU_HW_OpenGL::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 {
+  SyncGPUThread();
+
   // Get bounds with wrap-around handled.
   const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
@@ -702,7 +732,8 @@ void GPU_HW_OpenGL::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
                &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left]);
   glPixelStorei(GL_PACK_ALIGNMENT, 4);
   glPixelStorei(GL_PACK_ROW_LENGTH, 0);
-  RestoreGraphicsAPIState();
+  ExecuteRestoreGraphicsAPIState();
+  m_batch_ubo_dirty = true;
 }
 
 void GPU_HW_OpenGL::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
@@ -725,29 +756,35 @@ void GPU_HW_OpenGL::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
   width *= m_resolution_scale;
   height *= m_resolution_scale;
 
-  glScissor(x, m_vram_texture.GetHeight() - y - height, width, height);
-
   // fast path when not using interlaced rendering
   if (!IsInterlacedRenderingEnabled())
   {
-    const auto [r, g, b, a] = RGBA8ToFloat(m_true_color ? color : RGBA5551ToRGBA8888(RGBA8888ToRGBA5551(color)));
-    glClearColor(r, g, b, a);
-    IsGLES() ? glClearDepthf(a) : glClearDepth(a);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    SetScissorFromDrawingArea();
+    const auto clear_color = RGBA8ToFloat(m_true_color ? color : RGBA5551ToRGBA8888(RGBA8888ToRGBA5551(color)));
+    PushGPUThreadCommand([this, x, y, width, height, clear_color]() {
+      const auto [r, g, b, a] = clear_color;
+      glScissor(x, m_vram_texture.GetHeight() - y - height, width, height);
+      glClearColor(r, g, b, a);
+      IsGLES() ? glClearDepthf(a) : glClearDepth(a);
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      SetScissorFromDrawingArea();
+    });
   }
   else
   {
     const VRAMFillUBOData uniforms = GetVRAMFillUBOData(x, y, width, height, color);
+    m_batch_ubo_dirty = true;
 
-    m_vram_interlaced_fill_program.Bind();
-    UploadUniformBuffer(&uniforms, sizeof(uniforms));
-    glDisable(GL_BLEND);
-    glDepthFunc(GL_ALWAYS);
-    glBindVertexArray(m_attributeless_vao_id);
-    glDrawArrays(GL_TRIANGLES, 0, 3);
+    PushGPUThreadCommand([this, x, y, width, height, uniforms]() {
+      glScissor(x, m_vram_texture.GetHeight() - y - height, width, height);
+      m_vram_interlaced_fill_program.Bind();
+      UploadUniformBuffer(&uniforms, sizeof(uniforms));
+      glDisable(GL_BLEND);
+      glDepthFunc(GL_ALWAYS);
+      glBindVertexArray(m_attributeless_vao_id);
+      glDrawArrays(GL_TRIANGLES, 0, 3);
 
-    RestoreGraphicsAPIState();
+      ExecuteRestoreGraphicsAPIState();
+    });
   }
 }
 
@@ -759,32 +796,41 @@ void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
     const Common::Rectangle<u32> bounds = GetVRAMTransferBounds(x, y, width, height);
     GPU_HW::UpdateVRAM(bounds.left, bounds.top, bounds.GetWidth(), bounds.GetHeight(), data);
 
-    const auto map_result = m_texture_stream_buffer->Map(sizeof(u16), num_pixels * sizeof(u16));
-    std::memcpy(map_result.pointer, data, num_pixels * sizeof(u16));
-    m_texture_stream_buffer->Unmap(num_pixels * sizeof(u16));
-    m_texture_stream_buffer->Unbind();
-
-    glDisable(GL_BLEND);
-    glDepthFunc(m_GPUSTAT.check_mask_before_draw ? GL_GEQUAL : GL_ALWAYS);
-
-    m_vram_write_program.Bind();
-    if (m_use_ssbo_for_vram_writes)
-      glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_texture_stream_buffer->GetGLBufferId());
-    else
-      glBindTexture(GL_TEXTURE_BUFFER, m_texture_buffer_r16ui_texture);
-
-    const VRAMWriteUBOData uniforms = GetVRAMWriteUBOData(x, y, width, height, map_result.index_aligned);
-    UploadUniformBuffer(&uniforms, sizeof(uniforms));
-
-    // the viewport should already be set to the full vram, so just adjust the scissor
-    const Common::Rectangle<u32> scaled_bounds = bounds * m_resolution_scale;
-    glScissor(scaled_bounds.left, m_vram_texture.GetHeight() - scaled_bounds.top - scaled_bounds.GetHeight(),
-              scaled_bounds.GetWidth(), scaled_bounds.GetHeight());
-
-    glBindVertexArray(m_attributeless_vao_id);
-    glDrawArrays(GL_TRIANGLES, 0, 3);
-
-    RestoreGraphicsAPIState();
+    // buffer offset is filled in once the data has been copied to the texture buffer
+    VRAMWriteUBOData uniforms = GetVRAMWriteUBOData(x, y, width, height, 0);
+    const bool check_mask_before_draw = m_GPUSTAT.check_mask_before_draw;
+    m_batch_ubo_dirty = true;
+
+    PushGPUThreadCommandWithData(
+      data, num_pixels * sizeof(u16),
+      [this, bounds, num_pixels, uniforms, check_mask_before_draw](const void* data) mutable {
+        const auto map_result = m_texture_stream_buffer->Map(sizeof(u16), num_pixels * sizeof(u16));
+        std::memcpy(map_result.pointer, data, num_pixels * sizeof(u16));
+        m_texture_stream_buffer->Unmap(num_pixels * sizeof(u16));
+        m_texture_stream_buffer->Unbind();
+
+        glDisable(GL_BLEND);
+        glDepthFunc(check_mask_before_draw ? GL_GEQUAL : GL_ALWAYS);
+
+        m_vram_write_program.Bind();
+        if (m_use_ssbo_for_vram_writes)
+          glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_texture_stream_buffer->GetGLBufferId());
+        else
+          glBindTexture(GL_TEXTURE_BUFFER, m_texture_buffer_r16ui_texture);
+
+        uniforms.u_buffer_base_offset = map_result.index_aligned;
+        UploadUniformBuffer(&uniforms, sizeof(uniforms));
+
+        // the viewport should already be set to the full vram, so just adjust the scissor
+        const Common::Rectangle<u32> scaled_bounds = bounds * m_resolution_scale;
+        glScissor(scaled_bounds.left, m_vram_texture.GetHeight() - scaled_bounds.top - scaled_bounds.GetHeight(),
+                  scaled_bounds.GetWidth(), scaled_bounds.GetHeight());
+
+        glBindVertexArray(m_attributeless_vao_id);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+
+        ExecuteRestoreGraphicsAPIState();
+      });
   }
   else
   {
@@ -800,59 +846,62 @@ void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
 
     GPU_HW::UpdateVRAM(x, y, width, height, data);
 
-    const auto map_result = m_texture_stream_buffer->Map(sizeof(u32), num_pixels * sizeof(u32));
-
-    // reverse copy the rows so it matches opengl's lower-left origin
-    const u32 source_stride = width * sizeof(u16);
-    const u8* source_ptr = static_cast<const u8*>(data) + (source_stride * (height - 1));
-    u32* dest_ptr = static_cast<u32*>(map_result.pointer);
-    for (u32 row = 0; row < height; row++)
-    {
-      const u8* source_row_ptr = source_ptr;
+    PushGPUThreadCommandWithData(data, num_pixels * sizeof(u16), [this, x, y, width, height](const void* data) {
+      const u32 num_pixels = width * height;
+      const auto map_result = m_texture_stream_buffer->Map(sizeof(u32), num_pixels * sizeof(u32));
 
-      for (u32 col = 0; col < width; col++)
+      // reverse copy the rows so it matches opengl's lower-left origin
+      const u32 source_stride = width * sizeof(u16);
+      const u8* source_ptr = static_cast<const u8*>(data) + (source_stride * (height - 1));
+      u32* dest_ptr = static_cast<u32*>(map_result.pointer);
+      for (u32 row = 0; row < height; row++)
       {
-        u16 src_col;
-        std::memcpy(&src_col, source_row_ptr, sizeof(src_col));
-        source_row_ptr += sizeof(src_col);
+        const u8* source_row_ptr = source_ptr;
 
-        *(dest_ptr++) = RGBA5551ToRGBA8888(src_col);
-      }
+        for (u32 col = 0; col < width; col++)
+        {
+          u16 src_col;
+          std::memcpy(&src_col, source_row_ptr, sizeof(src_col));
+          source_row_ptr += sizeof(src_col);
 
-      source_ptr -= source_stride;
-    }
+          *(dest_ptr++) = RGBA5551ToRGBA8888(src_col);
+        }
 
-    m_texture_stream_buffer->Unmap(num_pixels * sizeof(u32));
-    m_texture_stream_buffer->Bind();
+        source_ptr -= source_stride;
+      }
 
-    // have to write to the 1x texture first
-    if (m_resolution_scale > 1)
-      m_vram_encoding_texture.Bind();
-    else
-      m_vram_texture.Bind();
+      m_texture_stream_buffer->Unmap(num_pixels * sizeof(u32));
+      m_texture_stream_buffer->Bind();
 
-    // lower-left origin flip happens here
-    const u32 flipped_y = VRAM_HEIGHT - y - height;
+      // have to write to the 1x texture first
+      if (m_resolution_scale > 1)
+        m_vram_encoding_texture.Bind();
+      else
+        m_vram_texture.Bind();
 
-    // update texture data
-    glTexSubImage2D(GL_TEXTURE_2D, 0, x, flipped_y, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
-                    reinterpret_cast<void*>(static_cast<uintptr_t>(map_result.buffer_offset)));
-    m_texture_stream_buffer->Unbind();
+      // lower-left origin flip happens here
+      const u32 flipped_y = VRAM_HEIGHT - y - height;
 
-    if (m_resolution_scale > 1)
-    {
-      // scale to internal resolution
-      const u32 scaled_width = width * m_resolution_scale;
-      const u32 scaled_height = height * m_resolution_scale;
-      const u32 scaled_x = x * m_resolution_scale;
-      const u32 scaled_y = y * m_resolution_scale;
-      const u32 scaled_flipped_y = m_vram_texture.GetHeight() - scaled_y - scaled_height;
-      glDisable(GL_SCISSOR_TEST);
-      m_vram_encoding_texture.BindFramebuffer(GL_READ_FRAMEBUFFER);
-      glBlitFramebuffer(x, flipped_y, x + width, flipped_y + height, scaled_x, scaled_flipped_y,
-                        scaled_x + scaled_width, scaled_flipped_y + scaled_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
-      glEnable(GL_SCISSOR_TEST);
-    }
+      // update texture data
+      glTexSubImage2D(GL_TEXTURE_2D, 0, x, flipped_y, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+                      reinterpret_cast<void*>(static_cast<uintptr_t>(map_result.buffer_offset)));
+      m_texture_stream_buffer->Unbind();
+
+      if (m_resolution_scale > 1)
+      {
+        // scale to internal resolution
+        const u32 scaled_width = width * m_resolution_scale;
+        const u32 scaled_height = height * m_resolution_scale;
+        const u32 scaled_x = x * m_resolution_scale;
+        const u32 scaled_y = y * m_resolution_scale;
+        const u32 scaled_flipped_y = m_vram_texture.GetHeight() - scaled_y - scaled_height;
+        glDisable(GL_SCISSOR_TEST);
+        m_vram_encoding_texture.BindFramebuffer(GL_READ_FRAMEBUFFER);
+        glBlitFramebuffer(x, flipped_y, x + width, flipped_y + height, scaled_x, scaled_flipped_y,
+                          scaled_x + scaled_width, scaled_flipped_y + scaled_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glEnable(GL_SCISSOR_TEST);
+      }
+    });
   }
 }
 
@@ -869,21 +918,26 @@ void GPU_HW_OpenGL::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
     VRAMCopyUBOData uniforms = GetVRAMCopyUBOData(src_x, src_y, dst_x, dst_y, width, height);
     uniforms.u_src_y = m_vram_texture.GetHeight() - uniforms.u_src_y - uniforms.u_height;
     uniforms.u_dst_y = m_vram_texture.GetHeight() - uniforms.u_dst_y - uniforms.u_height;
-    UploadUniformBuffer(&uniforms, sizeof(uniforms));
+    const bool check_mask_before_draw = m_GPUSTAT.check_mask_before_draw;
+    m_batch_ubo_dirty = true;
 
-    glDisable(GL_SCISSOR_TEST);
-    glDisable(GL_BLEND);
-    glDepthFunc(m_GPUSTAT.check_mask_before_draw ? GL_GEQUAL : GL_ALWAYS);
+    PushGPUThreadCommand([this, dst_bounds, uniforms, check_mask_before_draw]() {
+      UploadUniformBuffer(&uniforms, sizeof(uniforms));
 
-    const Common::Rectangle<u32> dst_bounds_scaled(dst_bounds * m_resolution_scale);
-    glViewport(dst_bounds_scaled.left,
-               m_vram_texture.GetHeight() - dst_bounds_scaled.top - dst_bounds_scaled.GetHeight(),
-               dst_bounds_scaled.GetWidth(), dst_bounds_scaled.GetHeight());
-    m_vram_read_texture.Bind();
-    m_vram_copy_program.Bind();
-    glDrawArrays(GL_TRIANGLES, 0, 3);
+      glDisable(GL_SCISSOR_TEST);
+      glDisable(GL_BLEND);
+      glDepthFunc(check_mask_before_draw ? GL_GEQUAL : GL_ALWAYS);
+
+      const Common::Rectangle<u32> dst_bounds_scaled(dst_bounds * m_resolution_scale);
+      glViewport(dst_bounds_scaled.left,
+                 m_vram_texture.GetHeight() - dst_bounds_scaled.top - dst_bounds_scaled.GetHeight(),
+                 dst_bounds_scaled.GetWidth(), dst_bounds_scaled.GetHeight());
+      m_vram_read_texture.Bind();
+      m_vram_copy_program.Bind();
+      glDrawArrays(GL_TRIANGLES, 0, 3);
 
-    RestoreGraphicsAPIState();
+      ExecuteRestoreGraphicsAPIState();
+    });
 
     if (m_GPUSTAT.check_mask_before_draw)
       m_current_depth++;
@@ -904,29 +958,31 @@ void GPU_HW_OpenGL::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
   src_y = m_vram_texture.GetHeight() - src_y - height;
   dst_y = m_vram_texture.GetHeight() - dst_y - height;
 
-  if (GLAD_GL_VERSION_4_3)
-  {
-    glCopyImageSubData(m_vram_texture.GetGLId(), GL_TEXTURE_2D, 0, src_x, src_y, 0, m_vram_texture.GetGLId(),
-                       GL_TEXTURE_2D, 0, dst_x, dst_y, 0, width, height, 1);
-  }
-  else if (GLAD_GL_EXT_copy_image)
-  {
-    glCopyImageSubDataEXT(m_vram_texture.GetGLId(), GL_TEXTURE_2D, 0, src_x, src_y, 0, m_vram_texture.GetGLId(),
-                          GL_TEXTURE_2D, 0, dst_x, dst_y, 0, width, height, 1);
-  }
-  else
-  {
-    glDisable(GL_SCISSOR_TEST);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_vram_fbo_id);
-    glBlitFramebuffer(src_x, src_y, src_x + width, src_y + height, dst_x, dst_y, dst_x + width, dst_y + height,
-                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
-    glEnable(GL_SCISSOR_TEST);
-  }
+  PushGPUThreadCommand([this, src_x, src_y, dst_x, dst_y, width, height]() {
+    if (GLAD_GL_VERSION_4_3)
+    {
+      glCopyImageSubData(m_vram_texture.GetGLId(), GL_TEXTURE_2D, 0, src_x, src_y, 0, m_vram_texture.GetGLId(),
+                         GL_TEXTURE_2D, 0, dst_x, dst_y, 0, width, height, 1);
+    }
+    else if (GLAD_GL_EXT_copy_image)
+    {
+      glCopyImageSubDataEXT(m_vram_texture.GetGLId(), GL_TEXTURE_2D, 0, src_x, src_y, 0, m_vram_texture.GetGLId(),
+                            GL_TEXTURE_2D, 0, dst_x, dst_y, 0, width, height, 1);
+    }
+    else
+    {
+      glDisable(GL_SCISSOR_TEST);
+      glBindFramebuffer(GL_READ_FRAMEBUFFER, m_vram_fbo_id);
+      glBlitFramebuffer(src_x, src_y, src_x + width, src_y + height, dst_x, dst_y, dst_x + width, dst_y + height,
+                        GL_COLOR_BUFFER_BIT, GL_NEAREST);
+      glEnable(GL_SCISSOR_TEST);
+    }
+  });
 }
 
-void GPU_HW_OpenGL::UpdateVRAMReadTexture()
+void GPU_HW_OpenGL::ExecuteUpdateVRAMReadTexture(const Common::Rectangle<u32>& dirty_rect)
 {
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
+  const auto scaled_rect = dirty_rect * m_resolution_scale;
   const u32 width = scaled_rect.GetWidth();
   const u32 height = scaled_rect.GetHeight();
   const u32 x = scaled_rect.left;
@@ -951,8 +1007,6 @@ void GPU_HW_OpenGL::UpdateVRAMReadTexture()
     glEnable(GL_SCISSOR_TEST);
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_vram_fbo_id);
   }
-
-  GPU_HW::UpdateVRAMReadTexture();
 }
 
 void GPU_HW_OpenGL::UpdateDepthBufferFromMaskBit()
@@ -972,6 +1026,55 @@ void GPU_HW_OpenGL::UpdateDepthBufferFromMaskBit()
   glEnable(GL_SCISSOR_TEST);
 }
 
+static void CopyWholeTexture(const GL::Texture& src, const GL::Texture& dst)
+{
+  if (GLAD_GL_VERSION_4_3)
+  {
+    glCopyImageSubData(src.GetGLId(), GL_TEXTURE_2D, 0, 0, 0, 0, dst.GetGLId(), GL_TEXTURE_2D, 0, 0, 0, 0,
+                       src.GetWidth(), src.GetHeight(), 1);
+  }
+  else
+  {
+    glCopyImageSubDataEXT(src.GetGLId(), GL_TEXTURE_2D, 0, 0, 0, 0, dst.GetGLId(), GL_TEXTURE_2D, 0, 0, 0, 0,
+                          src.GetWidth(), src.GetHeight(), 1);
+  }
+}
+
+bool GPU_HW_OpenGL::SaveVRAMSnapshot()
+{
+  // a blit would need the framebuffer bindings restored, so without copy_image VRAM just stays in the state
+  if (!GLAD_GL_VERSION_4_3 && !GLAD_GL_EXT_copy_image)
+    return false;
+
+  if (m_vram_snapshot_texture.GetWidth() != m_vram_texture.GetWidth() ||
+      m_vram_snapshot_texture.GetHeight() != m_vram_texture.GetHeight())
+  {
+    SyncGPUThread();
+    if (!m_vram_snapshot_texture.Create(m_vram_texture.GetWidth(), m_vram_texture.GetHeight(), GL_RGBA8, GL_RGBA,
+                                        GL_UNSIGNED_BYTE, nullptr, false))
+    {
+      Log_ErrorPrintf("Failed to create VRAM snapshot texture");
+      return false;
+    }
+  }
+
+  PushGPUThreadCommand([this]() { CopyWholeTexture(m_vram_texture, m_vram_snapshot_texture); });
+  return true;
+}
+
+bool GPU_HW_OpenGL::RestoreVRAMSnapshot()
+{
+  if (m_vram_snapshot_texture.GetWidth() != m_vram_texture.GetWidth() ||
+      m_vram_snapshot_texture.GetHeight() != m_vram_texture.GetHeight())
+  {
+    return false;
+  }
+
+  // the depth buffer is regenerated from the mask bits afterwards
+  PushGPUThreadCommand([this]() { CopyWholeTexture(m_vram_snapshot_texture, m_vram_texture); });
+  return true;
+}
+
 std::unique_ptr<GPU> GPU::CreateHardwareOpenGLRenderer()
 {
   return std::make_unique<GPU_HW_OpenGL>();
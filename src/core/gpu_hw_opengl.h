@@ -29,13 +29,17 @@ protected:
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
-  void UpdateVRAMReadTexture() override;
+  void ExecuteUpdateVRAMReadTexture(const Common::Rectangle<u32>& dirty_rect) override;
   void UpdateDepthBufferFromMaskBit() override;
   void SetScissorFromDrawingArea() override;
   void MapBatchVertexPointer(u32 required_vertices) override;
   void UnmapBatchVertexPointer(u32 used_vertices) override;
+  u32 UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices) override;
   void UploadUniformBuffer(const void* data, u32 data_size) override;
-  void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) override;
+  void DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                         u32 num_vertices) override;
+  bool SaveVRAMSnapshot() override;
+  bool RestoreVRAMSnapshot() override;
 
 private:
   struct GLStats
@@ -52,6 +56,8 @@ private:
 
   std::tuple<s32, s32> ConvertToFramebufferCoordinates(s32 x, s32 y);
 
+  void ExecuteRestoreGraphicsAPIState();
+
   void SetCapabilities(HostDisplay* host_display);
   bool CreateFramebuffer();
   void ClearFramebuffer();
@@ -70,6 +76,7 @@ private:
   GL::Texture m_vram_read_texture;
   GL::Texture m_vram_encoding_texture;
   GL::Texture m_display_texture;
+  GL::Texture m_vram_snapshot_texture;
 
   std::unique_ptr<GL::StreamBuffer> m_vertex_stream_buffer;
   GLuint m_vram_fbo_id = 0;
@@ -16,6 +16,8 @@ GPU_HW_Vulkan::GPU_HW_Vulkan() = default;
 
 GPU_HW_Vulkan::~GPU_HW_Vulkan()
 {
+  StopGPUThread();
+
   if (m_host_display)
   {
     m_host_display->ClearDisplayTexture();
@@ -83,6 +85,7 @@ bool GPU_HW_Vulkan::Initialize(HostDisplay* host_display)
 
   UpdateDepthBufferFromMaskBit();
   RestoreGraphicsAPIState();
+  StartGPUThread();
   return true;
 }
 
@@ -109,6 +112,14 @@ void GPU_HW_Vulkan::ResetGraphicsAPIState()
 }
 
 void GPU_HW_Vulkan::RestoreGraphicsAPIState()
+{
+  PushGPUThreadCommand([this, drawing_area = m_drawing_area]() {
+    m_scissor_drawing_area = drawing_area;
+    ExecuteRestoreGraphicsAPIState();
+  });
+}
+
+void GPU_HW_Vulkan::ExecuteRestoreGraphicsAPIState()
 {
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
@@ -150,6 +161,8 @@ void GPU_HW_Vulkan::UpdateSettings()
     UpdateDisplay();
     ResetGraphicsAPIState();
   }
+
+  StartGPUThread();
 }
 
 void GPU_HW_Vulkan::MapBatchVertexPointer(u32 required_vertices)
@@ -162,7 +175,7 @@ void GPU_HW_Vulkan::MapBatchVertexPointer(u32 required_vertices)
     Log_PerfPrintf("Executing command buffer while waiting for %u bytes in vertex stream buffer", required_space);
     EndRenderPass();
     g_vulkan_context->ExecuteCommandBuffer(false);
-    RestoreGraphicsAPIState();
+    ExecuteRestoreGraphicsAPIState();
     if (!m_vertex_stream_buffer.ReserveMemory(required_space, sizeof(BatchVertex)))
       Panic("Failed to reserve vertex stream buffer memory");
   }
@@ -184,6 +197,25 @@ void GPU_HW_Vulkan::UnmapBatchVertexPointer(u32 used_vertices)
   m_batch_current_vertex_ptr = nullptr;
 }
 
+u32 GPU_HW_Vulkan::UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices)
+{
+  const u32 size = num_vertices * sizeof(BatchVertex);
+  if (!m_vertex_stream_buffer.ReserveMemory(size, sizeof(BatchVertex)))
+  {
+    Log_PerfPrintf("Executing command buffer while waiting for %u bytes in vertex stream buffer", size);
+    EndRenderPass();
+    g_vulkan_context->ExecuteCommandBuffer(false);
+    ExecuteRestoreGraphicsAPIState();
+    if (!m_vertex_stream_buffer.ReserveMemory(size, sizeof(BatchVertex)))
+      Panic("Failed to reserve vertex stream buffer memory");
+  }
+
+  const u32 base_vertex = m_vertex_stream_buffer.GetCurrentOffset() / sizeof(BatchVertex);
+  std::memcpy(m_vertex_stream_buffer.GetCurrentHostPointer(), vertices, size);
+  m_vertex_stream_buffer.CommitMemory(size);
+  return base_vertex;
+}
+
 void GPU_HW_Vulkan::UploadUniformBuffer(const void* data, u32 data_size)
 {
   const u32 alignment = static_cast<u32>(g_vulkan_context->GetUniformBufferAlignment());
@@ -192,7 +224,7 @@ void GPU_HW_Vulkan::UploadUniformBuffer(const void* data, u32 data_size)
     Log_PerfPrintf("Executing command buffer while waiting for %u bytes in uniform stream buffer", data_size);
     EndRenderPass();
     g_vulkan_context->ExecuteCommandBuffer(false);
-    RestoreGraphicsAPIState();
+    ExecuteRestoreGraphicsAPIState();
     if (!m_uniform_stream_buffer.ReserveMemory(data_size, alignment))
       Panic("Failed to reserve uniform stream buffer memory");
   }
@@ -530,6 +562,7 @@ void GPU_HW_Vulkan::DestroyFramebuffer()
   m_vram_readback_texture.Destroy(false);
   m_display_texture.Destroy(false);
   m_vram_readback_staging_texture.Destroy(false);
+  m_vram_snapshot_texture.Destroy(false);
 }
 
 bool GPU_HW_Vulkan::CreateVertexBuffer()
@@ -889,7 +922,8 @@ void GPU_HW_Vulkan::DestroyPipelines()
   m_display_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
 }
 
-void GPU_HW_Vulkan::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices)
+void GPU_HW_Vulkan::DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                                      u32 num_vertices)
 {
   BeginVRAMRenderPass();
 
@@ -897,9 +931,9 @@ void GPU_HW_Vulkan::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vert
 
   // [primitive][depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
   VkPipeline pipeline =
-    m_batch_pipelines[BoolToUInt8(m_batch.check_mask_before_draw)][static_cast<u8>(render_mode)]
-                     [static_cast<u8>(m_batch.texture_mode)][static_cast<u8>(m_batch.transparency_mode)]
-                     [BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)];
+    m_batch_pipelines[BoolToUInt8(batch.check_mask_before_draw)][static_cast<u8>(render_mode)]
+                     [static_cast<u8>(batch.texture_mode)][static_cast<u8>(batch.transparency_mode)]
+                     [BoolToUInt8(batch.dithering)][BoolToUInt8(batch.interlacing)];
 
   vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
   vkCmdDraw(cmdbuf, num_vertices, 1, base_vertex, 0);
@@ -917,18 +951,23 @@ void GPU_HW_Vulkan::ClearDisplay()
 {
   GPU_HW::ClearDisplay();
 
-  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
-  m_display_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+  PushGPUThreadCommand([this]() {
+    VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+    m_display_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-  static const VkClearColorValue cc = {0.0f, 0.0f, 0.0f, 1.0f};
-  static const VkImageSubresourceRange srr = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-  vkCmdClearColorImage(cmdbuf, m_display_texture.GetImage(), m_display_texture.GetLayout(), &cc, 1, &srr);
+    static const VkClearColorValue cc = {0.0f, 0.0f, 0.0f, 1.0f};
+    static const VkImageSubresourceRange srr = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdClearColorImage(cmdbuf, m_display_texture.GetImage(), m_display_texture.GetLayout(), &cc, 1, &srr);
+  });
 }
 
 void GPU_HW_Vulkan::UpdateDisplay()
 {
   GPU_HW::UpdateDisplay();
 
+  // the display texture is handed to the host display, so everything up to this point has to be recorded
+  SyncGPUThread();
+
   if (g_settings.debugging.show_vram)
   {
     m_host_display->SetDisplayTexture(&m_vram_texture, m_vram_texture.GetWidth(), m_vram_texture.GetHeight(), 0, 0,
@@ -994,7 +1033,7 @@ void GPU_HW_Vulkan::UpdateDisplay()
       m_host_display->SetDisplayTexture(&m_display_texture, m_display_texture.GetWidth(), m_display_texture.GetHeight(),
                                         0, 0, scaled_display_width, scaled_display_height);
 
-      RestoreGraphicsAPIState();
+      ExecuteRestoreGraphicsAPIState();
     }
 
     m_host_display->SetDisplayParameters(m_crtc_state.display_width, m_crtc_state.display_height,
@@ -1006,6 +1045,8 @@ void GPU_HW_Vulkan::UpdateDisplay()
 
 void GPU_HW_Vulkan::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 {
+  SyncGPUThread();
+
   // Get bounds with wrap-around handled.
   const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
@@ -1045,7 +1086,7 @@ void GPU_HW_Vulkan::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
                                              &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left],
                                              VRAM_WIDTH * sizeof(u16));
 
-  RestoreGraphicsAPIState();
+  ExecuteRestoreGraphicsAPIState();
 }
 
 void GPU_HW_Vulkan::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
@@ -1067,18 +1108,20 @@ void GPU_HW_Vulkan::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
   width *= m_resolution_scale;
   height *= m_resolution_scale;
 
-  BeginVRAMRenderPass();
-
-  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
   const VRAMFillUBOData uniforms = GetVRAMFillUBOData(x, y, width, height, color);
-  vkCmdPushConstants(cmdbuf, m_no_samplers_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
-                     &uniforms);
-  vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                    m_vram_fill_pipelines[BoolToUInt8(IsInterlacedRenderingEnabled())]);
-  Vulkan::Util::SetViewportAndScissor(cmdbuf, x, y, width, height);
-  vkCmdDraw(cmdbuf, 3, 1, 0, 0);
+  const bool interlaced = IsInterlacedRenderingEnabled();
+  PushGPUThreadCommand([this, x, y, width, height, uniforms, interlaced]() {
+    BeginVRAMRenderPass();
 
-  RestoreGraphicsAPIState();
+    VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+    vkCmdPushConstants(cmdbuf, m_no_samplers_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
+                       &uniforms);
+    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vram_fill_pipelines[BoolToUInt8(interlaced)]);
+    Vulkan::Util::SetViewportAndScissor(cmdbuf, x, y, width, height);
+    vkCmdDraw(cmdbuf, 3, 1, 0, 0);
+
+    ExecuteRestoreGraphicsAPIState();
+  });
 }
 
 void GPU_HW_Vulkan::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data)
@@ -1086,43 +1129,49 @@ void GPU_HW_Vulkan::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
   const Common::Rectangle<u32> bounds = GetVRAMTransferBounds(x, y, width, height);
   GPU_HW::UpdateVRAM(bounds.left, bounds.top, bounds.GetWidth(), bounds.GetHeight(), data);
 
+  // buffer offset is filled in once the data has been copied to the texture buffer
   const u32 data_size = width * height * sizeof(u16);
-  const u32 alignment = std::max<u32>(sizeof(u16), static_cast<u32>(g_vulkan_context->GetTexelBufferAlignment()));
-  if (!m_texture_stream_buffer.ReserveMemory(data_size, alignment))
-  {
-    Log_PerfPrintf("Executing command buffer while waiting for %u bytes in stream buffer", data_size);
-    EndRenderPass();
-    g_vulkan_context->ExecuteCommandBuffer(false);
-    RestoreGraphicsAPIState();
+  VRAMWriteUBOData uniforms = GetVRAMWriteUBOData(x, y, width, height, 0);
+  const bool check_mask_before_draw = m_GPUSTAT.check_mask_before_draw;
+
+  PushGPUThreadCommandWithData(data, data_size, [this, bounds, data_size, uniforms,
+                                                 check_mask_before_draw](const void* data) mutable {
+    const u32 alignment = std::max<u32>(sizeof(u16), static_cast<u32>(g_vulkan_context->GetTexelBufferAlignment()));
     if (!m_texture_stream_buffer.ReserveMemory(data_size, alignment))
     {
-      Panic("Failed to allocate space in stream buffer for VRAM write");
-      return;
+      Log_PerfPrintf("Executing command buffer while waiting for %u bytes in stream buffer", data_size);
+      EndRenderPass();
+      g_vulkan_context->ExecuteCommandBuffer(false);
+      ExecuteRestoreGraphicsAPIState();
+      if (!m_texture_stream_buffer.ReserveMemory(data_size, alignment))
+      {
+        Panic("Failed to allocate space in stream buffer for VRAM write");
+        return;
+      }
     }
-  }
 
-  const u32 start_index = m_texture_stream_buffer.GetCurrentOffset() / sizeof(u16);
-  std::memcpy(m_texture_stream_buffer.GetCurrentHostPointer(), data, data_size);
-  m_texture_stream_buffer.CommitMemory(data_size);
+    uniforms.u_buffer_base_offset = m_texture_stream_buffer.GetCurrentOffset() / sizeof(u16);
+    std::memcpy(m_texture_stream_buffer.GetCurrentHostPointer(), data, data_size);
+    m_texture_stream_buffer.CommitMemory(data_size);
 
-  BeginVRAMRenderPass();
+    BeginVRAMRenderPass();
 
-  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
-  const VRAMWriteUBOData uniforms = GetVRAMWriteUBOData(x, y, width, height, start_index);
-  vkCmdPushConstants(cmdbuf, m_vram_write_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
-                     &uniforms);
-  vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                    m_vram_write_pipelines[BoolToUInt8(m_GPUSTAT.check_mask_before_draw)]);
-  vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vram_write_pipeline_layout, 0, 1,
-                          &m_vram_write_descriptor_set, 0, nullptr);
-
-  // the viewport should already be set to the full vram, so just adjust the scissor
-  const Common::Rectangle<u32> scaled_bounds = bounds * m_resolution_scale;
-  Vulkan::Util::SetScissor(cmdbuf, scaled_bounds.left, scaled_bounds.top, scaled_bounds.GetWidth(),
-                           scaled_bounds.GetHeight());
-  vkCmdDraw(cmdbuf, 3, 1, 0, 0);
+    VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+    vkCmdPushConstants(cmdbuf, m_vram_write_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
+                       &uniforms);
+    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                      m_vram_write_pipelines[BoolToUInt8(check_mask_before_draw)]);
+    vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vram_write_pipeline_layout, 0, 1,
+                            &m_vram_write_descriptor_set, 0, nullptr);
+
+    // the viewport should already be set to the full vram, so just adjust the scissor
+    const Common::Rectangle<u32> scaled_bounds = bounds * m_resolution_scale;
+    Vulkan::Util::SetScissor(cmdbuf, scaled_bounds.left, scaled_bounds.top, scaled_bounds.GetWidth(),
+                             scaled_bounds.GetHeight());
+    vkCmdDraw(cmdbuf, 3, 1, 0, 0);
 
-  RestoreGraphicsAPIState();
+    ExecuteRestoreGraphicsAPIState();
+  });
 }
 
 void GPU_HW_Vulkan::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
@@ -1137,20 +1186,23 @@ void GPU_HW_Vulkan::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
 
     const VRAMCopyUBOData uniforms(GetVRAMCopyUBOData(src_x, src_y, dst_x, dst_y, width, height));
     const Common::Rectangle<u32> dst_bounds_scaled(dst_bounds * m_resolution_scale);
+    const bool check_mask_before_draw = m_GPUSTAT.check_mask_before_draw;
 
-    BeginVRAMRenderPass();
+    PushGPUThreadCommand([this, uniforms, dst_bounds_scaled, check_mask_before_draw]() {
+      BeginVRAMRenderPass();
 
-    VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
-    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                      m_vram_copy_pipelines[BoolToUInt8(m_GPUSTAT.check_mask_before_draw)]);
-    vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_single_sampler_pipeline_layout, 0, 1,
-                            &m_vram_copy_descriptor_set, 0, nullptr);
-    vkCmdPushConstants(cmdbuf, m_single_sampler_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
-                       &uniforms);
-    Vulkan::Util::SetViewportAndScissor(cmdbuf, dst_bounds_scaled.left, dst_bounds_scaled.top,
-                                        dst_bounds_scaled.GetWidth(), dst_bounds_scaled.GetHeight());
-    vkCmdDraw(cmdbuf, 3, 1, 0, 0);
-    RestoreGraphicsAPIState();
+      VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+      vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                        m_vram_copy_pipelines[BoolToUInt8(check_mask_before_draw)]);
+      vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_single_sampler_pipeline_layout, 0, 1,
+                              &m_vram_copy_descriptor_set, 0, nullptr);
+      vkCmdPushConstants(cmdbuf, m_single_sampler_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
+                         &uniforms);
+      Vulkan::Util::SetViewportAndScissor(cmdbuf, dst_bounds_scaled.left, dst_bounds_scaled.top,
+                                          dst_bounds_scaled.GetWidth(), dst_bounds_scaled.GetHeight());
+      vkCmdDraw(cmdbuf, 3, 1, 0, 0);
+      ExecuteRestoreGraphicsAPIState();
+    });
 
     if (m_GPUSTAT.check_mask_before_draw)
       m_current_depth++;
@@ -1167,24 +1219,26 @@ void GPU_HW_Vulkan::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
   width *= m_resolution_scale;
   height *= m_resolution_scale;
 
-  EndRenderPass();
+  PushGPUThreadCommand([this, src_x, src_y, dst_x, dst_y, width, height]() {
+    EndRenderPass();
 
-  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+    VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
 
-  m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_GENERAL);
+    m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_GENERAL);
 
-  const VkImageCopy ic{{VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
-                       {static_cast<s32>(src_x), static_cast<s32>(src_y), 0},
-                       {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
-                       {static_cast<s32>(dst_x), static_cast<s32>(dst_y), 0},
-                       {width, height, 1u}};
-  vkCmdCopyImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), m_vram_texture.GetImage(),
-                 m_vram_texture.GetLayout(), 1, &ic);
+    const VkImageCopy ic{{VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+                         {static_cast<s32>(src_x), static_cast<s32>(src_y), 0},
+                         {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+                         {static_cast<s32>(dst_x), static_cast<s32>(dst_y), 0},
+                         {width, height, 1u}};
+    vkCmdCopyImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), m_vram_texture.GetImage(),
+                   m_vram_texture.GetLayout(), 1, &ic);
 
-  m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  });
 }
 
-void GPU_HW_Vulkan::UpdateVRAMReadTexture()
+void GPU_HW_Vulkan::ExecuteUpdateVRAMReadTexture(const Common::Rectangle<u32>& dirty_rect)
 {
   EndRenderPass();
 
@@ -1192,7 +1246,7 @@ void GPU_HW_Vulkan::UpdateVRAMReadTexture()
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
   m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
+  const auto scaled_rect = dirty_rect * m_resolution_scale;
   const VkImageCopy copy{{VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
                          {static_cast<s32>(scaled_rect.left), static_cast<s32>(scaled_rect.top), 0},
                          {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
@@ -1204,8 +1258,6 @@ void GPU_HW_Vulkan::UpdateVRAMReadTexture()
 
   m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-
-  GPU_HW::UpdateVRAMReadTexture();
 }
 
 void GPU_HW_Vulkan::UpdateDepthBufferFromMaskBit()
@@ -1228,7 +1280,71 @@ void GPU_HW_Vulkan::UpdateDepthBufferFromMaskBit()
 
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 
-  RestoreGraphicsAPIState();
+  ExecuteRestoreGraphicsAPIState();
+}
+
+bool GPU_HW_Vulkan::SaveVRAMSnapshot()
+{
+  if (!m_vram_snapshot_texture.IsValid())
+  {
+    SyncGPUThread();
+    if (!m_vram_snapshot_texture.Create(m_vram_texture.GetWidth(), m_vram_texture.GetHeight(), 1, 1,
+                                        m_vram_texture.GetFormat(), VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D,
+                                        VK_IMAGE_TILING_OPTIMAL,
+                                        VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                          VK_IMAGE_USAGE_TRANSFER_DST_BIT))
+    {
+      Log_ErrorPrintf("Failed to create VRAM snapshot texture");
+      return false;
+    }
+  }
+
+  PushGPUThreadCommand([this]() {
+    EndRenderPass();
+
+    VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+    m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    m_vram_snapshot_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    const VkImageCopy copy{{VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+                           {0, 0, 0},
+                           {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+                           {0, 0, 0},
+                           {m_vram_texture.GetWidth(), m_vram_texture.GetHeight(), 1u}};
+    vkCmdCopyImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), m_vram_snapshot_texture.GetImage(),
+                   m_vram_snapshot_texture.GetLayout(), 1u, &copy);
+
+    m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  });
+
+  return true;
+}
+
+bool GPU_HW_Vulkan::RestoreVRAMSnapshot()
+{
+  if (!m_vram_snapshot_texture.IsValid())
+    return false;
+
+  // the depth buffer is regenerated from the mask bits afterwards
+  PushGPUThreadCommand([this]() {
+    EndRenderPass();
+
+    VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+    m_vram_snapshot_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    const VkImageCopy copy{{VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+                           {0, 0, 0},
+                           {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+                           {0, 0, 0},
+                           {m_vram_texture.GetWidth(), m_vram_texture.GetHeight(), 1u}};
+    vkCmdCopyImage(cmdbuf, m_vram_snapshot_texture.GetImage(), m_vram_snapshot_texture.GetLayout(),
+                   m_vram_texture.GetImage(), m_vram_texture.GetLayout(), 1u, &copy);
+
+    m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  });
+
+  return true;
 }
 
 std::unique_ptr<GPU> GPU::CreateHardwareVulkanRenderer()
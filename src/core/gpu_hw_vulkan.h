@@ -28,13 +28,17 @@ protected:
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
-  void UpdateVRAMReadTexture() override;
+  void ExecuteUpdateVRAMReadTexture(const Common::Rectangle<u32>& dirty_rect) override;
   void UpdateDepthBufferFromMaskBit() override;
   void SetScissorFromDrawingArea() override;
   void MapBatchVertexPointer(u32 required_vertices) override;
   void UnmapBatchVertexPointer(u32 used_vertices) override;
+  u32 UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices) override;
   void UploadUniformBuffer(const void* data, u32 data_size) override;
-  void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) override;
+  void DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                         u32 num_vertices) override;
+  bool SaveVRAMSnapshot() override;
+  bool RestoreVRAMSnapshot() override;
 
 private:
   enum : u32
@@ -44,6 +48,8 @@ private:
   void SetCapabilities();
   void DestroyResources();
 
+  void ExecuteRestoreGraphicsAPIState();
+
   ALWAYS_INLINE bool InRenderPass() const { return (m_current_render_pass != VK_NULL_HANDLE); }
   void BeginRenderPass(VkRenderPass render_pass, VkFramebuffer framebuffer, u32 x, u32 y, u32 width, u32 height);
   void BeginVRAMRenderPass();
@@ -85,6 +91,7 @@ private:
   Vulkan::Texture m_vram_readback_texture;
   Vulkan::StagingTexture m_vram_readback_staging_texture;
   Vulkan::Texture m_display_texture;
+  Vulkan::Texture m_vram_snapshot_texture;
 
   VkFramebuffer m_vram_framebuffer = VK_NULL_HANDLE;
   VkFramebuffer m_vram_update_depth_framebuffer = VK_NULL_HANDLE;
@@ -1,7 +1,10 @@
 #include "gpu_sw.h"
 #include "common/assert.h"
+#include "common/bitutils.h"
 #include "common/log.h"
+#include "common/trace.h"
 #include "host_display.h"
+#include "settings.h"
 #include "system.h"
 #include <algorithm>
 Log_SetChannel(GPU_SW);
@@ -14,6 +17,8 @@ GPU_SW::GPU_SW()
 
 GPU_SW::~GPU_SW()
 {
+  StopWorkerThreads();
+
   if (m_host_display)
     m_host_display->ClearDisplayTexture();
 }
@@ -32,16 +37,34 @@ bool GPU_SW::Initialize(HostDisplay* host_display)
   if (!m_display_texture)
     return false;
 
+  if (g_settings.gpu_use_thread)
+    StartWorkerThreads();
+
   return true;
 }
 
 void GPU_SW::Reset()
 {
+  SyncWorkerThreads();
+
   GPU::Reset();
 
   m_vram.fill(0);
 }
 
+void GPU_SW::UpdateSettings()
+{
+  GPU::UpdateSettings();
+
+  if (g_settings.gpu_use_thread != IsUsingWorkerThreads())
+  {
+    if (g_settings.gpu_use_thread)
+      StartWorkerThreads();
+    else
+      StopWorkerThreads();
+  }
+}
+
 void GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32* dst_ptr, u32 dst_stride, u32 width, u32 height, bool interlaced,
                           bool interleaved)
 {
@@ -149,6 +172,8 @@ void GPU_SW::ClearDisplay()
 
 void GPU_SW::UpdateDisplay()
 {
+  SyncWorkerThreads();
+
   // fill display texture
   m_display_texture_buffer.resize(VRAM_WIDTH * VRAM_HEIGHT);
 
@@ -214,6 +239,197 @@ void GPU_SW::UpdateDisplay()
   }
 }
 
+void GPU_SW::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
+{
+  // the caller reads m_vram_ptr directly afterwards
+  SyncWorkerThreads();
+}
+
+void GPU_SW::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
+{
+  // Hardware tests show that fills seem to break on the first two lines when the offset matches the displayed field.
+  if (IsInterlacedRenderingEnabled() && IsCRTCScanlinePending())
+    SynchronizeCRTC();
+
+  SWCommand* cmd = AllocateCommand(SWCommandType::FillVRAM);
+  cmd->fill.x = x;
+  cmd->fill.y = y;
+  cmd->fill.width = width;
+  cmd->fill.height = height;
+  cmd->fill.color = RGBA8888ToRGBA5551(color);
+  SubmitCommand(cmd);
+}
+
+void GPU_SW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data)
+{
+  SWCommand* cmd = AllocateCommand(SWCommandType::UpdateVRAM);
+  cmd->update.x = x;
+  cmd->update.y = y;
+  cmd->update.width = width;
+  cmd->update.height = height;
+
+  // the source is only valid for the duration of the call, so keep a copy when it's queued
+  if (IsUsingWorkerThreads())
+  {
+    const u16* src_ptr = static_cast<const u16*>(data);
+    cmd->update_data.assign(src_ptr, src_ptr + (width * height));
+    cmd->update.data = cmd->update_data.data();
+  }
+  else
+  {
+    cmd->update.data = static_cast<const u16*>(data);
+  }
+
+  SubmitCommand(cmd);
+}
+
+void GPU_SW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
+{
+  SWCommand* cmd = AllocateCommand(SWCommandType::CopyVRAM);
+  cmd->copy.src_x = src_x;
+  cmd->copy.src_y = src_y;
+  cmd->copy.dst_x = dst_x;
+  cmd->copy.dst_y = dst_y;
+  cmd->copy.width = width;
+  cmd->copy.height = height;
+  SubmitCommand(cmd);
+}
+
+void GPU_SW::ExecuteFillVRAM(const SWDrawState& state, const SWBand& band, u32 x, u32 y, u32 width, u32 height,
+                             u16 color)
+{
+  for (u32 yoffs = 0; yoffs < height; yoffs++)
+  {
+    const u32 row = (y + yoffs) % VRAM_HEIGHT;
+    if (!band.ContainsLine(row) || ShouldSkipLine(state, row))
+      continue;
+
+    u16* row_ptr = &m_vram[row * VRAM_WIDTH];
+    if ((x + width) <= VRAM_WIDTH)
+    {
+      std::fill_n(&row_ptr[x], width, color);
+    }
+    else
+    {
+      for (u32 xoffs = 0; xoffs < width; xoffs++)
+        row_ptr[(x + xoffs) % VRAM_WIDTH] = color;
+    }
+  }
+}
+
+void GPU_SW::ExecuteUpdateVRAM(const SWDrawState& state, const SWBand& band, u32 x, u32 y, u32 width, u32 height,
+                               const u16* data)
+{
+  if (state.mask_and != 0)
+  {
+    // Masked pixels don't consume source data, so rows can't be located independently. These updates are exclusive.
+    const u16* src_ptr = data;
+    for (u32 row = 0; row < height;)
+    {
+      u16* dst_row_ptr = &m_vram[((y + row++) % VRAM_HEIGHT) * VRAM_WIDTH];
+      for (u32 col = 0; col < width;)
+      {
+        // TODO: Handle unaligned reads...
+        u16* pixel_ptr = &dst_row_ptr[(x + col++) % VRAM_WIDTH];
+        if (((*pixel_ptr) & state.mask_and) == 0)
+          *pixel_ptr = *(src_ptr++) | state.mask_or;
+      }
+    }
+
+    return;
+  }
+
+  const u16* src_ptr = data;
+  for (u32 row = 0; row < height; row++, src_ptr += width)
+  {
+    const u32 dst_y = (y + row) % VRAM_HEIGHT;
+    if (!band.ContainsLine(dst_y))
+      continue;
+
+    u16* dst_row_ptr = &m_vram[dst_y * VRAM_WIDTH];
+    if ((x + width) <= VRAM_WIDTH && state.mask_or == 0)
+    {
+      std::copy_n(src_ptr, width, &dst_row_ptr[x]);
+    }
+    else
+    {
+      for (u32 col = 0; col < width; col++)
+        dst_row_ptr[(x + col) % VRAM_WIDTH] = src_ptr[col] | state.mask_or;
+    }
+  }
+}
+
+void GPU_SW::ExecuteCopyVRAM(const SWDrawState& state, u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width,
+                             u32 height)
+{
+  // Break up oversized copies. This behavior has not been verified on console.
+  if ((src_x + width) > VRAM_WIDTH || (dst_x + width) > VRAM_WIDTH)
+  {
+    u32 remaining_rows = height;
+    u32 current_src_y = src_y;
+    u32 current_dst_y = dst_y;
+    while (remaining_rows > 0)
+    {
+      const u32 rows_to_copy =
+        std::min<u32>(remaining_rows, std::min<u32>(VRAM_HEIGHT - current_src_y, VRAM_HEIGHT - current_dst_y));
+
+      u32 remaining_columns = width;
+      u32 current_src_x = src_x;
+      u32 current_dst_x = dst_x;
+      while (remaining_columns > 0)
+      {
+        const u32 columns_to_copy =
+          std::min<u32>(remaining_columns, std::min<u32>(VRAM_WIDTH - current_src_x, VRAM_WIDTH - current_dst_x));
+        ExecuteCopyVRAM(state, current_src_x, current_src_y, current_dst_x, current_dst_y, columns_to_copy,
+                        rows_to_copy);
+        current_src_x = (current_src_x + columns_to_copy) % VRAM_WIDTH;
+        current_dst_x = (current_dst_x + columns_to_copy) % VRAM_WIDTH;
+        remaining_columns -= columns_to_copy;
+      }
+
+      current_src_y = (current_src_y + rows_to_copy) % VRAM_HEIGHT;
+      current_dst_y = (current_dst_y + rows_to_copy) % VRAM_HEIGHT;
+      remaining_rows -= rows_to_copy;
+    }
+
+    return;
+  }
+
+  // Copy in reverse when src_x < dst_x, this is verified on console.
+  if (src_x < dst_x || ((src_x + width - 1) % VRAM_WIDTH) < ((dst_x + width - 1) % VRAM_WIDTH))
+  {
+    for (u32 row = 0; row < height; row++)
+    {
+      const u16* src_row_ptr = &m_vram[((src_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
+      u16* dst_row_ptr = &m_vram[((dst_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
+
+      for (s32 col = static_cast<s32>(width - 1); col >= 0; col--)
+      {
+        const u16 src_pixel = src_row_ptr[(src_x + static_cast<u32>(col)) % VRAM_WIDTH];
+        u16* dst_pixel_ptr = &dst_row_ptr[(dst_x + static_cast<u32>(col)) % VRAM_WIDTH];
+        if ((*dst_pixel_ptr & state.mask_and) == 0)
+          *dst_pixel_ptr = src_pixel | state.mask_or;
+      }
+    }
+  }
+  else
+  {
+    for (u32 row = 0; row < height; row++)
+    {
+      const u16* src_row_ptr = &m_vram[((src_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
+      u16* dst_row_ptr = &m_vram[((dst_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
+
+      for (u32 col = 0; col < width; col++)
+      {
+        const u16 src_pixel = src_row_ptr[(src_x + col) % VRAM_WIDTH];
+        u16* dst_pixel_ptr = &dst_row_ptr[(dst_x + col) % VRAM_WIDTH];
+        if ((*dst_pixel_ptr & state.mask_and) == 0)
+          *dst_pixel_ptr = src_pixel | state.mask_or;
+      }
+    }
+  }
+}
+
 void GPU_SW::DispatchRenderCommand()
 {
   const RenderCommand rc{m_render_command.bits};
@@ -255,12 +471,31 @@ void GPU_SW::DispatchRenderCommand()
       if (!IsDrawingAreaIsValid())
         return;
 
-      const DrawTriangleFunction DrawFunction = GetDrawTriangleFunction(
-        rc.shading_enable, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable, dithering_enable);
+      SWCommand* cmd = AllocateCommand(SWCommandType::DrawTriangles);
+      Common::Rectangle<s32> bounds;
+      cmd->bounds.SetInvalid();
+      for (u32 i = 0; i < num_vertices - 2; i++)
+      {
+        // the second triangle of a quad uses vertices 2,1,3
+        const SWVertex* v0 = &vertices[i * 2];
+        const SWVertex* v1 = &vertices[1];
+        const SWVertex* v2 = &vertices[i + 2];
+        if (GetTriangleBounds(cmd->state, v0, v1, v2, &bounds))
+        {
+          AddDrawTriangleTicks(bounds.right - bounds.left + 1, bounds.bottom - bounds.top + 1, rc.shading_enable,
+                               rc.texture_enable, rc.transparency_enable);
+          cmd->bounds.Include(bounds);
+        }
+      }
+      if (!cmd->bounds.Valid())
+        return;
 
-      (this->*DrawFunction)(&vertices[0], &vertices[1], &vertices[2]);
-      if (num_vertices > 3)
-        (this->*DrawFunction)(&vertices[2], &vertices[1], &vertices[3]);
+      cmd->triangles.function = GetDrawTriangleFunction(rc.shading_enable, rc.texture_enable, rc.raw_texture_enable,
+                                                        rc.transparency_enable, dithering_enable);
+      cmd->triangles.num_vertices = num_vertices;
+      cmd->textured = rc.texture_enable;
+      std::copy_n(vertices.begin(), num_vertices, cmd->triangles.vertices);
+      SubmitCommand(cmd);
     }
     break;
 
@@ -306,10 +541,35 @@ void GPU_SW::DispatchRenderCommand()
       if (!IsDrawingAreaIsValid())
         return;
 
-      const DrawRectangleFunction DrawFunction =
-        GetDrawRectangleFunction(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
+      SWCommand* cmd = AllocateCommand(SWCommandType::DrawRectangle);
+      {
+        const s32 start_x = TruncateVertexPosition(m_drawing_offset.x + vp.x);
+        const s32 start_y = TruncateVertexPosition(m_drawing_offset.y + vp.y);
+        const u32 clip_left = static_cast<u32>(std::clamp<s32>(start_x, m_drawing_area.left, m_drawing_area.right));
+        const u32 clip_right =
+          static_cast<u32>(std::clamp<s32>(start_x + width, m_drawing_area.left, m_drawing_area.right)) + 1u;
+        const u32 clip_top = static_cast<u32>(std::clamp<s32>(start_y, m_drawing_area.top, m_drawing_area.bottom));
+        const u32 clip_bottom =
+          static_cast<u32>(std::clamp<s32>(start_y + height, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
+        AddDrawRectangleTicks(clip_right - clip_left, clip_bottom - clip_top, rc.texture_enable,
+                              rc.transparency_enable);
+        cmd->bounds.Set(static_cast<s32>(clip_left), static_cast<s32>(clip_top), static_cast<s32>(clip_right - 1),
+                        static_cast<s32>(clip_bottom - 1));
+      }
 
-      (this->*DrawFunction)(vp.x, vp.y, width, height, r, g, b, texcoord_x, texcoord_y);
+      cmd->rectangle.function =
+        GetDrawRectangleFunction(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
+      cmd->rectangle.x = vp.x;
+      cmd->rectangle.y = vp.y;
+      cmd->rectangle.width = static_cast<u32>(width);
+      cmd->rectangle.height = static_cast<u32>(height);
+      cmd->rectangle.r = r;
+      cmd->rectangle.g = g;
+      cmd->rectangle.b = b;
+      cmd->rectangle.texcoord_x = texcoord_x;
+      cmd->rectangle.texcoord_y = texcoord_y;
+      cmd->textured = rc.texture_enable;
+      SubmitCommand(cmd);
     }
     break;
 
@@ -346,7 +606,33 @@ void GPU_SW::DispatchRenderCommand()
 
         // down here because of the FIFO pops
         if (IsDrawingAreaIsValid())
-          (this->*DrawFunction)(p0, p1);
+        {
+          const s32 min_x = std::min(p0->x, p1->x);
+          const s32 max_x = std::max(p0->x, p1->x);
+          const s32 min_y = std::min(p0->y, p1->y);
+          const s32 max_y = std::max(p0->y, p1->y);
+
+          // TODO: Move to base class
+          const u32 clip_left = static_cast<u32>(std::clamp<s32>(min_x, m_drawing_area.left, m_drawing_area.left));
+          const u32 clip_right =
+            static_cast<u32>(std::clamp<s32>(max_x, m_drawing_area.left, m_drawing_area.right)) + 1u;
+          const u32 clip_top = static_cast<u32>(std::clamp<s32>(min_y, m_drawing_area.top, m_drawing_area.bottom));
+          const u32 clip_bottom =
+            static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
+          AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, shaded);
+
+          // pad the bounds by a pixel, the stepping can round either way
+          SWCommand* cmd = AllocateCommand(SWCommandType::DrawLine);
+          cmd->bounds.Set(
+            std::clamp<s32>(min_x + m_drawing_offset.x - 1, m_drawing_area.left, m_drawing_area.right),
+            std::clamp<s32>(min_y + m_drawing_offset.y - 1, m_drawing_area.top, m_drawing_area.bottom),
+            std::clamp<s32>(max_x + m_drawing_offset.x + 1, m_drawing_area.left, m_drawing_area.right),
+            std::clamp<s32>(max_y + m_drawing_offset.y + 1, m_drawing_area.top, m_drawing_area.bottom));
+          cmd->line.function = DrawFunction;
+          cmd->line.vertices[0] = *p0;
+          cmd->line.vertices[1] = *p1;
+          SubmitCommand(cmd);
+        }
 
         // swap p0/p1 so that the last vertex is used as the first for the next line
         std::swap(p0, p1);
@@ -407,45 +693,70 @@ static constexpr u8 Interpolate(u8 v0, u8 v1, u8 v2, s32 w0, s32 w1, s32 w2, s32
   return (vd < 0) ? 0 : ((vd > 0xFF) ? 0xFF : static_cast<u8>(vd));
 }
 
+#define orient2d(ax, ay, bx, by, cx, cy) ((bx - ax) * (cy - ay) - (by - ay) * (cx - ax))
+
+bool GPU_SW::GetTriangleBounds(const SWDrawState& state, const SWVertex* v0, const SWVertex* v1, const SWVertex* v2,
+                               Common::Rectangle<s32>* bounds)
+{
+  const s32 px0 = v0->x + state.drawing_offset.x;
+  const s32 py0 = v0->y + state.drawing_offset.y;
+  const s32 px1 = v1->x + state.drawing_offset.x;
+  const s32 py1 = v1->y + state.drawing_offset.y;
+  const s32 px2 = v2->x + state.drawing_offset.x;
+  const s32 py2 = v2->y + state.drawing_offset.y;
+
+  // cull degenerate triangles
+  if (orient2d(px0, py0, px1, py1, px2, py2) == 0)
+    return false;
+
+  // compute bounding box of triangle
+  const s32 min_x = std::min(px0, std::min(px1, px2));
+  const s32 max_x = std::max(px0, std::max(px1, px2));
+  const s32 min_y = std::min(py0, std::min(py1, py2));
+  const s32 max_y = std::max(py0, std::max(py1, py2));
+
+  // reject triangles which cover the whole vram area
+  if (static_cast<u32>(max_x - min_x) > MAX_PRIMITIVE_WIDTH || static_cast<u32>(max_y - min_y) > MAX_PRIMITIVE_HEIGHT)
+    return false;
+
+  // clip to drawing area
+  const s32 left = static_cast<s32>(state.drawing_area.left);
+  const s32 right = static_cast<s32>(state.drawing_area.right);
+  const s32 top = static_cast<s32>(state.drawing_area.top);
+  const s32 bottom = static_cast<s32>(state.drawing_area.bottom);
+  bounds->Set(std::clamp(min_x, left, right), std::clamp(min_y, top, bottom), std::clamp(max_x, left, right),
+              std::clamp(max_y, top, bottom));
+  return true;
+}
+
 template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
          bool dithering_enable>
-void GPU_SW::DrawTriangle(const SWVertex* v0, const SWVertex* v1, const SWVertex* v2)
+void GPU_SW::DrawTriangle(const SWDrawState& state, const SWBand& band, const SWVertex* v0, const SWVertex* v1,
+                          const SWVertex* v2)
 {
-#define orient2d(ax, ay, bx, by, cx, cy) ((bx - ax) * (cy - ay) - (by - ay) * (cx - ax))
-
   // ensure the vertices follow a counter-clockwise order
   if (IsClockwiseWinding(v0, v1, v2))
     std::swap(v1, v2);
 
-  const s32 px0 = v0->x + m_drawing_offset.x;
-  const s32 py0 = v0->y + m_drawing_offset.y;
-  const s32 px1 = v1->x + m_drawing_offset.x;
-  const s32 py1 = v1->y + m_drawing_offset.y;
-  const s32 px2 = v2->x + m_drawing_offset.x;
-  const s32 py2 = v2->y + m_drawing_offset.y;
+  Common::Rectangle<s32> bounds;
+  if (!GetTriangleBounds(state, v0, v1, v2, &bounds))
+    return;
+
+  const s32 px0 = v0->x + state.drawing_offset.x;
+  const s32 py0 = v0->y + state.drawing_offset.y;
+  const s32 px1 = v1->x + state.drawing_offset.x;
+  const s32 py1 = v1->y + state.drawing_offset.y;
+  const s32 px2 = v2->x + state.drawing_offset.x;
+  const s32 py2 = v2->y + state.drawing_offset.y;
 
   // Barycentric coordinates at minX/minY corner
   const s32 ws = orient2d(px0, py0, px1, py1, px2, py2);
   const s32 half_ws = std::max<s32>((ws / 2) - 1, 0);
-  if (ws == 0)
-    return;
-
-  // compute bounding box of triangle
-  s32 min_x = std::min(px0, std::min(px1, px2));
-  s32 max_x = std::max(px0, std::max(px1, px2));
-  s32 min_y = std::min(py0, std::min(py1, py2));
-  s32 max_y = std::max(py0, std::max(py1, py2));
-
-  // reject triangles which cover the whole vram area
-  if (static_cast<u32>(max_x - min_x) > MAX_PRIMITIVE_WIDTH || static_cast<u32>(max_y - min_y) > MAX_PRIMITIVE_HEIGHT)
-    return;
 
-  // clip to drawing area
-  min_x = std::clamp(min_x, static_cast<s32>(m_drawing_area.left), static_cast<s32>(m_drawing_area.right));
-  max_x = std::clamp(max_x, static_cast<s32>(m_drawing_area.left), static_cast<s32>(m_drawing_area.right));
-  min_y = std::clamp(min_y, static_cast<s32>(m_drawing_area.top), static_cast<s32>(m_drawing_area.bottom));
-  max_y = std::clamp(max_y, static_cast<s32>(m_drawing_area.top), static_cast<s32>(m_drawing_area.bottom));
-  AddDrawTriangleTicks(max_x - min_x + 1, max_y - min_y + 1, shading_enable, texture_enable, transparency_enable);
+  const s32 min_x = bounds.left;
+  const s32 max_x = bounds.right;
+  const s32 min_y = bounds.top;
+  const s32 max_y = bounds.bottom;
 
   // compute per-pixel increments
   const s32 a01 = py0 - py1, b01 = px1 - px0;
@@ -462,47 +773,97 @@ void GPU_SW::DrawTriangle(const SWVertex* v0, const SWVertex* v1, const SWVertex
   s32 w1 = orient2d(px2, py2, px0, py0, min_x, min_y);
   s32 w2 = orient2d(px0, py0, px1, py1, min_x, min_y);
 
+  const SWSpan::PixelState ps = GetPixelState(state);
+  const bool use_spans = !texture_enable || state.span_shading;
+
   // *exclusive* of max coordinate in PSX
   for (s32 y = min_y; y <= max_y; y++)
   {
+    if (!band.ContainsLine(static_cast<u32>(y)) || ShouldSkipLine(state, static_cast<u32>(y)))
+    {
+      w0 += b12;
+      w1 += b20;
+      w2 += b01;
+      continue;
+    }
+
     s32 row_w0 = w0;
     s32 row_w1 = w1;
     s32 row_w2 = w2;
+    u16* row_ptr = GetPixelPtr(0, static_cast<u32>(y));
 
-    for (s32 x = min_x; x <= max_x; x++)
+    for (s32 x = min_x; x <= max_x; x += SWSpan::SPAN_WIDTH)
     {
-      if (((row_w0 + w0_bias) | (row_w1 + w1_bias) | (row_w2 + w2_bias)) >= 0)
+      const u32 count = std::min<u32>(static_cast<u32>(max_x - x + 1), SWSpan::SPAN_WIDTH);
+      SWSpan::SpanPixels pixels;
+      pixels.coverage = 0;
+
+      for (u32 i = 0; i < count; i++)
       {
-        const s32 b0 = row_w0;
-        const s32 b1 = row_w1;
-        const s32 b2 = row_w2;
-
-        const u8 r =
-          shading_enable ? Interpolate(v0->color_r, v1->color_r, v2->color_r, b0, b1, b2, ws, half_ws) : v0->color_r;
-        const u8 g =
-          shading_enable ? Interpolate(v0->color_g, v1->color_g, v2->color_g, b0, b1, b2, ws, half_ws) : v0->color_g;
-        const u8 b =
-          shading_enable ? Interpolate(v0->color_b, v1->color_b, v2->color_b, b0, b1, b2, ws, half_ws) : v0->color_b;
-
-        const u8 texcoord_x = Interpolate(v0->texcoord_x, v1->texcoord_x, v2->texcoord_x, b0, b1, b2, ws, half_ws);
-        const u8 texcoord_y = Interpolate(v0->texcoord_y, v1->texcoord_y, v2->texcoord_y, b0, b1, b2, ws, half_ws);
-
-        ShadePixel<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-          static_cast<u32>(x), static_cast<u32>(y), r, g, b, texcoord_x, texcoord_y);
+        if (((row_w0 + w0_bias) | (row_w1 + w1_bias) | (row_w2 + w2_bias)) >= 0)
+        {
+          const s32 b0 = row_w0;
+          const s32 b1 = row_w1;
+          const s32 b2 = row_w2;
+
+          const u8 r =
+            shading_enable ? Interpolate(v0->color_r, v1->color_r, v2->color_r, b0, b1, b2, ws, half_ws) : v0->color_r;
+          const u8 g =
+            shading_enable ? Interpolate(v0->color_g, v1->color_g, v2->color_g, b0, b1, b2, ws, half_ws) : v0->color_g;
+          const u8 b =
+            shading_enable ? Interpolate(v0->color_b, v1->color_b, v2->color_b, b0, b1, b2, ws, half_ws) : v0->color_b;
+
+          u16 texel = 0;
+          if constexpr (texture_enable)
+          {
+            const u8 texcoord_x = Interpolate(v0->texcoord_x, v1->texcoord_x, v2->texcoord_x, b0, b1, b2, ws, half_ws);
+            const u8 texcoord_y = Interpolate(v0->texcoord_y, v1->texcoord_y, v2->texcoord_y, b0, b1, b2, ws, half_ws);
+            texel = FetchTexel(state, texcoord_x, texcoord_y);
+          }
+
+          if (use_spans)
+          {
+            pixels.texels[i] = texel;
+            pixels.r[i] = r;
+            pixels.g[i] = g;
+            pixels.b[i] = b;
+            pixels.coverage |= static_cast<u8>(1u << i);
+          }
+          else
+          {
+            // the texture overlaps the target, so each pixel has to be written before the next texel is fetched
+            SWSpan::ShadePixel<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+              ps, &row_ptr[x + static_cast<s32>(i)], static_cast<u32>(x) + i, static_cast<u32>(y), texel, r, g, b);
+          }
+        }
+
+        row_w0 += a12;
+        row_w1 += a20;
+        row_w2 += a01;
       }
 
-      row_w0 += a12;
-      row_w1 += a20;
-      row_w2 += a01;
+      if (pixels.coverage == 0)
+        continue;
+
+      if (count == SWSpan::SPAN_WIDTH)
+      {
+        SWSpan::ShadeSpan<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+          ps, &row_ptr[x], static_cast<u32>(x), static_cast<u32>(y), pixels);
+      }
+      else
+      {
+        SWSpan::ShadeSpanScalar<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+          ps, &row_ptr[x], static_cast<u32>(x), static_cast<u32>(y), pixels, count);
+      }
     }
 
     w0 += b12;
     w1 += b20;
     w2 += b01;
   }
+}
 
 #undef orient2d
-}
 
 GPU_SW::DrawTriangleFunction GPU_SW::GetDrawTriangleFunction(bool shading_enable, bool texture_enable,
                                                              bool raw_texture_enable, bool transparency_enable,
@@ -536,195 +897,117 @@ GPU_SW::DrawTriangleFunction GPU_SW::GetDrawTriangleFunction(bool shading_enable
 }
 
 template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-void GPU_SW::DrawRectangle(s32 origin_x, s32 origin_y, u32 width, u32 height, u8 r, u8 g, u8 b, u8 origin_texcoord_x,
-                           u8 origin_texcoord_y)
+void GPU_SW::DrawRectangle(const SWDrawState& state, const SWBand& band, s32 origin_x, s32 origin_y, u32 width,
+                           u32 height, u8 r, u8 g, u8 b, u8 origin_texcoord_x, u8 origin_texcoord_y)
 {
-  const s32 start_x = TruncateVertexPosition(m_drawing_offset.x + origin_x);
-  const s32 start_y = TruncateVertexPosition(m_drawing_offset.y + origin_y);
+  const s32 start_x = TruncateVertexPosition(state.drawing_offset.x + origin_x);
+  const s32 start_y = TruncateVertexPosition(state.drawing_offset.y + origin_y);
+  const s32 clip_left = std::max(start_x, static_cast<s32>(state.drawing_area.left));
+  const s32 clip_right = std::min(start_x + static_cast<s32>(width) - 1, static_cast<s32>(state.drawing_area.right));
+  if (clip_left > clip_right)
+    return;
 
-  {
-    const u32 clip_left = static_cast<u32>(std::clamp<s32>(start_x, m_drawing_area.left, m_drawing_area.right));
-    const u32 clip_right =
-      static_cast<u32>(std::clamp<s32>(start_x + static_cast<s32>(width), m_drawing_area.left, m_drawing_area.right)) +
-      1u;
-    const u32 clip_top = static_cast<u32>(std::clamp<s32>(start_y, m_drawing_area.top, m_drawing_area.bottom));
-    const u32 clip_bottom =
-      static_cast<u32>(std::clamp<s32>(start_y + static_cast<s32>(height), m_drawing_area.top, m_drawing_area.bottom)) +
-      1u;
-    AddDrawRectangleTicks(clip_right - clip_left, clip_bottom - clip_top, texture_enable, transparency_enable);
-  }
+  const SWSpan::PixelState ps = GetPixelState(state);
+  const bool use_spans = !texture_enable || state.span_shading;
+
+  SWSpan::SpanPixels pixels;
+  std::fill_n(pixels.texels, SWSpan::SPAN_WIDTH, u16(0));
+  std::fill_n(pixels.r, SWSpan::SPAN_WIDTH, r);
+  std::fill_n(pixels.g, SWSpan::SPAN_WIDTH, g);
+  std::fill_n(pixels.b, SWSpan::SPAN_WIDTH, b);
 
   for (u32 offset_y = 0; offset_y < height; offset_y++)
   {
     const s32 y = start_y + static_cast<s32>(offset_y);
-    if (y < static_cast<s32>(m_drawing_area.top) || y > static_cast<s32>(m_drawing_area.bottom))
+    if (y < static_cast<s32>(state.drawing_area.top) || y > static_cast<s32>(state.drawing_area.bottom) ||
+        !band.ContainsLine(static_cast<u32>(y)) || ShouldSkipLine(state, static_cast<u32>(y)))
+    {
       continue;
+    }
 
     const u8 texcoord_y = Truncate8(ZeroExtend32(origin_texcoord_y) + offset_y);
+    u16* row_ptr = GetPixelPtr(0, static_cast<u32>(y));
 
-    for (u32 offset_x = 0; offset_x < width; offset_x++)
+    for (s32 x = clip_left; x <= clip_right; x += SWSpan::SPAN_WIDTH)
     {
-      const s32 x = start_x + static_cast<s32>(offset_x);
-      if (x < static_cast<s32>(m_drawing_area.left) || x > static_cast<s32>(m_drawing_area.right))
-        continue;
-
-      const u8 texcoord_x = Truncate8(ZeroExtend32(origin_texcoord_x) + offset_x);
-
-      ShadePixel<texture_enable, raw_texture_enable, transparency_enable, false>(
-        static_cast<u32>(x), static_cast<u32>(y), r, g, b, texcoord_x, texcoord_y);
-    }
-  }
-}
+      const u32 count = std::min<u32>(static_cast<u32>(clip_right - x + 1), SWSpan::SPAN_WIDTH);
+      pixels.coverage = static_cast<u8>((1u << count) - 1u);
 
-constexpr GPU_SW::DitherLUT GPU_SW::ComputeDitherLUT()
-{
-  DitherLUT lut = {};
-  for (u32 i = 0; i < DITHER_MATRIX_SIZE; i++)
-  {
-    for (u32 j = 0; j < DITHER_MATRIX_SIZE; j++)
-    {
-      for (s32 value = 0; value < DITHER_LUT_SIZE; value++)
+      if constexpr (texture_enable)
       {
-        const s32 dithered_value = (value + DITHER_MATRIX[i][j]) >> 3;
-        lut[i][j][value] = static_cast<u8>((dithered_value < 0) ? 0 : ((dithered_value > 31) ? 31 : dithered_value));
-      }
-    }
-  }
-  return lut;
-}
-
-static constexpr GPU_SW::DitherLUT s_dither_lut = GPU_SW::ComputeDitherLUT();
+        for (u32 i = 0; i < count; i++)
+        {
+          const u8 texcoord_x = Truncate8(ZeroExtend32(origin_texcoord_x) + static_cast<u32>(x - start_x) + i);
+          pixels.texels[i] = FetchTexel(state, texcoord_x, texcoord_y);
 
-template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
-void GPU_SW::ShadePixel(u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y)
-{
-  VRAMPixel color;
-  bool transparent;
-  if constexpr (texture_enable)
-  {
-    // Apply texture window
-    // TODO: Precompute the second half
-    texcoord_x = (texcoord_x & ~(m_draw_mode.texture_window_mask_x * 8u)) |
-                 ((m_draw_mode.texture_window_offset_x & m_draw_mode.texture_window_mask_x) * 8u);
-    texcoord_y = (texcoord_y & ~(m_draw_mode.texture_window_mask_y * 8u)) |
-                 ((m_draw_mode.texture_window_offset_y & m_draw_mode.texture_window_mask_y) * 8u);
+          // the texture overlaps the target, so each pixel has to be written before the next texel is fetched
+          if (!use_spans)
+          {
+            SWSpan::ShadePixel<texture_enable, raw_texture_enable, transparency_enable, false>(
+              ps, &row_ptr[x + static_cast<s32>(i)], static_cast<u32>(x) + i, static_cast<u32>(y), pixels.texels[i], r,
+              g, b);
+          }
+        }
 
-    VRAMPixel texture_color;
-    switch (m_draw_mode.GetTextureMode())
-    {
-      case GPU::TextureMode::Palette4Bit:
-      {
-        const u16 palette_value = GetPixel((m_draw_mode.texture_page_x + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
-                                           (m_draw_mode.texture_page_y + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
-        texture_color.bits = GetPixel((m_draw_mode.texture_palette_x + ZeroExtend32(palette_index)) % VRAM_WIDTH,
-                                      m_draw_mode.texture_palette_y);
+        if (!use_spans)
+          continue;
       }
-      break;
 
-      case GPU::TextureMode::Palette8Bit:
+      if (count == SWSpan::SPAN_WIDTH)
       {
-        const u16 palette_value = GetPixel((m_draw_mode.texture_page_x + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
-                                           (m_draw_mode.texture_page_y + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
-        texture_color.bits = GetPixel((m_draw_mode.texture_palette_x + ZeroExtend32(palette_index)) % VRAM_WIDTH,
-                                      m_draw_mode.texture_palette_y);
+        SWSpan::ShadeSpan<texture_enable, raw_texture_enable, transparency_enable, false>(
+          ps, &row_ptr[x], static_cast<u32>(x), static_cast<u32>(y), pixels);
       }
-      break;
-
-      default:
+      else
       {
-        texture_color.bits = GetPixel((m_draw_mode.texture_page_x + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
-                                      (m_draw_mode.texture_page_y + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+        SWSpan::ShadeSpanScalar<texture_enable, raw_texture_enable, transparency_enable, false>(
+          ps, &row_ptr[x], static_cast<u32>(x), static_cast<u32>(y), pixels, count);
       }
-      break;
-    }
-
-    if (texture_color.bits == 0)
-      return;
-
-    transparent = texture_color.c;
-
-    if constexpr (raw_texture_enable)
-    {
-      color.bits = texture_color.bits;
-    }
-    else
-    {
-      const u32 dither_y = (dithering_enable) ? (y & 3u) : 2u;
-      const u32 dither_x = (dithering_enable) ? (x & 3u) : 3u;
-
-      color.bits = (ZeroExtend16(s_dither_lut[dither_y][dither_x][(u16(texture_color.r) * u16(color_r)) >> 4]) << 0) |
-                   (ZeroExtend16(s_dither_lut[dither_y][dither_x][(u16(texture_color.g) * u16(color_g)) >> 4]) << 5) |
-                   (ZeroExtend16(s_dither_lut[dither_y][dither_x][(u16(texture_color.b) * u16(color_b)) >> 4]) << 10) |
-                   (texture_color.bits & 0x8000u);
     }
   }
-  else
-  {
-    transparent = true;
+}
 
-    const u32 dither_y = (dithering_enable) ? (y & 3u) : 2u;
-    const u32 dither_x = (dithering_enable) ? (x & 3u) : 3u;
+SWSpan::PixelState GPU_SW::GetPixelState(const SWDrawState& state)
+{
+  return SWSpan::PixelState{state.mask_and, state.mask_or, state.transparency_mode};
+}
 
-    color.bits = (ZeroExtend16(s_dither_lut[dither_y][dither_x][color_r]) << 0) |
-                 (ZeroExtend16(s_dither_lut[dither_y][dither_x][color_g]) << 5) |
-                 (ZeroExtend16(s_dither_lut[dither_y][dither_x][color_b]) << 10);
-  }
+bool GPU_SW::ShouldSkipLine(const SWDrawState& state, u32 y)
+{
+  return (state.interlaced_rendering && state.active_line_lsb == (y & 1u));
+}
 
-  const VRAMPixel bg_color{GetPixel(static_cast<u32>(x), static_cast<u32>(y))};
-  if constexpr (transparency_enable)
+u16 GPU_SW::FetchTexel(const SWDrawState& state, u8 texcoord_x, u8 texcoord_y) const
+{
+  // Apply texture window
+  // TODO: Precompute the second half
+  texcoord_x = (texcoord_x & ~(state.texture_window_mask_x * 8u)) |
+               ((state.texture_window_offset_x & state.texture_window_mask_x) * 8u);
+  texcoord_y = (texcoord_y & ~(state.texture_window_mask_y * 8u)) |
+               ((state.texture_window_offset_y & state.texture_window_mask_y) * 8u);
+
+  switch (state.texture_mode)
   {
-    if (transparent)
+    case GPU::TextureMode::Palette4Bit:
     {
-#define BLEND_AVERAGE(bg, fg) Truncate8(std::min<u32>((ZeroExtend32(bg) / 2) + (ZeroExtend32(fg) / 2), 0x1F))
-#define BLEND_ADD(bg, fg) Truncate8(std::min<u32>(ZeroExtend32(bg) + ZeroExtend32(fg), 0x1F))
-#define BLEND_SUBTRACT(bg, fg) Truncate8((bg > fg) ? ((bg) - (fg)) : 0)
-#define BLEND_QUARTER(bg, fg) Truncate8(std::min<u32>(ZeroExtend32(bg) + ZeroExtend32(fg / 4), 0x1F))
-
-#define BLEND_RGB(func)                                                                                                \
-  color.Set(func(bg_color.r.GetValue(), color.r.GetValue()), func(bg_color.g.GetValue(), color.g.GetValue()),          \
-            func(bg_color.b.GetValue(), color.b.GetValue()), color.c.GetValue())
-
-      switch (m_draw_mode.GetTransparencyMode())
-      {
-        case GPU::TransparencyMode::HalfBackgroundPlusHalfForeground:
-          BLEND_RGB(BLEND_AVERAGE);
-          break;
-        case GPU::TransparencyMode::BackgroundPlusForeground:
-          BLEND_RGB(BLEND_ADD);
-          break;
-        case GPU::TransparencyMode::BackgroundMinusForeground:
-          BLEND_RGB(BLEND_SUBTRACT);
-          break;
-        case GPU::TransparencyMode::BackgroundPlusQuarterForeground:
-          BLEND_RGB(BLEND_QUARTER);
-          break;
-        default:
-          break;
-      }
-
-#undef BLEND_RGB
-
-#undef BLEND_QUARTER
-#undef BLEND_SUBTRACT
-#undef BLEND_ADD
-#undef BLEND_AVERAGE
+      const u16 palette_value = GetPixel((state.texture_page_x + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
+                                         (state.texture_page_y + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+      const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
+      return GetPixel((state.texture_palette_x + ZeroExtend32(palette_index)) % VRAM_WIDTH, state.texture_palette_y);
     }
-  }
-  else
-  {
-    UNREFERENCED_VARIABLE(transparent);
-  }
-
-  const u16 mask_and = m_GPUSTAT.GetMaskAND();
-  if ((bg_color.bits & mask_and) != 0)
-    return;
 
-  if (IsInterlacedRenderingEnabled() && GetActiveLineLSB() == (static_cast<u32>(y) & 1u))
-    return;
+    case GPU::TextureMode::Palette8Bit:
+    {
+      const u16 palette_value = GetPixel((state.texture_page_x + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
+                                         (state.texture_page_y + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+      const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
+      return GetPixel((state.texture_palette_x + ZeroExtend32(palette_index)) % VRAM_WIDTH, state.texture_palette_y);
+    }
 
-  SetPixel(static_cast<u32>(x), static_cast<u32>(y), color.bits | m_GPUSTAT.GetMaskOR());
+    default:
+      return GetPixel((state.texture_page_x + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
+                      (state.texture_page_y + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+  }
 }
 
 constexpr FixedPointCoord GetLineCoordStep(s32 delta, s32 k)
@@ -749,7 +1032,7 @@ constexpr FixedPointColor GetLineColorStep(s32 delta, s32 k)
 }
 
 template<bool shading_enable, bool transparency_enable, bool dithering_enable>
-void GPU_SW::DrawLine(const SWVertex* p0, const SWVertex* p1)
+void GPU_SW::DrawLine(const SWDrawState& state, const SWBand& band, const SWVertex* p0, const SWVertex* p1)
 {
   // Algorithm based on Mednafen.
   if (p0->x > p1->x)
@@ -759,21 +1042,6 @@ void GPU_SW::DrawLine(const SWVertex* p0, const SWVertex* p1)
   const s32 dy = p1->y - p0->y;
   const s32 k = std::max(std::abs(dx), std::abs(dy));
 
-  {
-    // TODO: Move to base class
-    const s32 min_x = std::min(p0->x, p1->x);
-    const s32 max_x = std::max(p0->x, p1->x);
-    const s32 min_y = std::min(p0->y, p1->y);
-    const s32 max_y = std::max(p0->y, p1->y);
-
-    const u32 clip_left = static_cast<u32>(std::clamp<s32>(min_x, m_drawing_area.left, m_drawing_area.left));
-    const u32 clip_right = static_cast<u32>(std::clamp<s32>(max_x, m_drawing_area.left, m_drawing_area.right)) + 1u;
-    const u32 clip_top = static_cast<u32>(std::clamp<s32>(min_y, m_drawing_area.top, m_drawing_area.bottom));
-    const u32 clip_bottom = static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
-
-    AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, shading_enable);
-  }
-
   FixedPointCoord step_x, step_y;
   FixedPointColor step_r, step_g, step_b;
   if (k > 0)
@@ -803,6 +1071,8 @@ void GPU_SW::DrawLine(const SWVertex* p0, const SWVertex* p1)
     step_b = 0;
   }
 
+  const SWSpan::PixelState ps = GetPixelState(state);
+
   FixedPointCoord current_x = IntToFixedCoord(p0->x);
   FixedPointCoord current_y = IntToFixedCoord(p0->y);
   FixedPointColor current_r = IntToFixedColor(p0->color_r);
@@ -811,18 +1081,20 @@ void GPU_SW::DrawLine(const SWVertex* p0, const SWVertex* p1)
 
   for (s32 i = 0; i <= k; i++)
   {
-    const s32 x = m_drawing_offset.x + FixedToIntCoord(current_x);
-    const s32 y = m_drawing_offset.y + FixedToIntCoord(current_y);
+    const s32 x = state.drawing_offset.x + FixedToIntCoord(current_x);
+    const s32 y = state.drawing_offset.y + FixedToIntCoord(current_y);
 
     const u8 r = shading_enable ? FixedColorToInt(current_r) : p0->color_r;
     const u8 g = shading_enable ? FixedColorToInt(current_g) : p0->color_g;
     const u8 b = shading_enable ? FixedColorToInt(current_b) : p0->color_b;
 
-    if (x >= static_cast<s32>(m_drawing_area.left) && x <= static_cast<s32>(m_drawing_area.right) &&
-        y >= static_cast<s32>(m_drawing_area.top) && y <= static_cast<s32>(m_drawing_area.bottom))
+    if (x >= static_cast<s32>(state.drawing_area.left) && x <= static_cast<s32>(state.drawing_area.right) &&
+        y >= static_cast<s32>(state.drawing_area.top) && y <= static_cast<s32>(state.drawing_area.bottom) &&
+        band.ContainsLine(static_cast<u32>(y)) && !ShouldSkipLine(state, static_cast<u32>(y)))
     {
-      ShadePixel<false, false, transparency_enable, dithering_enable>(static_cast<u32>(x), static_cast<u32>(y), r, g, b,
-                                                                      0, 0);
+      SWSpan::ShadePixel<false, false, transparency_enable, dithering_enable>(
+        ps, GetPixelPtr(static_cast<u32>(x), static_cast<u32>(y)), static_cast<u32>(x), static_cast<u32>(y), 0, r, g,
+        b);
     }
 
     current_x += step_x;
@@ -865,6 +1137,346 @@ GPU_SW::DrawRectangleFunction GPU_SW::GetDrawRectangleFunction(bool texture_enab
   return funcs[u8(texture_enable)][u8(raw_texture_enable)][u8(transparency_enable)];
 }
 
+void GPU_SW::StartWorkerThreads()
+{
+  if (IsUsingWorkerThreads())
+    return;
+
+  // leave a core for the CPU thread
+  const u32 hardware_threads = std::thread::hardware_concurrency();
+  const u32 num_workers = std::clamp<u32>((hardware_threads > 1) ? (hardware_threads - 1) : 1, 1, MAX_WORKER_THREADS);
+  Log_InfoPrintf("Using %u software renderer worker threads", num_workers);
+
+  if (!m_command_queue)
+    m_command_queue = std::make_unique<SWCommand[]>(COMMAND_QUEUE_SIZE);
+
+  const u64 queued = m_queued_commands.load();
+  m_last_wake_queued_commands = queued;
+  m_worker_shutdown_flag.store(false);
+  m_num_workers = num_workers;
+  for (u32 i = 0; i < num_workers; i++)
+  {
+    m_workers[i].completed_commands.store(queued);
+    m_workers[i].thread = std::thread(&GPU_SW::WorkerThreadEntryPoint, this, i);
+  }
+}
+
+void GPU_SW::StopWorkerThreads()
+{
+  if (!IsUsingWorkerThreads())
+    return;
+
+  SyncWorkerThreads();
+
+  {
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_worker_shutdown_flag.store(true);
+    m_worker_wake_cv.notify_all();
+  }
+
+  for (u32 i = 0; i < m_num_workers; i++)
+    m_workers[i].thread.join();
+
+  m_num_workers = 0;
+}
+
+void GPU_SW::WorkerThreadEntryPoint(u32 index)
+{
+  SWWorker& worker = m_workers[index];
+  const SWBand band{index, m_num_workers};
+  u64 position = worker.completed_commands.load();
+  TRACE_THREAD_NAME("Software Renderer Worker");
+
+  for (;;)
+  {
+    const u64 queued = m_queued_commands.load(std::memory_order_acquire);
+    if (position == queued)
+    {
+      std::unique_lock<std::mutex> lock(m_worker_mutex);
+      m_worker_idle_cv.notify_all();
+      m_worker_wake_cv.wait(lock, [this, position]() {
+        return m_worker_shutdown_flag.load() || m_queued_commands.load(std::memory_order_acquire) != position;
+      });
+
+      if (m_queued_commands.load(std::memory_order_acquire) == position)
+        return;
+
+      continue;
+    }
+
+    TRACE_SCOPE("GPU_SW::ExecuteQueuedCommands");
+    for (; position < queued; position++)
+    {
+      const SWCommand& cmd = m_command_queue[position % COMMAND_QUEUE_SIZE];
+      if (cmd.exclusive)
+      {
+        if (index == 0)
+        {
+          WaitForCompletedCommandCount(position);
+          ExecuteCommand(cmd, SWBand{0, 1});
+        }
+        else
+        {
+          while (m_workers[0].completed_commands.load(std::memory_order_acquire) <= position)
+            std::this_thread::yield();
+        }
+      }
+      else
+      {
+        WaitForCompletedCommandCount(cmd.dependency);
+        ExecuteCommand(cmd, band);
+      }
+
+      worker.completed_commands.store(position + 1, std::memory_order_release);
+    }
+  }
+}
+
+void GPU_SW::WakeWorkerThreads()
+{
+  m_last_wake_queued_commands = m_queued_commands.load(std::memory_order_relaxed);
+
+  // taking the lock ensures a worker which is about to sleep sees the new commands
+  std::unique_lock<std::mutex> lock(m_worker_mutex);
+  m_worker_wake_cv.notify_all();
+}
+
+void GPU_SW::SyncWorkerThreads()
+{
+  if (!IsUsingWorkerThreads())
+    return;
+
+  const u64 queued = m_queued_commands.load(std::memory_order_relaxed);
+  if (GetCompletedCommandCount() == queued)
+    return;
+
+  WakeWorkerThreads();
+
+  std::unique_lock<std::mutex> lock(m_worker_mutex);
+  m_worker_idle_cv.wait(lock, [this, queued]() { return GetCompletedCommandCount() == queued; });
+}
+
+u64 GPU_SW::GetCompletedCommandCount() const
+{
+  u64 count = m_workers[0].completed_commands.load(std::memory_order_acquire);
+  for (u32 i = 1; i < m_num_workers; i++)
+    count = std::min(count, m_workers[i].completed_commands.load(std::memory_order_acquire));
+  return count;
+}
+
+void GPU_SW::WaitForCompletedCommandCount(u64 count) const
+{
+  while (GetCompletedCommandCount() < count)
+    std::this_thread::yield();
+}
+
+GPU_SW::SWCommand* GPU_SW::AllocateCommand(SWCommandType type)
+{
+  SWCommand* cmd;
+  if (IsUsingWorkerThreads())
+  {
+    // slots can't be reused until every worker is done with them
+    const u64 queued = m_queued_commands.load(std::memory_order_relaxed);
+    if ((queued - GetCompletedCommandCount()) >= COMMAND_QUEUE_SIZE)
+      SyncWorkerThreads();
+
+    cmd = &m_command_queue[queued % COMMAND_QUEUE_SIZE];
+  }
+  else
+  {
+    cmd = &m_immediate_command;
+  }
+
+  cmd->type = type;
+  cmd->textured = false;
+  cmd->exclusive = false;
+  cmd->dependency = 0;
+  cmd->state.texture_page_x = m_draw_mode.texture_page_x;
+  cmd->state.texture_page_y = m_draw_mode.texture_page_y;
+  cmd->state.texture_palette_x = m_draw_mode.texture_palette_x;
+  cmd->state.texture_palette_y = m_draw_mode.texture_palette_y;
+  cmd->state.texture_window_mask_x = m_draw_mode.texture_window_mask_x;
+  cmd->state.texture_window_mask_y = m_draw_mode.texture_window_mask_y;
+  cmd->state.texture_window_offset_x = m_draw_mode.texture_window_offset_x;
+  cmd->state.texture_window_offset_y = m_draw_mode.texture_window_offset_y;
+  cmd->state.texture_mode = m_draw_mode.GetTextureMode();
+  cmd->state.transparency_mode = m_draw_mode.GetTransparencyMode();
+  cmd->state.drawing_area = m_drawing_area;
+  cmd->state.drawing_offset = m_drawing_offset;
+  cmd->state.mask_and = m_GPUSTAT.GetMaskAND();
+  cmd->state.mask_or = m_GPUSTAT.GetMaskOR();
+  cmd->state.interlaced_rendering = IsInterlacedRenderingEnabled();
+  cmd->state.active_line_lsb = m_crtc_state.active_line_lsb;
+  return cmd;
+}
+
+void GPU_SW::SubmitCommand(SWCommand* cmd)
+{
+  TileMask read_tiles = {};
+  TileMask write_tiles = {};
+  GetCommandTiles(*cmd, &read_tiles, &write_tiles);
+
+  // Commands which read pixels they write, or copies between rows, can't be split into bands. Spans also fetch all
+  // their texels before writing any pixels, which is only safe when the texture doesn't overlap the target.
+  bool overlapping = false;
+  for (u32 i = 0; i < read_tiles.size(); i++)
+    overlapping |= ((read_tiles[i] & write_tiles[i]) != 0);
+  cmd->state.span_shading = !overlapping;
+
+  if (!IsUsingWorkerThreads())
+  {
+    ExecuteCommand(*cmd, SWBand{0, 1});
+    return;
+  }
+
+  cmd->exclusive = (overlapping || cmd->type == SWCommandType::CopyVRAM ||
+                    (cmd->type == SWCommandType::UpdateVRAM && cmd->state.mask_and != 0));
+
+  // Workers execute exclusive commands after everything before them, and nothing can start until they're done.
+  const u64 count = m_queued_commands.load(std::memory_order_relaxed) + 1;
+  if (!cmd->exclusive)
+  {
+    // Reads wait for earlier writes to the same tiles, writes wait for earlier reads of the same tiles. Writes after
+    // writes don't need to wait, since the same worker owns the line in both commands.
+    u64 dependency = 0;
+    for (u32 i = 0; i < read_tiles.size(); i++)
+    {
+      for (u64 bits = read_tiles[i]; bits != 0; bits &= (bits - 1))
+      {
+        const u32 tile = (i * 64) + CountTrailingZeros(bits);
+        dependency = std::max(dependency, m_tile_last_write[tile]);
+        m_tile_last_read[tile] = count;
+      }
+      for (u64 bits = write_tiles[i]; bits != 0; bits &= (bits - 1))
+      {
+        const u32 tile = (i * 64) + CountTrailingZeros(bits);
+        dependency = std::max(dependency, m_tile_last_read[tile]);
+        m_tile_last_write[tile] = count;
+      }
+    }
+
+    cmd->dependency = dependency;
+  }
+
+  m_queued_commands.store(count, std::memory_order_release);
+  if ((count - m_last_wake_queued_commands) >= WAKE_WORKERS_INTERVAL)
+    WakeWorkerThreads();
+}
+
+void GPU_SW::ExecuteCommand(const SWCommand& cmd, const SWBand& band)
+{
+  switch (cmd.type)
+  {
+    case SWCommandType::DrawTriangles:
+    {
+      const SWVertex* vertices = cmd.triangles.vertices;
+      (this->*cmd.triangles.function)(cmd.state, band, &vertices[0], &vertices[1], &vertices[2]);
+      if (cmd.triangles.num_vertices > 3)
+        (this->*cmd.triangles.function)(cmd.state, band, &vertices[2], &vertices[1], &vertices[3]);
+    }
+    break;
+
+    case SWCommandType::DrawRectangle:
+    {
+      (this->*cmd.rectangle.function)(cmd.state, band, cmd.rectangle.x, cmd.rectangle.y, cmd.rectangle.width,
+                                      cmd.rectangle.height, cmd.rectangle.r, cmd.rectangle.g, cmd.rectangle.b,
+                                      cmd.rectangle.texcoord_x, cmd.rectangle.texcoord_y);
+    }
+    break;
+
+    case SWCommandType::DrawLine:
+      (this->*cmd.line.function)(cmd.state, band, &cmd.line.vertices[0], &cmd.line.vertices[1]);
+      break;
+
+    case SWCommandType::FillVRAM:
+      ExecuteFillVRAM(cmd.state, band, cmd.fill.x, cmd.fill.y, cmd.fill.width, cmd.fill.height, cmd.fill.color);
+      break;
+
+    case SWCommandType::UpdateVRAM:
+      ExecuteUpdateVRAM(cmd.state, band, cmd.update.x, cmd.update.y, cmd.update.width, cmd.update.height,
+                        cmd.update.data);
+      break;
+
+    case SWCommandType::CopyVRAM:
+      ExecuteCopyVRAM(cmd.state, cmd.copy.src_x, cmd.copy.src_y, cmd.copy.dst_x, cmd.copy.dst_y, cmd.copy.width,
+                      cmd.copy.height);
+      break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+}
+
+void GPU_SW::AddRectangleToTileMask(TileMask* mask, u32 x, u32 y, u32 width, u32 height)
+{
+  if (width == 0 || height == 0)
+    return;
+
+  // the rectangle can wrap around the edges of VRAM
+  x %= VRAM_WIDTH;
+  y %= VRAM_HEIGHT;
+  const u32 first_tile_x = x / TILE_WIDTH;
+  const u32 first_tile_y = y / TILE_HEIGHT;
+  const u32 num_tiles_x = std::min<u32>(((x % TILE_WIDTH) + width + TILE_WIDTH - 1) / TILE_WIDTH, NUM_TILES_X);
+  const u32 num_tiles_y = std::min<u32>(((y % TILE_HEIGHT) + height + TILE_HEIGHT - 1) / TILE_HEIGHT, NUM_TILES_Y);
+
+  for (u32 ty = 0; ty < num_tiles_y; ty++)
+  {
+    const u32 row = ((first_tile_y + ty) % NUM_TILES_Y) * NUM_TILES_X;
+    for (u32 tx = 0; tx < num_tiles_x; tx++)
+    {
+      const u32 tile = row + ((first_tile_x + tx) % NUM_TILES_X);
+      (*mask)[tile / 64] |= (UINT64_C(1) << (tile % 64));
+    }
+  }
+}
+
+void GPU_SW::GetCommandTiles(const SWCommand& cmd, TileMask* read_tiles, TileMask* write_tiles)
+{
+  switch (cmd.type)
+  {
+    case SWCommandType::DrawTriangles:
+    case SWCommandType::DrawRectangle:
+    case SWCommandType::DrawLine:
+    {
+      AddRectangleToTileMask(write_tiles, static_cast<u32>(cmd.bounds.left), static_cast<u32>(cmd.bounds.top),
+                             static_cast<u32>(cmd.bounds.right - cmd.bounds.left + 1),
+                             static_cast<u32>(cmd.bounds.bottom - cmd.bounds.top + 1));
+
+      if (cmd.textured)
+      {
+        // same sizes as DrawMode::GetTexturePageRectangle()/GetTexturePaletteRectangle()
+        static constexpr std::array<u32, 4> texture_page_widths = {
+          {TEXTURE_PAGE_WIDTH / 4, TEXTURE_PAGE_WIDTH / 2, TEXTURE_PAGE_WIDTH, TEXTURE_PAGE_WIDTH}};
+        static constexpr std::array<u32, 4> palette_widths = {{16, 256, 0, 0}};
+        const u8 mode = static_cast<u8>(cmd.state.texture_mode);
+        AddRectangleToTileMask(read_tiles, cmd.state.texture_page_x, cmd.state.texture_page_y,
+                               texture_page_widths[mode], TEXTURE_PAGE_HEIGHT);
+        AddRectangleToTileMask(read_tiles, cmd.state.texture_palette_x, cmd.state.texture_palette_y,
+                               palette_widths[mode], 1);
+      }
+    }
+    break;
+
+    case SWCommandType::FillVRAM:
+      AddRectangleToTileMask(write_tiles, cmd.fill.x, cmd.fill.y, cmd.fill.width, cmd.fill.height);
+      break;
+
+    case SWCommandType::UpdateVRAM:
+      AddRectangleToTileMask(write_tiles, cmd.update.x, cmd.update.y, cmd.update.width, cmd.update.height);
+      break;
+
+    case SWCommandType::CopyVRAM:
+      AddRectangleToTileMask(read_tiles, cmd.copy.src_x, cmd.copy.src_y, cmd.copy.width, cmd.copy.height);
+      AddRectangleToTileMask(write_tiles, cmd.copy.dst_x, cmd.copy.dst_y, cmd.copy.width, cmd.copy.height);
+      break;
+
+    default:
+      break;
+  }
+}
+
 std::unique_ptr<GPU> GPU::CreateSoftwareRenderer()
 {
   return std::make_unique<GPU_SW>();
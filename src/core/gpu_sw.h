@@ -1,7 +1,12 @@
 #pragma once
 #include "gpu.h"
+#include "gpu_sw_span.h"
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 class HostDisplayTexture;
@@ -16,17 +21,13 @@ public:
 
   bool Initialize(HostDisplay* host_display) override;
   void Reset() override;
+  void UpdateSettings() override;
 
   u16 GetPixel(u32 x, u32 y) const { return m_vram[VRAM_WIDTH * y + x]; }
   const u16* GetPixelPtr(u32 x, u32 y) const { return &m_vram[VRAM_WIDTH * y + x]; }
   u16* GetPixelPtr(u32 x, u32 y) { return &m_vram[VRAM_WIDTH * y + x]; }
   void SetPixel(u32 x, u32 y, u16 value) { m_vram[VRAM_WIDTH * y + x] = value; }
 
-  // this is actually (31 * 255) >> 4) == 494, but to simplify addressing we use the next power of two (512)
-  static constexpr u32 DITHER_LUT_SIZE = 512;
-  using DitherLUT = std::array<std::array<std::array<u8, 512>, DITHER_MATRIX_SIZE>, DITHER_MATRIX_SIZE>;
-  static constexpr DitherLUT ComputeDitherLUT();
-
 protected:
   struct SWVertex
   {
@@ -44,6 +45,55 @@ protected:
     ALWAYS_INLINE void SetTexcoord(u16 value) { std::tie(texcoord_x, texcoord_y) = UnpackTexcoord(value); }
   };
 
+  /// Draw state captured when a command is queued, so the workers never read registers the CPU thread is changing.
+  struct SWDrawState
+  {
+    u32 texture_page_x;
+    u32 texture_page_y;
+    u32 texture_palette_x;
+    u32 texture_palette_y;
+    u8 texture_window_mask_x;   // in 8 pixel steps
+    u8 texture_window_mask_y;   // in 8 pixel steps
+    u8 texture_window_offset_x; // in 8 pixel steps
+    u8 texture_window_offset_y; // in 8 pixel steps
+    TextureMode texture_mode;
+    TransparencyMode transparency_mode;
+    Common::Rectangle<u32> drawing_area;
+    DrawingOffset drawing_offset;
+    u16 mask_and;
+    u16 mask_or;
+    bool interlaced_rendering;
+    u8 active_line_lsb;
+    bool span_shading; // texels can be fetched for a whole span before it's written
+  };
+
+  /// Scanlines owned by a worker. Lines are handed out in interleaved bands, so every worker gets a share of each
+  /// primitive, and each worker keeps the draw order for its own lines.
+  struct SWBand
+  {
+    u32 index;
+    u32 count;
+
+    ALWAYS_INLINE bool ContainsLine(u32 y) const { return ((y >> BAND_HEIGHT_SHIFT) % count) == index; }
+  };
+
+  enum : u32
+  {
+    MAX_WORKER_THREADS = 4,
+    BAND_HEIGHT_SHIFT = 3,
+    COMMAND_QUEUE_SIZE = 2048,
+    WAKE_WORKERS_INTERVAL = 64,
+
+    // VRAM is split into tiles for tracking dependencies between queued commands.
+    TILE_WIDTH = 64,
+    TILE_HEIGHT = 32,
+    NUM_TILES_X = VRAM_WIDTH / TILE_WIDTH,
+    NUM_TILES_Y = VRAM_HEIGHT / TILE_HEIGHT,
+    NUM_TILES = NUM_TILES_X * NUM_TILES_Y
+  };
+
+  using TileMask = std::array<u64, NUM_TILES / 64>;
+
   //////////////////////////////////////////////////////////////////////////
   // Scanout
   //////////////////////////////////////////////////////////////////////////
@@ -54,6 +104,19 @@ protected:
   void ClearDisplay() override;
   void UpdateDisplay() override;
 
+  //////////////////////////////////////////////////////////////////////////
+  // VRAM Transfers
+  //////////////////////////////////////////////////////////////////////////
+  void ReadVRAM(u32 x, u32 y, u32 width, u32 height) override;
+  void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
+  void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data) override;
+  void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
+
+  void ExecuteFillVRAM(const SWDrawState& state, const SWBand& band, u32 x, u32 y, u32 width, u32 height, u16 color);
+  void ExecuteUpdateVRAM(const SWDrawState& state, const SWBand& band, u32 x, u32 y, u32 width, u32 height,
+                         const u16* data);
+  void ExecuteCopyVRAM(const SWDrawState& state, u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height);
+
   //////////////////////////////////////////////////////////////////////////
   // Rasterization
   //////////////////////////////////////////////////////////////////////////
@@ -62,34 +125,158 @@ protected:
 
   static bool IsClockwiseWinding(const SWVertex* v0, const SWVertex* v1, const SWVertex* v2);
 
-  template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
-  void ShadePixel(u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y);
+  /// Computes the area of the drawing area covered by a triangle. Returns false if the triangle is culled.
+  static bool GetTriangleBounds(const SWDrawState& state, const SWVertex* v0, const SWVertex* v1, const SWVertex* v2,
+                                Common::Rectangle<s32>* bounds);
+
+  static SWSpan::PixelState GetPixelState(const SWDrawState& state);
+
+  /// Returns true if the line is in the displayed field, and not drawn to with interlaced rendering.
+  static bool ShouldSkipLine(const SWDrawState& state, u32 y);
+
+  u16 FetchTexel(const SWDrawState& state, u8 texcoord_x, u8 texcoord_y) const;
 
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
            bool dithering_enable>
-  void DrawTriangle(const SWVertex* v0, const SWVertex* v1, const SWVertex* v2);
+  void DrawTriangle(const SWDrawState& state, const SWBand& band, const SWVertex* v0, const SWVertex* v1,
+                    const SWVertex* v2);
 
-  using DrawTriangleFunction = void (GPU_SW::*)(const SWVertex* v0, const SWVertex* v1, const SWVertex* v2);
+  using DrawTriangleFunction = void (GPU_SW::*)(const SWDrawState& state, const SWBand& band, const SWVertex* v0,
+                                                const SWVertex* v1, const SWVertex* v2);
   DrawTriangleFunction GetDrawTriangleFunction(bool shading_enable, bool texture_enable, bool raw_texture_enable,
                                                bool transparency_enable, bool dithering_enable);
 
   template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-  void DrawRectangle(s32 origin_x, s32 origin_y, u32 width, u32 height, u8 r, u8 g, u8 b, u8 origin_texcoord_x,
-                     u8 origin_texcoord_y);
+  void DrawRectangle(const SWDrawState& state, const SWBand& band, s32 origin_x, s32 origin_y, u32 width, u32 height,
+                     u8 r, u8 g, u8 b, u8 origin_texcoord_x, u8 origin_texcoord_y);
 
-  using DrawRectangleFunction = void (GPU_SW::*)(s32 origin_x, s32 origin_y, u32 width, u32 height, u8 r, u8 g, u8 b,
+  using DrawRectangleFunction = void (GPU_SW::*)(const SWDrawState& state, const SWBand& band, s32 origin_x,
+                                                 s32 origin_y, u32 width, u32 height, u8 r, u8 g, u8 b,
                                                  u8 origin_texcoord_x, u8 origin_texcoord_y);
   DrawRectangleFunction GetDrawRectangleFunction(bool texture_enable, bool raw_texture_enable,
                                                  bool transparency_enable);
 
   template<bool shading_enable, bool transparency_enable, bool dithering_enable>
-  void DrawLine(const SWVertex* p0, const SWVertex* p1);
+  void DrawLine(const SWDrawState& state, const SWBand& band, const SWVertex* p0, const SWVertex* p1);
 
-  using DrawLineFunction = void (GPU_SW::*)(const SWVertex* p0, const SWVertex* p1);
+  using DrawLineFunction = void (GPU_SW::*)(const SWDrawState& state, const SWBand& band, const SWVertex* p0,
+                                            const SWVertex* p1);
   DrawLineFunction GetDrawLineFunction(bool shading_enable, bool transparency_enable, bool dithering_enable);
 
+  //////////////////////////////////////////////////////////////////////////
+  // Command Queue
+  //////////////////////////////////////////////////////////////////////////
+
+  enum class SWCommandType : u8
+  {
+    DrawTriangles,
+    DrawRectangle,
+    DrawLine,
+    FillVRAM,
+    UpdateVRAM,
+    CopyVRAM
+  };
+
+  struct SWCommand
+  {
+    SWCommandType type;
+    bool textured;                 // draw command reads from the texture page
+    bool exclusive;                // run by the first worker alone, after all earlier commands have completed
+    u64 dependency;                // number of commands all workers must have completed before this one can start
+    Common::Rectangle<s32> bounds; // inclusive VRAM area written by draw commands
+    SWDrawState state;
+
+    union
+    {
+      struct
+      {
+        DrawTriangleFunction function;
+        u32 num_vertices;
+        SWVertex vertices[4];
+      } triangles;
+
+      struct
+      {
+        DrawRectangleFunction function;
+        s32 x, y;
+        u32 width, height;
+        u8 r, g, b;
+        u8 texcoord_x, texcoord_y;
+      } rectangle;
+
+      struct
+      {
+        DrawLineFunction function;
+        SWVertex vertices[2];
+      } line;
+
+      struct
+      {
+        u32 x, y, width, height;
+        u16 color;
+      } fill;
+
+      struct
+      {
+        u32 x, y, width, height;
+        const u16* data;
+      } update;
+
+      struct
+      {
+        u32 src_x, src_y, dst_x, dst_y, width, height;
+      } copy;
+    };
+
+    std::vector<u16> update_data; // copy of the data for queued VRAM updates
+  };
+
+  struct alignas(64) SWWorker
+  {
+    std::thread thread;
+    std::atomic<u64> completed_commands{0};
+  };
+
+  bool IsUsingWorkerThreads() const { return m_num_workers > 0; }
+  void StartWorkerThreads();
+  void StopWorkerThreads();
+  void WorkerThreadEntryPoint(u32 index);
+  void WakeWorkerThreads();
+
+  /// Blocks until the workers have executed all queued commands, after which VRAM can be accessed directly.
+  void SyncWorkerThreads();
+
+  u64 GetCompletedCommandCount() const;
+  void WaitForCompletedCommandCount(u64 count) const;
+
+  SWCommand* AllocateCommand(SWCommandType type);
+  void SubmitCommand(SWCommand* cmd);
+  void ExecuteCommand(const SWCommand& cmd, const SWBand& band);
+
+  static void AddRectangleToTileMask(TileMask* mask, u32 x, u32 y, u32 width, u32 height);
+  static void GetCommandTiles(const SWCommand& cmd, TileMask* read_tiles, TileMask* write_tiles);
+
   std::vector<u32> m_display_texture_buffer;
   std::unique_ptr<HostDisplayTexture> m_display_texture;
 
   std::array<u16, VRAM_WIDTH * VRAM_HEIGHT> m_vram;
+
+  // commands are executed directly out of this when not using worker threads
+  SWCommand m_immediate_command = {};
+
+  std::unique_ptr<SWCommand[]> m_command_queue;
+  std::atomic<u64> m_queued_commands{0};
+  u64 m_last_wake_queued_commands = 0;
+
+  std::array<SWWorker, MAX_WORKER_THREADS> m_workers;
+  u32 m_num_workers = 0;
+
+  std::mutex m_worker_mutex;
+  std::condition_variable m_worker_wake_cv;
+  std::condition_variable m_worker_idle_cv;
+  std::atomic_bool m_worker_shutdown_flag{false};
+
+  // last command to read/write each VRAM tile, as a count of queued commands
+  std::array<u64, NUM_TILES> m_tile_last_read = {};
+  std::array<u64, NUM_TILES> m_tile_last_write = {};
 };
@@ -0,0 +1,391 @@
+#pragma once
+#include "common/cpu_detect.h"
+#include "gpu.h"
+#include <array>
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#include <arm_neon.h>
+#endif
+
+// Pixel shading for the software renderer. The rasterizer computes colours and fetches texels for a span of pixels,
+// which is then modulated, dithered, blended and written to VRAM. ShadePixel() is the reference implementation, the
+// vector path in ShadeSpan() produces the same output for a whole span at once.
+namespace SWSpan {
+
+#if defined(CPU_X64) || defined(CPU_AARCH64)
+#define SW_SPAN_VECTORIZED 1
+#endif
+
+enum : u32
+{
+  SPAN_WIDTH = 8
+};
+
+struct PixelState
+{
+  u16 mask_and;
+  u16 mask_or;
+  GPU::TransparencyMode transparency_mode;
+};
+
+struct SpanPixels
+{
+  alignas(16) u16 texels[SPAN_WIDTH];
+  alignas(8) u8 r[SPAN_WIDTH];
+  alignas(8) u8 g[SPAN_WIDTH];
+  alignas(8) u8 b[SPAN_WIDTH];
+  u8 coverage; // bit per pixel
+};
+
+// this is actually (31 * 255) >> 4) == 494, but to simplify addressing we use the next power of two (512)
+static constexpr u32 DITHER_LUT_SIZE = 512;
+using DitherLUT = std::array<std::array<std::array<u8, DITHER_LUT_SIZE>, GPU::DITHER_MATRIX_SIZE>, GPU::DITHER_MATRIX_SIZE>;
+
+constexpr DitherLUT ComputeDitherLUT()
+{
+  DitherLUT lut = {};
+  for (u32 i = 0; i < GPU::DITHER_MATRIX_SIZE; i++)
+  {
+    for (u32 j = 0; j < GPU::DITHER_MATRIX_SIZE; j++)
+    {
+      for (s32 value = 0; value < static_cast<s32>(DITHER_LUT_SIZE); value++)
+      {
+        const s32 dithered_value = (value + GPU::DITHER_MATRIX[i][j]) >> 3;
+        lut[i][j][value] = static_cast<u8>((dithered_value < 0) ? 0 : ((dithered_value > 31) ? 31 : dithered_value));
+      }
+    }
+  }
+  return lut;
+}
+
+inline constexpr DitherLUT s_dither_lut = ComputeDitherLUT();
+
+ALWAYS_INLINE u16 PackRGB(u32 r, u32 g, u32 b) { return Truncate16(r | (g << 5) | (b << 10)); }
+
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+ALWAYS_INLINE void ShadePixel(const PixelState& ps, u16* pixel_ptr, u32 x, u32 y, u16 texel, u8 color_r, u8 color_g,
+                              u8 color_b)
+{
+  u16 color;
+  bool transparent;
+  if constexpr (texture_enable)
+  {
+    if (texel == 0)
+      return;
+
+    transparent = (texel & 0x8000u) != 0;
+
+    if constexpr (raw_texture_enable)
+    {
+      color = texel;
+    }
+    else
+    {
+      const u32 dither_y = (dithering_enable) ? (y & 3u) : 2u;
+      const u32 dither_x = (dithering_enable) ? (x & 3u) : 3u;
+      const auto& lut = s_dither_lut[dither_y][dither_x];
+
+      color = PackRGB(lut[((texel & 0x1Fu) * u32(color_r)) >> 4], lut[(((texel >> 5) & 0x1Fu) * u32(color_g)) >> 4],
+                      lut[(((texel >> 10) & 0x1Fu) * u32(color_b)) >> 4]) |
+              (texel & 0x8000u);
+    }
+  }
+  else
+  {
+    transparent = true;
+
+    const u32 dither_y = (dithering_enable) ? (y & 3u) : 2u;
+    const u32 dither_x = (dithering_enable) ? (x & 3u) : 3u;
+    const auto& lut = s_dither_lut[dither_y][dither_x];
+
+    color = PackRGB(lut[color_r], lut[color_g], lut[color_b]);
+  }
+
+  const u16 bg_color = *pixel_ptr;
+  if constexpr (transparency_enable)
+  {
+    if (transparent)
+    {
+      const u32 bg_r = bg_color & 0x1Fu;
+      const u32 bg_g = (bg_color >> 5) & 0x1Fu;
+      const u32 bg_b = (bg_color >> 10) & 0x1Fu;
+      const u32 fg_r = color & 0x1Fu;
+      const u32 fg_g = (color >> 5) & 0x1Fu;
+      const u32 fg_b = (color >> 10) & 0x1Fu;
+
+#define BLEND_AVERAGE(bg, fg) std::min<u32>((bg / 2) + (fg / 2), 0x1F)
+#define BLEND_ADD(bg, fg) std::min<u32>(bg + fg, 0x1F)
+#define BLEND_SUBTRACT(bg, fg) ((bg > fg) ? (bg - fg) : 0)
+#define BLEND_QUARTER(bg, fg) std::min<u32>(bg + (fg / 4), 0x1F)
+
+#define BLEND_RGB(func)                                                                                                \
+  color = PackRGB(func(bg_r, fg_r), func(bg_g, fg_g), func(bg_b, fg_b)) | (color & 0x8000u)
+
+      switch (ps.transparency_mode)
+      {
+        case GPU::TransparencyMode::HalfBackgroundPlusHalfForeground:
+          BLEND_RGB(BLEND_AVERAGE);
+          break;
+        case GPU::TransparencyMode::BackgroundPlusForeground:
+          BLEND_RGB(BLEND_ADD);
+          break;
+        case GPU::TransparencyMode::BackgroundMinusForeground:
+          BLEND_RGB(BLEND_SUBTRACT);
+          break;
+        case GPU::TransparencyMode::BackgroundPlusQuarterForeground:
+          BLEND_RGB(BLEND_QUARTER);
+          break;
+        default:
+          break;
+      }
+
+#undef BLEND_RGB
+
+#undef BLEND_QUARTER
+#undef BLEND_SUBTRACT
+#undef BLEND_ADD
+#undef BLEND_AVERAGE
+    }
+  }
+  else
+  {
+    UNREFERENCED_VARIABLE(transparent);
+  }
+
+  if ((bg_color & ps.mask_and) != 0)
+    return;
+
+  *pixel_ptr = color | ps.mask_or;
+}
+
+/// Shades the first count pixels of a span one at a time.
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+ALWAYS_INLINE void ShadeSpanScalar(const PixelState& ps, u16* dst_ptr, u32 x, u32 y, const SpanPixels& pixels,
+                                   u32 count)
+{
+  for (u32 i = 0; i < count; i++)
+  {
+    if (pixels.coverage & (1u << i))
+    {
+      ShadePixel<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+        ps, &dst_ptr[i], x + i, y, pixels.texels[i], pixels.r[i], pixels.g[i], pixels.b[i]);
+    }
+  }
+}
+
+#ifdef SW_SPAN_VECTORIZED
+
+namespace Vector {
+
+#if defined(CPU_X64)
+
+using U16x8 = __m128i;
+
+ALWAYS_INLINE U16x8 Load(const u16* ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+ALWAYS_INLINE void Store(u16* ptr, U16x8 v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), v); }
+ALWAYS_INLINE U16x8 LoadU8(const u8* ptr)
+{
+  return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ptr)), _mm_setzero_si128());
+}
+ALWAYS_INLINE U16x8 Set(u16 value) { return _mm_set1_epi16(static_cast<s16>(value)); }
+ALWAYS_INLINE U16x8 And(U16x8 a, U16x8 b) { return _mm_and_si128(a, b); }
+ALWAYS_INLINE U16x8 Or(U16x8 a, U16x8 b) { return _mm_or_si128(a, b); }
+ALWAYS_INLINE U16x8 Add(U16x8 a, U16x8 b) { return _mm_add_epi16(a, b); }
+ALWAYS_INLINE U16x8 Mul(U16x8 a, U16x8 b) { return _mm_mullo_epi16(a, b); }
+ALWAYS_INLINE U16x8 SubSaturate(U16x8 a, U16x8 b) { return _mm_subs_epu16(a, b); }
+ALWAYS_INLINE U16x8 MinSigned(U16x8 a, U16x8 b) { return _mm_min_epi16(a, b); }
+ALWAYS_INLINE U16x8 MaxSigned(U16x8 a, U16x8 b) { return _mm_max_epi16(a, b); }
+ALWAYS_INLINE U16x8 Equal(U16x8 a, U16x8 b) { return _mm_cmpeq_epi16(a, b); }
+ALWAYS_INLINE U16x8 Select(U16x8 mask, U16x8 a, U16x8 b)
+{
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+template<int n>
+ALWAYS_INLINE U16x8 ShiftLeft(U16x8 v)
+{
+  return _mm_slli_epi16(v, n);
+}
+template<int n>
+ALWAYS_INLINE U16x8 ShiftRight(U16x8 v)
+{
+  return _mm_srli_epi16(v, n);
+}
+template<int n>
+ALWAYS_INLINE U16x8 ShiftRightSigned(U16x8 v)
+{
+  return _mm_srai_epi16(v, n);
+}
+
+#elif defined(CPU_AARCH64)
+
+using U16x8 = uint16x8_t;
+
+ALWAYS_INLINE U16x8 Load(const u16* ptr) { return vld1q_u16(ptr); }
+ALWAYS_INLINE void Store(u16* ptr, U16x8 v) { vst1q_u16(ptr, v); }
+ALWAYS_INLINE U16x8 LoadU8(const u8* ptr) { return vmovl_u8(vld1_u8(ptr)); }
+ALWAYS_INLINE U16x8 Set(u16 value) { return vdupq_n_u16(value); }
+ALWAYS_INLINE U16x8 And(U16x8 a, U16x8 b) { return vandq_u16(a, b); }
+ALWAYS_INLINE U16x8 Or(U16x8 a, U16x8 b) { return vorrq_u16(a, b); }
+ALWAYS_INLINE U16x8 Add(U16x8 a, U16x8 b) { return vaddq_u16(a, b); }
+ALWAYS_INLINE U16x8 Mul(U16x8 a, U16x8 b) { return vmulq_u16(a, b); }
+ALWAYS_INLINE U16x8 SubSaturate(U16x8 a, U16x8 b) { return vqsubq_u16(a, b); }
+ALWAYS_INLINE U16x8 MinSigned(U16x8 a, U16x8 b)
+{
+  return vreinterpretq_u16_s16(vminq_s16(vreinterpretq_s16_u16(a), vreinterpretq_s16_u16(b)));
+}
+ALWAYS_INLINE U16x8 MaxSigned(U16x8 a, U16x8 b)
+{
+  return vreinterpretq_u16_s16(vmaxq_s16(vreinterpretq_s16_u16(a), vreinterpretq_s16_u16(b)));
+}
+ALWAYS_INLINE U16x8 Equal(U16x8 a, U16x8 b) { return vceqq_u16(a, b); }
+ALWAYS_INLINE U16x8 Select(U16x8 mask, U16x8 a, U16x8 b) { return vbslq_u16(mask, a, b); }
+template<int n>
+ALWAYS_INLINE U16x8 ShiftLeft(U16x8 v)
+{
+  return vshlq_n_u16(v, n);
+}
+template<int n>
+ALWAYS_INLINE U16x8 ShiftRight(U16x8 v)
+{
+  return vshrq_n_u16(v, n);
+}
+template<int n>
+ALWAYS_INLINE U16x8 ShiftRightSigned(U16x8 v)
+{
+  return vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(v), n));
+}
+
+#endif
+
+/// Dither matrix rows, rotated so that the first element is for the pixel at (x & 3).
+struct alignas(16) DitherSpanTable
+{
+  u16 values[GPU::DITHER_MATRIX_SIZE][GPU::DITHER_MATRIX_SIZE][SPAN_WIDTH];
+};
+
+constexpr DitherSpanTable ComputeDitherSpanTable()
+{
+  DitherSpanTable table = {};
+  for (u32 y = 0; y < GPU::DITHER_MATRIX_SIZE; y++)
+  {
+    for (u32 x = 0; x < GPU::DITHER_MATRIX_SIZE; x++)
+    {
+      for (u32 i = 0; i < SPAN_WIDTH; i++)
+        table.values[y][x][i] = static_cast<u16>(GPU::DITHER_MATRIX[y][(x + i) % GPU::DITHER_MATRIX_SIZE]);
+    }
+  }
+  return table;
+}
+
+inline constexpr DitherSpanTable s_dither_span_table = ComputeDitherSpanTable();
+
+/// Same as the dither LUT: adds the offset, drops the low three bits and clamps to 0..31.
+ALWAYS_INLINE U16x8 Dither(U16x8 value, U16x8 offset)
+{
+  return MinSigned(MaxSigned(ShiftRightSigned<3>(Add(value, offset)), Set(0)), Set(0x1F));
+}
+
+ALWAYS_INLINE U16x8 PackRGB(U16x8 r, U16x8 g, U16x8 b) { return Or(Or(r, ShiftLeft<5>(g)), ShiftLeft<10>(b)); }
+
+} // namespace Vector
+
+#endif
+
+/// Shades a full span of SPAN_WIDTH pixels starting at dst_ptr, which must not cross the end of a VRAM row. Pixels which
+/// aren't covered are written back unchanged.
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+ALWAYS_INLINE void ShadeSpan(const PixelState& ps, u16* dst_ptr, u32 x, u32 y, const SpanPixels& pixels)
+{
+#ifdef SW_SPAN_VECTORIZED
+  using namespace Vector;
+
+  alignas(16) static constexpr u16 coverage_bits[SPAN_WIDTH] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
+  const U16x8 coverage_mask = Load(coverage_bits);
+  const U16x8 channel_mask = Set(0x1F);
+  const U16x8 zero = Set(0);
+
+  const U16x8 bg = Load(dst_ptr);
+  U16x8 write_mask = Equal(And(Set(pixels.coverage), coverage_mask), coverage_mask);
+
+  const U16x8 dither =
+    dithering_enable ? Load(s_dither_span_table.values[y & 3u][x & 3u]) : Set(static_cast<u16>(GPU::DITHER_MATRIX[2][3]));
+
+  U16x8 color;
+  U16x8 transparent;
+  if constexpr (texture_enable)
+  {
+    const U16x8 texel = Load(pixels.texels);
+    write_mask = And(write_mask, Select(Equal(texel, zero), zero, Set(0xFFFF)));
+    transparent = ShiftRightSigned<15>(texel);
+
+    if constexpr (raw_texture_enable)
+    {
+      color = texel;
+    }
+    else
+    {
+      const U16x8 r = Dither(ShiftRight<4>(Mul(And(texel, channel_mask), LoadU8(pixels.r))), dither);
+      const U16x8 g = Dither(ShiftRight<4>(Mul(And(ShiftRight<5>(texel), channel_mask), LoadU8(pixels.g))), dither);
+      const U16x8 b = Dither(ShiftRight<4>(Mul(And(ShiftRight<10>(texel), channel_mask), LoadU8(pixels.b))), dither);
+      color = Or(PackRGB(r, g, b), And(texel, Set(0x8000)));
+    }
+  }
+  else
+  {
+    transparent = Set(0xFFFF);
+    color = PackRGB(Dither(LoadU8(pixels.r), dither), Dither(LoadU8(pixels.g), dither), Dither(LoadU8(pixels.b), dither));
+  }
+
+  if constexpr (transparency_enable)
+  {
+    const U16x8 bg_r = And(bg, channel_mask);
+    const U16x8 bg_g = And(ShiftRight<5>(bg), channel_mask);
+    const U16x8 bg_b = And(ShiftRight<10>(bg), channel_mask);
+    const U16x8 fg_r = And(color, channel_mask);
+    const U16x8 fg_g = And(ShiftRight<5>(color), channel_mask);
+    const U16x8 fg_b = And(ShiftRight<10>(color), channel_mask);
+
+    U16x8 blended;
+    switch (ps.transparency_mode)
+    {
+      case GPU::TransparencyMode::HalfBackgroundPlusHalfForeground:
+        blended = PackRGB(Add(ShiftRight<1>(bg_r), ShiftRight<1>(fg_r)), Add(ShiftRight<1>(bg_g), ShiftRight<1>(fg_g)),
+                          Add(ShiftRight<1>(bg_b), ShiftRight<1>(fg_b)));
+        break;
+      case GPU::TransparencyMode::BackgroundPlusForeground:
+        blended = PackRGB(MinSigned(Add(bg_r, fg_r), channel_mask), MinSigned(Add(bg_g, fg_g), channel_mask),
+                          MinSigned(Add(bg_b, fg_b), channel_mask));
+        break;
+      case GPU::TransparencyMode::BackgroundMinusForeground:
+        blended = PackRGB(SubSaturate(bg_r, fg_r), SubSaturate(bg_g, fg_g), SubSaturate(bg_b, fg_b));
+        break;
+      case GPU::TransparencyMode::BackgroundPlusQuarterForeground:
+        blended = PackRGB(MinSigned(Add(bg_r, ShiftRight<2>(fg_r)), channel_mask),
+                          MinSigned(Add(bg_g, ShiftRight<2>(fg_g)), channel_mask),
+                          MinSigned(Add(bg_b, ShiftRight<2>(fg_b)), channel_mask));
+        break;
+      default:
+        blended = PackRGB(fg_r, fg_g, fg_b);
+        break;
+    }
+
+    color = Select(transparent, Or(blended, And(color, Set(0x8000))), color);
+  }
+  else
+  {
+    UNREFERENCED_VARIABLE(transparent);
+  }
+
+  if (ps.mask_and != 0)
+    write_mask = And(write_mask, Equal(And(bg, Set(ps.mask_and)), zero));
+
+  Store(dst_ptr, Select(write_mask, Or(color, Set(ps.mask_or)), bg));
+#else
+  ShadeSpanScalar<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(ps, dst_ptr, x, y, pixels,
+                                                                                             SPAN_WIDTH);
+#endif
+}
+
+} // namespace SWSpan
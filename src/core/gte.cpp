@@ -1,12 +1,34 @@
 #include "gte.h"
 #include "common/assert.h"
 #include "common/bitutils.h"
+#include "common/cpu_detect.h"
 #include "common/state_wrapper.h"
 #include "cpu_core.h"
 #include "pgxp.h"
 #include "settings.h"
 #include <algorithm>
 #include <array>
+#include <utility>
+
+#if defined(CPU_X64)
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#define GTE_VECTOR_KERNELS 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#define GTE_VECTOR_TARGET
+#else
+// SSE4.1 for signed 32x32->64 multiplies and SSE4.2 for 64-bit compares, checked for at runtime.
+#define GTE_VECTOR_TARGET __attribute__((target("sse4.2")))
+#endif
+#elif defined(CPU_AARCH64)
+#include <arm_neon.h>
+#define GTE_VECTOR_KERNELS 1
+#define GTE_VECTOR_TARGET
+#endif
+
+#define VECTOR_FUNC ALWAYS_INLINE GTE_VECTOR_TARGET static
 
 namespace GTE {
 
@@ -461,95 +483,101 @@ static void MulMatVecBuggy(const s16 M[3][3], const s32 T[3], const s16 Vx, cons
 #undef dot3
 }
 
-static void Execute_MVMVA(Instruction inst)
+template<u8 mx>
+ALWAYS_INLINE static const s16 (*GetMVMVAMatrix(s16 buggy_M[3][3]))[3]
 {
-  REGS.FLAG.Clear();
-
-  // TODO: Remove memcpy..
-  s16 M[3][3];
-  switch (inst.mvmva_multiply_matrix)
+  if constexpr (mx == 0)
   {
-    case 0:
-      std::memcpy(M, REGS.RT, sizeof(s16) * 3 * 3);
-      break;
-    case 1:
-      std::memcpy(M, REGS.LLM, sizeof(s16) * 3 * 3);
-      break;
-    case 2:
-      std::memcpy(M, REGS.LCM, sizeof(s16) * 3 * 3);
-      break;
-    default:
-    {
-      // buggy
-      M[0][0] = -static_cast<s16>(ZeroExtend16(REGS.RGBC[0]) << 4);
-      M[0][1] = static_cast<s16>(ZeroExtend16(REGS.RGBC[0]) << 4);
-      M[0][2] = REGS.IR0;
-      M[1][0] = REGS.RT[0][2];
-      M[1][1] = REGS.RT[0][2];
-      M[1][2] = REGS.RT[0][2];
-      M[2][0] = REGS.RT[1][1];
-      M[2][1] = REGS.RT[1][1];
-      M[2][2] = REGS.RT[1][1];
-    }
-    break;
+    return REGS.RT;
   }
-
-  s16 Vx, Vy, Vz;
-  switch (inst.mvmva_multiply_vector)
+  else if constexpr (mx == 1)
   {
-    case 0:
-      Vx = REGS.V0[0];
-      Vy = REGS.V0[1];
-      Vz = REGS.V0[2];
-      break;
-    case 1:
-      Vx = REGS.V1[0];
-      Vy = REGS.V1[1];
-      Vz = REGS.V1[2];
-      break;
-    case 2:
-      Vx = REGS.V2[0];
-      Vy = REGS.V2[1];
-      Vz = REGS.V2[2];
-      break;
-    default:
-      Vx = REGS.IR1;
-      Vy = REGS.IR2;
-      Vz = REGS.IR3;
-      break;
+    return REGS.LLM;
+  }
+  else if constexpr (mx == 2)
+  {
+    return REGS.LCM;
+  }
+  else
+  {
+    // buggy
+    buggy_M[0][0] = -static_cast<s16>(ZeroExtend16(REGS.RGBC[0]) << 4);
+    buggy_M[0][1] = static_cast<s16>(ZeroExtend16(REGS.RGBC[0]) << 4);
+    buggy_M[0][2] = REGS.IR0;
+    buggy_M[1][0] = REGS.RT[0][2];
+    buggy_M[1][1] = REGS.RT[0][2];
+    buggy_M[1][2] = REGS.RT[0][2];
+    buggy_M[2][0] = REGS.RT[1][1];
+    buggy_M[2][1] = REGS.RT[1][1];
+    buggy_M[2][2] = REGS.RT[1][1];
+    return buggy_M;
   }
+}
 
-  static const s32 zero_T[3] = {};
-  switch (inst.mvmva_translation_vector)
+template<u8 v>
+ALWAYS_INLINE static void GetMVMVAVector(s16* Vx, s16* Vy, s16* Vz)
+{
+  if constexpr (v == 0)
   {
-    case 0:
-      MulMatVec(M, REGS.TR, Vx, Vy, Vz, inst.GetShift(), inst.lm);
-      break;
-    case 1:
-      MulMatVec(M, REGS.BK, Vx, Vy, Vz, inst.GetShift(), inst.lm);
-      break;
-    case 2:
-      MulMatVecBuggy(M, REGS.FC, Vx, Vy, Vz, inst.GetShift(), inst.lm);
-      break;
-    default:
-      MulMatVec(M, zero_T, Vx, Vy, Vz, inst.GetShift(), inst.lm);
-      break;
+    *Vx = REGS.V0[0];
+    *Vy = REGS.V0[1];
+    *Vz = REGS.V0[2];
+  }
+  else if constexpr (v == 1)
+  {
+    *Vx = REGS.V1[0];
+    *Vy = REGS.V1[1];
+    *Vz = REGS.V1[2];
+  }
+  else if constexpr (v == 2)
+  {
+    *Vx = REGS.V2[0];
+    *Vy = REGS.V2[1];
+    *Vz = REGS.V2[2];
+  }
+  else
+  {
+    *Vx = REGS.IR1;
+    *Vy = REGS.IR2;
+    *Vz = REGS.IR3;
   }
+}
+
+template<u8 mx, u8 v, u8 cv, bool sf, bool lm>
+static void Execute_MVMVA(Instruction inst)
+{
+  constexpr u8 shift = sf ? 12 : 0;
+  REGS.FLAG.Clear();
+
+  s16 buggy_M[3][3];
+  const s16(*M)[3] = GetMVMVAMatrix<mx>(buggy_M);
+  s16 Vx, Vy, Vz;
+  GetMVMVAVector<v>(&Vx, &Vy, &Vz);
+
+  // The translation-less form skips the intermediate MAC check, but a single 16x16 product can't overflow 44 bits.
+  if constexpr (cv == 0)
+    MulMatVec(M, REGS.TR, Vx, Vy, Vz, shift, lm);
+  else if constexpr (cv == 1)
+    MulMatVec(M, REGS.BK, Vx, Vy, Vz, shift, lm);
+  else if constexpr (cv == 2)
+    MulMatVecBuggy(M, REGS.FC, Vx, Vy, Vz, shift, lm);
+  else
+    MulMatVec(M, Vx, Vy, Vz, shift, lm);
 
   REGS.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
 static void Execute_SQR(Instruction inst)
 {
   REGS.FLAG.Clear();
 
   // 32-bit multiply for speed - 16x16 isn't >32bit, and we know it won't overflow/underflow.
-  const u8 shift = inst.GetShift();
+  constexpr u8 shift = sf ? 12 : 0;
   REGS.MAC1 = (s32(REGS.IR1) * s32(REGS.IR1)) >> shift;
   REGS.MAC2 = (s32(REGS.IR2) * s32(REGS.IR2)) >> shift;
   REGS.MAC3 = (s32(REGS.IR3) * s32(REGS.IR3)) >> shift;
 
-  const bool lm = inst.lm;
   TruncateAndSetIR<1>(REGS.MAC1, lm);
   TruncateAndSetIR<2>(REGS.MAC2, lm);
   TruncateAndSetIR<3>(REGS.MAC3, lm);
@@ -557,13 +585,13 @@ static void Execute_SQR(Instruction inst)
   REGS.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
 static void Execute_OP(Instruction inst)
 {
   REGS.FLAG.Clear();
 
   // Take copies since we overwrite them in each step.
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
+  constexpr u8 shift = sf ? 12 : 0;
   const s32 D1 = s32(REGS.RT[0][0]);
   const s32 D2 = s32(REGS.RT[1][1]);
   const s32 D3 = s32(REGS.RT[2][2]);
@@ -580,32 +608,9 @@ static void Execute_OP(Instruction inst)
   REGS.FLAG.UpdateError();
 }
 
-static void RTPS(const s16 V[3], u8 shift, bool lm, bool last)
+// Pushes SZ/SXY for a transformed vertex, and updates MAC0/IR0 for the last vertex. z is MAC3 before the shift.
+static void ProjectRTPS(s64 z, bool last)
 {
-#define dot3(i)                                                                                                        \
-  SignExtendMACResult<i + 1>(SignExtendMACResult<i + 1>((s64(REGS.TR[i]) << 12) + (s64(REGS.RT[i][0]) * s64(V[0]))) +  \
-                             (s64(REGS.RT[i][1]) * s64(V[1]))) +                                                       \
-    (s64(REGS.RT[i][2]) * s64(V[2]))
-
-  // IR1 = MAC1 = (TRX*1000h + RT11*VX0 + RT12*VY0 + RT13*VZ0) SAR (sf*12)
-  // IR2 = MAC2 = (TRY*1000h + RT21*VX0 + RT22*VY0 + RT23*VZ0) SAR (sf*12)
-  // IR3 = MAC3 = (TRZ*1000h + RT31*VX0 + RT32*VY0 + RT33*VZ0) SAR (sf*12)
-  const s64 x = dot3(0);
-  const s64 y = dot3(1);
-  const s64 z = dot3(2);
-  TruncateAndSetMAC<1>(x, shift);
-  TruncateAndSetMAC<2>(y, shift);
-  TruncateAndSetMAC<3>(z, shift);
-  TruncateAndSetIR<1>(REGS.MAC1, lm);
-  TruncateAndSetIR<2>(REGS.MAC2, lm);
-
-  // The command does saturate IR1,IR2,IR3 to -8000h..+7FFFh (regardless of lm bit). When using RTP with sf=0, then the
-  // IR3 saturation flag (FLAG.22) gets set <only> if "MAC3 SAR 12" exceeds -8000h..+7FFFh (although IR3 is saturated
-  // when "MAC3" exceeds -8000h..+7FFFh).
-  TruncateAndSetIR<3>(s32(z >> 12), false);
-  REGS.dr32[11] = std::clamp(REGS.MAC3, lm ? 0 : IR123_MIN_VALUE, IR123_MAX_VALUE);
-#undef dot3
-
   // SZ3 = MAC3 SAR ((1-sf)*12)                           ;ScreenZ FIFO 0..+FFFFh
   PushSZ(s32(z >> 12));
 
@@ -646,19 +651,49 @@ static void RTPS(const s16 V[3], u8 shift, bool lm, bool last)
   }
 }
 
+static void RTPS(const s16 V[3], u8 shift, bool lm, bool last)
+{
+#define dot3(i)                                                                                                        \
+  SignExtendMACResult<i + 1>(SignExtendMACResult<i + 1>((s64(REGS.TR[i]) << 12) + (s64(REGS.RT[i][0]) * s64(V[0]))) +  \
+                             (s64(REGS.RT[i][1]) * s64(V[1]))) +                                                       \
+    (s64(REGS.RT[i][2]) * s64(V[2]))
+
+  // IR1 = MAC1 = (TRX*1000h + RT11*VX0 + RT12*VY0 + RT13*VZ0) SAR (sf*12)
+  // IR2 = MAC2 = (TRY*1000h + RT21*VX0 + RT22*VY0 + RT23*VZ0) SAR (sf*12)
+  // IR3 = MAC3 = (TRZ*1000h + RT31*VX0 + RT32*VY0 + RT33*VZ0) SAR (sf*12)
+  const s64 x = dot3(0);
+  const s64 y = dot3(1);
+  const s64 z = dot3(2);
+  TruncateAndSetMAC<1>(x, shift);
+  TruncateAndSetMAC<2>(y, shift);
+  TruncateAndSetMAC<3>(z, shift);
+  TruncateAndSetIR<1>(REGS.MAC1, lm);
+  TruncateAndSetIR<2>(REGS.MAC2, lm);
+
+  // The command does saturate IR1,IR2,IR3 to -8000h..+7FFFh (regardless of lm bit). When using RTP with sf=0, then the
+  // IR3 saturation flag (FLAG.22) gets set <only> if "MAC3 SAR 12" exceeds -8000h..+7FFFh (although IR3 is saturated
+  // when "MAC3" exceeds -8000h..+7FFFh).
+  TruncateAndSetIR<3>(s32(z >> 12), false);
+  REGS.dr32[11] = std::clamp(REGS.MAC3, lm ? 0 : IR123_MIN_VALUE, IR123_MAX_VALUE);
+#undef dot3
+
+  ProjectRTPS(z, last);
+}
+
+template<bool sf, bool lm>
 static void Execute_RTPS(Instruction inst)
 {
   REGS.FLAG.Clear();
-  RTPS(REGS.V0, inst.GetShift(), inst.lm, true);
+  RTPS(REGS.V0, sf ? 12 : 0, lm, true);
   REGS.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
 static void Execute_RTPT(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
+  constexpr u8 shift = sf ? 12 : 0;
 
   RTPS(REGS.V0, shift, lm, false);
   RTPS(REGS.V1, shift, lm, false);
@@ -742,21 +777,22 @@ static void NCS(const s16 V[3], u8 shift, bool lm)
   PushRGBFromMAC();
 }
 
+template<bool sf, bool lm>
 static void Execute_NCS(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  NCS(REGS.V0, inst.GetShift(), inst.lm);
+  NCS(REGS.V0, sf ? 12 : 0, lm);
 
   REGS.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
 static void Execute_NCT(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
+  constexpr u8 shift = sf ? 12 : 0;
 
   NCS(REGS.V0, shift, lm);
   NCS(REGS.V1, shift, lm);
@@ -783,21 +819,22 @@ static void NCCS(const s16 V[3], u8 shift, bool lm)
   PushRGBFromMAC();
 }
 
+template<bool sf, bool lm>
 static void Execute_NCCS(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  NCCS(REGS.V0, inst.GetShift(), inst.lm);
+  NCCS(REGS.V0, sf ? 12 : 0, lm);
 
   REGS.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
 static void Execute_NCCT(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
+  constexpr u8 shift = sf ? 12 : 0;
 
   NCCS(REGS.V0, shift, lm);
   NCCS(REGS.V1, shift, lm);
@@ -827,21 +864,22 @@ static void NCDS(const s16 V[3], u8 shift, bool lm)
   PushRGBFromMAC();
 }
 
+template<bool sf, bool lm>
 static void Execute_NCDS(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  NCDS(REGS.V0, inst.GetShift(), inst.lm);
+  NCDS(REGS.V0, sf ? 12 : 0, lm);
 
   REGS.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
 static void Execute_NCDT(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
+  constexpr u8 shift = sf ? 12 : 0;
 
   NCDS(REGS.V0, shift, lm);
   NCDS(REGS.V1, shift, lm);
@@ -850,12 +888,12 @@ static void Execute_NCDT(Instruction inst)
   REGS.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
 static void Execute_CC(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
+  constexpr u8 shift = sf ? 12 : 0;
 
   // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (BK*1000h + LCM*IR) SAR (sf*12)
   MulMatVec(REGS.LCM, REGS.BK, REGS.IR1, REGS.IR2, REGS.IR3, shift, lm);
@@ -872,12 +910,12 @@ static void Execute_CC(Instruction inst)
   REGS.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
 static void Execute_CDP(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
+  constexpr u8 shift = sf ? 12 : 0;
 
   // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (BK*1000h + LCM*IR) SAR (sf*12)
   MulMatVec(REGS.LCM, REGS.BK, REGS.IR1, REGS.IR2, REGS.IR3, shift, lm);
@@ -913,21 +951,22 @@ static void DPCS(const u8 color[3], u8 shift, bool lm)
   PushRGBFromMAC();
 }
 
+template<bool sf, bool lm>
 static void Execute_DPCS(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  DPCS(REGS.RGBC, inst.GetShift(), inst.lm);
+  DPCS(REGS.RGBC, sf ? 12 : 0, lm);
 
   REGS.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
 static void Execute_DPCT(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
+  constexpr u8 shift = sf ? 12 : 0;
 
   for (u32 i = 0; i < 3; i++)
     DPCS(REGS.RGB0, shift, lm);
@@ -935,12 +974,12 @@ static void Execute_DPCT(Instruction inst)
   REGS.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
 static void Execute_DCPL(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
+  constexpr u8 shift = sf ? 12 : 0;
 
   // No need to assign these to MAC[1-3], as it'll never overflow.
   // [MAC1,MAC2,MAC3] = [R*IR1,G*IR2,B*IR3] SHL 4          ;<--- for DCPL only
@@ -957,12 +996,12 @@ static void Execute_DCPL(Instruction inst)
   REGS.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
 static void Execute_INTPL(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
+  constexpr u8 shift = sf ? 12 : 0;
 
   // No need to assign these to MAC[1-3], as it'll never overflow.
   // [MAC1,MAC2,MAC3] = [IR1,IR2,IR3] SHL 12               ;<--- for INTPL only
@@ -975,12 +1014,12 @@ static void Execute_INTPL(Instruction inst)
   REGS.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
 static void Execute_GPL(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
+  constexpr u8 shift = sf ? 12 : 0;
 
   // [MAC1,MAC2,MAC3] = [MAC1,MAC2,MAC3] SHL (sf*12)       ;<--- for GPL only
   // [MAC1,MAC2,MAC3] = (([IR1,IR2,IR3] * IR0) + [MAC1,MAC2,MAC3]) SAR (sf*12)
@@ -994,12 +1033,12 @@ static void Execute_GPL(Instruction inst)
   REGS.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
 static void Execute_GPF(Instruction inst)
 {
   REGS.FLAG.Clear();
 
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
+  constexpr u8 shift = sf ? 12 : 0;
 
   // [MAC1,MAC2,MAC3] = [0,0,0]                            ;<--- for GPF only
   // [MAC1,MAC2,MAC3] = (([IR1,IR2,IR3] * IR0) + [MAC1,MAC2,MAC3]) SAR (sf*12)
@@ -1013,117 +1052,771 @@ static void Execute_GPF(Instruction inst)
   REGS.FLAG.UpdateError();
 }
 
-void ExecuteInstruction(u32 inst_bits)
+#ifdef GTE_VECTOR_KERNELS
+
+// Vector kernels. Each lane holds one row of a matrix-vector product, so a 3x3 multiply is two 64-bit lane pairs
+// (rows 0-1 and row 2) on the MAC side, and one four-lane vector of 32-bit values on the IR side. The fourth lane is
+// padding and never stored. Flag conditions are accumulated as lane masks and turned into FLAG bits once per command.
+namespace Vector {
+
+#if defined(CPU_X64)
+
+using Vec64 = __m128i;
+using Vec32 = __m128i;
+using MulOperand = __m128i; // 32-bit values in dwords 0 and 2
+
+VECTOR_FUNC MulOperand MakeMulOperand(s32 a, s32 b)
 {
-  const Instruction inst{inst_bits};
-  switch (inst.command)
+  return _mm_set_epi32(0, b, 0, a);
+}
+VECTOR_FUNC MulOperand BroadcastMulOperand(s32 value)
+{
+  return _mm_set1_epi32(value);
+}
+template<u32 lane>
+VECTOR_FUNC MulOperand BroadcastLaneMulOperand(Vec32 v)
+{
+  return _mm_shuffle_epi32(v, _MM_SHUFFLE(lane, lane, lane, lane));
+}
+VECTOR_FUNC Vec64 Mul(MulOperand a, MulOperand b)
+{
+  return _mm_mul_epi32(a, b);
+}
+
+VECTOR_FUNC Vec64 MakeVec64(s64 a, s64 b)
+{
+  return _mm_set_epi64x(b, a);
+}
+VECTOR_FUNC Vec64 Broadcast64(s64 value)
+{
+  return _mm_set1_epi64x(value);
+}
+VECTOR_FUNC Vec64 Zero64()
+{
+  return _mm_setzero_si128();
+}
+VECTOR_FUNC Vec64 Add64(Vec64 a, Vec64 b)
+{
+  return _mm_add_epi64(a, b);
+}
+VECTOR_FUNC Vec64 Sub64(Vec64 a, Vec64 b)
+{
+  return _mm_sub_epi64(a, b);
+}
+VECTOR_FUNC Vec64 Or64(Vec64 a, Vec64 b)
+{
+  return _mm_or_si128(a, b);
+}
+VECTOR_FUNC Vec64 CompareGreater64(Vec64 a, Vec64 b)
+{
+  return _mm_cmpgt_epi64(a, b);
+}
+VECTOR_FUNC u32 MoveMask64(Vec64 mask)
+{
+  return static_cast<u32>(_mm_movemask_pd(_mm_castsi128_pd(mask)));
+}
+template<u32 lane>
+VECTOR_FUNC s64 Lane64(Vec64 v)
+{
+  return _mm_extract_epi64(v, lane);
+}
+
+VECTOR_FUNC Vec64 SignExtendMAC(Vec64 v)
+{
+  // no 64-bit arithmetic shift before AVX-512, so sign-extend from bit 43 with xor/sub
+  const __m128i mask = _mm_set1_epi64x((INT64_C(1) << 44) - 1);
+  const __m128i sign = _mm_set1_epi64x(INT64_C(1) << 43);
+  return _mm_sub_epi64(_mm_xor_si128(_mm_and_si128(v, mask), sign), sign);
+}
+
+// Low 32 bits of each lane after an arithmetic right shift. These bits are the same for a logical shift.
+template<u32 shift>
+VECTOR_FUNC Vec32 NarrowShifted(Vec64 lo, Vec64 hi)
+{
+  if constexpr (shift != 0)
   {
-    case 0x01:
-      Execute_RTPS(inst);
-      break;
+    lo = _mm_srli_epi64(lo, shift);
+    hi = _mm_srli_epi64(hi, shift);
+  }
 
-    case 0x06:
-    {
-      if (g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_culling)
-        Execute_NCLIP_PGXP(inst);
-      else
-        Execute_NCLIP(inst);
-    }
-    break;
+  return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+VECTOR_FUNC Vec64 WidenLow(Vec32 v)
+{
+  return _mm_cvtepi32_epi64(v);
+}
+VECTOR_FUNC Vec64 WidenHigh(Vec32 v)
+{
+  return _mm_cvtepi32_epi64(_mm_srli_si128(v, 8));
+}
 
-    case 0x0C:
-      Execute_OP(inst);
-      break;
+VECTOR_FUNC Vec32 MakeVec32(s32 a, s32 b, s32 c, s32 d)
+{
+  return _mm_set_epi32(d, c, b, a);
+}
+VECTOR_FUNC Vec32 Broadcast32(s32 value)
+{
+  return _mm_set1_epi32(value);
+}
+VECTOR_FUNC Vec32 Add32(Vec32 a, Vec32 b)
+{
+  return _mm_add_epi32(a, b);
+}
+VECTOR_FUNC Vec32 Mul32(Vec32 a, Vec32 b)
+{
+  return _mm_mullo_epi32(a, b);
+}
+VECTOR_FUNC Vec32 And32(Vec32 a, Vec32 b)
+{
+  return _mm_and_si128(a, b);
+}
+template<u32 shift>
+VECTOR_FUNC Vec32 ShiftLeft32(Vec32 v)
+{
+  return _mm_slli_epi32(v, shift);
+}
+template<u32 shift>
+VECTOR_FUNC Vec32 ShiftRightArithmetic32(Vec32 v)
+{
+  if constexpr (shift != 0)
+    return _mm_srai_epi32(v, shift);
+  else
+    return v;
+}
+VECTOR_FUNC Vec32 Clamp32(Vec32 v, Vec32 min_value, Vec32 max_value)
+{
+  return _mm_min_epi32(_mm_max_epi32(v, min_value), max_value);
+}
+VECTOR_FUNC Vec32 CompareEqual32(Vec32 a, Vec32 b)
+{
+  return _mm_cmpeq_epi32(a, b);
+}
+VECTOR_FUNC u32 MoveMask32(Vec32 mask)
+{
+  return static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+}
+template<u32 lane>
+VECTOR_FUNC s32 Lane32(Vec32 v)
+{
+  return _mm_extract_epi32(v, lane);
+}
+template<u32 lane>
+VECTOR_FUNC Vec32 InsertLane32(Vec32 v, s32 value)
+{
+  return _mm_insert_epi32(v, value, lane);
+}
 
-    case 0x10:
-      Execute_DPCS(inst);
-      break;
+// Low byte of lanes 0-2 packed into a 24-bit value. Lanes must already be in 0..FFh.
+VECTOR_FUNC u32 PackBytes(Vec32 v)
+{
+  const __m128i words = _mm_packus_epi32(v, v);
+  return static_cast<u32>(_mm_cvtsi128_si32(_mm_packus_epi16(words, words))) & 0xFFFFFFu;
+}
 
-    case 0x11:
-      Execute_INTPL(inst);
-      break;
+#elif defined(CPU_AARCH64)
 
-    case 0x12:
-      Execute_MVMVA(inst);
-      break;
+using Vec64 = int64x2_t;
+using Vec32 = int32x4_t;
+using MulOperand = int32x2_t;
 
-    case 0x13:
-      Execute_NCDS(inst);
-      break;
+VECTOR_FUNC MulOperand MakeMulOperand(s32 a, s32 b)
+{
+  return vset_lane_s32(b, vdup_n_s32(a), 1);
+}
+VECTOR_FUNC MulOperand BroadcastMulOperand(s32 value)
+{
+  return vdup_n_s32(value);
+}
+template<u32 lane>
+VECTOR_FUNC MulOperand BroadcastLaneMulOperand(Vec32 v)
+{
+  return vdup_laneq_s32(v, lane);
+}
+VECTOR_FUNC Vec64 Mul(MulOperand a, MulOperand b)
+{
+  return vmull_s32(a, b);
+}
 
-    case 0x14:
-      Execute_CDP(inst);
-      break;
+VECTOR_FUNC Vec64 MakeVec64(s64 a, s64 b)
+{
+  return vsetq_lane_s64(b, vdupq_n_s64(a), 1);
+}
+VECTOR_FUNC Vec64 Broadcast64(s64 value)
+{
+  return vdupq_n_s64(value);
+}
+VECTOR_FUNC Vec64 Zero64()
+{
+  return vdupq_n_s64(0);
+}
+VECTOR_FUNC Vec64 Add64(Vec64 a, Vec64 b)
+{
+  return vaddq_s64(a, b);
+}
+VECTOR_FUNC Vec64 Sub64(Vec64 a, Vec64 b)
+{
+  return vsubq_s64(a, b);
+}
+VECTOR_FUNC Vec64 Or64(Vec64 a, Vec64 b)
+{
+  return vorrq_s64(a, b);
+}
+VECTOR_FUNC Vec64 CompareGreater64(Vec64 a, Vec64 b)
+{
+  return vreinterpretq_s64_u64(vcgtq_s64(a, b));
+}
+VECTOR_FUNC u32 MoveMask64(Vec64 mask)
+{
+  return static_cast<u32>(vgetq_lane_s64(mask, 0) & 1) | (static_cast<u32>(vgetq_lane_s64(mask, 1) & 1) << 1);
+}
+template<u32 lane>
+VECTOR_FUNC s64 Lane64(Vec64 v)
+{
+  return vgetq_lane_s64(v, lane);
+}
 
-    case 0x16:
-      Execute_NCDT(inst);
-      break;
+VECTOR_FUNC Vec64 SignExtendMAC(Vec64 v)
+{
+  return vshrq_n_s64(vshlq_n_s64(v, 20), 20);
+}
 
-    case 0x1B:
-      Execute_NCCS(inst);
-      break;
+template<u32 shift>
+VECTOR_FUNC Vec32 NarrowShifted(Vec64 lo, Vec64 hi)
+{
+  if constexpr (shift != 0)
+  {
+    lo = vshrq_n_s64(lo, shift);
+    hi = vshrq_n_s64(hi, shift);
+  }
 
-    case 0x1C:
-      Execute_CC(inst);
-      break;
+  return vcombine_s32(vmovn_s64(lo), vmovn_s64(hi));
+}
+VECTOR_FUNC Vec64 WidenLow(Vec32 v)
+{
+  return vmovl_s32(vget_low_s32(v));
+}
+VECTOR_FUNC Vec64 WidenHigh(Vec32 v)
+{
+  return vmovl_s32(vget_high_s32(v));
+}
 
-    case 0x1E:
-      Execute_NCS(inst);
-      break;
+VECTOR_FUNC Vec32 MakeVec32(s32 a, s32 b, s32 c, s32 d)
+{
+  const s32 values[4] = {a, b, c, d};
+  return vld1q_s32(values);
+}
+VECTOR_FUNC Vec32 Broadcast32(s32 value)
+{
+  return vdupq_n_s32(value);
+}
+VECTOR_FUNC Vec32 Add32(Vec32 a, Vec32 b)
+{
+  return vaddq_s32(a, b);
+}
+VECTOR_FUNC Vec32 Mul32(Vec32 a, Vec32 b)
+{
+  return vmulq_s32(a, b);
+}
+VECTOR_FUNC Vec32 And32(Vec32 a, Vec32 b)
+{
+  return vandq_s32(a, b);
+}
+template<u32 shift>
+VECTOR_FUNC Vec32 ShiftLeft32(Vec32 v)
+{
+  return vshlq_n_s32(v, shift);
+}
+template<u32 shift>
+VECTOR_FUNC Vec32 ShiftRightArithmetic32(Vec32 v)
+{
+  if constexpr (shift != 0)
+    return vshrq_n_s32(v, shift);
+  else
+    return v;
+}
+VECTOR_FUNC Vec32 Clamp32(Vec32 v, Vec32 min_value, Vec32 max_value)
+{
+  return vminq_s32(vmaxq_s32(v, min_value), max_value);
+}
+VECTOR_FUNC Vec32 CompareEqual32(Vec32 a, Vec32 b)
+{
+  return vreinterpretq_s32_u32(vceqq_s32(a, b));
+}
+VECTOR_FUNC u32 MoveMask32(Vec32 mask)
+{
+  static constexpr s32 lane_bits[4] = {1, 2, 4, 8};
+  return static_cast<u32>(vaddvq_s32(vandq_s32(mask, vld1q_s32(lane_bits))));
+}
+template<u32 lane>
+VECTOR_FUNC s32 Lane32(Vec32 v)
+{
+  return vgetq_lane_s32(v, lane);
+}
+template<u32 lane>
+VECTOR_FUNC Vec32 InsertLane32(Vec32 v, s32 value)
+{
+  return vsetq_lane_s32(value, v, lane);
+}
 
-    case 0x20:
-      Execute_NCT(inst);
-      break;
+VECTOR_FUNC u32 PackBytes(Vec32 v)
+{
+  const uint16x4_t words = vmovn_u32(vreinterpretq_u32_s32(v));
+  return vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(words, words))), 0) & 0xFFFFFFu;
+}
 
-    case 0x28:
-      Execute_SQR(inst);
-      break;
+#endif
 
-    case 0x29:
-      Execute_DCPL(inst);
-      break;
+struct Matrix
+{
+  MulOperand lo[3]; // column j of rows 0 and 1
+  MulOperand hi[3]; // column j of row 2
+};
 
-    case 0x2A:
-      Execute_DPCT(inst);
-      break;
+struct Translation
+{
+  Vec64 lo; // rows 0 and 1, shifted left by 12
+  Vec64 hi; // row 2
+};
 
-    case 0x2D:
-      Execute_AVSZ3(inst);
-      break;
+// Lanes which have set each group of FLAG bits. IR and color lanes are tracked as "unchanged by saturation".
+struct Flags
+{
+  Vec64 mac_overflow_lo;
+  Vec64 mac_overflow_hi;
+  Vec64 mac_underflow_lo;
+  Vec64 mac_underflow_hi;
+  Vec32 ir_unsaturated;
+  Vec32 color_unsaturated;
+};
+
+struct MACAndIR
+{
+  Vec32 mac;
+  Vec32 ir;
+};
 
-    case 0x2E:
-      Execute_AVSZ4(inst);
-      break;
+VECTOR_FUNC Flags InitFlags()
+{
+  return Flags{Zero64(), Zero64(), Zero64(), Zero64(), Broadcast32(-1), Broadcast32(-1)};
+}
 
-    case 0x30:
-      Execute_RTPT(inst);
-      break;
+VECTOR_FUNC Matrix LoadMatrix(const s16 M[3][3])
+{
+  Matrix ret;
+  for (u32 j = 0; j < 3; j++)
+  {
+    ret.lo[j] = MakeMulOperand(M[0][j], M[1][j]);
+    ret.hi[j] = MakeMulOperand(M[2][j], 0);
+  }
+  return ret;
+}
 
-    case 0x3D:
-      Execute_GPF(inst);
-      break;
+VECTOR_FUNC Translation LoadTranslation(const s32 T[3])
+{
+  return Translation{MakeVec64(s64(T[0]) << 12, s64(T[1]) << 12), MakeVec64(s64(T[2]) << 12, 0)};
+}
 
-    case 0x3E:
-      Execute_GPL(inst);
-      break;
+VECTOR_FUNC void CheckMACOverflow(Vec64 lo, Vec64 hi, Flags* flags)
+{
+  const Vec64 max_value = Broadcast64(MAC123_MAX_VALUE);
+  const Vec64 min_value = Broadcast64(MAC123_MIN_VALUE);
+  flags->mac_overflow_lo = Or64(flags->mac_overflow_lo, CompareGreater64(lo, max_value));
+  flags->mac_overflow_hi = Or64(flags->mac_overflow_hi, CompareGreater64(hi, max_value));
+  flags->mac_underflow_lo = Or64(flags->mac_underflow_lo, CompareGreater64(min_value, lo));
+  flags->mac_underflow_hi = Or64(flags->mac_underflow_hi, CompareGreater64(min_value, hi));
+}
 
-    case 0x3F:
-      Execute_NCCT(inst);
-      break;
+// (T << 12) + M * V, with the same intermediate MAC checks and wrapping as the scalar dot3.
+VECTOR_FUNC void MulMatVec(const Matrix& M, const Translation& T, MulOperand Vx, MulOperand Vy, MulOperand Vz,
+                           Vec64* out_lo, Vec64* out_hi, Flags* flags)
+{
+  Vec64 lo = Add64(T.lo, Mul(M.lo[0], Vx));
+  Vec64 hi = Add64(T.hi, Mul(M.hi[0], Vx));
+  CheckMACOverflow(lo, hi, flags);
+  lo = Add64(SignExtendMAC(lo), Mul(M.lo[1], Vy));
+  hi = Add64(SignExtendMAC(hi), Mul(M.hi[1], Vy));
+  CheckMACOverflow(lo, hi, flags);
+  *out_lo = Add64(SignExtendMAC(lo), Mul(M.lo[2], Vz));
+  *out_hi = Add64(SignExtendMAC(hi), Mul(M.hi[2], Vz));
+}
 
-    default:
-      Panic("Missing handler");
-      break;
+// M * V. Three 16x16 products can't leave the MAC range, so there are no intermediate checks.
+VECTOR_FUNC void MulMatVec(const Matrix& M, MulOperand Vx, MulOperand Vy, MulOperand Vz, Vec64* out_lo, Vec64* out_hi)
+{
+  *out_lo = Add64(Add64(Mul(M.lo[0], Vx), Mul(M.lo[1], Vy)), Mul(M.lo[2], Vz));
+  *out_hi = Add64(Add64(Mul(M.hi[0], Vx), Mul(M.hi[1], Vy)), Mul(M.hi[2], Vz));
+}
+
+template<bool lm>
+VECTOR_FUNC Vec32 SaturateIR(Vec32 value, Flags* flags)
+{
+  const Vec32 ir = Clamp32(value, Broadcast32(lm ? 0 : IR123_MIN_VALUE), Broadcast32(IR123_MAX_VALUE));
+  flags->ir_unsaturated = And32(flags->ir_unsaturated, CompareEqual32(ir, value));
+  return ir;
+}
+
+VECTOR_FUNC void StoreMACAndIR(Vec32 mac, Vec32 ir)
+{
+  REGS.dr32[25] = static_cast<u32>(Lane32<0>(mac));
+  REGS.dr32[26] = static_cast<u32>(Lane32<1>(mac));
+  REGS.dr32[27] = static_cast<u32>(Lane32<2>(mac));
+  REGS.dr32[9] = static_cast<u32>(Lane32<0>(ir));
+  REGS.dr32[10] = static_cast<u32>(Lane32<1>(ir));
+  REGS.dr32[11] = static_cast<u32>(Lane32<2>(ir));
+}
+
+template<u8 shift, bool lm>
+VECTOR_FUNC MACAndIR TruncateAndSetMACAndIR(Vec64 lo, Vec64 hi, Flags* flags)
+{
+  CheckMACOverflow(lo, hi, flags);
+  const Vec32 mac = NarrowShifted<shift>(lo, hi);
+  const Vec32 ir = SaturateIR<lm>(mac, flags);
+  StoreMACAndIR(mac, ir);
+  return MACAndIR{mac, ir};
+}
+
+// For values known to fit in 32 bits, which can't set the MAC flags.
+template<u8 shift, bool lm>
+VECTOR_FUNC MACAndIR TruncateAndSetMACAndIR(Vec32 value, Flags* flags)
+{
+  const Vec32 mac = ShiftRightArithmetic32<shift>(value);
+  const Vec32 ir = SaturateIR<lm>(mac, flags);
+  StoreMACAndIR(mac, ir);
+  return MACAndIR{mac, ir};
+}
+
+VECTOR_FUNC void PushRGBFromMAC(Vec32 mac, Flags* flags)
+{
+  // Note: SHR 4 used instead of /16 as the results are different.
+  const Vec32 value = ShiftRightArithmetic32<4>(mac);
+  const Vec32 rgb = Clamp32(value, Broadcast32(0), Broadcast32(0xFF));
+  flags->color_unsaturated = And32(flags->color_unsaturated, CompareEqual32(rgb, value));
+
+  REGS.dr32[20] = REGS.dr32[21];                                       // RGB0 <- RGB1
+  REGS.dr32[21] = REGS.dr32[22];                                       // RGB1 <- RGB2
+  REGS.dr32[22] = PackBytes(rgb) | (ZeroExtend32(REGS.RGBC[3]) << 24); // RGB2 <- Value
+}
+
+template<u8 shift, bool lm>
+VECTOR_FUNC void RTPS(const Matrix& RT, const Translation& TR, const s16 V[3], bool last, Flags* flags)
+{
+  Vec64 lo, hi;
+  MulMatVec(RT, TR, BroadcastMulOperand(V[0]), BroadcastMulOperand(V[1]), BroadcastMulOperand(V[2]), &lo, &hi,
+            flags);
+  CheckMACOverflow(lo, hi, flags);
+
+  const Vec32 mac = NarrowShifted<shift>(lo, hi);
+  const Vec32 ir = Clamp32(mac, Broadcast32(lm ? 0 : IR123_MIN_VALUE), Broadcast32(IR123_MAX_VALUE));
+  StoreMACAndIR(mac, ir);
+
+  // IR3 is saturated from MAC3 like IR1/IR2, but its flag comes from "MAC3 SAR 12" without lm.
+  const s64 z = Lane64<0>(hi);
+  const Vec32 flag_value = (shift == 12) ? mac : InsertLane32<2>(mac, s32(z >> 12));
+  const Vec32 flag_ir = Clamp32(flag_value, MakeVec32(lm ? 0 : IR123_MIN_VALUE, lm ? 0 : IR123_MIN_VALUE,
+                                                      IR123_MIN_VALUE, IR123_MIN_VALUE),
+                                Broadcast32(IR123_MAX_VALUE));
+  flags->ir_unsaturated = And32(flags->ir_unsaturated, CompareEqual32(flag_ir, flag_value));
+
+  ProjectRTPS(z, last);
+}
+
+struct LightingState
+{
+  Matrix LLM;
+  Matrix LCM;
+  Translation BK;
+  Vec32 RGBC;
+};
+
+VECTOR_FUNC LightingState LoadLightingState()
+{
+  return LightingState{LoadMatrix(REGS.LLM), LoadMatrix(REGS.LCM), LoadTranslation(REGS.BK),
+                       MakeVec32(REGS.RGBC[0], REGS.RGBC[1], REGS.RGBC[2], 0)};
+}
+
+// [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (BK*1000h + LCM*(LLM*V SAR (sf*12))) SAR (sf*12)
+template<u8 shift, bool lm>
+VECTOR_FUNC MACAndIR Light(const LightingState& ls, const s16 V[3], Flags* flags)
+{
+  Vec64 lo, hi;
+  MulMatVec(ls.LLM, BroadcastMulOperand(V[0]), BroadcastMulOperand(V[1]), BroadcastMulOperand(V[2]), &lo, &hi);
+  const Vec32 ir = TruncateAndSetMACAndIR<shift, lm>(lo, hi, flags).ir;
+
+  MulMatVec(ls.LCM, ls.BK, BroadcastLaneMulOperand<0>(ir), BroadcastLaneMulOperand<1>(ir),
+            BroadcastLaneMulOperand<2>(ir), &lo, &hi, flags);
+  return TruncateAndSetMACAndIR<shift, lm>(lo, hi, flags);
+}
+
+template<u8 shift, bool lm>
+VECTOR_FUNC void NCS(const LightingState& ls, const s16 V[3], Flags* flags)
+{
+  PushRGBFromMAC(Light<shift, lm>(ls, V, flags).mac, flags);
+}
+
+template<u8 shift, bool lm>
+VECTOR_FUNC void NCCS(const LightingState& ls, const s16 V[3], Flags* flags)
+{
+  const Vec32 ir = Light<shift, lm>(ls, V, flags).ir;
+
+  // [MAC1,MAC2,MAC3] = [R*IR1,G*IR2,B*IR3] SHL 4 SAR (sf*12)
+  PushRGBFromMAC(TruncateAndSetMACAndIR<shift, lm>(ShiftLeft32<4>(Mul32(ls.RGBC, ir)), flags).mac, flags);
+}
+
+template<u8 shift, bool lm>
+VECTOR_FUNC void NCDS(const LightingState& ls, const Translation& FC, const s16 V[3], Flags* flags)
+{
+  const Vec32 ir = Light<shift, lm>(ls, V, flags).ir;
+  const Vec32 in_MAC = ShiftLeft32<4>(Mul32(ls.RGBC, ir));
+
+  // [IR1,IR2,IR3] = (([RFC,GFC,BFC] SHL 12) - [MAC1,MAC2,MAC3]) SAR (sf*12)
+  const Vec32 fc_ir =
+    TruncateAndSetMACAndIR<shift, false>(Sub64(FC.lo, WidenLow(in_MAC)), Sub64(FC.hi, WidenHigh(in_MAC)), flags).ir;
+
+  // [MAC1,MAC2,MAC3] = (([IR1,IR2,IR3] * IR0) + [MAC1,MAC2,MAC3]) SAR (sf*12), at most 31 bits
+  PushRGBFromMAC(
+    TruncateAndSetMACAndIR<shift, lm>(Add32(Mul32(fc_ir, Broadcast32(REGS.IR0)), in_MAC), flags).mac, flags);
+}
+
+VECTOR_FUNC void MergeFlags(const Flags& flags)
+{
+  // row N is MAC(N+1): overflow at bit 30-N, underflow at bit 27-N
+  const u32 overflow = MoveMask64(flags.mac_overflow_lo) | ((MoveMask64(flags.mac_overflow_hi) & 1u) << 2);
+  const u32 underflow = MoveMask64(flags.mac_underflow_lo) | ((MoveMask64(flags.mac_underflow_hi) & 1u) << 2);
+
+  // IR(N+1) saturated at bit 24-N, color component N at bit 21-N
+  const u32 ir = ~MoveMask32(flags.ir_unsaturated);
+  const u32 color = ~MoveMask32(flags.color_unsaturated);
+
+  REGS.FLAG.bits |= ((overflow & 1u) << 30) | ((overflow & 2u) << 28) | ((overflow & 4u) << 26) |
+                    ((underflow & 1u) << 27) | ((underflow & 2u) << 25) | ((underflow & 4u) << 23) |
+                    ((ir & 1u) << 24) | ((ir & 2u) << 22) | ((ir & 4u) << 20) | ((color & 1u) << 21) |
+                    ((color & 2u) << 19) | ((color & 4u) << 17);
+  REGS.FLAG.UpdateError();
+}
+
+} // namespace Vector
+
+template<bool sf, bool lm>
+GTE_VECTOR_TARGET static void ExecuteVector_RTPS(Instruction inst)
+{
+  REGS.FLAG.Clear();
+
+  Vector::Flags flags = Vector::InitFlags();
+  Vector::RTPS<sf ? 12 : 0, lm>(Vector::LoadMatrix(REGS.RT), Vector::LoadTranslation(REGS.TR), REGS.V0, true,
+                                &flags);
+
+  Vector::MergeFlags(flags);
+}
+
+template<bool sf, bool lm>
+GTE_VECTOR_TARGET static void ExecuteVector_RTPT(Instruction inst)
+{
+  REGS.FLAG.Clear();
+
+  Vector::Flags flags = Vector::InitFlags();
+  const Vector::Matrix RT = Vector::LoadMatrix(REGS.RT);
+  const Vector::Translation TR = Vector::LoadTranslation(REGS.TR);
+  Vector::RTPS<sf ? 12 : 0, lm>(RT, TR, REGS.V0, false, &flags);
+  Vector::RTPS<sf ? 12 : 0, lm>(RT, TR, REGS.V1, false, &flags);
+  Vector::RTPS<sf ? 12 : 0, lm>(RT, TR, REGS.V2, true, &flags);
+
+  Vector::MergeFlags(flags);
+}
+
+template<bool sf, bool lm>
+GTE_VECTOR_TARGET static void ExecuteVector_NCS(Instruction inst)
+{
+  REGS.FLAG.Clear();
+
+  Vector::Flags flags = Vector::InitFlags();
+  Vector::NCS<sf ? 12 : 0, lm>(Vector::LoadLightingState(), REGS.V0, &flags);
+
+  Vector::MergeFlags(flags);
+}
+
+template<bool sf, bool lm>
+GTE_VECTOR_TARGET static void ExecuteVector_NCT(Instruction inst)
+{
+  REGS.FLAG.Clear();
+
+  Vector::Flags flags = Vector::InitFlags();
+  const Vector::LightingState ls = Vector::LoadLightingState();
+  Vector::NCS<sf ? 12 : 0, lm>(ls, REGS.V0, &flags);
+  Vector::NCS<sf ? 12 : 0, lm>(ls, REGS.V1, &flags);
+  Vector::NCS<sf ? 12 : 0, lm>(ls, REGS.V2, &flags);
+
+  Vector::MergeFlags(flags);
+}
+
+template<bool sf, bool lm>
+GTE_VECTOR_TARGET static void ExecuteVector_NCCS(Instruction inst)
+{
+  REGS.FLAG.Clear();
+
+  Vector::Flags flags = Vector::InitFlags();
+  Vector::NCCS<sf ? 12 : 0, lm>(Vector::LoadLightingState(), REGS.V0, &flags);
+
+  Vector::MergeFlags(flags);
+}
+
+template<bool sf, bool lm>
+GTE_VECTOR_TARGET static void ExecuteVector_NCCT(Instruction inst)
+{
+  REGS.FLAG.Clear();
+
+  Vector::Flags flags = Vector::InitFlags();
+  const Vector::LightingState ls = Vector::LoadLightingState();
+  Vector::NCCS<sf ? 12 : 0, lm>(ls, REGS.V0, &flags);
+  Vector::NCCS<sf ? 12 : 0, lm>(ls, REGS.V1, &flags);
+  Vector::NCCS<sf ? 12 : 0, lm>(ls, REGS.V2, &flags);
+
+  Vector::MergeFlags(flags);
+}
+
+template<bool sf, bool lm>
+GTE_VECTOR_TARGET static void ExecuteVector_NCDS(Instruction inst)
+{
+  REGS.FLAG.Clear();
+
+  Vector::Flags flags = Vector::InitFlags();
+  Vector::NCDS<sf ? 12 : 0, lm>(Vector::LoadLightingState(), Vector::LoadTranslation(REGS.FC), REGS.V0, &flags);
+
+  Vector::MergeFlags(flags);
+}
+
+template<bool sf, bool lm>
+GTE_VECTOR_TARGET static void ExecuteVector_NCDT(Instruction inst)
+{
+  REGS.FLAG.Clear();
+
+  Vector::Flags flags = Vector::InitFlags();
+  const Vector::LightingState ls = Vector::LoadLightingState();
+  const Vector::Translation FC = Vector::LoadTranslation(REGS.FC);
+  Vector::NCDS<sf ? 12 : 0, lm>(ls, FC, REGS.V0, &flags);
+  Vector::NCDS<sf ? 12 : 0, lm>(ls, FC, REGS.V1, &flags);
+  Vector::NCDS<sf ? 12 : 0, lm>(ls, FC, REGS.V2, &flags);
+
+  Vector::MergeFlags(flags);
+}
+
+template<u8 mx, u8 v, u8 cv, bool sf, bool lm>
+GTE_VECTOR_TARGET static void ExecuteVector_MVMVA(Instruction inst)
+{
+  static_assert(cv != 2, "the buggy FC form uses the scalar kernel");
+  REGS.FLAG.Clear();
+
+  s16 buggy_M[3][3];
+  const Vector::Matrix M = Vector::LoadMatrix(GetMVMVAMatrix<mx>(buggy_M));
+  s16 Vx, Vy, Vz;
+  GetMVMVAVector<v>(&Vx, &Vy, &Vz);
+
+  Vector::Flags flags = Vector::InitFlags();
+  Vector::Vec64 lo, hi;
+  if constexpr (cv == 3)
+  {
+    Vector::MulMatVec(M, Vector::BroadcastMulOperand(Vx), Vector::BroadcastMulOperand(Vy),
+                      Vector::BroadcastMulOperand(Vz), &lo, &hi);
+  }
+  else
+  {
+    Vector::MulMatVec(M, Vector::LoadTranslation((cv == 0) ? REGS.TR : REGS.BK), Vector::BroadcastMulOperand(Vx),
+                      Vector::BroadcastMulOperand(Vy), Vector::BroadcastMulOperand(Vz), &lo, &hi, &flags);
   }
+  Vector::TruncateAndSetMACAndIR<sf ? 12 : 0, lm>(lo, hi, &flags);
+
+  Vector::MergeFlags(flags);
 }
 
-InstructionImpl GetInstructionImpl(u32 inst_bits)
+#endif // GTE_VECTOR_KERNELS
+
+// MVMVA operands packed as [sf:1][mx:2][v:2][cv:2][lm:1], i.e. instruction bits 13-19 followed by lm.
+template<u32 index>
+static constexpr InstructionImpl GetMVMVAImpl()
+{
+  return &Execute_MVMVA<(index >> 5) & 3, (index >> 3) & 3, (index >> 1) & 3, ((index >> 7) & 1) != 0, (index & 1) != 0>;
+}
+
+template<std::size_t... indices>
+static constexpr std::array<InstructionImpl, sizeof...(indices)> MakeMVMVAImplTable(std::index_sequence<indices...>)
+{
+  return {{GetMVMVAImpl<indices>()...}};
+}
+
+static constexpr std::array<InstructionImpl, 256> s_mvmva_impls = MakeMVMVAImplTable(std::make_index_sequence<256>());
+
+#ifdef GTE_VECTOR_KERNELS
+
+template<u32 index>
+static constexpr InstructionImpl GetVectorMVMVAImpl()
+{
+  // The FC translation form emulates a hardware bug in MulMatVecBuggy, so it keeps the scalar kernel.
+  if constexpr (((index >> 1) & 3) == 2)
+    return GetMVMVAImpl<index>();
+  else
+    return &ExecuteVector_MVMVA<(index >> 5) & 3, (index >> 3) & 3, (index >> 1) & 3, ((index >> 7) & 1) != 0,
+                                (index & 1) != 0>;
+}
+
+template<std::size_t... indices>
+static constexpr std::array<InstructionImpl, sizeof...(indices)>
+MakeVectorMVMVAImplTable(std::index_sequence<indices...>)
+{
+  return {{GetVectorMVMVAImpl<indices>()...}};
+}
+
+static constexpr std::array<InstructionImpl, 256> s_vector_mvmva_impls =
+  MakeVectorMVMVAImplTable(std::make_index_sequence<256>());
+
+#endif
+
+bool HasVectorKernels()
+{
+#if defined(CPU_X64)
+  static const bool supported = []() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return ((info[2] >> 20) & 1) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2") != 0;
+#endif
+  }();
+  return supported;
+#elif defined(CPU_AARCH64)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void ExecuteInstruction(u32 inst_bits)
+{
+  GetInstructionImpl(inst_bits)(Instruction{inst_bits});
+}
+
+InstructionImpl GetInstructionImpl(u32 inst_bits, bool force_scalar /* = false */)
 {
   const Instruction inst{inst_bits};
+
+#define SF_LM_IMPL(name)                                                                                               \
+  (inst.sf ? (inst.lm ? &Execute_##name<true, true> : &Execute_##name<true, false>) :                                \
+             (inst.lm ? &Execute_##name<false, true> : &Execute_##name<false, false>))
+
+#ifdef GTE_VECTOR_KERNELS
+  const bool use_vector = !force_scalar && HasVectorKernels();
+#define VECTOR_SF_LM_IMPL(name)                                                                                        \
+  (use_vector ? (inst.sf ? (inst.lm ? &ExecuteVector_##name<true, true> : &ExecuteVector_##name<true, false>) :      \
+                           (inst.lm ? &ExecuteVector_##name<false, true> : &ExecuteVector_##name<false, false>)) :   \
+                SF_LM_IMPL(name))
+#else
+#define VECTOR_SF_LM_IMPL(name) SF_LM_IMPL(name)
+#endif
+
   switch (inst.command)
   {
     case 0x01:
-      return &Execute_RTPS;
+      return VECTOR_SF_LM_IMPL(RTPS);
 
     case 0x06:
     {
@@ -1134,46 +1827,53 @@ InstructionImpl GetInstructionImpl(u32 inst_bits)
     }
 
     case 0x0C:
-      return &Execute_OP;
+      return SF_LM_IMPL(OP);
 
     case 0x10:
-      return &Execute_DPCS;
+      return SF_LM_IMPL(DPCS);
 
     case 0x11:
-      return &Execute_INTPL;
+      return SF_LM_IMPL(INTPL);
 
     case 0x12:
-      return &Execute_MVMVA;
+    {
+      const u32 index = (((inst_bits >> 13) & 0x7F) << 1) | BoolToUInt32(inst.lm);
+#ifdef GTE_VECTOR_KERNELS
+      if (use_vector)
+        return s_vector_mvmva_impls[index];
+#endif
+      return s_mvmva_impls[index];
+    }
 
     case 0x13:
-      return &Execute_NCDS;
+      return VECTOR_SF_LM_IMPL(NCDS);
 
     case 0x14:
-      return &Execute_CDP;
+      return SF_LM_IMPL(CDP);
 
     case 0x16:
-      return &Execute_NCDT;
+      return VECTOR_SF_LM_IMPL(NCDT);
 
     case 0x1B:
-      return &Execute_NCCS;
+      return VECTOR_SF_LM_IMPL(NCCS);
 
     case 0x1C:
-      return &Execute_CC;
+      return SF_LM_IMPL(CC);
 
     case 0x1E:
-      return &Execute_NCS;
+      return VECTOR_SF_LM_IMPL(NCS);
 
     case 0x20:
-      return &Execute_NCT;
+      return VECTOR_SF_LM_IMPL(NCT);
 
     case 0x28:
-      return &Execute_SQR;
+      return SF_LM_IMPL(SQR);
 
     case 0x29:
-      return &Execute_DCPL;
+      return SF_LM_IMPL(DCPL);
 
     case 0x2A:
-      return &Execute_DPCT;
+      return SF_LM_IMPL(DPCT);
 
     case 0x2D:
       return &Execute_AVSZ3;
@@ -1182,21 +1882,24 @@ InstructionImpl GetInstructionImpl(u32 inst_bits)
       return &Execute_AVSZ4;
 
     case 0x30:
-      return &Execute_RTPT;
+      return VECTOR_SF_LM_IMPL(RTPT);
 
     case 0x3D:
-      return &Execute_GPF;
+      return SF_LM_IMPL(GPF);
 
     case 0x3E:
-      return &Execute_GPL;
+      return SF_LM_IMPL(GPL);
 
     case 0x3F:
-      return &Execute_NCCT;
+      return VECTOR_SF_LM_IMPL(NCCT);
 
     default:
       Panic("Missing handler");
       return nullptr;
   }
+
+#undef VECTOR_SF_LM_IMPL
+#undef SF_LM_IMPL
 }
 
 } // namespace GTE
@@ -19,6 +19,9 @@ u32* GetRegisterPtr(u32 index);
 void ExecuteInstruction(u32 inst_bits);
 
 using InstructionImpl = void (*)(Instruction);
-InstructionImpl GetInstructionImpl(u32 inst_bits);
+InstructionImpl GetInstructionImpl(u32 inst_bits, bool force_scalar = false);
+
+// true if the SIMD transform/lighting kernels are usable on this CPU
+bool HasVectorKernels();
 
 } // namespace GTE
@@ -56,6 +56,11 @@ public:
   virtual bool InitializeRenderDevice(std::string_view shader_cache_directory, bool debug_device) = 0;
   virtual bool MakeRenderContextCurrent() = 0;
   virtual bool DoneRenderContextCurrent() = 0;
+
+  /// Returns false if the render context can't be handed to another thread with DoneRenderContextCurrent() and
+  /// MakeRenderContextCurrent(), e.g. when it is owned by the frontend.
+  virtual bool SupportsThreadedRendering() const;
+
   virtual void DestroyRenderDevice() = 0;
   virtual void DestroyRenderSurface() = 0;
   virtual bool ChangeRenderWindow(const WindowInfo& wi) = 0;
@@ -3,6 +3,7 @@
 #include "cdrom.h"
 #include "common/audio_stream.h"
 #include "common/byte_stream.h"
+#include "common/cd_image.h"
 #include "common/file_system.h"
 #include "common/image.h"
 #include "common/log.h"
@@ -17,6 +18,7 @@
 #include "pgxp.h"
 #include "save_state_version.h"
 #include "system.h"
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <cwchar>
@@ -38,6 +40,8 @@ HostInterface::HostInterface()
 
 HostInterface::~HostInterface()
 {
+  StopSaveStateWriteThread();
+
   // system should be shut down prior to the destructor
   Assert(System::IsShutdown() && !m_audio_stream && !m_display);
   Assert(g_host_interface == this);
@@ -49,7 +53,11 @@ bool HostInterface::Initialize()
   return true;
 }
 
-void HostInterface::Shutdown() {}
+void HostInterface::Shutdown()
+{
+  // make sure the resume state is on disk before we exit
+  StopSaveStateWriteThread();
+}
 
 void HostInterface::CreateAudioStream()
 {
@@ -280,6 +288,9 @@ std::optional<std::vector<u8>> HostInterface::GetBIOSImage(ConsoleRegion region)
 
 bool HostInterface::LoadState(const char* filename)
 {
+  // the state could still be on its way to the disk
+  WaitForSaveStateWrites();
+
   std::unique_ptr<ByteStream> stream = FileSystem::OpenFile(filename, BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
   if (!stream)
     return false;
@@ -309,25 +320,126 @@ bool HostInterface::LoadState(const char* filename)
 
 bool HostInterface::SaveState(const char* filename)
 {
+  // Only serializing has to happen on this thread, compressing and writing the ~4MB state can happen in the background.
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream_CreateGrowableMemoryStream();
+  if (!System::SaveState(stream.get()))
+  {
+    ReportFormattedError(TranslateString("OSDMessage", "Saving state to '%s' failed."), filename);
+    return false;
+  }
+
+  QueueSaveStateWrite(SaveStateWrite{filename, std::move(stream), g_settings.save_state_compression});
+  return true;
+}
+
+void HostInterface::QueueSaveStateWrite(SaveStateWrite write)
+{
+  std::unique_lock<std::mutex> lock(m_save_state_write_mutex);
+  if (!m_save_state_write_thread.joinable())
+  {
+    m_save_state_write_shutdown = false;
+    m_save_state_write_thread = std::thread(&HostInterface::SaveStateWriteThread, this);
+  }
+
+  // a newer state for the same file replaces one which hasn't been written yet
+  auto iter = std::find_if(m_save_state_write_queue.begin(), m_save_state_write_queue.end(),
+                           [&write](const SaveStateWrite& it) { return it.filename == write.filename; });
+  if (iter != m_save_state_write_queue.end())
+    *iter = std::move(write);
+  else
+    m_save_state_write_queue.push_back(std::move(write));
+
+  m_save_state_write_cv.notify_one();
+}
+
+void HostInterface::WaitForSaveStateWrites()
+{
+  std::unique_lock<std::mutex> lock(m_save_state_write_mutex);
+  m_save_state_write_done_cv.wait(lock,
+                                  [this]() { return m_save_state_write_queue.empty() && !m_save_state_write_busy; });
+}
+
+void HostInterface::StopSaveStateWriteThread()
+{
+  if (!m_save_state_write_thread.joinable())
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(m_save_state_write_mutex);
+    m_save_state_write_shutdown = true;
+    m_save_state_write_cv.notify_one();
+  }
+
+  m_save_state_write_thread.join();
+}
+
+void HostInterface::SaveStateWriteThread()
+{
+  std::unique_lock<std::mutex> lock(m_save_state_write_mutex);
+  for (;;)
+  {
+    // anything still queued is written before shutting down
+    m_save_state_write_cv.wait(lock,
+                               [this]() { return !m_save_state_write_queue.empty() || m_save_state_write_shutdown; });
+    if (m_save_state_write_queue.empty())
+      break;
+
+    SaveStateWrite write = std::move(m_save_state_write_queue.front());
+    m_save_state_write_queue.pop_front();
+    m_save_state_write_busy = true;
+    lock.unlock();
+
+    if (WriteSaveStateFile(write))
+    {
+      AddFormattedOSDMessage(5.0f, TranslateString("OSDMessage", "State saved to '%s'."), write.filename.c_str());
+    }
+    else
+    {
+      AddFormattedOSDMessage(15.0f, TranslateString("OSDMessage", "Saving state to '%s' failed."),
+                             write.filename.c_str());
+    }
+
+    lock.lock();
+    m_save_state_write_busy = false;
+    m_save_state_write_done_cv.notify_all();
+  }
+}
+
+bool HostInterface::WriteSaveStateFile(const SaveStateWrite& write)
+{
+  Common::Timer timer;
+
   std::unique_ptr<ByteStream> stream =
-    FileSystem::OpenFile(filename, BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
-                                     BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED);
+    FileSystem::OpenFile(write.filename.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE |
+                                                   BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_ATOMIC_UPDATE |
+                                                   BYTESTREAM_OPEN_STREAMED);
   if (!stream)
+  {
+    Log_ErrorPrintf("Failed to open '%s' for writing save state", write.filename.c_str());
     return false;
+  }
 
-  const bool result = System::SaveState(stream.get());
+  const u8* state_data = write.state->GetMemoryPointer();
+  const u32 state_size = static_cast<u32>(write.state->GetSize());
+  const bool result = write.compress ? System::CompressSaveState(state_data, state_size, stream.get()) :
+                                       stream->Write2(state_data, state_size);
   if (!result)
   {
-    ReportFormattedError(TranslateString("OSDMessage", "Saving state to '%s' failed."), filename);
+    Log_ErrorPrintf("Failed to write save state to '%s'", write.filename.c_str());
     stream->Discard();
+    return false;
   }
-  else
+
+  const u32 file_size = static_cast<u32>(stream->GetPosition());
+  if (!stream->Commit())
   {
-    AddFormattedOSDMessage(5.0f, TranslateString("OSDMessage", "State saved to '%s'."), filename);
-    stream->Commit();
+    Log_ErrorPrintf("Failed to commit save state to '%s'", write.filename.c_str());
+    return false;
   }
 
-  return result;
+  Log_InfoPrintf("Wrote %u byte save state (%u bytes uncompressed) to '%s' in %.2f ms", file_size, state_size,
+                 write.filename.c_str(), timer.GetTimeMilliseconds());
+  return true;
 }
 
 void HostInterface::OnSystemCreated() {}
@@ -356,17 +468,25 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetBoolValue("Main", "IncreaseTimerResolution", true);
   si.SetBoolValue("Main", "StartPaused", false);
   si.SetBoolValue("Main", "SaveStateOnExit", true);
+  si.SetBoolValue("Main", "CompressSaveStates", true);
   si.SetBoolValue("Main", "ConfirmPowerOff", true);
   si.SetBoolValue("Main", "LoadDevicesFromSaveStates", false);
   si.SetBoolValue("Main", "ApplyGameSettings", true);
+  si.SetBoolValue("Main", "RewindEnable", false);
+  si.SetIntValue("Main", "RewindSaveInterval", Settings::DEFAULT_REWIND_SAVE_INTERVAL);
+  si.SetIntValue("Main", "RewindMemoryBudgetMB", Settings::DEFAULT_REWIND_MEMORY_BUDGET_MB);
+  si.SetIntValue("Main", "RunaheadFrames", 0);
 
   si.SetStringValue("CPU", "ExecutionMode", Settings::GetCPUExecutionModeName(Settings::DEFAULT_CPU_EXECUTION_MODE));
   si.SetBoolValue("CPU", "RecompilerMemoryExceptions", false);
+  si.SetBoolValue("CPU", "Fastmem", true);
   si.SetBoolValue("CPU", "ICache", false);
 
   si.SetStringValue("GPU", "Renderer", Settings::GetRendererName(Settings::DEFAULT_GPU_RENDERER));
   si.SetIntValue("GPU", "ResolutionScale", 1);
   si.SetBoolValue("GPU", "UseDebugDevice", false);
+  si.SetBoolValue("GPU", "UseThread", true);
+  si.SetBoolValue("GPU", "UseHardwareThread", false);
   si.SetBoolValue("GPU", "TrueColor", false);
   si.SetBoolValue("GPU", "ScaledDithering", true);
   si.SetBoolValue("GPU", "TextureFiltering", false);
@@ -395,6 +515,8 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetBoolValue("Display", "VSync", true);
 
   si.SetBoolValue("CDROM", "ReadThread", true);
+  si.SetIntValue("CDROM", "ReadaheadSectors", Settings::DEFAULT_CDROM_READAHEAD_SECTORS);
+  si.SetIntValue("CDROM", "CHDCacheSizeMB", Settings::DEFAULT_CDROM_CHD_CACHE_SIZE_MB);
   si.SetBoolValue("CDROM", "RegionCheck", true);
   si.SetBoolValue("CDROM", "LoadImageToRAM", false);
 
@@ -440,9 +562,16 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetIntValue("Hacks", "GPUMaxRunAhead", static_cast<int>(Settings::DEFAULT_GPU_MAX_RUN_AHEAD));
 }
 
+// The hunk cache is used by the game list as well, so it's applied whether or not a system is running.
+static void UpdateCHDHunkCacheSize()
+{
+  CDImage::SetCHDHunkCacheSize(std::min(g_settings.cdrom_chd_cache_size_mb, 2048u) * 1048576u);
+}
+
 void HostInterface::LoadSettings(SettingsInterface& si)
 {
   g_settings.Load(si);
+  UpdateCHDHunkCacheSize();
 }
 
 void HostInterface::FixIncompatibleSettings(bool display_osd_messages)
@@ -458,17 +587,6 @@ void HostInterface::FixIncompatibleSettings(bool display_osd_messages)
       }
       g_settings.gpu_pgxp_enable = false;
     }
-    else if (g_settings.gpu_pgxp_cpu && g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler)
-    {
-      if (display_osd_messages)
-      {
-        AddOSDMessage(
-          TranslateStdString("OSDMessage",
-                             "PGXP CPU mode is incompatible with the recompiler, using Cached Interpreter instead."),
-          10.0f);
-      }
-      g_settings.cpu_execution_mode = CPUExecutionMode::CachedInterpreter;
-    }
   }
 }
 
@@ -481,6 +599,9 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
 {
   if (System::IsValid())
   {
+    // the run-ahead snapshot was taken with the old settings
+    System::RollbackRunahead();
+
     if (g_settings.gpu_renderer != old_settings.gpu_renderer ||
         g_settings.gpu_use_debug_device != old_settings.gpu_use_debug_device)
     {
@@ -511,7 +632,8 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
     {
       AddFormattedOSDMessage(5.0f, "Switching to %s CPU execution mode.",
                              Settings::GetCPUExecutionModeName(g_settings.cpu_execution_mode));
-      CPU::CodeCache::SetUseRecompiler(g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler);
+      CPU::CodeCache::SetUseRecompiler(g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler,
+                                       g_settings.IsUsingFastmem());
       CPU::CodeCache::Flush();
       CPU::ClearICache();
     }
@@ -521,6 +643,16 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
     {
       AddFormattedOSDMessage(5.0f, "CPU memory exceptions %s, flushing all blocks.",
                              g_settings.cpu_recompiler_memory_exceptions ? "enabled" : "disabled");
+      CPU::CodeCache::SetUseRecompiler(true, g_settings.IsUsingFastmem());
+      CPU::CodeCache::Flush();
+    }
+
+    if (g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler &&
+        g_settings.cpu_fastmem != old_settings.cpu_fastmem)
+    {
+      AddFormattedOSDMessage(5.0f, "CPU fastmem %s, flushing all blocks.",
+                             g_settings.cpu_fastmem ? "enabled" : "disabled");
+      CPU::CodeCache::SetUseRecompiler(true, g_settings.IsUsingFastmem());
       CPU::CodeCache::Flush();
     }
 
@@ -533,11 +665,29 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
       CPU::ClearICache();
     }
 
+    if (g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler &&
+        g_settings.cpu_recompiler_traces != old_settings.cpu_recompiler_traces)
+    {
+      AddFormattedOSDMessage(5.0f, "CPU recompiler traces %s, flushing all blocks.",
+                             g_settings.cpu_recompiler_traces ? "enabled" : "disabled");
+      CPU::CodeCache::Flush();
+    }
+
+    if (g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler &&
+        g_settings.cpu_recompiler_tiering != old_settings.cpu_recompiler_tiering)
+    {
+      AddFormattedOSDMessage(5.0f, "CPU recompiler tiering %s, flushing all blocks.",
+                             g_settings.cpu_recompiler_tiering ? "enabled" : "disabled");
+      CPU::CodeCache::Flush();
+    }
+
     m_audio_stream->SetOutputVolume(g_settings.audio_output_muted ? 0 : g_settings.audio_output_volume);
 
     if (g_settings.gpu_resolution_scale != old_settings.gpu_resolution_scale ||
         g_settings.gpu_fifo_size != old_settings.gpu_fifo_size ||
         g_settings.gpu_max_run_ahead != old_settings.gpu_max_run_ahead ||
+        g_settings.gpu_use_thread != old_settings.gpu_use_thread ||
+        g_settings.gpu_use_hw_thread != old_settings.gpu_use_hw_thread ||
         g_settings.gpu_true_color != old_settings.gpu_true_color ||
         g_settings.gpu_scaled_dithering != old_settings.gpu_scaled_dithering ||
         g_settings.gpu_texture_filtering != old_settings.gpu_texture_filtering ||
@@ -565,10 +715,24 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
       if (g_settings.gpu_pgxp_enable)
         PGXP::Initialize();
     }
+    else if (g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_cpu != old_settings.gpu_pgxp_cpu)
+    {
+      if (g_settings.IsUsingRecompiler())
+      {
+        AddFormattedOSDMessage(5.0f, "PGXP CPU mode %s, recompiling all blocks.",
+                               g_settings.gpu_pgxp_cpu ? "enabled" : "disabled");
+        CPU::CodeCache::Flush();
+      }
+
+      PGXP::Initialize();
+    }
 
     if (g_settings.cdrom_read_thread != old_settings.cdrom_read_thread)
       g_cdrom.SetUseReadThread(g_settings.cdrom_read_thread);
 
+    if (g_settings.cdrom_readahead_sectors != old_settings.cdrom_readahead_sectors)
+      g_cdrom.SetReadaheadSectors(g_settings.cdrom_readahead_sectors);
+
     if (g_settings.memory_card_types != old_settings.memory_card_types ||
         g_settings.memory_card_paths != old_settings.memory_card_paths ||
         (g_settings.memory_card_use_playlist_title != old_settings.memory_card_use_playlist_title &&
@@ -579,8 +743,18 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
 
     g_dma.SetMaxSliceTicks(g_settings.dma_max_slice_ticks);
     g_dma.SetHaltTicks(g_settings.dma_halt_ticks);
+
+    if (g_settings.rewind_enable != old_settings.rewind_enable ||
+        g_settings.rewind_save_interval != old_settings.rewind_save_interval ||
+        g_settings.rewind_memory_budget_mb != old_settings.rewind_memory_budget_mb)
+    {
+      System::UpdateRewindSettings();
+    }
   }
 
+  if (g_settings.cdrom_chd_cache_size_mb != old_settings.cdrom_chd_cache_size_mb)
+    UpdateCHDHunkCacheSize();
+
   bool controllers_updated = false;
   for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
   {
@@ -4,12 +4,14 @@
 #include "settings.h"
 #include "types.h"
 #include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 enum LOGLEVEL;
@@ -17,6 +19,7 @@ enum LOGLEVEL;
 class AudioStream;
 class ByteStream;
 class CDImage;
+class GrowableMemoryByteStream;
 class HostDisplay;
 class GameList;
 
@@ -159,13 +162,39 @@ protected:
   /// Updates software cursor state, based on controllers.
   void UpdateSoftwareCursor();
 
+  /// Serializes the state, then compresses and writes it to the file on the save state writer thread.
   bool SaveState(const char* filename);
+
+  /// Blocks until all queued save states have been written to disk.
+  void WaitForSaveStateWrites();
+
   void CreateAudioStream();
 
   std::unique_ptr<HostDisplay> m_display;
   std::unique_ptr<AudioStream> m_audio_stream;
   std::string m_program_directory;
   std::string m_user_directory;
+
+private:
+  struct SaveStateWrite
+  {
+    std::string filename;
+    std::unique_ptr<GrowableMemoryByteStream> state;
+    bool compress;
+  };
+
+  void QueueSaveStateWrite(SaveStateWrite write);
+  void StopSaveStateWriteThread();
+  void SaveStateWriteThread();
+  bool WriteSaveStateFile(const SaveStateWrite& write);
+
+  std::thread m_save_state_write_thread;
+  std::mutex m_save_state_write_mutex;
+  std::condition_variable m_save_state_write_cv;
+  std::condition_variable m_save_state_write_done_cv;
+  std::deque<SaveStateWrite> m_save_state_write_queue;
+  bool m_save_state_write_busy = false;
+  bool m_save_state_write_shutdown = false;
 };
 
 #define TRANSLATABLE(context, str) str
@@ -4,6 +4,7 @@
 #include "cpu_core.h"
 #include "dma.h"
 #include "interrupt_controller.h"
+#include "subsystem_timing.h"
 #include "system.h"
 #include <imgui.h>
 Log_SetChannel(MDEC);
@@ -16,8 +17,10 @@ MDEC::~MDEC() = default;
 
 void MDEC::Initialize()
 {
-  m_block_copy_out_event = TimingEvents::CreateTimingEvent("MDEC Block Copy Out", TICKS_PER_BLOCK, TICKS_PER_BLOCK,
-                                                           std::bind(&MDEC::CopyOutBlock, this), false);
+  m_block_copy_out_event = TimingEvents::CreateTimingEvent(
+    "MDEC Block Copy Out", TICKS_PER_BLOCK, TICKS_PER_BLOCK,
+    [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<MDEC*>(param)->CopyOutBlock(); }, this,
+    false);
   m_total_blocks_decoded = 0;
   Reset();
 }
@@ -114,6 +117,8 @@ void MDEC::WriteRegister(u32 offset, u32 value)
 
 void MDEC::DMARead(u32* words, u32 word_count)
 {
+  SubsystemTiming::ScopedTimer subsystem_timer(SubsystemTiming::Subsystem::MDEC);
+
   if (m_data_out_fifo.GetSize() < word_count)
   {
     Log_WarningPrintf("Insufficient data in output FIFO (requested %u, have %u)", word_count,
@@ -231,6 +236,8 @@ void MDEC::WriteCommandRegister(u32 value)
 
 void MDEC::Execute()
 {
+  SubsystemTiming::ScopedTimer subsystem_timer(SubsystemTiming::Subsystem::MDEC);
+
   for (;;)
   {
     switch (m_state)
@@ -412,6 +419,8 @@ void MDEC::ScheduleBlockCopyOut(TickCount ticks)
 
 void MDEC::CopyOutBlock()
 {
+  SubsystemTiming::ScopedTimer subsystem_timer(SubsystemTiming::Subsystem::MDEC);
+
   Assert(m_state == State::WritingMacroblock);
   m_block_copy_out_event->Deactivate();
 
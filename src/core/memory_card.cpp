@@ -15,7 +15,10 @@ MemoryCard::MemoryCard()
 
   m_save_event =
     TimingEvents::CreateTimingEvent("Memory Card Host Flush", SAVE_DELAY_IN_SYSCLK_TICKS, SAVE_DELAY_IN_SYSCLK_TICKS,
-                                    std::bind(&MemoryCard::SaveIfChanged, this, true), false);
+                                    [](void* param, TickCount ticks, TickCount ticks_late) {
+                                      static_cast<MemoryCard*>(param)->SaveIfChanged(true);
+                                    },
+                                    this, false);
 }
 
 MemoryCard::~MemoryCard()
@@ -46,6 +46,12 @@ bool NamcoGunCon::DoState(StateWrapper& sw)
   return true;
 }
 
+bool NamcoGunCon::DoInputState(StateWrapper& sw)
+{
+  sw.Do(&m_button_state);
+  return !sw.HasError();
+}
+
 void NamcoGunCon::SetAxisState(s32 axis_code, float value) {}
 
 void NamcoGunCon::SetButtonState(Button button, bool pressed)
@@ -32,6 +32,7 @@ public:
 
   void Reset() override;
   bool DoState(StateWrapper& sw) override;
+  bool DoInputState(StateWrapper& sw) override;
   void LoadSettings(const char* section) override;
   bool GetSoftwareCursor(const Common::RGBA8Image** image, float* image_scale) override;
 
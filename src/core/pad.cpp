@@ -17,7 +17,9 @@ Pad::~Pad() = default;
 void Pad::Initialize()
 {
   m_transfer_event = TimingEvents::CreateTimingEvent(
-    "Pad Serial Transfer", 1, 1, std::bind(&Pad::TransferEvent, this, std::placeholders::_2), false);
+    "Pad Serial Transfer", 1, 1,
+    [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<Pad*>(param)->TransferEvent(ticks_late); },
+    this, false);
   Reset();
 }
 
@@ -147,6 +149,17 @@ bool Pad::DoState(StateWrapper& sw)
   return !sw.HasError();
 }
 
+bool Pad::DoInputState(StateWrapper& sw)
+{
+  for (u32 i = 0; i < NUM_SLOTS; i++)
+  {
+    if (m_controllers[i] && !m_controllers[i]->DoInputState(sw))
+      return false;
+  }
+
+  return !sw.HasError();
+}
+
 void Pad::SetController(u32 slot, std::unique_ptr<Controller> dev)
 {
   m_controllers[slot] = std::move(dev);
@@ -22,6 +22,9 @@ public:
   void Reset();
   bool DoState(StateWrapper& sw);
 
+  /// Saves/loads the host input of the connected controllers, see Controller::DoInputState().
+  bool DoInputState(StateWrapper& sw);
+
   Controller* GetController(u32 slot) const { return m_controllers[slot].get(); }
   void SetController(u32 slot, std::unique_ptr<Controller> dev);
 
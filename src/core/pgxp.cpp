@@ -20,8 +20,10 @@
 
 #include "pgxp.h"
 #include "settings.h"
+#include <array>
 #include <cmath>
 #include <climits>
+#include <memory>
 
 namespace PGXP {
 // pgxp_types.h
@@ -97,6 +99,7 @@ typedef enum
 
 static const PGXP_value PGXP_value_invalid_address = {0.f, 0.f, 0.f, {0}, 0, 0, INVALID_ADDRESS, 0, 0};
 static const PGXP_value PGXP_value_zero = {0.f, 0.f, 0.f, {0}, 0, VALID_ALL, 0, 0, 0};
+static const PGXP_value PGXP_value_unwritten = {0.f, 0.f, 0.f, {0}, 0, 0, 0, 0, 0};
 
 static void MakeValid(PGXP_value* pV, u32 psxV);
 static void Validate(PGXP_value* pV, u32 psxV);
@@ -124,8 +127,9 @@ typedef union
 
 // pgxp_mem.h
 static u32 PGXP_ConvertAddress(u32 addr);
+static PGXP_value* LookupMem(u32 paddr);
 static PGXP_value* GetPtr(u32 addr);
-static PGXP_value* ReadMem(u32 addr);
+static const PGXP_value* ReadMem(u32 addr);
 
 static void ValidateAndCopyMem(PGXP_value* dest, u32 addr, u32 value);
 static void ValidateAndCopyMem16(PGXP_value* dest, u32 addr, u32 value, int sign);
@@ -134,6 +138,7 @@ static void WriteMem(PGXP_value* value, u32 addr);
 static void WriteMem16(PGXP_value* src, u32 addr);
 
 // pgxp_gpu.h
+static void PGXP_InitVertexCache();
 void PGXP_CacheVertex(short sx, short sy, const PGXP_value* _pVertex);
 
 // pgxp_gte.h
@@ -195,15 +200,24 @@ double f16Overflow(double in)
 
 // pgxp_mem.c
 static void PGXP_InitMem();
-static PGXP_value Mem[3 * 2048 * 1024 / 4]; // mirror 2MB in 32-bit words * 3
+
+// Shadow values for 2MB RAM, 1KB scratchpad and the 60KB of I/O registers, in 32-bit words. Pages are only allocated
+// once something is written to them, until then they read as PGXP_value_unwritten, which has nothing valid.
 static const u32 UserMemOffset = 0;
 static const u32 ScratchOffset = 2048 * 1024 / 4;
-static const u32 RegisterOffset = 2 * 2048 * 1024 / 4;
-static const u32 InvalidAddress = 3 * 2048 * 1024 / 4;
+static const u32 RegisterOffset = ScratchOffset + 1024 / 4;
+static const u32 InvalidAddress = RegisterOffset + (0x10000 - 0x1000) / 4;
+
+static const u32 MemPageShift = 10;
+static const u32 MemPageSize = 1u << MemPageShift;
+static const u32 MemPageMask = MemPageSize - 1;
+static const u32 MemPageCount = (InvalidAddress + MemPageMask) >> MemPageShift;
+static std::array<std::unique_ptr<PGXP_value[]>, MemPageCount> MemPages;
 
 void PGXP_InitMem()
 {
-  memset(Mem, 0, sizeof(Mem));
+  for (std::unique_ptr<PGXP_value[]>& page : MemPages)
+    page.reset();
 }
 
 u32 PGXP_ConvertAddress(u32 addr)
@@ -221,7 +235,13 @@ u32 PGXP_ConvertAddress(u32 addr)
     default:
       if ((paddr >> 20) == 0x1f8)
       {
-        if (paddr >= 0x1f801000)
+        if (paddr >= 0x1f801000 && (paddr & 0xFFFF) < 0x1000)
+        {
+          // 0x1F8x0000-0x1F8x0FFF mirrors of the scratchpad aren't tracked
+          paddr = InvalidAddress;
+          break;
+        }
+        else if (paddr >= 0x1f801000)
         {
           //	paddr = ((paddr & 0xFFFF) - 0x1000);
           //	paddr = (paddr % 0x2000) >> 2;
@@ -249,27 +269,53 @@ u32 PGXP_ConvertAddress(u32 addr)
   return paddr;
 }
 
+// Returns NULL if the page hasn't been written to yet.
+PGXP_value* LookupMem(u32 paddr)
+{
+  PGXP_value* page = MemPages[paddr >> MemPageShift].get();
+  return page ? &page[paddr & MemPageMask] : NULL;
+}
+
+// For writes, allocates the page if needed.
 PGXP_value* GetPtr(u32 addr)
 {
   addr = PGXP_ConvertAddress(addr);
+  if (addr == InvalidAddress)
+    return NULL;
 
-  if (addr != InvalidAddress)
-    return &Mem[addr];
-  return NULL;
+  std::unique_ptr<PGXP_value[]>& page = MemPages[addr >> MemPageShift];
+  if (!page)
+    page = std::make_unique<PGXP_value[]>(MemPageSize);
+
+  return &page[addr & MemPageMask];
 }
 
-PGXP_value* ReadMem(u32 addr)
+const PGXP_value* ReadMem(u32 addr)
 {
-  return GetPtr(addr);
+  addr = PGXP_ConvertAddress(addr);
+  if (addr == InvalidAddress)
+    return NULL;
+
+  const PGXP_value* pMem = LookupMem(addr);
+  return pMem ? pMem : &PGXP_value_unwritten;
 }
 
 void ValidateAndCopyMem(PGXP_value* dest, u32 addr, u32 value)
 {
-  PGXP_value* pMem = GetPtr(addr);
-  if (pMem != NULL)
+  const u32 paddr = PGXP_ConvertAddress(addr);
+  if (paddr != InvalidAddress)
   {
-    Validate(pMem, value);
-    *dest = *pMem;
+    // unwritten values have nothing to invalidate
+    PGXP_value* pMem = LookupMem(paddr);
+    if (pMem)
+    {
+      Validate(pMem, value);
+      *dest = *pMem;
+    }
+    else
+    {
+      *dest = PGXP_value_unwritten;
+    }
     return;
   }
 
@@ -280,8 +326,8 @@ void ValidateAndCopyMem16(PGXP_value* dest, u32 addr, u32 value, int sign)
 {
   u32 validMask = 0;
   psx_value val, mask;
-  PGXP_value* pMem = GetPtr(addr);
-  if (pMem != NULL)
+  const u32 paddr = PGXP_ConvertAddress(addr);
+  if (paddr != InvalidAddress)
   {
     mask.d = val.d = 0;
     // determine if high or low word
@@ -299,8 +345,16 @@ void ValidateAndCopyMem16(PGXP_value* dest, u32 addr, u32 value, int sign)
     }
 
     // validate and copy whole value
-    MaskValidate(pMem, val.d, mask.d, validMask);
-    *dest = *pMem;
+    PGXP_value* pMem = LookupMem(paddr);
+    if (pMem)
+    {
+      MaskValidate(pMem, val.d, mask.d, validMask);
+      *dest = *pMem;
+    }
+    else
+    {
+      *dest = PGXP_value_unwritten;
+    }
 
     // if high word then shift
     if ((addr % 4) == 2)
@@ -373,6 +427,7 @@ void Initialize()
   PGXP_InitMem();
   PGXP_InitCPU();
   PGXP_InitGTE();
+  PGXP_InitVertexCache();
 }
 
 void PGXP_SetModes(u32 modes)
@@ -589,12 +644,55 @@ const unsigned int mode_write = 1;
 const unsigned int mode_read = 2;
 const unsigned int mode_fail = 3;
 
-PGXP_value vertexCache[0x800 * 2][0x800 * 2];
+// Only a few thousand distinct screen positions are used per frame, so rather than covering the whole 4096x4096
+// coordinate space, entries are kept in a fixed-size hash table. When every slot a position can probe is taken, the
+// first one is replaced. Entries are tagged with the generation they were written in, so clearing is a counter bump.
+struct VertexCacheEntry
+{
+  u32 key;
+  u32 generation;
+  float x;
+  float y;
+  float z;
+};
+
+static constexpr u32 VERTEX_CACHE_SIZE_BITS = 16;
+static constexpr u32 VERTEX_CACHE_SIZE = 1u << VERTEX_CACHE_SIZE_BITS;
+static constexpr u32 VERTEX_CACHE_MAX_PROBES = 8;
+
+static VertexCacheEntry vertexCache[VERTEX_CACHE_SIZE];
+static u32 vertexCacheGeneration = 1;
 
 unsigned int baseID = 0;
 unsigned int lastID = 0;
 unsigned int cacheMode = 0;
 
+void PGXP_InitVertexCache()
+{
+  cacheMode = mode_init;
+}
+
+static void ClearVertexCache()
+{
+  // generation zero is never current, so a wrapped counter needs the stale tags wiped
+  if (++vertexCacheGeneration == 0)
+  {
+    memset(vertexCache, 0x00, sizeof(vertexCache));
+    vertexCacheGeneration = 1;
+  }
+}
+
+ALWAYS_INLINE static u32 GetVertexCacheKey(short sx, short sy)
+{
+  return ZeroExtend32(static_cast<u16>(sx)) | (ZeroExtend32(static_cast<u16>(sy)) << 16);
+}
+
+ALWAYS_INLINE static u32 GetVertexCacheSlot(u32 key)
+{
+  // fibonacci hashing, neighbouring positions end up far apart
+  return (key * UINT32_C(0x9E3779B1)) >> (32 - VERTEX_CACHE_SIZE_BITS);
+}
+
 unsigned int IsSessionID(unsigned int vertID)
 {
   // No wrapping
@@ -615,7 +713,6 @@ unsigned int IsSessionID(unsigned int vertID)
 void PGXP_CacheVertex(short sx, short sy, const PGXP_value* _pVertex)
 {
   const PGXP_value* pNewVertex = (const PGXP_value*)_pVertex;
-  PGXP_value* pOldVertex = NULL;
 
   if (!pNewVertex)
   {
@@ -629,7 +726,7 @@ void PGXP_CacheVertex(short sx, short sy, const PGXP_value* _pVertex)
     {
       // Initialise cache on first use
       if (cacheMode == mode_init)
-        memset(vertexCache, 0x00, sizeof(vertexCache));
+        ClearVertexCache();
 
       // First vertex of write session (frame?)
       cacheMode = mode_write;
@@ -640,29 +737,30 @@ void PGXP_CacheVertex(short sx, short sy, const PGXP_value* _pVertex)
 
     if (sx >= -0x800 && sx <= 0x7ff && sy >= -0x800 && sy <= 0x7ff)
     {
-      pOldVertex = &vertexCache[sy + 0x800][sx + 0x800];
-
-      // To avoid ambiguity there can only be one valid entry per-session
-      if (0) //(IsSessionID(pOldVertex->count) && (pOldVertex->value == pNewVertex->value))
+      const u32 key = GetVertexCacheKey(sx, sy);
+      const u32 home_slot = GetVertexCacheSlot(key);
+      VertexCacheEntry* entry = &vertexCache[home_slot];
+      for (u32 i = 0; i < VERTEX_CACHE_MAX_PROBES; i++)
       {
-        // check to ensure this isn't identical
-        if ((fabsf(pOldVertex->x - pNewVertex->x) > 0.1f) || (fabsf(pOldVertex->y - pNewVertex->y) > 0.1f) ||
-            (fabsf(pOldVertex->z - pNewVertex->z) > 0.1f))
+        VertexCacheEntry* probe = &vertexCache[(home_slot + i) & (VERTEX_CACHE_SIZE - 1)];
+        if (probe->generation != vertexCacheGeneration || probe->key == key)
         {
-          *pOldVertex = *pNewVertex;
-          pOldVertex->gFlags = 5;
-          return;
+          entry = probe;
+          break;
         }
       }
 
       // Write vertex into cache
-      *pOldVertex = *pNewVertex;
-      pOldVertex->gFlags = 1;
+      entry->key = key;
+      entry->generation = vertexCacheGeneration;
+      entry->x = pNewVertex->x;
+      entry->y = pNewVertex->y;
+      entry->z = pNewVertex->z;
     }
   }
 }
 
-PGXP_value* PGXP_GetCachedVertex(short sx, short sy)
+static const VertexCacheEntry* PGXP_GetCachedVertex(short sx, short sy)
 {
   // if (bGteAccuracy)
   {
@@ -673,7 +771,7 @@ PGXP_value* PGXP_GetCachedVertex(short sx, short sy)
 
       // Initialise cache on first use
       if (cacheMode == mode_init)
-        memset(vertexCache, 0x00, sizeof(vertexCache));
+        ClearVertexCache();
 
       // First vertex of read session (frame?)
       cacheMode = mode_read;
@@ -681,8 +779,16 @@ PGXP_value* PGXP_GetCachedVertex(short sx, short sy)
 
     if (sx >= -0x800 && sx <= 0x7ff && sy >= -0x800 && sy <= 0x7ff)
     {
-      // Return pointer to cache entry
-      return &vertexCache[sy + 0x800][sx + 0x800];
+      const u32 key = GetVertexCacheKey(sx, sy);
+      const u32 home_slot = GetVertexCacheSlot(key);
+      for (u32 i = 0; i < VERTEX_CACHE_MAX_PROBES; i++)
+      {
+        const VertexCacheEntry* entry = &vertexCache[(home_slot + i) & (VERTEX_CACHE_SIZE - 1)];
+        if (entry->generation != vertexCacheGeneration)
+          break;
+        if (entry->key == key)
+          return entry;
+      }
     }
   }
 
@@ -715,14 +821,14 @@ bool GetPreciseVertex(u32 addr, u32 value, int x, int y, int xOffs, int yOffs, f
     const short psx_y = (short)(value >> 16);
 
     // Look in cache for valid vertex
-    vert = PGXP_GetCachedVertex(psx_x, psx_y);
-    if ((vert) && /*(IsSessionID(vert->count)) &&*/ (vert->gFlags == 1))
+    const VertexCacheEntry* cached_vert = PGXP_GetCachedVertex(psx_x, psx_y);
+    if (cached_vert)
     {
       // a value is found, it is from the current session and is unambiguous (there was only one value recorded at that
       // position)
-      *out_x = TruncateVertexPosition(vert->x) + static_cast<float>(xOffs);
-      *out_y = TruncateVertexPosition(vert->y) + static_cast<float>(yOffs);
-      *out_w = vert->z / 32768.0f;
+      *out_x = TruncateVertexPosition(cached_vert->x) + static_cast<float>(xOffs);
+      *out_y = TruncateVertexPosition(cached_vert->y) + static_cast<float>(yOffs);
+      *out_w = cached_vert->z / 32768.0f;
       return false; // iCB: Getting the wrong w component causes too great an error when using perspective correction
                     // so disable it
     }
@@ -758,7 +864,7 @@ void PGXP_InitCPU()
 static void InvalidLoad(u32 addr, u32 code, u32 value)
 {
   u32 reg = ((code >> 16) & 0x1F); // The rt part of the instruction register
-  PGXP_value* pD = NULL;
+  const PGXP_value* pD = NULL;
   PGXP_value p;
 
   p.x = p.y = -1337; // default values
@@ -787,7 +893,7 @@ static void InvalidLoad(u32 addr, u32 code, u32 value)
 static void InvalidStore(u32 addr, u32 code, u32 value)
 {
   u32 reg = ((code >> 16) & 0x1F); // The rt part of the instruction register
-  PGXP_value* pD = NULL;
+  const PGXP_value* pD = NULL;
   PGXP_value p;
 
   pD = ReadMem(addr);
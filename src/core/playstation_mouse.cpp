@@ -49,6 +49,12 @@ bool PlayStationMouse::DoState(StateWrapper& sw)
   return true;
 }
 
+bool PlayStationMouse::DoInputState(StateWrapper& sw)
+{
+  sw.Do(&m_button_state);
+  return !sw.HasError();
+}
+
 void PlayStationMouse::SetAxisState(s32 axis_code, float value) {}
 
 void PlayStationMouse::SetButtonState(Button button, bool pressed)
@@ -0,0 +1,239 @@
+#include "rewind_buffer.h"
+#include "common/log.h"
+#include <algorithm>
+#include <zlib.h>
+Log_SetChannel(RewindBuffer);
+
+RewindBuffer::RewindBuffer()
+{
+  m_worker_thread = std::thread(&RewindBuffer::WorkerThread, this);
+}
+
+RewindBuffer::~RewindBuffer()
+{
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_shutdown = true;
+    m_queue.clear();
+    m_work_cv.notify_one();
+  }
+
+  m_worker_thread.join();
+}
+
+u32 RewindBuffer::GetSnapshotCount()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  const u32 stored_count = m_has_newest ? (static_cast<u32>(m_deltas.size()) + 1) : 0;
+  return stored_count + static_cast<u32>(m_queue.size()) + (m_worker_busy ? 1 : 0);
+}
+
+u64 RewindBuffer::GetMemoryUsage()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  return m_delta_memory_usage + (m_has_newest ? m_newest.size() : 0);
+}
+
+void RewindBuffer::SetMemoryBudget(u64 budget)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  WaitForWorker(lock);
+  m_memory_budget = budget;
+  EnforceMemoryBudget();
+}
+
+std::vector<u8> RewindBuffer::AllocateSnapshot()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_free_buffers.empty())
+    return {};
+
+  std::vector<u8> buffer = std::move(m_free_buffers.back());
+  m_free_buffers.pop_back();
+  return buffer;
+}
+
+void RewindBuffer::PushSnapshot(std::vector<u8> snapshot)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_queue.push_back(std::move(snapshot));
+  m_work_cv.notify_one();
+}
+
+bool RewindBuffer::PopSnapshot(std::vector<u8>* snapshot)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  WaitForWorker(lock);
+  if (!m_has_newest)
+    return false;
+
+  if (m_deltas.empty())
+  {
+    snapshot->assign(m_newest.begin(), m_newest.end());
+    return true;
+  }
+
+  std::vector<u8> older;
+  if (!m_free_buffers.empty())
+  {
+    older = std::move(m_free_buffers.back());
+    m_free_buffers.pop_back();
+  }
+
+  if (!DecodeDelta(m_deltas.back(), m_newest, &older))
+  {
+    // can't go back any further than this
+    Log_ErrorPrintf("Failed to decode rewind snapshot, dropping %u older snapshots",
+                    static_cast<u32>(m_deltas.size()));
+    m_deltas.clear();
+    m_delta_memory_usage = 0;
+    snapshot->assign(m_newest.begin(), m_newest.end());
+    return true;
+  }
+
+  m_delta_memory_usage -= m_deltas.back().compressed_data.size();
+  m_deltas.pop_back();
+
+  ReleaseBuffer(std::move(*snapshot));
+  *snapshot = std::move(m_newest);
+  m_newest = std::move(older);
+  return true;
+}
+
+void RewindBuffer::Flush()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  WaitForWorker(lock);
+}
+
+void RewindBuffer::Clear()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_queue.clear();
+  WaitForWorker(lock);
+
+  m_deltas.clear();
+  m_delta_memory_usage = 0;
+  if (m_has_newest)
+  {
+    ReleaseBuffer(std::move(m_newest));
+    m_newest = {};
+    m_has_newest = false;
+  }
+}
+
+void RewindBuffer::WaitForWorker(std::unique_lock<std::mutex>& lock)
+{
+  m_done_cv.wait(lock, [this]() { return m_queue.empty() && !m_worker_busy; });
+}
+
+void RewindBuffer::ReleaseBuffer(std::vector<u8> buffer)
+{
+  if (m_free_buffers.size() < MAX_FREE_BUFFERS)
+    m_free_buffers.push_back(std::move(buffer));
+}
+
+void RewindBuffer::EnforceMemoryBudget()
+{
+  const u64 newest_size = m_has_newest ? m_newest.size() : 0;
+  while (!m_deltas.empty() && (m_delta_memory_usage + newest_size) > m_memory_budget)
+  {
+    m_delta_memory_usage -= m_deltas.front().compressed_data.size();
+    m_deltas.pop_front();
+  }
+}
+
+void RewindBuffer::WorkerThread()
+{
+  std::vector<u8> scratch;
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;)
+  {
+    m_work_cv.wait(lock, [this]() { return !m_queue.empty() || m_shutdown; });
+    if (m_shutdown)
+      break;
+
+    std::vector<u8> snapshot = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_worker_busy = true;
+
+    // nothing else touches the stored snapshots while we're busy
+    if (m_has_newest)
+    {
+      lock.unlock();
+      DeltaSnapshot delta;
+      const bool encoded = EncodeDelta(m_newest, snapshot, &scratch, &delta);
+      lock.lock();
+
+      if (encoded)
+      {
+        m_delta_memory_usage += delta.compressed_data.size();
+        m_deltas.push_back(std::move(delta));
+      }
+      else
+      {
+        Log_ErrorPrintf("Failed to encode rewind snapshot, dropping %u older snapshots",
+                        static_cast<u32>(m_deltas.size()));
+        m_deltas.clear();
+        m_delta_memory_usage = 0;
+      }
+
+      ReleaseBuffer(std::move(m_newest));
+    }
+
+    m_newest = std::move(snapshot);
+    m_has_newest = true;
+    EnforceMemoryBudget();
+
+    m_worker_busy = false;
+    m_done_cv.notify_all();
+  }
+}
+
+bool RewindBuffer::EncodeDelta(const std::vector<u8>& older, const std::vector<u8>& newer, std::vector<u8>* scratch,
+                               DeltaSnapshot* delta)
+{
+  // the state size can change slightly, anything past the end of the newer snapshot is stored as-is
+  const size_t size = older.size();
+  const size_t common_size = std::min(size, newer.size());
+  scratch->resize(size);
+  for (size_t i = 0; i < common_size; i++)
+    (*scratch)[i] = older[i] ^ newer[i];
+  std::copy(older.begin() + common_size, older.end(), scratch->begin() + common_size);
+
+  uLongf compressed_size = compressBound(static_cast<uLong>(size));
+  delta->compressed_data.resize(compressed_size);
+  const int err = compress2(delta->compressed_data.data(), &compressed_size, scratch->data(),
+                            static_cast<uLong>(size), Z_BEST_SPEED);
+  if (err != Z_OK)
+  {
+    Log_ErrorPrintf("compress2() failed: %d", err);
+    return false;
+  }
+
+  delta->compressed_data.resize(compressed_size);
+  delta->compressed_data.shrink_to_fit();
+  delta->size = static_cast<u32>(size);
+  return true;
+}
+
+bool RewindBuffer::DecodeDelta(const DeltaSnapshot& delta, const std::vector<u8>& newer, std::vector<u8>* older)
+{
+  older->resize(delta.size);
+
+  uLongf size = static_cast<uLongf>(delta.size);
+  const int err = uncompress(older->data(), &size, delta.compressed_data.data(),
+                             static_cast<uLong>(delta.compressed_data.size()));
+  if (err != Z_OK || size != delta.size)
+  {
+    Log_ErrorPrintf("uncompress() failed: %d", err);
+    return false;
+  }
+
+  const size_t common_size = std::min<size_t>(delta.size, newer.size());
+  for (size_t i = 0; i < common_size; i++)
+    (*older)[i] ^= newer[i];
+
+  return true;
+}
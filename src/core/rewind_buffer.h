@@ -0,0 +1,78 @@
+#pragma once
+#include "types.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Snapshots of the system state for rewinding. The newest snapshot is kept as-is, and each older snapshot is stored as
+/// the compressed XOR of itself and the snapshot after it. Little changes between snapshots, so the XOR is mostly zeros
+/// and compresses to a fraction of a full state. Encoding happens on a worker thread, so capturing only costs the time
+/// to serialize the state.
+class RewindBuffer
+{
+public:
+  RewindBuffer();
+  ~RewindBuffer();
+
+  /// Number of snapshots which can be rewound to, including any still being encoded.
+  u32 GetSnapshotCount();
+
+  /// Memory used by the stored snapshots, in bytes.
+  u64 GetMemoryUsage();
+
+  /// Older snapshots are dropped when the stored snapshots use more than this many bytes.
+  void SetMemoryBudget(u64 budget);
+
+  /// Returns a buffer to serialize the next snapshot into. Reuses the memory of previous snapshots where possible.
+  std::vector<u8> AllocateSnapshot();
+
+  /// Queues a snapshot to be encoded against the previous one.
+  void PushSnapshot(std::vector<u8> snapshot);
+
+  /// Returns the newest snapshot and makes the one before it the newest. The oldest snapshot is never removed, so
+  /// rewinding stops there. The previous contents of snapshot are reused. Returns false if there are no snapshots.
+  bool PopSnapshot(std::vector<u8>* snapshot);
+
+  /// Blocks until all queued snapshots have been encoded.
+  void Flush();
+
+  /// Removes all snapshots.
+  void Clear();
+
+private:
+  static constexpr u32 MAX_FREE_BUFFERS = 4;
+
+  struct DeltaSnapshot
+  {
+    std::vector<u8> compressed_data;
+    u32 size;
+  };
+
+  void WorkerThread();
+  void WaitForWorker(std::unique_lock<std::mutex>& lock);
+  void ReleaseBuffer(std::vector<u8> buffer);
+  void EnforceMemoryBudget();
+
+  static bool EncodeDelta(const std::vector<u8>& older, const std::vector<u8>& newer, std::vector<u8>* scratch,
+                          DeltaSnapshot* delta);
+  static bool DecodeDelta(const DeltaSnapshot& delta, const std::vector<u8>& newer, std::vector<u8>* older);
+
+  // oldest first, each one is relative to the snapshot after it
+  std::deque<DeltaSnapshot> m_deltas;
+  std::vector<u8> m_newest;
+  bool m_has_newest = false;
+  u64 m_delta_memory_usage = 0;
+  u64 m_memory_budget = 0;
+
+  std::deque<std::vector<u8>> m_queue;
+  std::vector<std::vector<u8>> m_free_buffers;
+
+  std::thread m_worker_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_work_cv;
+  std::condition_variable m_done_cv;
+  bool m_worker_busy = false;
+  bool m_shutdown = false;
+};
@@ -10,7 +10,10 @@ struct SAVE_STATE_HEADER
   enum : u32
   {
     MAX_TITLE_LENGTH = 128,
-    MAX_GAME_CODE_LENGTH = 32
+    MAX_GAME_CODE_LENGTH = 32,
+
+    COMPRESSION_TYPE_NONE = 0,
+    COMPRESSION_TYPE_ZLIB = 1
   };
 
   u32 magic;
@@ -83,22 +83,34 @@ void Settings::Load(SettingsInterface& si)
   start_paused = si.GetBoolValue("Main", "StartPaused", false);
   start_fullscreen = si.GetBoolValue("Main", "StartFullscreen", false);
   save_state_on_exit = si.GetBoolValue("Main", "SaveStateOnExit", true);
+  save_state_compression = si.GetBoolValue("Main", "CompressSaveStates", true);
   confim_power_off = si.GetBoolValue("Main", "ConfirmPowerOff", true);
   load_devices_from_save_states = si.GetBoolValue("Main", "LoadDevicesFromSaveStates", false);
   apply_game_settings = si.GetBoolValue("Main", "ApplyGameSettings", true);
+  rewind_enable = si.GetBoolValue("Main", "RewindEnable", false);
+  rewind_save_interval =
+    static_cast<u32>(std::max(si.GetIntValue("Main", "RewindSaveInterval", DEFAULT_REWIND_SAVE_INTERVAL), 1));
+  rewind_memory_budget_mb =
+    static_cast<u32>(si.GetIntValue("Main", "RewindMemoryBudgetMB", DEFAULT_REWIND_MEMORY_BUDGET_MB));
+  runahead_frames = static_cast<u32>(std::clamp(si.GetIntValue("Main", "RunaheadFrames", 0), 0, 10));
 
   cpu_execution_mode =
     ParseCPUExecutionMode(
       si.GetStringValue("CPU", "ExecutionMode", GetCPUExecutionModeName(DEFAULT_CPU_EXECUTION_MODE)).c_str())
       .value_or(DEFAULT_CPU_EXECUTION_MODE);
   cpu_recompiler_memory_exceptions = si.GetBoolValue("CPU", "RecompilerMemoryExceptions", false);
+  cpu_fastmem = si.GetBoolValue("CPU", "Fastmem", true);
   cpu_recompiler_icache = si.GetBoolValue("CPU", "RecompilerICache", false);
+  cpu_recompiler_traces = si.GetBoolValue("CPU", "RecompilerTraces", true);
+  cpu_recompiler_tiering = si.GetBoolValue("CPU", "RecompilerTiering", true);
 
   gpu_renderer = ParseRendererName(si.GetStringValue("GPU", "Renderer", GetRendererName(DEFAULT_GPU_RENDERER)).c_str())
                    .value_or(DEFAULT_GPU_RENDERER);
   gpu_adapter = si.GetStringValue("GPU", "Adapter", "");
   gpu_resolution_scale = static_cast<u32>(si.GetIntValue("GPU", "ResolutionScale", 1));
   gpu_use_debug_device = si.GetBoolValue("GPU", "UseDebugDevice", false);
+  gpu_use_thread = si.GetBoolValue("GPU", "UseThread", true);
+  gpu_use_hw_thread = si.GetBoolValue("GPU", "UseHardwareThread", false);
   gpu_true_color = si.GetBoolValue("GPU", "TrueColor", true);
   gpu_scaled_dithering = si.GetBoolValue("GPU", "ScaledDithering", false);
   gpu_texture_filtering = si.GetBoolValue("GPU", "TextureFiltering", false);
@@ -131,6 +143,10 @@ void Settings::Load(SettingsInterface& si)
   video_sync_enabled = si.GetBoolValue("Display", "VSync", true);
 
   cdrom_read_thread = si.GetBoolValue("CDROM", "ReadThread", true);
+  cdrom_readahead_sectors =
+    static_cast<u32>(si.GetIntValue("CDROM", "ReadaheadSectors", DEFAULT_CDROM_READAHEAD_SECTORS));
+  cdrom_chd_cache_size_mb =
+    static_cast<u32>(si.GetIntValue("CDROM", "CHDCacheSizeMB", DEFAULT_CDROM_CHD_CACHE_SIZE_MB));
   cdrom_region_check = si.GetBoolValue("CDROM", "RegionCheck", true);
   cdrom_load_image_to_ram = si.GetBoolValue("CDROM", "LoadImageToRAM", false);
 
@@ -201,18 +217,28 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Main", "StartPaused", start_paused);
   si.SetBoolValue("Main", "StartFullscreen", start_fullscreen);
   si.SetBoolValue("Main", "SaveStateOnExit", save_state_on_exit);
+  si.SetBoolValue("Main", "CompressSaveStates", save_state_compression);
   si.SetBoolValue("Main", "ConfirmPowerOff", confim_power_off);
   si.SetBoolValue("Main", "LoadDevicesFromSaveStates", load_devices_from_save_states);
   si.SetBoolValue("Main", "ApplyGameSettings", apply_game_settings);
+  si.SetBoolValue("Main", "RewindEnable", rewind_enable);
+  si.SetIntValue("Main", "RewindSaveInterval", rewind_save_interval);
+  si.SetIntValue("Main", "RewindMemoryBudgetMB", rewind_memory_budget_mb);
+  si.SetIntValue("Main", "RunaheadFrames", runahead_frames);
 
   si.SetStringValue("CPU", "ExecutionMode", GetCPUExecutionModeName(cpu_execution_mode));
   si.SetBoolValue("CPU", "RecompilerMemoryExceptions", cpu_recompiler_memory_exceptions);
+  si.SetBoolValue("CPU", "Fastmem", cpu_fastmem);
   si.SetBoolValue("CPU", "RecompilerICache", cpu_recompiler_icache);
+  si.SetBoolValue("CPU", "RecompilerTraces", cpu_recompiler_traces);
+  si.SetBoolValue("CPU", "RecompilerTiering", cpu_recompiler_tiering);
 
   si.SetStringValue("GPU", "Renderer", GetRendererName(gpu_renderer));
   si.SetStringValue("GPU", "Adapter", gpu_adapter.c_str());
   si.SetIntValue("GPU", "ResolutionScale", static_cast<long>(gpu_resolution_scale));
   si.SetBoolValue("GPU", "UseDebugDevice", gpu_use_debug_device);
+  si.SetBoolValue("GPU", "UseThread", gpu_use_thread);
+  si.SetBoolValue("GPU", "UseHardwareThread", gpu_use_hw_thread);
   si.SetBoolValue("GPU", "TrueColor", gpu_true_color);
   si.SetBoolValue("GPU", "ScaledDithering", gpu_scaled_dithering);
   si.SetBoolValue("GPU", "TextureFiltering", gpu_texture_filtering);
@@ -239,6 +265,8 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Display", "VSync", video_sync_enabled);
 
   si.SetBoolValue("CDROM", "ReadThread", cdrom_read_thread);
+  si.SetIntValue("CDROM", "ReadaheadSectors", cdrom_readahead_sectors);
+  si.SetIntValue("CDROM", "CHDCacheSizeMB", cdrom_chd_cache_size_mb);
   si.SetBoolValue("CDROM", "RegionCheck", cdrom_region_check);
   si.SetBoolValue("CDROM", "LoadImageToRAM", cdrom_load_image_to_ram);
 
@@ -411,6 +439,27 @@ const char* Settings::GetCPUExecutionModeDisplayName(CPUExecutionMode mode)
   return s_cpu_execution_mode_display_names[static_cast<u8>(mode)];
 }
 
+static std::array<const char*, 3> s_pgxp_mode_names = {{"Disabled", "Memory", "CPU"}};
+
+std::optional<PGXPMode> Settings::ParsePGXPMode(const char* str)
+{
+  u8 index = 0;
+  for (const char* name : s_pgxp_mode_names)
+  {
+    if (StringUtil::Strcasecmp(name, str) == 0)
+      return static_cast<PGXPMode>(index);
+
+    index++;
+  }
+
+  return std::nullopt;
+}
+
+const char* Settings::GetPGXPModeName(PGXPMode mode)
+{
+  return s_pgxp_mode_names[static_cast<u8>(mode)];
+}
+
 static constexpr auto s_gpu_renderer_names = make_array(
 #ifdef WIN32
   "D3D11",
@@ -69,7 +69,10 @@ struct Settings
 
   CPUExecutionMode cpu_execution_mode = CPUExecutionMode::Interpreter;
   bool cpu_recompiler_memory_exceptions = false;
+  bool cpu_fastmem = true;
   bool cpu_recompiler_icache = false;
+  bool cpu_recompiler_traces = true;
+  bool cpu_recompiler_tiering = true;
 
   float emulation_speed = 1.0f;
   bool speed_limiter_enabled = true;
@@ -77,14 +80,23 @@ struct Settings
   bool start_paused = false;
   bool start_fullscreen = false;
   bool save_state_on_exit = true;
+  bool save_state_compression = true;
   bool confim_power_off = true;
   bool load_devices_from_save_states = false;
   bool apply_game_settings = true;
 
+  bool rewind_enable = false;
+  u32 rewind_save_interval = DEFAULT_REWIND_SAVE_INTERVAL;
+  u32 rewind_memory_budget_mb = DEFAULT_REWIND_MEMORY_BUDGET_MB;
+
+  u32 runahead_frames = 0;
+
   GPURenderer gpu_renderer = GPURenderer::Software;
   std::string gpu_adapter;
   u32 gpu_resolution_scale = 1;
   bool gpu_use_debug_device = false;
+  bool gpu_use_thread = true;
+  bool gpu_use_hw_thread = false;
   bool gpu_true_color = true;
   bool gpu_scaled_dithering = false;
   bool gpu_texture_filtering = false;
@@ -110,6 +122,8 @@ struct Settings
   bool video_sync_enabled = true;
 
   bool cdrom_read_thread = true;
+  u32 cdrom_readahead_sectors = DEFAULT_CDROM_READAHEAD_SECTORS;
+  u32 cdrom_chd_cache_size_mb = DEFAULT_CDROM_CHD_CACHE_SIZE_MB;
   bool cdrom_region_check = true;
   bool cdrom_load_image_to_ram = false;
 
@@ -160,12 +174,17 @@ struct Settings
 
   ALWAYS_INLINE bool IsUsingCodeCache() const { return (cpu_execution_mode != CPUExecutionMode::Interpreter); }
   ALWAYS_INLINE bool IsUsingRecompiler() const { return (cpu_execution_mode == CPUExecutionMode::Recompiler); }
+  ALWAYS_INLINE bool IsUsingFastmem() const
+  {
+    return (cpu_fastmem && cpu_execution_mode == CPUExecutionMode::Recompiler && !cpu_recompiler_memory_exceptions);
+  }
   ALWAYS_INLINE bool IsUsingSoftwareRenderer() const { return (gpu_renderer == GPURenderer::Software); }
 
   ALWAYS_INLINE PGXPMode GetPGXPMode()
   {
     return gpu_pgxp_enable ? (gpu_pgxp_cpu ? PGXPMode::CPU : PGXPMode::Memory) : PGXPMode::Disabled;
   }
+  ALWAYS_INLINE bool UsingPGXPCPUMode() const { return (gpu_pgxp_enable && gpu_pgxp_cpu); }
 
   bool HasAnyPerGameMemoryCards() const;
 
@@ -174,7 +193,11 @@ struct Settings
     DEFAULT_DMA_MAX_SLICE_TICKS = 1000,
     DEFAULT_DMA_HALT_TICKS = 100,
     DEFAULT_GPU_FIFO_SIZE = 16,
-    DEFAULT_GPU_MAX_RUN_AHEAD = 128
+    DEFAULT_GPU_MAX_RUN_AHEAD = 128,
+    DEFAULT_CDROM_READAHEAD_SECTORS = 8,
+    DEFAULT_CDROM_CHD_CACHE_SIZE_MB = 16,
+    DEFAULT_REWIND_SAVE_INTERVAL = 30,
+    DEFAULT_REWIND_MEMORY_BUDGET_MB = 64
   };
 
   void Load(SettingsInterface& si);
@@ -196,6 +219,9 @@ struct Settings
   static const char* GetCPUExecutionModeName(CPUExecutionMode mode);
   static const char* GetCPUExecutionModeDisplayName(CPUExecutionMode mode);
 
+  static std::optional<PGXPMode> ParsePGXPMode(const char* str);
+  static const char* GetPGXPModeName(PGXPMode mode);
+
   static std::optional<GPURenderer> ParseRendererName(const char* str);
   static const char* GetRendererName(GPURenderer renderer);
   static const char* GetRendererDisplayName(GPURenderer renderer);
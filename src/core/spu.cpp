@@ -3,10 +3,12 @@
 #include "common/audio_stream.h"
 #include "common/log.h"
 #include "common/state_wrapper.h"
+#include "common/trace.h"
 #include "common/wav_writer.h"
 #include "dma.h"
 #include "host_interface.h"
 #include "interrupt_controller.h"
+#include "subsystem_timing.h"
 #include "system.h"
 #include <imgui.h>
 Log_SetChannel(SPU);
@@ -19,11 +21,13 @@ SPU::~SPU() = default;
 
 void SPU::Initialize()
 {
-  m_tick_event = TimingEvents::CreateTimingEvent("SPU Sample", SYSCLK_TICKS_PER_SPU_TICK, SYSCLK_TICKS_PER_SPU_TICK,
-                                                 std::bind(&SPU::Execute, this, std::placeholders::_1), false);
-  m_transfer_event =
-    TimingEvents::CreateTimingEvent("SPU Transfer", TRANSFER_TICKS_PER_HALFWORD, TRANSFER_TICKS_PER_HALFWORD,
-                                    std::bind(&SPU::ExecuteTransfer, this, std::placeholders::_1), false);
+  m_tick_event = TimingEvents::CreateTimingEvent(
+    "SPU Sample", SYSCLK_TICKS_PER_SPU_TICK, SYSCLK_TICKS_PER_SPU_TICK,
+    [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<SPU*>(param)->Execute(ticks); }, this, false);
+  m_transfer_event = TimingEvents::CreateTimingEvent(
+    "SPU Transfer", TRANSFER_TICKS_PER_HALFWORD, TRANSFER_TICKS_PER_HALFWORD,
+    [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<SPU*>(param)->ExecuteTransfer(ticks); }, this,
+    false);
 
   Reset();
 }
@@ -155,7 +159,8 @@ bool SPU::DoState(StateWrapper& sw)
 
   if (sw.IsReading())
   {
-    g_host_interface->GetAudioStream()->EmptyBuffers();
+    if (!m_audio_output_muted)
+      g_host_interface->GetAudioStream()->EmptyBuffers();
     UpdateEventInterval();
     UpdateTransferEvent();
   }
@@ -678,15 +683,26 @@ void SPU::IncrementCaptureBufferPosition()
 
 void SPU::Execute(TickCount ticks)
 {
+  SubsystemTiming::ScopedTimer subsystem_timer(SubsystemTiming::Subsystem::SPU);
+  TRACE_SCOPE("SPU::Execute");
+
   u32 remaining_frames = static_cast<u32>((ticks + m_ticks_carry) / SYSCLK_TICKS_PER_SPU_TICK);
   m_ticks_carry = (ticks + m_ticks_carry) % SYSCLK_TICKS_PER_SPU_TICK;
 
   while (remaining_frames > 0)
   {
-    AudioStream* const output_stream = g_host_interface->GetAudioStream();
+    AudioStream* const output_stream = m_audio_output_muted ? nullptr : g_host_interface->GetAudioStream();
     s16* output_frame_start;
     u32 output_frame_space = remaining_frames;
-    output_stream->BeginWrite(&output_frame_start, &output_frame_space);
+    if (output_stream)
+    {
+      output_stream->BeginWrite(&output_frame_start, &output_frame_space);
+    }
+    else
+    {
+      output_frame_start = m_muted_output_buffer.data();
+      output_frame_space = MUTED_OUTPUT_BUFFER_FRAMES;
+    }
 
     s16* output_frame = output_frame_start;
     const u32 frames_in_this_batch = std::min(remaining_frames, output_frame_space);
@@ -777,10 +793,14 @@ void SPU::Execute(TickCount ticks)
       IncrementCaptureBufferPosition();
     }
 
-    if (m_dump_writer)
-      m_dump_writer->WriteFrames(output_frame_start, frames_in_this_batch);
+    if (output_stream)
+    {
+      if (m_dump_writer)
+        m_dump_writer->WriteFrames(output_frame_start, frames_in_this_batch);
+
+      output_stream->EndWrite(frames_in_this_batch);
+    }
 
-    output_stream->EndWrite(frames_in_this_batch);
     remaining_frames -= frames_in_this_batch;
   }
 }
@@ -806,6 +826,8 @@ void SPU::UpdateEventInterval()
 
 void SPU::ExecuteTransfer(TickCount ticks)
 {
+  SubsystemTiming::ScopedTimer subsystem_timer(SubsystemTiming::Subsystem::SPU);
+
   const RAMTransferMode mode = m_SPUCNT.ram_transfer_mode;
   Assert(mode != RAMTransferMode::Stopped);
 
@@ -943,6 +965,8 @@ void SPU::UpdateDMARequest()
 
 void SPU::DMARead(u32* words, u32 word_count)
 {
+  SubsystemTiming::ScopedTimer subsystem_timer(SubsystemTiming::Subsystem::SPU);
+
   /*
     From @JaCzekanski - behavior when block size is larger than the FIFO size
     for blocks <= 0x16 - all data is transferred correctly
@@ -1012,6 +1036,8 @@ void SPU::DMARead(u32* words, u32 word_count)
 
 void SPU::DMAWrite(const u32* words, u32 word_count)
 {
+  SubsystemTiming::ScopedTimer subsystem_timer(SubsystemTiming::Subsystem::SPU);
+
   const u16* halfwords = reinterpret_cast<const u16*>(words);
   u32 halfword_count = word_count * 2;
 
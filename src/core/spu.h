@@ -45,6 +45,11 @@ public:
   /// Stops dumping audio to file, if started.
   bool StopDumpingAudio();
 
+  /// While muted, samples are still generated but not sent to the audio stream or dump file. Loading state while muted
+  /// keeps the samples already queued, which run-ahead relies on when it rolls back.
+  ALWAYS_INLINE bool IsAudioOutputMuted() const { return m_audio_output_muted; }
+  ALWAYS_INLINE void SetAudioOutputMuted(bool muted) { m_audio_output_muted = muted; }
+
 private:
   static constexpr u32 RAM_SIZE = 512 * 1024;
   static constexpr u32 RAM_MASK = RAM_SIZE - 1;
@@ -58,6 +63,7 @@ private:
   static constexpr s16 ENVELOPE_MIN_VOLUME = 0;
   static constexpr s16 ENVELOPE_MAX_VOLUME = 0x7FFF;
   static constexpr u32 CAPTURE_BUFFER_SIZE_PER_CHANNEL = 0x400;
+  static constexpr u32 MUTED_OUTPUT_BUFFER_FRAMES = 1024;
   static constexpr u32 MINIMUM_TICKS_BETWEEN_KEY_ON_OFF = 2;
   static constexpr u32 NUM_REVERB_REGS = 32;
   static constexpr u32 FIFO_SIZE_IN_HALFWORDS = 32;
@@ -369,6 +375,8 @@ private:
   std::unique_ptr<TimingEvent> m_tick_event;
   std::unique_ptr<TimingEvent> m_transfer_event;
   std::unique_ptr<Common::WAVWriter> m_dump_writer;
+  std::array<s16, MUTED_OUTPUT_BUFFER_FRAMES * 2> m_muted_output_buffer{};
+  bool m_audio_output_muted = false;
   TickCount m_ticks_carry = 0;
 
   SPUCNT m_SPUCNT = {};
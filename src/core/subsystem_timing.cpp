@@ -0,0 +1,51 @@
+#include "subsystem_timing.h"
+
+namespace SubsystemTiming {
+
+State g_state = {};
+
+static constexpr std::array<const char*, static_cast<u32>(Subsystem::Count)> s_subsystem_names = {
+  {"CPU", "GPU", "SPU", "CDROM", "MDEC"}};
+
+const char* GetSubsystemName(Subsystem subsystem)
+{
+  return s_subsystem_names[static_cast<u32>(subsystem)];
+}
+
+void Start()
+{
+  g_state.time.fill(0);
+  g_state.current = Subsystem::CPU;
+  g_state.last_switch_time = Common::Timer::GetValue();
+  g_state.enabled = true;
+}
+
+void Stop()
+{
+  if (!g_state.enabled)
+    return;
+
+  Switch(Subsystem::CPU);
+  g_state.enabled = false;
+}
+
+double GetTimeSeconds(Subsystem subsystem)
+{
+  return Common::Timer::ConvertValueToSeconds(g_state.time[static_cast<u32>(subsystem)]);
+}
+
+Subsystem Switch(Subsystem subsystem)
+{
+  // a scope can outlive Stop(), the totals shouldn't change after that
+  const Subsystem previous = g_state.current;
+  if (!g_state.enabled)
+    return previous;
+
+  const Common::Timer::Value now = Common::Timer::GetValue();
+  g_state.time[static_cast<u32>(previous)] += now - g_state.last_switch_time;
+  g_state.last_switch_time = now;
+  g_state.current = subsystem;
+  return previous;
+}
+
+} // namespace SubsystemTiming
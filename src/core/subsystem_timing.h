@@ -0,0 +1,73 @@
+#pragma once
+#include "common/timer.h"
+#include "types.h"
+#include <array>
+
+/// Breakdown of the host time spent emulating each part of the system. Time is charged to whichever subsystem was
+/// entered last, anything outside of a timed scope goes to the CPU. Off by default, when enabled each timed scope
+/// costs two reads of the host timer.
+namespace SubsystemTiming {
+
+enum class Subsystem : u8
+{
+  CPU,
+  GPU,
+  SPU,
+  CDROM,
+  MDEC,
+  Count
+};
+
+struct State
+{
+  std::array<Common::Timer::Value, static_cast<u32>(Subsystem::Count)> time;
+  Common::Timer::Value last_switch_time;
+  Subsystem current;
+  bool enabled;
+};
+
+extern State g_state;
+
+const char* GetSubsystemName(Subsystem subsystem);
+
+/// Clears the totals and starts timing, charging the CPU until another subsystem is entered.
+void Start();
+
+/// Stops timing. The totals are kept until the next Start().
+void Stop();
+
+ALWAYS_INLINE bool IsEnabled()
+{
+  return g_state.enabled;
+}
+
+/// Returns the time charged to the subsystem since the last Start().
+double GetTimeSeconds(Subsystem subsystem);
+
+/// Charges the time since the last switch to the current subsystem, then makes subsystem current.
+/// Returns the previously current subsystem.
+Subsystem Switch(Subsystem subsystem);
+
+/// Charges the enclosing scope to a subsystem, returning to the previous one when it ends.
+class ScopedTimer
+{
+public:
+  ALWAYS_INLINE ScopedTimer(Subsystem subsystem)
+    : m_previous(g_state.enabled ? Switch(subsystem) : Subsystem::Count)
+  {
+  }
+
+  ALWAYS_INLINE ~ScopedTimer()
+  {
+    if (m_previous != Subsystem::Count)
+      Switch(m_previous);
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+  Subsystem m_previous;
+};
+
+} // namespace SubsystemTiming
@@ -3,10 +3,12 @@
 #include "bus.h"
 #include "cdrom.h"
 #include "common/audio_stream.h"
+#include "common/byte_stream.h"
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/state_wrapper.h"
 #include "common/string_util.h"
+#include "common/trace.h"
 #include "controller.h"
 #include "cpu_code_cache.h"
 #include "cpu_core.h"
@@ -22,13 +24,18 @@
 #include "memory_card.h"
 #include "pad.h"
 #include "psf_loader.h"
+#include "rewind_buffer.h"
 #include "save_state_version.h"
 #include "sio.h"
 #include "spu.h"
 #include "timers.h"
+#include <algorithm>
+#include <array>
 #include <cstdio>
+#include <cstring>
 #include <imgui.h>
 #include <limits>
+#include <zlib.h>
 Log_SetChannel(System);
 
 #ifdef WIN32
@@ -61,13 +68,28 @@ static bool SetExpansionROM(const char* filename);
 static std::unique_ptr<CDImage> OpenCDImage(const char* path, bool force_preload);
 
 static bool DoLoadState(ByteStream* stream, bool force_software_renderer);
-static bool DoState(StateWrapper& sw);
+static bool DeflateStateData(const void* data, u32 size, ByteStream* out_stream, u32* out_compressed_size);
+static bool InflateStateData(const void* compressed_data, u32 compressed_size, void* data, u32 size);
+
+/// Fast snapshots are only loaded again in this session, so they can keep the code cache and leave VRAM in the renderer.
+// Fast snapshots keep VRAM on the GPU and the code cache intact. keep_code_cache only does the latter, for snapshots
+// which are held in memory but still need VRAM serialized.
+static bool DoState(StateWrapper& sw, bool fast_snapshot = false, bool keep_code_cache = false);
 static bool CreateGPU(GPURenderer renderer);
 
 static bool Initialize(bool force_software_renderer);
 
 static void UpdateRunningGame(const char* path, CDImage* image);
 
+static void SaveRewindSnapshot();
+static void DoRewind();
+
+static void DoRunFrame();
+static void DoRunahead();
+static bool SaveRunaheadSnapshot();
+static bool LoadRunaheadSnapshot();
+static void InvalidateRunaheadSnapshot();
+
 static State s_state = State::Shutdown;
 
 static ConsoleRegion s_region = ConsoleRegion::NTSC_U;
@@ -98,6 +120,24 @@ static u32 s_last_global_tick_counter = 0;
 static Common::Timer s_fps_timer;
 static Common::Timer s_frame_timer;
 
+static std::unique_ptr<RewindBuffer> s_rewind_buffer;
+static std::vector<u8> s_rewind_load_buffer;
+static u32 s_rewind_save_counter = 0;
+static u32 s_rewind_load_counter = 0;
+static bool s_rewinding = false;
+static float s_rewind_capture_time = 0.0f;
+static float s_rewind_capture_time_accumulator = 0.0f;
+static u32 s_rewind_capture_count = 0;
+
+static std::vector<u8> s_runahead_snapshot;
+static u32 s_runahead_snapshot_size = 0;
+static bool s_runahead_snapshot_valid = false;
+static float s_runahead_time = 0.0f;
+static float s_runahead_snapshot_time = 0.0f;
+static float s_runahead_time_accumulator = 0.0f;
+static float s_runahead_snapshot_time_accumulator = 0.0f;
+static u32 s_runahead_frame_count = 0;
+
 // Playlist of disc images.
 static std::vector<std::string> s_media_playlist;
 static std::string s_media_playlist_filename;
@@ -223,12 +263,15 @@ ConsoleRegion GetConsoleRegionForDiscRegion(DiscRegion region)
 
 bool RecreateGPU(GPURenderer renderer)
 {
+  // the new renderer won't have the run-ahead VRAM snapshot
+  RollbackRunahead();
+
   g_gpu->RestoreGraphicsAPIState();
 
   // save current state
   std::unique_ptr<ByteStream> state_stream = ByteStream_CreateGrowableMemoryStream();
   StateWrapper sw(state_stream.get(), StateWrapper::Mode::Write);
-  const bool state_valid = g_gpu->DoState(sw) && TimingEvents::DoState(sw);
+  const bool state_valid = g_gpu->DoState(sw, true) && TimingEvents::DoState(sw);
   if (!state_valid)
     Log_ErrorPrintf("Failed to save old GPU state when switching renderers");
 
@@ -247,7 +290,7 @@ bool RecreateGPU(GPURenderer renderer)
     state_stream->SeekAbsolute(0);
     sw.SetMode(StateWrapper::Mode::Read);
     g_gpu->RestoreGraphicsAPIState();
-    g_gpu->DoState(sw);
+    g_gpu->DoState(sw, true);
     TimingEvents::DoState(sw);
     g_gpu->ResetGraphicsAPIState();
   }
@@ -462,8 +505,12 @@ bool Initialize(bool force_software_renderer)
   TimingEvents::Initialize();
 
   CPU::Initialize();
-  CPU::CodeCache::Initialize(g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler);
-  Bus::Initialize();
+
+  if (!Bus::Initialize())
+    return false;
+
+  CPU::CodeCache::Initialize(g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler,
+                             g_settings.IsUsingFastmem());
 
   if (!CreateGPU(force_software_renderer ? GPURenderer::Software : g_settings.gpu_renderer))
     return false;
@@ -480,6 +527,7 @@ bool Initialize(bool force_software_renderer)
   g_sio.Initialize();
 
   UpdateThrottlePeriod();
+  UpdateRewindSettings();
   return true;
 }
 
@@ -488,6 +536,14 @@ void Shutdown()
   if (s_state == State::Shutdown)
     return;
 
+  s_rewind_buffer.reset();
+  s_rewind_load_buffer = {};
+  s_rewinding = false;
+
+  InvalidateRunaheadSnapshot();
+  s_runahead_snapshot = {};
+  s_runahead_snapshot_size = 0;
+
   g_sio.Shutdown();
   g_mdec.Shutdown();
   g_spu.Shutdown();
@@ -547,7 +603,7 @@ bool CreateGPU(GPURenderer renderer)
   return true;
 }
 
-bool DoState(StateWrapper& sw)
+bool DoState(StateWrapper& sw, bool fast_snapshot, bool keep_code_cache)
 {
   if (!sw.DoMarker("System"))
     return false;
@@ -559,7 +615,8 @@ bool DoState(StateWrapper& sw)
   if (!sw.DoMarker("CPU") || !CPU::DoState(sw))
     return false;
 
-  if (sw.IsReading())
+  // without a flush, loading RAM invalidates any blocks in pages which changed
+  if (sw.IsReading() && !fast_snapshot && !keep_code_cache)
     CPU::CodeCache::Flush();
 
   if (!sw.DoMarker("Bus") || !Bus::DoState(sw))
@@ -572,7 +629,7 @@ bool DoState(StateWrapper& sw)
     return false;
 
   g_gpu->RestoreGraphicsAPIState();
-  const bool gpu_result = sw.DoMarker("GPU") && g_gpu->DoState(sw);
+  const bool gpu_result = sw.DoMarker("GPU") && g_gpu->DoState(sw, !fast_snapshot);
   g_gpu->ResetGraphicsAPIState();
   if (!gpu_result)
     return false;
@@ -625,6 +682,10 @@ void Reset()
   TimingEvents::Reset();
   ResetPerformanceCounters();
 
+  if (s_rewind_buffer)
+    s_rewind_buffer->Clear();
+  InvalidateRunaheadSnapshot();
+
   g_gpu->ResetGraphicsAPIState();
 }
 
@@ -731,7 +792,8 @@ bool DoLoadState(ByteStream* state, bool force_software_renderer)
       UpdateMemoryCards();
   }
 
-  if (header.data_compression_type != 0)
+  if (header.data_compression_type != SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE &&
+      header.data_compression_type != SAVE_STATE_HEADER::COMPRESSION_TYPE_ZLIB)
   {
     g_host_interface->ReportFormattedError("Unknown save state compression type %u", header.data_compression_type);
     return false;
@@ -740,13 +802,47 @@ bool DoLoadState(ByteStream* state, bool force_software_renderer)
   if (!state->SeekAbsolute(header.offset_to_data))
     return false;
 
-  StateWrapper sw(state, StateWrapper::Mode::Read);
-  if (!DoState(sw))
-    return false;
+  if (header.data_compression_type == SAVE_STATE_HEADER::COMPRESSION_TYPE_ZLIB)
+  {
+    // don't trust the sizes in the header until they've been checked, they're used for the allocations
+    const u64 remaining_size = state->GetSize() - std::min(state->GetPosition(), state->GetSize());
+    if (header.data_uncompressed_size > MAX_SAVE_STATE_SIZE || header.data_compressed_size > remaining_size)
+    {
+      g_host_interface->ReportFormattedError("Save state data size is invalid (%u compressed, %u uncompressed).",
+                                             header.data_compressed_size, header.data_uncompressed_size);
+      return false;
+    }
+
+    std::vector<u8> compressed_data(header.data_compressed_size);
+    std::vector<u8> data(header.data_uncompressed_size);
+    if (!state->Read2(compressed_data.data(), header.data_compressed_size) ||
+        !InflateStateData(compressed_data.data(), header.data_compressed_size, data.data(),
+                          header.data_uncompressed_size))
+    {
+      g_host_interface->ReportError("Failed to decompress save state data.");
+      return false;
+    }
+
+    ReadOnlyMemoryByteStream data_stream(data.data(), header.data_uncompressed_size);
+    StateWrapper sw(&data_stream, StateWrapper::Mode::Read);
+    if (!DoState(sw))
+      return false;
+  }
+  else
+  {
+    StateWrapper sw(state, StateWrapper::Mode::Read);
+    if (!DoState(sw))
+      return false;
+  }
 
   if (s_state == State::Starting)
     s_state = State::Running;
 
+  // the snapshots are from a different timeline now
+  if (s_rewind_buffer)
+    s_rewind_buffer->Clear();
+  InvalidateRunaheadSnapshot();
+
   return true;
 }
 
@@ -755,6 +851,9 @@ bool SaveState(ByteStream* state, u32 screenshot_size /* = 128 */)
   if (IsShutdown())
     return false;
 
+  // save the frame the input was actually given to, not one we ran ahead to
+  RollbackRunahead();
+
   SAVE_STATE_HEADER header = {};
 
   const u64 header_position = state->GetPosition();
@@ -815,7 +914,7 @@ bool SaveState(ByteStream* state, u32 screenshot_size /* = 128 */)
     if (!result)
       return false;
 
-    header.data_compression_type = 0;
+    header.data_compression_type = SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE;
     header.data_uncompressed_size = static_cast<u32>(state->GetPosition() - header.offset_to_data);
   }
 
@@ -830,12 +929,182 @@ bool SaveState(ByteStream* state, u32 screenshot_size /* = 128 */)
   return true;
 }
 
+static bool DeflateStateData(const void* data, u32 size, ByteStream* out_stream, u32* out_compressed_size)
+{
+  // Most of the state is RAM and VRAM, which is largely runs and repeats. The fastest level gets most of the gain.
+  z_stream strm = {};
+  int err = deflateInit(&strm, Z_BEST_SPEED);
+  if (err != Z_OK)
+  {
+    Log_ErrorPrintf("deflateInit() failed: %d", err);
+    return false;
+  }
+
+  strm.avail_in = static_cast<uInt>(size);
+  strm.next_in = static_cast<Bytef*>(const_cast<void*>(data));
+
+  std::array<u8, 65536> buffer;
+  do
+  {
+    strm.avail_out = static_cast<uInt>(buffer.size());
+    strm.next_out = buffer.data();
+    err = deflate(&strm, Z_FINISH);
+    if (err == Z_STREAM_ERROR)
+    {
+      Log_ErrorPrintf("deflate() failed: %d", err);
+      deflateEnd(&strm);
+      return false;
+    }
+
+    const u32 buffer_used = static_cast<u32>(buffer.size() - strm.avail_out);
+    if (!out_stream->Write2(buffer.data(), buffer_used))
+    {
+      deflateEnd(&strm);
+      return false;
+    }
+  } while (err != Z_STREAM_END);
+
+  *out_compressed_size = static_cast<u32>(strm.total_out);
+  deflateEnd(&strm);
+  return true;
+}
+
+static bool InflateStateData(const void* compressed_data, u32 compressed_size, void* data, u32 size)
+{
+  z_stream strm = {};
+  strm.avail_in = static_cast<uInt>(compressed_size);
+  strm.next_in = static_cast<Bytef*>(const_cast<void*>(compressed_data));
+  strm.avail_out = static_cast<uInt>(size);
+  strm.next_out = static_cast<Bytef*>(data);
+
+  int err = inflateInit(&strm);
+  if (err != Z_OK)
+  {
+    Log_ErrorPrintf("inflateInit() failed: %d", err);
+    return false;
+  }
+
+  // the uncompressed size is in the header, so we can do this in one pass
+  err = inflate(&strm, Z_FINISH);
+  inflateEnd(&strm);
+  if (err != Z_STREAM_END || strm.total_out != size)
+  {
+    Log_ErrorPrintf("inflate() failed: %d (%u of %u bytes)", err, static_cast<u32>(strm.total_out), size);
+    return false;
+  }
+
+  return true;
+}
+
+static bool ReadStateHeader(const void* state_data, u32 state_size, SAVE_STATE_HEADER* header)
+{
+  if (state_size < sizeof(SAVE_STATE_HEADER))
+    return false;
+
+  std::memcpy(header, state_data, sizeof(SAVE_STATE_HEADER));
+  if (header->magic != SAVE_STATE_MAGIC || header->offset_to_data < sizeof(SAVE_STATE_HEADER) ||
+      header->offset_to_data > state_size)
+  {
+    return false;
+  }
+
+  if (header->data_uncompressed_size > MAX_SAVE_STATE_SIZE)
+    return false;
+
+  const u32 data_size = (header->data_compression_type == SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE) ?
+                          header->data_uncompressed_size :
+                          header->data_compressed_size;
+  return (data_size <= (state_size - header->offset_to_data));
+}
+
+bool CompressSaveState(const void* state_data, u32 state_size, ByteStream* out_state)
+{
+  SAVE_STATE_HEADER header;
+  if (!ReadStateHeader(state_data, state_size, &header) ||
+      header.data_compression_type != SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE)
+  {
+    return false;
+  }
+
+  // everything up to the data is small, so it's copied as-is
+  const u8* state_bytes = static_cast<const u8*>(state_data);
+  const u64 header_position = out_state->GetPosition();
+  if (!out_state->Write2(state_bytes, header.offset_to_data))
+    return false;
+
+  u32 compressed_size;
+  if (!DeflateStateData(state_bytes + header.offset_to_data, header.data_uncompressed_size, out_state,
+                        &compressed_size))
+  {
+    return false;
+  }
+
+  header.data_compression_type = SAVE_STATE_HEADER::COMPRESSION_TYPE_ZLIB;
+  header.data_compressed_size = compressed_size;
+
+  const u64 end_position = out_state->GetPosition();
+  return (out_state->SeekAbsolute(header_position) && out_state->Write2(&header, sizeof(header)) &&
+          out_state->SeekAbsolute(end_position));
+}
+
+bool DecompressSaveState(const void* state_data, u32 state_size, ByteStream* out_state)
+{
+  SAVE_STATE_HEADER header;
+  if (!ReadStateHeader(state_data, state_size, &header))
+    return false;
+
+  const u8* state_bytes = static_cast<const u8*>(state_data);
+  if (header.data_compression_type == SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE)
+    return out_state->Write2(state_bytes, header.offset_to_data + header.data_uncompressed_size);
+  else if (header.data_compression_type != SAVE_STATE_HEADER::COMPRESSION_TYPE_ZLIB)
+    return false;
+
+  std::vector<u8> data(header.data_uncompressed_size);
+  if (!InflateStateData(state_bytes + header.offset_to_data, header.data_compressed_size, data.data(),
+                        header.data_uncompressed_size))
+  {
+    return false;
+  }
+
+  header.data_compression_type = SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE;
+  header.data_compressed_size = 0;
+  return (out_state->Write2(&header, sizeof(header)) &&
+          out_state->Write2(state_bytes + sizeof(header), header.offset_to_data - sizeof(header)) &&
+          out_state->Write2(data.data(), header.data_uncompressed_size));
+}
+
 void RunFrame()
 {
+  TRACE_SCOPE("System::RunFrame");
+
   s_frame_timer.Reset();
 
+  if (s_rewinding)
+  {
+    DoRewind();
+    return;
+  }
+
+  // go back to the last frame with input, this frame is run again with the current input
+  if (s_runahead_snapshot_valid)
+    LoadRunaheadSnapshot();
+
   g_gpu->RestoreGraphicsAPIState();
+  DoRunFrame();
+  g_gpu->ResetGraphicsAPIState();
 
+  if (s_rewind_buffer && ++s_rewind_save_counter >= g_settings.rewind_save_interval)
+  {
+    s_rewind_save_counter = 0;
+    SaveRewindSnapshot();
+  }
+
+  if (g_settings.runahead_frames > 0)
+    DoRunahead();
+}
+
+void DoRunFrame()
+{
   switch (g_settings.cpu_execution_mode)
   {
     case CPUExecutionMode::Recompiler:
@@ -858,8 +1127,223 @@ void RunFrame()
 
   // Generate any pending samples from the SPU before sleeping, this way we reduce the chances of underruns.
   g_spu.GeneratePendingSamples();
+}
+
+void UpdateRewindSettings()
+{
+  if (!g_settings.rewind_enable)
+  {
+    if (s_rewind_buffer)
+      Log_InfoPrintf("Rewind disabled");
+
+    s_rewind_buffer.reset();
+    s_rewind_load_buffer = {};
+    s_rewinding = false;
+    return;
+  }
+
+  if (!s_rewind_buffer)
+  {
+    s_rewind_buffer = std::make_unique<RewindBuffer>();
+    s_rewind_save_counter = 0;
+  }
+
+  Log_InfoPrintf("Rewind enabled, saving every %u frames, %u MB budget", g_settings.rewind_save_interval,
+                 g_settings.rewind_memory_budget_mb);
+  s_rewind_buffer->SetMemoryBudget(static_cast<u64>(g_settings.rewind_memory_budget_mb) * 1048576u);
+}
+
+bool IsRewinding()
+{
+  return s_rewinding;
+}
+
+void SetRewinding(bool enabled)
+{
+  if (!s_rewind_buffer || s_rewinding == enabled)
+    return;
+
+  s_rewinding = enabled;
+  s_rewind_load_counter = 0;
+
+  // start from a full interval, so the snapshot we stopped at isn't immediately captured again
+  s_rewind_save_counter = 0;
+  ResetPerformanceCounters();
+}
+
+u32 GetRewindSnapshotCount()
+{
+  return s_rewind_buffer ? s_rewind_buffer->GetSnapshotCount() : 0;
+}
+
+u64 GetRewindMemoryUsage()
+{
+  return s_rewind_buffer ? s_rewind_buffer->GetMemoryUsage() : 0;
+}
+
+float GetRewindCaptureTime()
+{
+  return s_rewind_capture_time;
+}
+
+void SaveRewindSnapshot()
+{
+  Common::Timer timer;
+
+  // serialize straight into the snapshot's memory, the stream only allocates if the state has grown
+  std::vector<u8> snapshot = s_rewind_buffer->AllocateSnapshot();
+  if (snapshot.size() < MAX_SAVE_STATE_SIZE)
+    snapshot.resize(MAX_SAVE_STATE_SIZE);
+
+  GrowableMemoryByteStream stream(snapshot.data(), static_cast<u32>(snapshot.size()));
+  StateWrapper sw(&stream, StateWrapper::Mode::Write);
+  if (!DoState(sw))
+  {
+    Log_ErrorPrintf("Failed to save rewind snapshot");
+    return;
+  }
+
+  const u32 size = static_cast<u32>(stream.GetPosition());
+  if (stream.GetMemoryPointer() != snapshot.data())
+    snapshot.assign(stream.GetMemoryPointer(), stream.GetMemoryPointer() + size);
+  else
+    snapshot.resize(size);
+
+  s_rewind_buffer->PushSnapshot(std::move(snapshot));
+
+  s_rewind_capture_time_accumulator += static_cast<float>(timer.GetTimeMilliseconds());
+  s_rewind_capture_count++;
+}
+
+void DoRewind()
+{
+  // step back at twice the speed the snapshots were taken at
+  if (s_rewind_load_counter > 0)
+  {
+    s_rewind_load_counter--;
+    return;
+  }
+
+  s_rewind_load_counter = (g_settings.rewind_save_interval / 2u);
 
+  Common::Timer timer;
+  if (!s_rewind_buffer->PopSnapshot(&s_rewind_load_buffer))
+    return;
+
+  // The renderers only hold one VRAM snapshot, which belongs to runahead, so VRAM comes from the rewind snapshot. The
+  // code cache is kept, only blocks in RAM pages which differ are invalidated.
+  ReadOnlyMemoryByteStream stream(s_rewind_load_buffer.data(), static_cast<u32>(s_rewind_load_buffer.size()));
+  StateWrapper sw(&stream, StateWrapper::Mode::Read);
+  if (!DoState(sw, false, true))
+  {
+    // shouldn't happen, the snapshots are from this session
+    Log_ErrorPrintf("Failed to load rewind snapshot");
+    s_rewind_buffer->Clear();
+    s_rewinding = false;
+    return;
+  }
+
+  Log_DevPrintf("Rewound to frame %u in %.2f ms", s_frame_number, timer.GetTimeMilliseconds());
+  InvalidateRunaheadSnapshot();
+
+  // the frame number went backwards
+  ResetPerformanceCounters();
+}
+
+void RollbackRunahead()
+{
+  if (s_runahead_snapshot_valid)
+    LoadRunaheadSnapshot();
+}
+
+float GetRunaheadTime()
+{
+  return s_runahead_time;
+}
+
+float GetRunaheadSnapshotTime()
+{
+  return s_runahead_snapshot_time;
+}
+
+void DoRunahead()
+{
+  Common::Timer timer;
+  if (!SaveRunaheadSnapshot())
+    return;
+
+  s_runahead_snapshot_time_accumulator += static_cast<float>(timer.GetTimeMilliseconds());
+
+  // the frames ahead are only shown, their samples are generated again after the rollback
+  g_spu.SetAudioOutputMuted(true);
+
+  g_gpu->RestoreGraphicsAPIState();
+  for (u32 i = 0; i < g_settings.runahead_frames; i++)
+    DoRunFrame();
   g_gpu->ResetGraphicsAPIState();
+
+  s_runahead_time_accumulator += static_cast<float>(timer.GetTimeMilliseconds());
+  s_runahead_frame_count++;
+}
+
+bool SaveRunaheadSnapshot()
+{
+  // the buffer is kept at its largest size, so it's only allocated once
+  if (s_runahead_snapshot.size() < MAX_SAVE_STATE_SIZE)
+    s_runahead_snapshot.resize(MAX_SAVE_STATE_SIZE);
+
+  GrowableMemoryByteStream stream(s_runahead_snapshot.data(), static_cast<u32>(s_runahead_snapshot.size()));
+  StateWrapper sw(&stream, StateWrapper::Mode::Write);
+  if (!DoState(sw, true))
+  {
+    Log_ErrorPrintf("Failed to save run-ahead snapshot");
+    return false;
+  }
+
+  s_runahead_snapshot_size = static_cast<u32>(stream.GetPosition());
+  if (stream.GetMemoryPointer() != s_runahead_snapshot.data())
+    s_runahead_snapshot.assign(stream.GetMemoryPointer(), stream.GetMemoryPointer() + s_runahead_snapshot_size);
+
+  s_runahead_snapshot_valid = true;
+  return true;
+}
+
+bool LoadRunaheadSnapshot()
+{
+  Common::Timer timer;
+
+  // the host has set the input for the next frame since the snapshot was taken, that has to be kept
+  std::array<u8, 64> input_state_buffer;
+  GrowableMemoryByteStream input_stream(input_state_buffer.data(), static_cast<u32>(input_state_buffer.size()));
+  StateWrapper input_sw(&input_stream, StateWrapper::Mode::Write);
+  g_pad.DoInputState(input_sw);
+
+  // still muted from the frames ahead, so the SPU keeps the samples already queued
+  ReadOnlyMemoryByteStream stream(s_runahead_snapshot.data(), s_runahead_snapshot_size);
+  StateWrapper sw(&stream, StateWrapper::Mode::Read);
+  const bool result = DoState(sw, true);
+  InvalidateRunaheadSnapshot();
+
+  input_stream.SeekAbsolute(0);
+  input_sw.SetMode(StateWrapper::Mode::Read);
+  g_pad.DoInputState(input_sw);
+
+  if (!result)
+  {
+    Log_ErrorPrintf("Failed to load run-ahead snapshot");
+    return false;
+  }
+
+  const float time = static_cast<float>(timer.GetTimeMilliseconds());
+  s_runahead_snapshot_time_accumulator += time;
+  s_runahead_time_accumulator += time;
+  return true;
+}
+
+void InvalidateRunaheadSnapshot()
+{
+  s_runahead_snapshot_valid = false;
+  g_spu.SetAudioOutputMuted(false);
 }
 
 void SetThrottleFrequency(float frequency)
@@ -876,6 +1360,8 @@ void UpdateThrottlePeriod()
 
 void Throttle()
 {
+  TRACE_SCOPE("System::Throttle");
+
   // Allow variance of up to 40ms either way.
   constexpr s64 MAX_VARIANCE_TIME = INT64_C(40000000);
 
@@ -941,6 +1427,21 @@ void UpdatePerformanceCounters()
   s_last_global_tick_counter = global_tick_counter;
   s_fps_timer.Reset();
 
+  s_rewind_capture_time =
+    (s_rewind_capture_count > 0) ? (s_rewind_capture_time_accumulator / static_cast<float>(s_rewind_capture_count)) :
+                                   0.0f;
+  s_rewind_capture_time_accumulator = 0.0f;
+  s_rewind_capture_count = 0;
+
+  s_runahead_time =
+    (s_runahead_frame_count > 0) ? (s_runahead_time_accumulator / static_cast<float>(s_runahead_frame_count)) : 0.0f;
+  s_runahead_snapshot_time = (s_runahead_frame_count > 0) ?
+                               (s_runahead_snapshot_time_accumulator / static_cast<float>(s_runahead_frame_count)) :
+                               0.0f;
+  s_runahead_time_accumulator = 0.0f;
+  s_runahead_snapshot_time_accumulator = 0.0f;
+  s_runahead_frame_count = 0;
+
   g_host_interface->OnSystemPerformanceCountersUpdated();
 }
 
@@ -80,11 +80,40 @@ void Shutdown();
 bool LoadState(ByteStream* state);
 bool SaveState(ByteStream* state, u32 screenshot_size = 128);
 
+/// Copies an uncompressed state from SaveState() to out_state, deflating the state data. The header, media filenames
+/// and screenshot are left uncompressed so they can still be read without decompressing the whole state.
+bool CompressSaveState(const void* state_data, u32 state_size, ByteStream* out_state);
+
+/// Copies a state to out_state, inflating the state data if it is compressed.
+bool DecompressSaveState(const void* state_data, u32 state_size, ByteStream* out_state);
+
 /// Recreates the GPU component, saving/loading the state so it is preserved. Call when the GPU renderer changes.
 bool RecreateGPU(GPURenderer renderer);
 
 void RunFrame();
 
+/// Creates or destroys the rewind buffer, call when the rewind settings change.
+void UpdateRewindSettings();
+
+/// While rewinding, RunFrame() steps back through the rewind snapshots instead of running the system.
+bool IsRewinding();
+void SetRewinding(bool enabled);
+
+/// Rewind statistics for the performance overlay. The capture time is the average time spent serializing a snapshot
+/// on the emulation thread, over the last performance counter update.
+u32 GetRewindSnapshotCount();
+u64 GetRewindMemoryUsage();
+float GetRewindCaptureTime();
+
+/// Rolls back the frames which were run ahead, leaving the system at the last frame run with input. Call before changing
+/// anything which the run-ahead snapshot depends on.
+void RollbackRunahead();
+
+/// Run-ahead statistics for the performance overlay, averaged per frame over the last performance counter update. The
+/// run-ahead time includes running the extra frames, the snapshot time is only saving and loading the state.
+float GetRunaheadTime();
+float GetRunaheadSnapshotTime();
+
 /// Adjusts the throttle frequency, i.e. how many times we should sleep per second.
 void SetThrottleFrequency(float frequency);
 
@@ -2,17 +2,19 @@
 #include "common/assert.h"
 #include "common/log.h"
 #include "common/state_wrapper.h"
+#include "common/trace.h"
 #include "cpu_core.h"
 #include "system.h"
 Log_SetChannel(TimingEvents);
 
 namespace TimingEvents {
 
-static std::vector<TimingEvent*> s_events;
+static TimingEvent* s_active_events_head = nullptr;
+static TimingEvent* s_active_events_tail = nullptr;
+static u32 s_active_event_count = 0;
 static u32 s_global_tick_counter = 0;
 static u32 s_last_event_run_time = 0;
 static bool s_running_events = false;
-static bool s_events_need_sorting = false;
 
 u32 GetGlobalTickCounter()
 {
@@ -32,14 +34,14 @@ void Reset()
 
 void Shutdown()
 {
-  Assert(s_events.empty());
+  Assert(s_active_event_count == 0);
 }
 
 std::unique_ptr<TimingEvent> CreateTimingEvent(std::string name, TickCount period, TickCount interval,
-                                               TimingEventCallback callback, bool activate)
+                                               TimingEventCallback callback, void* callback_param, bool activate)
 {
   std::unique_ptr<TimingEvent> event =
-    std::make_unique<TimingEvent>(std::move(name), period, interval, std::move(callback));
+    std::make_unique<TimingEvent>(std::move(name), period, interval, callback, callback_param);
   if (activate)
     event->Activate();
 
@@ -49,74 +51,139 @@ std::unique_ptr<TimingEvent> CreateTimingEvent(std::string name, TickCount perio
 void UpdateCPUDowncount()
 {
   if (!CPU::g_state.frame_done)
-    CPU::g_state.downcount = s_events[0]->GetDowncount();
+    CPU::g_state.downcount = s_active_events_head->GetDowncount();
 }
 
-static bool CompareEvents(const TimingEvent* lhs, const TimingEvent* rhs)
+static void LinkEventBefore(TimingEvent* event, TimingEvent* next)
 {
-  return lhs->GetDowncount() > rhs->GetDowncount();
+  event->m_next = next;
+  if (next)
+  {
+    event->m_prev = next->m_prev;
+    next->m_prev = event;
+  }
+  else
+  {
+    event->m_prev = s_active_events_tail;
+    s_active_events_tail = event;
+  }
+
+  if (event->m_prev)
+    event->m_prev->m_next = event;
+  else
+    s_active_events_head = event;
+}
+
+static void UnlinkEvent(TimingEvent* event)
+{
+  if (event->m_prev)
+    event->m_prev->m_next = event->m_next;
+  else
+    s_active_events_head = event->m_next;
+
+  if (event->m_next)
+    event->m_next->m_prev = event->m_prev;
+  else
+    s_active_events_tail = event->m_prev;
+
+  event->m_prev = nullptr;
+  event->m_next = nullptr;
+}
+
+static void InsertEvent(TimingEvent* event)
+{
+  DebugAssert(!event->m_prev && !event->m_next);
+
+  // Events with the same downcount run in the order they were added.
+  TimingEvent* next = s_active_events_head;
+  while (next && next->m_downcount <= event->m_downcount)
+    next = next->m_next;
+
+  LinkEventBefore(event, next);
 }
 
 static void AddActiveEvent(TimingEvent* event)
 {
-  s_events.push_back(event);
+  InsertEvent(event);
+  s_active_event_count++;
+
   if (!s_running_events)
-  {
-    std::push_heap(s_events.begin(), s_events.end(), CompareEvents);
     UpdateCPUDowncount();
-  }
-  else
-  {
-    s_events_need_sorting = true;
-  }
 }
 
 static void RemoveActiveEvent(TimingEvent* event)
 {
-  auto iter = std::find_if(s_events.begin(), s_events.end(), [event](const auto& it) { return event == it; });
-  if (iter == s_events.end())
-  {
-    Panic("Attempt to remove inactive event");
-    return;
-  }
+  DebugAssert(s_active_event_count > 0);
 
-  s_events.erase(iter);
-  if (!s_running_events)
+  UnlinkEvent(event);
+  s_active_event_count--;
+
+  if (!s_running_events && s_active_events_head)
+    UpdateCPUDowncount();
+}
+
+/// Moves an active event to its position in the list after its downcount has changed.
+static void SortEvent(TimingEvent* event)
+{
+  const TickCount downcount = event->m_downcount;
+  if (event->m_prev && event->m_prev->m_downcount > downcount)
   {
-    std::make_heap(s_events.begin(), s_events.end(), CompareEvents);
-    if (!s_events.empty())
-      UpdateCPUDowncount();
+    // moving towards the head
+    TimingEvent* next = event->m_prev;
+    while (next->m_prev && next->m_prev->m_downcount > downcount)
+      next = next->m_prev;
+
+    UnlinkEvent(event);
+    LinkEventBefore(event, next);
   }
-  else
+  else if (event->m_next && event->m_next->m_downcount <= downcount)
   {
-    s_events_need_sorting = true;
+    // moving towards the tail
+    TimingEvent* next = event->m_next->m_next;
+    while (next && next->m_downcount <= downcount)
+      next = next->m_next;
+
+    UnlinkEvent(event);
+    LinkEventBefore(event, next);
   }
+
+  if (!s_running_events)
+    UpdateCPUDowncount();
 }
 
 static TimingEvent* FindActiveEvent(const char* name)
 {
-  auto iter =
-    std::find_if(s_events.begin(), s_events.end(), [&name](auto& ev) { return ev->GetName().compare(name) == 0; });
+  for (TimingEvent* event = s_active_events_head; event; event = event->m_next)
+  {
+    if (event->GetName().compare(name) == 0)
+      return event;
+  }
 
-  return (iter != s_events.end()) ? *iter : nullptr;
+  return nullptr;
 }
 
 static void SortEvents()
 {
-  if (!s_running_events)
-  {
-    std::make_heap(s_events.begin(), s_events.end(), CompareEvents);
-    UpdateCPUDowncount();
-  }
-  else
+  // Rebuild the list, since any number of downcounts may have changed.
+  TimingEvent* event = s_active_events_head;
+  s_active_events_head = nullptr;
+  s_active_events_tail = nullptr;
+  while (event)
   {
-    s_events_need_sorting = true;
+    TimingEvent* next = event->m_next;
+    event->m_prev = nullptr;
+    event->m_next = nullptr;
+    InsertEvent(event);
+    event = next;
   }
+
+  if (!s_running_events && s_active_events_head)
+    UpdateCPUDowncount();
 }
 
 void RunEvents()
 {
-  DebugAssert(!s_running_events && !s_events.empty());
+  DebugAssert(!s_running_events && s_active_events_head);
 
   s_running_events = true;
 
@@ -124,23 +191,22 @@ void RunEvents()
   CPU::ResetPendingTicks();
   while (pending_ticks > 0)
   {
-    const TickCount time = std::min(pending_ticks, s_events[0]->GetDowncount());
+    const TickCount time = std::min(pending_ticks, s_active_events_head->GetDowncount());
     s_global_tick_counter += static_cast<u32>(time);
     pending_ticks -= time;
 
     // Apply downcount to all events.
     // This will result in a negative downcount for those events which are late.
-    for (TimingEvent* evt : s_events)
+    for (TimingEvent* evt = s_active_events_head; evt; evt = evt->m_next)
     {
       evt->m_downcount -= time;
       evt->m_time_since_last_run += time;
     }
 
     // Now we can actually run the callbacks.
-    while (s_events.front()->m_downcount <= 0)
+    while (s_active_events_head->m_downcount <= 0)
     {
-      TimingEvent* evt = s_events.front();
-      std::pop_heap(s_events.begin(), s_events.end(), CompareEvents);
+      TimingEvent* evt = s_active_events_head;
 
       // Factor late time into the time for the next invocation.
       const TickCount ticks_late = -evt->m_downcount;
@@ -149,21 +215,14 @@ void RunEvents()
       evt->m_time_since_last_run = 0;
 
       // The cycles_late is only an indicator, it doesn't modify the cycles to execute.
-      evt->m_callback(ticks_to_execute, ticks_late);
-
-      // Place it in the appropriate position in the queue.
-      if (s_events_need_sorting)
       {
-        // Another event may have been changed by this event, or the interval/downcount changed.
-        std::make_heap(s_events.begin(), s_events.end(), CompareEvents);
-        s_events_need_sorting = false;
-      }
-      else
-      {
-        // Keep the event list in a heap. The event we just serviced will be in the last place,
-        // so we can use push_here instead of make_heap, which should be faster.
-        std::push_heap(s_events.begin(), s_events.end(), CompareEvents);
+        TRACE_SCOPE(evt->m_trace_name);
+        evt->m_callback(evt->m_callback_param, ticks_to_execute, ticks_late);
       }
+
+      // Place it in the appropriate position in the queue, unless the callback deactivated it.
+      if (evt->m_active)
+        SortEvent(evt);
     }
   }
 
@@ -216,10 +275,10 @@ bool DoState(StateWrapper& sw)
   }
   else
   {
-    u32 event_count = static_cast<u32>(s_events.size());
+    u32 event_count = s_active_event_count;
     sw.Do(&event_count);
 
-    for (TimingEvent* evt : s_events)
+    for (TimingEvent* evt = s_active_events_head; evt; evt = evt->m_next)
     {
       sw.Do(&evt->m_name);
       sw.Do(&evt->m_downcount);
@@ -238,10 +297,14 @@ bool DoState(StateWrapper& sw)
 
 } // namespace TimingEvents
 
-TimingEvent::TimingEvent(std::string name, TickCount period, TickCount interval, TimingEventCallback callback)
-  : m_downcount(interval), m_time_since_last_run(0), m_period(period), m_interval(interval),
-    m_callback(std::move(callback)), m_name(std::move(name)), m_active(false)
+TimingEvent::TimingEvent(std::string name, TickCount period, TickCount interval, TimingEventCallback callback,
+                         void* callback_param)
+  : m_downcount(interval), m_time_since_last_run(0), m_period(period), m_interval(interval), m_callback(callback),
+    m_callback_param(callback_param), m_name(std::move(name)), m_active(false)
 {
+#ifdef WITH_TRACING
+  m_trace_name = Trace::InternName(m_name.c_str());
+#endif
 }
 
 TimingEvent::~TimingEvent()
@@ -276,7 +339,7 @@ void TimingEvent::Schedule(TickCount ticks)
   {
     // Event is already active, so we leave the time since last run alone, and just modify the downcount.
     // If this is a call from an IO handler for example, re-sort the event queue.
-    TimingEvents::SortEvents();
+    TimingEvents::SortEvent(this);
   }
 }
 
@@ -300,7 +363,7 @@ void TimingEvent::Reset()
 
   m_downcount = m_interval;
   m_time_since_last_run = 0;
-  TimingEvents::SortEvents();
+  TimingEvents::SortEvent(this);
 }
 
 void TimingEvent::InvokeEarly(bool force /* = false */)
@@ -315,10 +378,10 @@ void TimingEvent::InvokeEarly(bool force /* = false */)
 
   m_downcount = pending_ticks + m_interval;
   m_time_since_last_run -= ticks_to_execute;
-  m_callback(ticks_to_execute, 0);
+  m_callback(m_callback_param, ticks_to_execute, 0);
 
   // Since we've changed the downcount, we need to re-sort the events.
-  TimingEvents::SortEvents();
+  TimingEvents::SortEvent(this);
 }
 
 void TimingEvent::Activate()
@@ -1,20 +1,20 @@
 #pragma once
-#include <functional>
 #include <memory>
 #include <string>
-#include <vector>
 
 #include "types.h"
 
 class StateWrapper;
 
-// Event callback type. Second parameter is the number of cycles the event was executed "late".
-using TimingEventCallback = std::function<void(TickCount ticks, TickCount ticks_late)>;
+// Event callback type. First parameter is the pointer passed when creating the event. Third parameter is the number
+// of cycles the event was executed "late".
+using TimingEventCallback = void (*)(void* param, TickCount ticks, TickCount ticks_late);
 
 class TimingEvent
 {
 public:
-  TimingEvent(std::string name, TickCount period, TickCount interval, TimingEventCallback callback);
+  TimingEvent(std::string name, TickCount period, TickCount interval, TimingEventCallback callback,
+              void* callback_param);
   ~TimingEvent();
 
   const std::string& GetName() const { return m_name; }
@@ -56,13 +56,21 @@ public:
   void SetInterval(TickCount interval) { m_interval = interval; }
   void SetPeriod(TickCount period) { m_period = period; }
 
+  // Active events are kept in an intrusive list, sorted by downcount.
+  TimingEvent* m_prev = nullptr;
+  TimingEvent* m_next = nullptr;
+
   TickCount m_downcount;
   TickCount m_time_since_last_run;
   TickCount m_period;
   TickCount m_interval;
 
   TimingEventCallback m_callback;
+  void* m_callback_param;
   std::string m_name;
+#ifdef WITH_TRACING
+  const char* m_trace_name;
+#endif
   bool m_active;
 };
 
@@ -76,7 +84,7 @@ void Shutdown();
 
 /// Creates a new event.
 std::unique_ptr<TimingEvent> CreateTimingEvent(std::string name, TickCount period, TickCount interval,
-                                               TimingEventCallback callback, bool activate);
+                                               TimingEventCallback callback, void* callback_param, bool activate);
 
 /// Serialization.
 bool DoState(StateWrapper& sw);
@@ -0,0 +1,453 @@
+#include "bench_host_interface.h"
+#include "common/audio_stream.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/string_util.h"
+#include "common/timer.h"
+#include "common/trace.h"
+#include "core/cpu_code_cache.h"
+#include "core/subsystem_timing.h"
+#include "core/system.h"
+#include "null_host_display.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+#include "scmversion/scmversion.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+Log_SetChannel(BenchHostInterface);
+
+BenchHostInterface::BenchHostInterface() = default;
+
+BenchHostInterface::~BenchHostInterface() = default;
+
+bool BenchHostInterface::Initialize()
+{
+  if (!HostInterface::Initialize())
+    return false;
+
+  // info messages go to stdout, which the report may be written to
+  const LOGLEVEL log_level = m_verbose ? LOGLEVEL_INFO : LOGLEVEL_WARNING;
+  Log::SetConsoleOutputParams(true, nullptr, log_level);
+  Log::SetFilterLevel(log_level);
+
+  SetDefaultSettings(m_settings_interface);
+  for (const SettingOverride& so : m_setting_overrides)
+    m_settings_interface.SetStringValue(so.section.c_str(), so.key.c_str(), so.value.c_str());
+
+  LoadSettings(m_settings_interface);
+  if (g_settings.gpu_renderer != GPURenderer::Software)
+  {
+    Log_WarningPrintf("Only the software renderer can run without a display, ignoring %s renderer.",
+                      Settings::GetRendererName(g_settings.gpu_renderer));
+    g_settings.gpu_renderer = GPURenderer::Software;
+  }
+
+  // worker threads would rasterize outside of the GPU timing scope, and make the GPU look cheaper than it is
+  if (g_settings.gpu_use_thread)
+  {
+    Log_WarningPrintf("Subsystem timing requires the GPU to run on the CPU thread, ignoring GPU/UseThread.");
+    g_settings.gpu_use_thread = false;
+  }
+
+  FixIncompatibleSettings(false);
+  return true;
+}
+
+void BenchHostInterface::Shutdown()
+{
+  DestroySystem();
+  HostInterface::Shutdown();
+}
+
+std::string BenchHostInterface::GetStringSettingValue(const char* section, const char* key,
+                                                      const char* default_value /* = "" */)
+{
+  return m_settings_interface.GetStringValue(section, key, default_value);
+}
+
+bool BenchHostInterface::AcquireHostDisplay()
+{
+  m_display = std::make_unique<NullHostDisplay>();
+  return true;
+}
+
+void BenchHostInterface::ReleaseHostDisplay()
+{
+  m_display.reset();
+}
+
+std::unique_ptr<AudioStream> BenchHostInterface::CreateAudioStream(AudioBackend backend)
+{
+  return AudioStream::CreateNullAudioStream();
+}
+
+void BenchHostInterface::SetDefaultSettings(SettingsInterface& si)
+{
+  HostInterface::SetDefaultSettings(si);
+
+  // nothing should slow the run down, or be written to disk
+  si.SetBoolValue("Main", "SpeedLimiterEnabled", false);
+  si.SetBoolValue("Main", "SaveStateOnExit", false);
+  si.SetStringValue("GPU", "Renderer", Settings::GetRendererName(GPURenderer::Software));
+  si.SetBoolValue("GPU", "UseThread", false);
+  si.SetStringValue("Audio", "Backend", Settings::GetAudioBackendName(AudioBackend::Null));
+  si.SetBoolValue("Audio", "Sync", false);
+  si.SetStringValue("MemoryCards", "Card1Type", Settings::GetMemoryCardTypeName(MemoryCardType::None));
+  si.SetStringValue("MemoryCards", "Card2Type", Settings::GetMemoryCardTypeName(MemoryCardType::None));
+}
+
+void BenchHostInterface::FixIncompatibleSettings(bool display_osd_messages)
+{
+  // PGXP's precise vertices are only used by the hardware renderers, but the CPU-side tracking is what gets measured,
+  // so it stays enabled with the software renderer.
+  const bool pgxp_enable = g_settings.gpu_pgxp_enable;
+  HostInterface::FixIncompatibleSettings(display_osd_messages);
+  g_settings.gpu_pgxp_enable = pgxp_enable;
+}
+
+static void PrintCommandLineHelp(const char* progname)
+{
+  std::fprintf(stderr, "DuckStation Benchmark Version %s (%s)\n", g_scm_tag_str, g_scm_branch_str);
+  std::fprintf(stderr, "Usage: %s [parameters] [--] [boot filename]\n", progname);
+  std::fprintf(stderr, "\n");
+  std::fprintf(stderr, "Boots the BIOS when no filename or save state is given.\n");
+  std::fprintf(stderr, "\n");
+  std::fprintf(stderr, "  -help: Displays this information and exits.\n");
+  std::fprintf(stderr, "  -frames <count>: Number of frames to time (default %u).\n",
+               static_cast<u32>(BenchHostInterface::DEFAULT_FRAME_COUNT));
+  std::fprintf(stderr, "  -warmup <count>: Number of frames to run before timing starts.\n");
+  std::fprintf(stderr, "  -statefile <filename>: Resumes from the specified save state.\n"
+                       "    No boot filename is required with this option.\n");
+  std::fprintf(stderr, "  -bios <filename>: Path to the BIOS image.\n");
+  std::fprintf(stderr, "  -cpu <mode>: CPU execution mode (Interpreter, CachedInterpreter, Recompiler).\n");
+  std::fprintf(stderr, "  -pgxp <mode>: PGXP mode (Disabled, Memory, CPU). Run once per mode on the same\n"
+                       "    save state to compare the cost of PGXP.\n");
+  std::fprintf(stderr, "  -set <section>/<key>=<value>: Overrides a setting, e.g. CPU/Fastmem=false.\n");
+  std::fprintf(stderr, "  -fastboot: Skips the BIOS intro when booting a disc.\n");
+  std::fprintf(stderr, "  -output <filename>: Writes the JSON report to a file instead of stdout.\n");
+#ifdef WITH_TRACING
+  std::fprintf(stderr, "  -trace <filename>: Saves a Chrome trace of the timed frames to a file.\n");
+#endif
+  std::fprintf(stderr, "  -verbose: Logs informational messages as well as warnings and errors.\n");
+  std::fprintf(stderr, "  --: Signals that no more arguments will follow and the remaining\n"
+                       "    parameters make up the filename. Use when the filename contains\n"
+                       "    spaces or starts with a dash.\n");
+  std::fprintf(stderr, "\n");
+}
+
+static std::optional<u32> ParseCount(const char* str)
+{
+  const std::optional<s32> value = StringUtil::FromChars<s32>(str);
+  if (!value.has_value() || value.value() < 0)
+    return std::nullopt;
+
+  return static_cast<u32>(value.value());
+}
+
+bool BenchHostInterface::ParseCommandLineParameters(int argc, char* argv[])
+{
+  bool no_more_args = false;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (!no_more_args)
+    {
+#define CHECK_ARG(str) !std::strcmp(argv[i], str)
+#define CHECK_ARG_PARAM(str) (!std::strcmp(argv[i], str) && ((i + 1) < argc))
+
+      if (CHECK_ARG("-help"))
+      {
+        PrintCommandLineHelp(argv[0]);
+        return false;
+      }
+      else if (CHECK_ARG_PARAM("-frames") || CHECK_ARG_PARAM("-warmup"))
+      {
+        const bool warmup = CHECK_ARG("-warmup");
+        const std::optional<u32> count = ParseCount(argv[++i]);
+        if (!count.has_value() || (!warmup && count.value() == 0))
+        {
+          std::fprintf(stderr, "Invalid frame count: '%s'\n", argv[i]);
+          return false;
+        }
+
+        (warmup ? m_warmup_frame_count : m_frame_count) = count.value();
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-statefile"))
+      {
+        m_state_filename = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-bios"))
+      {
+        m_setting_overrides.push_back(SettingOverride{"BIOS", "Path", argv[++i]});
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-cpu"))
+      {
+        if (!Settings::ParseCPUExecutionMode(argv[++i]).has_value())
+        {
+          std::fprintf(stderr, "Unknown CPU execution mode: '%s'\n", argv[i]);
+          return false;
+        }
+
+        m_setting_overrides.push_back(SettingOverride{"CPU", "ExecutionMode", argv[i]});
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-pgxp"))
+      {
+        const std::optional<PGXPMode> mode = Settings::ParsePGXPMode(argv[++i]);
+        if (!mode.has_value())
+        {
+          std::fprintf(stderr, "Unknown PGXP mode: '%s'\n", argv[i]);
+          return false;
+        }
+
+        m_setting_overrides.push_back(
+          SettingOverride{"GPU", "PGXPEnable", (mode.value() != PGXPMode::Disabled) ? "true" : "false"});
+        m_setting_overrides.push_back(
+          SettingOverride{"GPU", "PGXPCPU", (mode.value() == PGXPMode::CPU) ? "true" : "false"});
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-set"))
+      {
+        const char* setting = argv[++i];
+        const char* slash = std::strchr(setting, '/');
+        const char* equals = slash ? std::strchr(slash, '=') : nullptr;
+        if (!slash || !equals || slash == setting || equals == (slash + 1))
+        {
+          std::fprintf(stderr, "Setting should be in the form <section>/<key>=<value>: '%s'\n", setting);
+          return false;
+        }
+
+        m_setting_overrides.push_back(SettingOverride{std::string(setting, slash - setting),
+                                                      std::string(slash + 1, equals - slash - 1),
+                                                      std::string(equals + 1)});
+        continue;
+      }
+      else if (CHECK_ARG("-fastboot"))
+      {
+        m_force_fast_boot = true;
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-output"))
+      {
+        m_output_filename = argv[++i];
+        continue;
+      }
+#ifdef WITH_TRACING
+      else if (CHECK_ARG_PARAM("-trace"))
+      {
+        m_trace_filename = argv[++i];
+        continue;
+      }
+#endif
+      else if (CHECK_ARG("-verbose"))
+      {
+        m_verbose = true;
+        continue;
+      }
+      else if (CHECK_ARG("--"))
+      {
+        no_more_args = true;
+        continue;
+      }
+      else if (argv[i][0] == '-')
+      {
+        std::fprintf(stderr, "Unknown parameter: '%s'\n", argv[i]);
+        return false;
+      }
+
+#undef CHECK_ARG
+#undef CHECK_ARG_PARAM
+    }
+
+    if (!m_boot_filename.empty())
+      m_boot_filename += ' ';
+    m_boot_filename += argv[i];
+  }
+
+  return true;
+}
+
+bool BenchHostInterface::BootForBenchmark()
+{
+  if (!m_state_filename.empty())
+  {
+    if (!m_boot_filename.empty())
+      Log_WarningPrintf("Ignoring boot filename '%s', the save state has its own media.", m_boot_filename.c_str());
+
+    if (!LoadState(m_state_filename.c_str()))
+    {
+      ReportFormattedError("Failed to load save state '%s'", m_state_filename.c_str());
+      return false;
+    }
+  }
+  else
+  {
+    SystemBootParameters boot_params(m_boot_filename);
+    boot_params.override_fast_boot = m_force_fast_boot;
+    boot_params.force_software_renderer = true;
+    if (!BootSystem(boot_params))
+      return false;
+  }
+
+  // the null stream drops samples as soon as they're written, but never wait for it regardless
+  m_audio_stream->SetSync(false);
+  return true;
+}
+
+bool BenchHostInterface::Run()
+{
+  if (!BootForBenchmark())
+    return false;
+
+  for (u32 i = 0; i < m_warmup_frame_count && System::IsRunning(); i++)
+    System::RunFrame();
+
+  Results results = {};
+  SubsystemTiming::Start();
+#ifdef WITH_TRACING
+  if (!m_trace_filename.empty())
+  {
+    Trace::SetThreadName("Emulation Thread");
+    Trace::SetRecording(true);
+  }
+#endif
+
+  const Common::Timer::Value start_time = Common::Timer::GetValue();
+  Common::Timer::Value last_frame_time = start_time;
+  for (; results.frames < m_frame_count && System::IsRunning(); results.frames++)
+  {
+    System::RunFrame();
+
+    const Common::Timer::Value frame_time = Common::Timer::GetValue();
+    results.worst_frame_time = std::max(
+      results.worst_frame_time, Common::Timer::ConvertValueToSeconds(frame_time - last_frame_time));
+    last_frame_time = frame_time;
+  }
+  results.elapsed_time = Common::Timer::ConvertValueToSeconds(last_frame_time - start_time);
+
+  SubsystemTiming::Stop();
+
+#ifdef WITH_TRACING
+  if (!m_trace_filename.empty())
+  {
+    Trace::SetRecording(false);
+    if (!Trace::SaveChromeTrace(m_trace_filename.c_str()))
+    {
+      ReportFormattedError("Failed to save trace to '%s'", m_trace_filename.c_str());
+      return false;
+    }
+  }
+#endif
+
+  if (results.frames < m_frame_count)
+  {
+    ReportFormattedError("System stopped after %u of %u frames", results.frames, m_frame_count);
+    return false;
+  }
+
+  return WriteReport(FormatReport(results));
+}
+
+std::string BenchHostInterface::FormatReport(const Results& results) const
+{
+  const double frames = static_cast<double>(results.frames);
+  const double fps = (results.elapsed_time > 0.0) ? (frames / results.elapsed_time) : 0.0;
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+
+  writer.Key("version");
+  writer.String(g_scm_tag_str);
+  writer.Key("branch");
+  writer.String(g_scm_branch_str);
+  writer.Key("filename");
+  writer.String(m_state_filename.empty() ? m_boot_filename.c_str() : m_state_filename.c_str());
+  writer.Key("cpu_execution_mode");
+  writer.String(Settings::GetCPUExecutionModeName(g_settings.cpu_execution_mode));
+  writer.Key("pgxp_mode");
+  writer.String(Settings::GetPGXPModeName(g_settings.GetPGXPMode()));
+  writer.Key("gpu_renderer");
+  writer.String(Settings::GetRendererName(g_settings.gpu_renderer));
+  writer.Key("gpu_use_thread");
+  writer.Bool(g_settings.gpu_use_thread);
+
+  writer.Key("warmup_frames");
+  writer.Uint(m_warmup_frame_count);
+  writer.Key("frames");
+  writer.Uint(results.frames);
+  writer.Key("elapsed_seconds");
+  writer.Double(results.elapsed_time);
+  writer.Key("fps");
+  writer.Double(fps);
+  writer.Key("speed_percent");
+  writer.Double(fps / System::GetThrottleFrequency() * 100.0);
+  writer.Key("average_frame_time_ms");
+  writer.Double((frames > 0.0) ? (results.elapsed_time * 1000.0 / frames) : 0.0);
+  writer.Key("worst_frame_time_ms");
+  writer.Double(results.worst_frame_time * 1000.0);
+
+  // whatever isn't covered by a subsystem ends up in the CPU
+  writer.Key("subsystems");
+  writer.StartObject();
+  for (u32 i = 0; i < static_cast<u32>(SubsystemTiming::Subsystem::Count); i++)
+  {
+    const SubsystemTiming::Subsystem subsystem = static_cast<SubsystemTiming::Subsystem>(i);
+    const double time = SubsystemTiming::GetTimeSeconds(subsystem);
+
+    writer.Key(SubsystemTiming::GetSubsystemName(subsystem));
+    writer.StartObject();
+    writer.Key("seconds");
+    writer.Double(time);
+    writer.Key("percent");
+    writer.Double((results.elapsed_time > 0.0) ? (time / results.elapsed_time * 100.0) : 0.0);
+    writer.Key("ms_per_frame");
+    writer.Double((frames > 0.0) ? (time * 1000.0 / frames) : 0.0);
+    writer.EndObject();
+  }
+  writer.EndObject();
+
+  // block counts are at the end of the run, compile counts include the warmup frames
+  const CPU::CodeCache::Stats code_cache_stats = CPU::CodeCache::GetStats();
+  writer.Key("code_cache");
+  writer.StartObject();
+  writer.Key("recompiler_tiering");
+  writer.Bool(g_settings.cpu_recompiler_tiering);
+  writer.Key("interpreted_blocks");
+  writer.Uint(code_cache_stats.interpreted_blocks);
+  writer.Key("recompiled_blocks");
+  writer.Uint(code_cache_stats.recompiled_blocks);
+  writer.Key("demoted_blocks");
+  writer.Uint(code_cache_stats.demoted_blocks);
+  writer.Key("host_compile_count");
+  writer.Uint64(code_cache_stats.host_compile_count);
+  writer.Key("code_change_count");
+  writer.Uint64(code_cache_stats.code_change_count);
+  writer.EndObject();
+
+  writer.EndObject();
+  return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+bool BenchHostInterface::WriteReport(const std::string& report) const
+{
+  if (m_output_filename.empty())
+  {
+    std::fprintf(stdout, "%s\n", report.c_str());
+    std::fflush(stdout);
+    return true;
+  }
+
+  if (!FileSystem::WriteFileToString(m_output_filename.c_str(), report))
+  {
+    Log_ErrorPrintf("Failed to write report to '%s'", m_output_filename.c_str());
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "core/host_interface.h"
+#include "memory_settings_interface.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+/// Runs the emulator without a window or audio device, as fast as it can go, and reports how long each part of the
+/// system took. The output is JSON so results can be compared between builds.
+class BenchHostInterface final : public HostInterface
+{
+public:
+  enum : u32
+  {
+    DEFAULT_FRAME_COUNT = 3600
+  };
+
+  BenchHostInterface();
+  ~BenchHostInterface();
+
+  bool Initialize() override;
+  void Shutdown() override;
+
+  std::string GetStringSettingValue(const char* section, const char* key, const char* default_value = "") override;
+
+  bool ParseCommandLineParameters(int argc, char* argv[]);
+
+  /// Boots the system, runs the requested number of frames, and writes the report. Returns false if any step failed.
+  bool Run();
+
+protected:
+  bool AcquireHostDisplay() override;
+  void ReleaseHostDisplay() override;
+  std::unique_ptr<AudioStream> CreateAudioStream(AudioBackend backend) override;
+
+  void SetDefaultSettings(SettingsInterface& si) override;
+  void FixIncompatibleSettings(bool display_osd_messages) override;
+
+private:
+  struct SettingOverride
+  {
+    std::string section;
+    std::string key;
+    std::string value;
+  };
+
+  struct Results
+  {
+    u32 frames;
+    double elapsed_time;
+    double worst_frame_time;
+  };
+
+  bool BootForBenchmark();
+  std::string FormatReport(const Results& results) const;
+  bool WriteReport(const std::string& report) const;
+
+  MemorySettingsInterface m_settings_interface;
+  std::vector<SettingOverride> m_setting_overrides;
+
+  std::string m_boot_filename;
+  std::string m_state_filename;
+  std::string m_output_filename;
+#ifdef WITH_TRACING
+  std::string m_trace_filename;
+#endif
+  std::optional<bool> m_force_fast_boot;
+  u32 m_frame_count = DEFAULT_FRAME_COUNT;
+  u32 m_warmup_frame_count = 0;
+  bool m_verbose = false;
+};
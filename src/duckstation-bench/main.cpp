@@ -0,0 +1,21 @@
+#include "bench_host_interface.h"
+#include <cstdlib>
+#include <memory>
+
+int main(int argc, char* argv[])
+{
+  std::unique_ptr<BenchHostInterface> host_interface = std::make_unique<BenchHostInterface>();
+  if (!host_interface->ParseCommandLineParameters(argc, argv))
+    return EXIT_FAILURE;
+
+  if (!host_interface->Initialize())
+  {
+    host_interface->Shutdown();
+    return EXIT_FAILURE;
+  }
+
+  const bool result = host_interface->Run();
+  host_interface->Shutdown();
+  host_interface.reset();
+  return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,103 @@
+#include "memory_settings_interface.h"
+#include "common/string_util.h"
+#include <algorithm>
+
+void MemorySettingsInterface::Clear()
+{
+  m_values.clear();
+  m_lists.clear();
+}
+
+const std::string* MemorySettingsInterface::FindValue(const char* section, const char* key) const
+{
+  const auto iter = m_values.find(Key(section, key));
+  return (iter != m_values.end()) ? &iter->second : nullptr;
+}
+
+int MemorySettingsInterface::GetIntValue(const char* section, const char* key, int default_value /* = 0 */)
+{
+  const std::string* value = FindValue(section, key);
+  return value ? StringUtil::FromChars<int>(*value).value_or(default_value) : default_value;
+}
+
+float MemorySettingsInterface::GetFloatValue(const char* section, const char* key, float default_value /* = 0.0f */)
+{
+  const std::string* value = FindValue(section, key);
+  return value ? StringUtil::FromChars<float>(*value).value_or(default_value) : default_value;
+}
+
+bool MemorySettingsInterface::GetBoolValue(const char* section, const char* key, bool default_value /* = false */)
+{
+  const std::string* value = FindValue(section, key);
+  return (value && !value->empty()) ? StringUtil::FromChars<bool>(*value).value_or(default_value) : default_value;
+}
+
+std::string MemorySettingsInterface::GetStringValue(const char* section, const char* key,
+                                                    const char* default_value /* = "" */)
+{
+  const std::string* value = FindValue(section, key);
+  return value ? *value : std::string(default_value);
+}
+
+void MemorySettingsInterface::SetIntValue(const char* section, const char* key, int value)
+{
+  m_values[Key(section, key)] = std::to_string(value);
+}
+
+void MemorySettingsInterface::SetFloatValue(const char* section, const char* key, float value)
+{
+  m_values[Key(section, key)] = StringUtil::StdStringFromFormat("%f", value);
+}
+
+void MemorySettingsInterface::SetBoolValue(const char* section, const char* key, bool value)
+{
+  m_values[Key(section, key)] = value ? "true" : "false";
+}
+
+void MemorySettingsInterface::SetStringValue(const char* section, const char* key, const char* value)
+{
+  m_values[Key(section, key)] = value;
+}
+
+std::vector<std::string> MemorySettingsInterface::GetStringList(const char* section, const char* key)
+{
+  const auto iter = m_lists.find(Key(section, key));
+  return (iter != m_lists.end()) ? iter->second : std::vector<std::string>();
+}
+
+void MemorySettingsInterface::SetStringList(const char* section, const char* key,
+                                            const std::vector<std::string>& items)
+{
+  m_lists[Key(section, key)] = items;
+}
+
+bool MemorySettingsInterface::RemoveFromStringList(const char* section, const char* key, const char* item)
+{
+  const auto iter = m_lists.find(Key(section, key));
+  if (iter == m_lists.end())
+    return false;
+
+  std::vector<std::string>& items = iter->second;
+  const auto item_iter = std::find(items.begin(), items.end(), item);
+  if (item_iter == items.end())
+    return false;
+
+  items.erase(item_iter);
+  return true;
+}
+
+bool MemorySettingsInterface::AddToStringList(const char* section, const char* key, const char* item)
+{
+  std::vector<std::string>& items = m_lists[Key(section, key)];
+  if (std::find(items.begin(), items.end(), item) != items.end())
+    return false;
+
+  items.emplace_back(item);
+  return true;
+}
+
+void MemorySettingsInterface::DeleteValue(const char* section, const char* key)
+{
+  m_values.erase(Key(section, key));
+  m_lists.erase(Key(section, key));
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "core/settings.h"
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Settings which only live for the lifetime of the process, so benchmark runs can't be affected by a config file.
+class MemorySettingsInterface final : public SettingsInterface
+{
+public:
+  void Clear() override;
+
+  int GetIntValue(const char* section, const char* key, int default_value = 0) override;
+  float GetFloatValue(const char* section, const char* key, float default_value = 0.0f) override;
+  bool GetBoolValue(const char* section, const char* key, bool default_value = false) override;
+  std::string GetStringValue(const char* section, const char* key, const char* default_value = "") override;
+
+  void SetIntValue(const char* section, const char* key, int value) override;
+  void SetFloatValue(const char* section, const char* key, float value) override;
+  void SetBoolValue(const char* section, const char* key, bool value) override;
+  void SetStringValue(const char* section, const char* key, const char* value) override;
+
+  std::vector<std::string> GetStringList(const char* section, const char* key) override;
+  void SetStringList(const char* section, const char* key, const std::vector<std::string>& items) override;
+  bool RemoveFromStringList(const char* section, const char* key, const char* item) override;
+  bool AddToStringList(const char* section, const char* key, const char* item) override;
+
+  void DeleteValue(const char* section, const char* key) override;
+
+private:
+  using Key = std::pair<std::string, std::string>;
+
+  const std::string* FindValue(const char* section, const char* key) const;
+
+  std::map<Key, std::string> m_values;
+  std::map<Key, std::vector<std::string>> m_lists;
+};
@@ -0,0 +1,115 @@
+#include "null_host_display.h"
+
+namespace {
+class NullDisplayTexture final : public HostDisplayTexture
+{
+public:
+  NullDisplayTexture(u32 width, u32 height) : m_width(width), m_height(height) {}
+  ~NullDisplayTexture() override = default;
+
+  void* GetHandle() const override { return const_cast<NullDisplayTexture*>(this); }
+  u32 GetWidth() const override { return m_width; }
+  u32 GetHeight() const override { return m_height; }
+
+private:
+  u32 m_width;
+  u32 m_height;
+};
+} // namespace
+
+NullHostDisplay::NullHostDisplay() = default;
+
+NullHostDisplay::~NullHostDisplay() = default;
+
+HostDisplay::RenderAPI NullHostDisplay::GetRenderAPI() const
+{
+  return RenderAPI::None;
+}
+
+void* NullHostDisplay::GetRenderDevice() const
+{
+  return nullptr;
+}
+
+void* NullHostDisplay::GetRenderContext() const
+{
+  return nullptr;
+}
+
+bool NullHostDisplay::HasRenderDevice() const
+{
+  return true;
+}
+
+bool NullHostDisplay::HasRenderSurface() const
+{
+  return true;
+}
+
+bool NullHostDisplay::CreateRenderDevice(const WindowInfo& wi, std::string_view adapter_name, bool debug_device)
+{
+  m_window_info = wi;
+  return true;
+}
+
+bool NullHostDisplay::InitializeRenderDevice(std::string_view shader_cache_directory, bool debug_device)
+{
+  return true;
+}
+
+void NullHostDisplay::DestroyRenderDevice() {}
+
+bool NullHostDisplay::MakeRenderContextCurrent()
+{
+  return true;
+}
+
+bool NullHostDisplay::DoneRenderContextCurrent()
+{
+  return true;
+}
+
+bool NullHostDisplay::ChangeRenderWindow(const WindowInfo& wi)
+{
+  m_window_info = wi;
+  return true;
+}
+
+void NullHostDisplay::ResizeRenderWindow(s32 new_window_width, s32 new_window_height)
+{
+  m_window_info.surface_width = new_window_width;
+  m_window_info.surface_height = new_window_height;
+}
+
+void NullHostDisplay::DestroyRenderSurface() {}
+
+bool NullHostDisplay::CreateResources()
+{
+  return true;
+}
+
+void NullHostDisplay::DestroyResources() {}
+
+std::unique_ptr<HostDisplayTexture> NullHostDisplay::CreateTexture(u32 width, u32 height, const void* data,
+                                                                   u32 data_stride, bool dynamic)
+{
+  return std::make_unique<NullDisplayTexture>(width, height);
+}
+
+void NullHostDisplay::UpdateTexture(HostDisplayTexture* texture, u32 x, u32 y, u32 width, u32 height,
+                                    const void* data, u32 data_stride)
+{
+}
+
+bool NullHostDisplay::DownloadTexture(const void* texture_handle, u32 x, u32 y, u32 width, u32 height, void* out_data,
+                                      u32 out_data_stride)
+{
+  return false;
+}
+
+void NullHostDisplay::SetVSync(bool enabled) {}
+
+bool NullHostDisplay::Render()
+{
+  return true;
+}
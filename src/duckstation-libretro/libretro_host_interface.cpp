@@ -370,7 +370,7 @@ void LibretroHostInterface::OnSystemDestroyed()
   m_using_hardware_renderer = false;
 }
 
-static std::array<retro_core_option_definition, 32> s_option_definitions = {{
+static std::array<retro_core_option_definition, 36> s_option_definitions = {{
   {"duckstation_Console.Region",
    "Console Region",
    "Determines which region/hardware to emulate. Auto-Detect will use the region of the disc inserted.",
@@ -412,6 +412,24 @@ static std::array<retro_core_option_definition, 32> s_option_definitions = {{
    "to performance. If games are running too fast, try enabling this option.",
    {{"true", "Enabled"}, {"false", "Disabled"}},
    "false"},
+  {"duckstation_CPU.Fastmem",
+   "CPU Recompiler Fast Memory Access",
+   "Maps RAM into the host address space so the recompiler can access it directly. Provides a significant performance "
+   "improvement in most games. Disable if you experience crashes on your device.",
+   {{"true", "Enabled"}, {"false", "Disabled"}},
+   "true"},
+  {"duckstation_CPU.RecompilerTraces",
+   "CPU Recompiler Traces",
+   "Compiles code across unconditional branches into a single block, so hot loops run without returning to the "
+   "dispatcher. Disable if you experience crashes or glitches.",
+   {{"true", "Enabled"}, {"false", "Disabled"}},
+   "true"},
+  {"duckstation_CPU.RecompilerTiering",
+   "CPU Recompiler Tiering",
+   "Interprets code until it has run enough times to be worth compiling, and stops recompiling code which keeps "
+   "modifying itself. Reduces stutter in games which load code overlays often.",
+   {{"true", "Enabled"}, {"false", "Disabled"}},
+   "true"},
   {"duckstation_GPU.Renderer",
    "GPU Renderer",
    "Which renderer to use to emulate the GPU",
@@ -449,6 +467,11 @@ static std::array<retro_core_option_definition, 32> s_option_definitions = {{
     {"15", "15x"},
     {"16", "16x"}},
    "1"},
+  {"duckstation_GPU.UseThread",
+   "Threaded Rendering",
+   "Uses worker threads to draw primitives with the software renderer, so the emulated CPU doesn't wait for them.",
+   {{"true", "Enabled"}, {"false", "Disabled"}},
+   "true"},
   {"duckstation_GPU.TrueColor",
    "True Color Rendering",
    "Disables dithering and uses the full 8 bits per channel of color information. May break rendering in some games.",
@@ -510,7 +533,7 @@ static std::array<retro_core_option_definition, 32> s_option_definitions = {{
   {"duckstation_GPU.PGXPCPU",
    "PGXP CPU Mode",
    "Tries to track vertex manipulation through the CPU. Some games require this option for PGXP to be effective. "
-   "Very slow, and incompatible with the recompiler.",
+   "Slow, especially with the interpreters.",
    {{"true", "Enabled"}, {"false", "Disabled"}},
    "false"},
   {"duckstation_Display.CropMode",
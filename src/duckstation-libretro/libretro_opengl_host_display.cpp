@@ -17,6 +17,12 @@ HostDisplay::RenderAPI LibretroOpenGLHostDisplay::GetRenderAPI() const
   return m_is_gles ? HostDisplay::RenderAPI::OpenGLES : HostDisplay::RenderAPI::OpenGL;
 }
 
+bool LibretroOpenGLHostDisplay::SupportsThreadedRendering() const
+{
+  // The libretro frontend owns the context, and expects it to be used from the thread calling retro_run().
+  return false;
+}
+
 void LibretroOpenGLHostDisplay::SetVSync(bool enabled)
 {
   // The libretro frontend controls this.
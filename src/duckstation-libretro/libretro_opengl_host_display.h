@@ -16,6 +16,7 @@ public:
   static bool RequestHardwareRendererContext(retro_hw_render_callback* cb, bool prefer_gles);
 
   RenderAPI GetRenderAPI() const override;
+  bool SupportsThreadedRendering() const override;
 
   bool CreateRenderDevice(const WindowInfo& wi, std::string_view adapter_name, bool debug_device) override;
   void DestroyRenderDevice() override;
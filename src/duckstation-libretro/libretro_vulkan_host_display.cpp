@@ -14,6 +14,12 @@ LibretroVulkanHostDisplay::LibretroVulkanHostDisplay() = default;
 
 LibretroVulkanHostDisplay::~LibretroVulkanHostDisplay() = default;
 
+bool LibretroVulkanHostDisplay::SupportsThreadedRendering() const
+{
+  // Command buffers are submitted through the frontend's queue, which is only valid from the retro_run() thread.
+  return false;
+}
+
 void LibretroVulkanHostDisplay::SetVSync(bool enabled)
 {
   // The libretro frontend controls this.
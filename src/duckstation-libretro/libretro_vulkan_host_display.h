@@ -14,6 +14,8 @@ public:
 
   static bool RequestHardwareRendererContext(retro_hw_render_callback* cb);
 
+  bool SupportsThreadedRendering() const override;
+
   bool CreateRenderDevice(const WindowInfo& wi, std::string_view adapter_name, bool debug_device) override;
   void DestroyRenderDevice() override;
 
@@ -29,6 +29,11 @@ AdvancedSettingsWidget::AdvancedSettingsWidget(QtHostInterface* host_interface,
                                                "RecompilerMemoryExceptions", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.cpuRecompilerICache, "CPU", "RecompilerICache",
                                                false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.cpuFastmem, "CPU", "Fastmem", true);
+  SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.cpuRecompilerTraces, "CPU", "RecompilerTraces",
+                                               true);
+  SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.cpuRecompilerTiering, "CPU", "RecompilerTiering",
+                                               true);
 
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.showDebugMenu, "Main", "ShowDebugMenu");
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.gpuUseDebugDevice, "GPU", "UseDebugDevice");
@@ -44,6 +49,20 @@ AdvancedSettingsWidget::AdvancedSettingsWidget(QtHostInterface* host_interface,
     m_ui.cpuRecompilerICache, tr("Enable Recompiler ICache"), tr("Unchecked"),
     tr("Determines whether the CPU's instruction cache is simulated in the recompiler. Improves accuracy at a small "
        "cost to performance. If games are running too fast, try enabling this option."));
+  dialog->registerWidgetHelp(
+    m_ui.cpuFastmem, tr("Enable Recompiler Fast Memory Access"), tr("Checked"),
+    tr("Maps RAM and the scratchpad into the host address space, so the recompiler can access them directly instead "
+       "of calling the memory handlers. Accesses which hit hardware registers are patched at runtime to use the slow "
+       "path. Only disable this option when debugging."));
+  dialog->registerWidgetHelp(
+    m_ui.cpuRecompilerTraces, tr("Enable Recompiler Traces"), tr("Checked"),
+    tr("Compiles code across unconditional branches into a single block, so hot loops run without returning to the "
+       "dispatcher. Only disable this option when debugging."));
+  dialog->registerWidgetHelp(
+    m_ui.cpuRecompilerTiering, tr("Enable Recompiler Block Tiering"), tr("Checked"),
+    tr("Interprets code until it has run enough times to be worth compiling, and keeps code which repeatedly modifies "
+       "itself in the interpreter. Reduces stutter in games which load code overlays often. Only disable this option "
+       "when debugging."));
 }
 
 AdvancedSettingsWidget::~AdvancedSettingsWidget() = default;
@@ -55,4 +74,7 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   m_ui.gpuFIFOSize->setValue(static_cast<int>(Settings::DEFAULT_GPU_FIFO_SIZE));
   m_ui.gpuMaxRunAhead->setValue(static_cast<int>(Settings::DEFAULT_GPU_MAX_RUN_AHEAD));
   m_ui.cpuRecompilerMemoryExceptions->setChecked(false);
+  m_ui.cpuFastmem->setChecked(true);
+  m_ui.cpuRecompilerTraces->setChecked(true);
+  m_ui.cpuRecompilerTiering->setChecked(true);
 }
@@ -32,6 +32,10 @@ ConsoleSettingsWidget::ConsoleSettingsWidget(QtHostInterface* host_interface, QW
                                                &Settings::ParseCPUExecutionMode, &Settings::GetCPUExecutionModeName,
                                                Settings::DEFAULT_CPU_EXECUTION_MODE);
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.cdromReadThread, "CDROM", "ReadThread");
+  SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.cdromReadaheadSectors, "CDROM", "ReadaheadSectors",
+                                              static_cast<int>(Settings::DEFAULT_CDROM_READAHEAD_SECTORS));
+  SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.cdromCHDCacheSize, "CDROM", "CHDCacheSizeMB",
+                                              static_cast<int>(Settings::DEFAULT_CDROM_CHD_CACHE_SIZE_MB));
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.cdromRegionCheck, "CDROM", "RegionCheck");
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.cdromLoadImageToRAM, "CDROM", "LoadImageToRAM",
                                                false);
@@ -42,6 +46,15 @@ ConsoleSettingsWidget::ConsoleSettingsWidget(QtHostInterface* host_interface, QW
                              tr("Patches the BIOS to skip the console's boot animation. Does not work with all games, "
                                 "but usually safe to enabled."));
   
+  dialog->registerWidgetHelp(
+    m_ui.cdromReadaheadSectors, tr("Readahead Sectors"), QStringLiteral("8"),
+    tr("Number of sectors the read thread loads ahead of the emulated drive. Higher values help with slow storage such "
+       "as network shares or compressed images, 0 only reads sectors when they are requested."));
+  dialog->registerWidgetHelp(
+    m_ui.cdromCHDCacheSize, tr("CHD Cache Size"), QStringLiteral("16"),
+    tr("Memory used to keep decompressed blocks of CHD images. A larger cache avoids decompressing the same data again "
+       "when a game switches between files on the disc. Upcoming blocks are only decompressed in advance when the "
+       "cache is enabled."));
   dialog->registerWidgetHelp(m_ui.cdromLoadImageToRAM, tr("Preload Image to RAM"), tr("Unchecked"),
                              tr("Loads the game image into RAM. Useful for network paths that may become unreliable during gameplay. In some cases also eliminates stutter when games initiate audio track playback."));
 }
@@ -436,26 +436,17 @@ void GamePropertiesDialog::computeTrackHashes()
   if (!image)
     return;
 
+  // all tracks in one pass, so they're hashed in parallel
   QtProgressCallback progress_callback(this);
-  progress_callback.SetProgressRange(image->GetTrackCount());
+  std::vector<CDImageHasher::Hash> hashes;
+  if (!CDImageHasher::GetTrackHashes(image.get(), &hashes, &progress_callback))
+    return;
 
-  for (u8 track = 1; track <= image->GetTrackCount(); track++)
+  for (u32 i = 0; i < static_cast<u32>(hashes.size()); i++)
   {
-    progress_callback.SetProgressValue(track - 1);
-    progress_callback.PushState();
-
-    CDImageHasher::Hash hash;
-    if (!CDImageHasher::GetTrackHash(image.get(), track, &hash, &progress_callback))
-    {
-      progress_callback.PopState();
-      break;
-    }
+    QString hash_string(QString::fromStdString(CDImageHasher::HashToString(hashes[i])));
 
-    QString hash_string(QString::fromStdString(CDImageHasher::HashToString(hash)));
-
-    QTableWidgetItem* item = m_ui.tracks->item(track - 1, 4);
+    QTableWidgetItem* item = m_ui.tracks->item(i, 4);
     item->setText(hash_string);
-
-    progress_callback.PopState();
   }
 }
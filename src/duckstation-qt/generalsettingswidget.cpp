@@ -25,6 +25,15 @@ GeneralSettingsWidget::GeneralSettingsWidget(QtHostInterface* host_interface, QW
                                                "LoadDevicesFromSaveStates", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.applyGameSettings, "Main", "ApplyGameSettings",
                                                true);
+  SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.compressSaveStates, "Main",
+                                               "CompressSaveStates", true);
+  SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.rewindEnable, "Main", "RewindEnable", false);
+  SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.rewindSaveInterval, "Main", "RewindSaveInterval",
+                                              static_cast<int>(Settings::DEFAULT_REWIND_SAVE_INTERVAL));
+  SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.rewindMemoryBudget, "Main",
+                                              "RewindMemoryBudgetMB",
+                                              static_cast<int>(Settings::DEFAULT_REWIND_MEMORY_BUDGET_MB));
+  SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.runaheadFrames, "Main", "RunaheadFrames", 0);
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.showOSDMessages, "Display", "ShowOSDMessages",
                                                true);
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.showFPS, "Display", "ShowFPS", false);
@@ -57,6 +66,25 @@ GeneralSettingsWidget::GeneralSettingsWidget(QtHostInterface* host_interface, QW
   dialog->registerWidgetHelp(m_ui.saveStateOnExit, tr("Save State On Exit"), tr("Checked"),
                              tr("Automatically saves the emulator state when powering down or exiting. You can then "
                                 "resume directly from where you left off next time."));
+  dialog->registerWidgetHelp(m_ui.compressSaveStates, tr("Compress Save States"), tr("Checked"),
+                             tr("Compresses save states before writing them to disk, making them several times "
+                                "smaller. States are written in the background, so this does not slow down saving."));
+  dialog->registerWidgetHelp(
+    m_ui.rewindEnable, tr("Enable Rewind"), tr("Unchecked"),
+    tr("Periodically keeps a snapshot of the emulated system in memory, so you can go back in time by holding the "
+       "Rewind hotkey. Each snapshot only stores what changed since the previous one."));
+  dialog->registerWidgetHelp(
+    m_ui.rewindSaveInterval, tr("Rewind Save Interval"), QStringLiteral("30"),
+    tr("Number of frames between rewind snapshots. Smaller intervals rewind more smoothly, but cost more time on the "
+       "emulation thread. The cost of each snapshot is shown in the performance overlay."));
+  dialog->registerWidgetHelp(m_ui.rewindMemoryBudget, tr("Rewind Memory Budget"), QStringLiteral("64"),
+                             tr("Memory used to keep rewind snapshots. The oldest snapshots are dropped when it is "
+                                "exceeded, so a larger budget lets you rewind further."));
+  dialog->registerWidgetHelp(
+    m_ui.runaheadFrames, tr("Run-Ahead Frames"), QStringLiteral("0"),
+    tr("Reduces input latency by running this many extra frames after each frame and showing the last one, then "
+       "rolling back before the next frame. The extra frames cost emulation time each frame, which is shown in the "
+       "performance overlay. Set to 0 to disable."));
   dialog->registerWidgetHelp(m_ui.startFullscreen, tr("Start Fullscreen"), tr("Unchecked"),
                              tr("Automatically switches to fullscreen mode when a game is started."));
   dialog->registerWidgetHelp(
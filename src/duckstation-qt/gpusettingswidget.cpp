@@ -30,6 +30,8 @@ GPUSettingsWidget::GPUSettingsWidget(QtHostInterface* host_interface, QWidget* p
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.displayIntegerScaling, "Display",
                                                "IntegerScaling");
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.vsync, "Display", "VSync");
+  SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.gpuThread, "GPU", "UseThread", true);
+  SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.gpuHardwareThread, "GPU", "UseHardwareThread");
   SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.resolutionScale, "GPU", "ResolutionScale");
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.trueColor, "GPU", "TrueColor");
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.scaledDithering, "GPU", "ScaledDithering");
@@ -70,6 +72,14 @@ GPUSettingsWidget::GPUSettingsWidget(QtHostInterface* host_interface, QWidget* p
     m_ui.adapter, tr("Adapter"), tr("(Default)"),
     tr("If your system contains multiple GPUs or adapters, you can select which GPU you wish to use for the hardware "
        "renderers. <br>This option is only supported in Direct3D and Vulkan. OpenGL will always use the default device."));
+  dialog->registerWidgetHelp(
+    m_ui.gpuThread, tr("Threaded Rendering"), tr("Checked"),
+    tr("Uses worker threads to draw primitives with the software renderer, so the emulated CPU doesn't have to wait "
+       "for them. <br>Only applies to the software renderer."));
+  dialog->registerWidgetHelp(
+    m_ui.gpuHardwareThread, tr("Threaded Submission"), tr("Unchecked"),
+    tr("Submits draws from a separate thread with the OpenGL and Vulkan renderers, so the emulated CPU doesn't have "
+       "to wait for the graphics driver. <br>Has no effect with the software and Direct3D 11 renderers."));
   dialog->registerWidgetHelp(
     m_ui.displayAspectRatio, tr("Aspect Ratio"), QStringLiteral("4:3"),
     tr("Changes the aspect ratio used to display the console's output to the screen. The default "
@@ -145,7 +155,7 @@ GPUSettingsWidget::GPUSettingsWidget(QtHostInterface* host_interface, QWidget* p
   dialog->registerWidgetHelp(
     m_ui.pgxpCPUMode, tr("CPU Mode"), tr("Unchecked"),
     tr("Tries to track vertex manipulation through the CPU. Some games require this option for PGXP to be effective. "
-       "Very slow, and incompatible with the recompiler."));
+       "Slow, especially with the interpreters."));
 }
 
 GPUSettingsWidget::~GPUSettingsWidget() = default;
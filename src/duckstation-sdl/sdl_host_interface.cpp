@@ -4,6 +4,7 @@
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/string_util.h"
+#include "core/cdrom_async_reader.h"
 #include "core/controller.h"
 #include "core/gpu.h"
 #include "core/host_display.h"
@@ -954,6 +955,9 @@ void SDLHostInterface::DrawDebugMenu()
 
   settings_changed |= ImGui::MenuItem("Recompiler Memory Exceptions", nullptr, &m_settings_copy.cpu_recompiler_memory_exceptions);
   settings_changed |= ImGui::MenuItem("Recompiler ICache", nullptr, &m_settings_copy.cpu_recompiler_icache);
+  settings_changed |= ImGui::MenuItem("Recompiler Fastmem", nullptr, &m_settings_copy.cpu_fastmem);
+  settings_changed |= ImGui::MenuItem("Recompiler Traces", nullptr, &m_settings_copy.cpu_recompiler_traces);
+  settings_changed |= ImGui::MenuItem("Recompiler Tiering", nullptr, &m_settings_copy.cpu_recompiler_tiering);
 
   if (settings_changed)
   {
@@ -1135,14 +1139,67 @@ void SDLHostInterface::DrawSettingsWindow()
         settings_changed |= ImGui::Checkbox("Pause On Start", &m_settings_copy.start_paused);
         settings_changed |= ImGui::Checkbox("Start Fullscreen", &m_settings_copy.start_fullscreen);
         settings_changed |= ImGui::Checkbox("Save State On Exit", &m_settings_copy.save_state_on_exit);
+        settings_changed |= ImGui::Checkbox("Compress Save States", &m_settings_copy.save_state_compression);
         settings_changed |=
           ImGui::Checkbox("Load Devices From Save States", &m_settings_copy.load_devices_from_save_states);
       }
 
+      ImGui::NewLine();
+      if (DrawSettingsSectionHeader("Rewind and Run-Ahead"))
+      {
+        settings_changed |= ImGui::Checkbox("Enable Rewind", &m_settings_copy.rewind_enable);
+
+        int rewind_save_interval = static_cast<int>(m_settings_copy.rewind_save_interval);
+        ImGui::Text("Save Interval (Frames):");
+        ImGui::SameLine(indent);
+        if (ImGui::SliderInt("##rewind_save_interval", &rewind_save_interval, 1, 300))
+        {
+          m_settings_copy.rewind_save_interval = static_cast<u32>(rewind_save_interval);
+          settings_changed = true;
+        }
+
+        int rewind_memory_budget = static_cast<int>(m_settings_copy.rewind_memory_budget_mb);
+        ImGui::Text("Memory Budget (MB):");
+        ImGui::SameLine(indent);
+        if (ImGui::SliderInt("##rewind_memory_budget", &rewind_memory_budget, 8, 1024))
+        {
+          m_settings_copy.rewind_memory_budget_mb = static_cast<u32>(rewind_memory_budget);
+          settings_changed = true;
+        }
+
+        int runahead_frames = static_cast<int>(m_settings_copy.runahead_frames);
+        ImGui::Text("Run-Ahead Frames:");
+        ImGui::SameLine(indent);
+        if (ImGui::SliderInt("##runahead_frames", &runahead_frames, 0, 10))
+        {
+          m_settings_copy.runahead_frames = static_cast<u32>(runahead_frames);
+          settings_changed = true;
+        }
+      }
+
       ImGui::NewLine();
       if (DrawSettingsSectionHeader("CDROM Emulation"))
       {
         settings_changed |= ImGui::Checkbox("Use Read Thread (Asynchronous)", &m_settings_copy.cdrom_read_thread);
+
+        int readahead_sectors = static_cast<int>(m_settings_copy.cdrom_readahead_sectors);
+        ImGui::Text("Readahead Sectors:");
+        ImGui::SameLine(indent);
+        if (ImGui::SliderInt("##readahead_sectors", &readahead_sectors, 0,
+                             static_cast<int>(CDROMAsyncReader::MAX_READAHEAD_SECTORS)))
+        {
+          m_settings_copy.cdrom_readahead_sectors = static_cast<u32>(readahead_sectors);
+          settings_changed = true;
+        }
+
+        int chd_cache_size = static_cast<int>(m_settings_copy.cdrom_chd_cache_size_mb);
+        ImGui::Text("CHD Cache Size (MB):");
+        ImGui::SameLine(indent);
+        if (ImGui::SliderInt("##chd_cache_size", &chd_cache_size, 0, 256))
+        {
+          m_settings_copy.cdrom_chd_cache_size_mb = static_cast<u32>(chd_cache_size);
+          settings_changed = true;
+        }
         settings_changed |= ImGui::Checkbox("Enable Region Check", &m_settings_copy.cdrom_region_check);
         settings_changed |= ImGui::Checkbox("Preload Image To RAM", &m_settings_copy.cdrom_load_image_to_ram);
       }
@@ -1309,6 +1366,8 @@ void SDLHostInterface::DrawSettingsWindow()
         }
 
         settings_changed |= ImGui::Checkbox("Use Debug Device", &m_settings_copy.gpu_use_debug_device);
+        settings_changed |= ImGui::Checkbox("Threaded Rendering", &m_settings_copy.gpu_use_thread);
+        settings_changed |= ImGui::Checkbox("Threaded Submission", &m_settings_copy.gpu_use_hw_thread);
         settings_changed |= ImGui::Checkbox("Linear Filtering", &m_settings_copy.display_linear_filtering);
         settings_changed |= ImGui::Checkbox("Integer Scaling", &m_settings_copy.display_integer_scaling);
         settings_changed |= ImGui::Checkbox("VSync", &m_settings_copy.video_sync_enabled);
@@ -5,6 +5,7 @@
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/string_util.h"
+#include "common/trace.h"
 #include "controller_interface.h"
 #include "core/cdrom.h"
 #include "core/cpu_code_cache.h"
@@ -80,6 +81,13 @@ bool CommonHostInterface::Initialize()
   RegisterAudioHotkeys();
 
   UpdateControllerInterface();
+
+#ifdef WITH_TRACING
+  // Always record, so a trace of whatever just happened can be saved with the hotkey.
+  Trace::SetThreadName("Emulation Thread");
+  Trace::SetRecording(true);
+#endif
+
   return true;
 }
 
@@ -751,8 +759,11 @@ void CommonHostInterface::DrawFPSWindow()
     return;
   }
 
-  const ImVec2 window_size =
-    ImVec2(175.0f * ImGui::GetIO().DisplayFramebufferScale.x, 48.0f * ImGui::GetIO().DisplayFramebufferScale.y);
+  const bool show_rewind = System::IsValid() && g_settings.rewind_enable;
+  const bool show_runahead = System::IsValid() && g_settings.runahead_frames > 0;
+  const float window_height = 48.0f + (show_rewind ? 16.0f : 0.0f) + (show_runahead ? 16.0f : 0.0f);
+  const ImVec2 window_size = ImVec2(175.0f * ImGui::GetIO().DisplayFramebufferScale.x,
+                                    window_height * ImGui::GetIO().DisplayFramebufferScale.y);
   ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - window_size.x, 0.0f), ImGuiCond_Always);
   ImGui::SetNextWindowSize(window_size);
 
@@ -816,6 +827,29 @@ void CommonHostInterface::DrawFPSWindow()
     ImGui::Text("%ux%u (%s)", effective_width, effective_height, interlaced ? "interlaced" : "progressive");
   }
 
+  if (show_rewind)
+  {
+    // capture time is what each snapshot costs the emulation thread, encoding happens in the background
+    const float memory_usage = static_cast<float>(System::GetRewindMemoryUsage()) / 1048576.0f;
+    if (System::IsRewinding())
+    {
+      ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Rewinding: %u (%.1fMB)", System::GetRewindSnapshotCount(),
+                         memory_usage);
+    }
+    else
+    {
+      ImGui::Text("Rewind: %.2fms %u (%.1fMB)", System::GetRewindCaptureTime(), System::GetRewindSnapshotCount(),
+                  memory_usage);
+    }
+  }
+
+  if (show_runahead)
+  {
+    // total time the extra frames cost per frame, and how much of it is saving/loading the snapshot
+    ImGui::Text("Run-Ahead %u: %.2fms (%.2fms)", g_settings.runahead_frames, System::GetRunaheadTime(),
+                System::GetRunaheadSnapshotTime());
+  }
+
   ImGui::End();
 }
 
@@ -1383,6 +1417,28 @@ void CommonHostInterface::RegisterGeneralHotkeys()
                      SaveScreenshot();
                  });
 
+#ifdef WITH_TRACING
+  RegisterHotkey(StaticString("General"), StaticString("SaveTrace"),
+                 StaticString(TRANSLATABLE("Hotkeys", "Save Trace")), [this](bool pressed) {
+                   if (!pressed)
+                     SaveTrace();
+                 });
+#endif
+
+  RegisterHotkey(StaticString("General"), StaticString("Rewind"), StaticString(TRANSLATABLE("Hotkeys", "Rewind")),
+                 [this](bool pressed) {
+                   if (!System::IsValid())
+                     return;
+
+                   if (pressed && !g_settings.rewind_enable)
+                   {
+                     AddOSDMessage(TranslateStdString("OSDMessage", "Rewind is not enabled."), 2.0f);
+                     return;
+                   }
+
+                   System::SetRewinding(pressed);
+                 });
+
   RegisterHotkey(StaticString("General"), StaticString("FrameStep"),
                  StaticString(TRANSLATABLE("Hotkeys", "Frame Step")), [this](bool pressed) {
                    if (!pressed)
@@ -1768,6 +1824,8 @@ std::vector<CommonHostInterface::SaveStateInfo> CommonHostInterface::GetAvailabl
 
 std::optional<CommonHostInterface::SaveStateInfo> CommonHostInterface::GetSaveStateInfo(const char* game_code, s32 slot)
 {
+  WaitForSaveStateWrites();
+
   const bool global = (!game_code || game_code[0] == 0);
   std::string path = global ? GetGlobalSaveStateFileName(slot) : GetGameSaveStateFileName(game_code, slot);
 
@@ -1781,6 +1839,8 @@ std::optional<CommonHostInterface::SaveStateInfo> CommonHostInterface::GetSaveSt
 std::optional<CommonHostInterface::ExtendedSaveStateInfo>
 CommonHostInterface::GetExtendedSaveStateInfo(const char* game_code, s32 slot)
 {
+  WaitForSaveStateWrites();
+
   const bool global = (!game_code || game_code[0] == 0);
   std::string path = global ? GetGlobalSaveStateFileName(slot) : GetGameSaveStateFileName(game_code, slot);
 
@@ -1835,6 +1895,8 @@ CommonHostInterface::GetExtendedSaveStateInfo(const char* game_code, s32 slot)
 
 void CommonHostInterface::DeleteSaveStates(const char* game_code, bool resume)
 {
+  WaitForSaveStateWrites();
+
   const std::vector<SaveStateInfo> states(GetAvailableSaveStates(game_code));
   for (const SaveStateInfo& si : states)
   {
@@ -2134,6 +2196,29 @@ bool CommonHostInterface::SaveScreenshot(const char* filename /* = nullptr */, b
   return true;
 }
 
+#ifdef WITH_TRACING
+
+bool CommonHostInterface::SaveTrace(const char* filename /* = nullptr */)
+{
+  std::string auto_filename;
+  if (!filename)
+  {
+    auto_filename = GetUserDirectoryRelativePath("dump/trace_%s.json", GetTimestampStringForFileName().GetCharArray());
+    filename = auto_filename.c_str();
+  }
+
+  if (!Trace::SaveChromeTrace(filename))
+  {
+    AddFormattedOSDMessage(10.0f, TranslateString("OSDMessage", "Failed to save trace to '%s'"), filename);
+    return false;
+  }
+
+  AddFormattedOSDMessage(5.0f, TranslateString("OSDMessage", "Trace saved to '%s'."), filename);
+  return true;
+}
+
+#endif
+
 void CommonHostInterface::ApplyGameSettings(bool display_osd_messages)
 {
   // this gets called while booting, so can't use valid
@@ -151,6 +151,12 @@ public:
   /// Saves a screenshot to the specified file. IF no file name is provided, one will be generated automatically.
   bool SaveScreenshot(const char* filename = nullptr, bool full_resolution = true, bool apply_aspect_ratio = true);
 
+#ifdef WITH_TRACING
+  /// Saves the most recent trace events to the specified file. If no file name is provided, one will be generated
+  /// automatically.
+  bool SaveTrace(const char* filename = nullptr);
+#endif
+
 protected:
   enum : u32
   {